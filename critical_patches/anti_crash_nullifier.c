@@ -1,15 +1,55 @@
 #define _GNU_SOURCE
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <strings.h>
 #include <unistd.h>
 #include <dlfcn.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
 #include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
 #include <objc/runtime.h>
 #include <objc/message.h>
 
 #define ADC_MAX_PLIST_SIZE 3221225472UL
 
+// Chat filter: $BH_WORLD_DIR/chat_filter.conf (BH_CHAT_FILTER overrides), one word or phrase per line
+#define ADC_FILTER_NAME      "chat_filter.conf"
+#define ADC_FILTER_POLL_SEC  2
+#define ADC_FILTER_MAX_LEN   64
+#define ADC_FILTER_MAX_CHARS (1 << 20)      // Pattern bytes in total
+#define ADC_FILTER_MAX_CELLS (1 << 24)      // States x byte classes, 64 MB of table
+
+// Chat rate limit: leaky bucket per alias, commands (/ and !) counted apart from chat
+#define ADC_RL_CHAT_RATE     2.0            // Messages drained per second
+#define ADC_RL_CHAT_BURST    8.0
+#define ADC_RL_CMD_RATE      1.0
+#define ADC_RL_CMD_BURST     5.0
+#define ADC_RL_PLAYERS       256            // Connections tracked
+#define ADC_RL_SENDERS       1024           // Recent payloads remembered with their sender, power of two
+#define ADC_RL_REPORT_SEC    10             // Drop reports per player at most this often
+
+// Plist predecode (BH_PLIST_WORKERS overrides the worker count, 0 turns it off)
+#define ADC_PRE_WORKERS     0           // Opt-in (BH_PLIST_WORKERS): no measured gain yet
+#define ADC_PRE_WORKERS_MAX 8
+#define ADC_PRE_MIN_BYTES   256         // Smaller plists decode faster than a handoff
+#define ADC_PRE_MAX_BYTES   (1 << 20)
+#define ADC_PRE_RING        256         // Jobs per worker queue, power of two
+#define ADC_PRE_PENDING     128         // Decoded plists waiting for the game
+#define ADC_PRE_POSTED      512
+#define ADC_PRE_FRAGS       32          // Fragmented packets being reassembled
+#define ADC_PRE_EXPIRE_NS   2000000000ull
+#define ADC_PRE_REPORT_SEC  60
+#define ADC_PRE_MAX_FD      4096
+
 typedef struct {
     uint32_t macroIndex;
     uint8_t createIfNotCreated;
@@ -27,6 +67,11 @@ typedef BOOL (*ADC_ID_Kind_IMP)(id, SEL, Class);
 typedef id (*ADC_ID_Alloc_IMP)(id, SEL);
 typedef id (*ADC_ID_Init_IMP)(id, SEL, const char*);
 
+typedef ssize_t (*ADC_RecvMsg_Func)(int, struct msghdr*, int);
+typedef ssize_t (*ADC_RecvFrom_Func)(int, void*, size_t, int, struct sockaddr*, socklen_t*);
+typedef BOOL (*ADC_RegThread_Func)(void);
+typedef id (*ADC_Intern_Func)(const char*);
+
 static ADC_PC_Plist_IMP ADC_Real_PlistWithData = NULL;
 static ADC_ID_Req_IMP   ADC_Real_RequestForBlock = NULL;
 static ADC_ID_Sim_IMP   ADC_Real_AddSimEvent = NULL;
@@ -43,6 +88,31 @@ static id ADC_ID_Str(const char* str) {
     return fInit(fAlloc((id)cls, sAlloc), sInit, str);
 }
 
+static void ADC_ID_Release(id obj) {
+    if (!obj) return;
+    SEL s = sel_registerName("release");
+    void (*f)(id, SEL) = (void (*)(id, SEL))class_getMethodImplementation(object_getClass(obj), s);
+    if (f) f(obj, s);
+}
+
+// Dictionary keys and replacement values, made once: string_pool.c shares
+// them with the other modules, otherwise they are our own immortal copies
+static struct { id msg, alias, empty, unknown; } g_ADC_Keys;
+static pthread_once_t g_ADC_KeysOnce = PTHREAD_ONCE_INIT;
+
+static id ADC_ConstStr(ADC_Intern_Func intern, const char* str) {
+    id obj = intern ? intern(str) : nil;
+    return obj ? obj : ADC_ID_Str(str);
+}
+
+static void ADC_KeysInit(void) {
+    ADC_Intern_Func intern = (ADC_Intern_Func)dlsym(RTLD_DEFAULT, "BHStr_Intern");
+    g_ADC_Keys.msg = ADC_ConstStr(intern, "message");
+    g_ADC_Keys.alias = ADC_ConstStr(intern, "alias");
+    g_ADC_Keys.empty = ADC_ConstStr(intern, "");
+    g_ADC_Keys.unknown = ADC_ConstStr(intern, "Unknown");
+}
+
 static id ADC_GetSafeEmptyMutableDict() {
     Class cls = objc_getClass("NSMutableDictionary");
     SEL s = sel_registerName("dictionary");
@@ -50,6 +120,13 @@ static id ADC_GetSafeEmptyMutableDict() {
     return f((id)cls, s);
 }
 
+// propertyListWithData: returns an object the caller does not own; our mutableCopy is +1
+static id ADC_Autorelease(id obj) {
+    SEL s = sel_registerName("autorelease");
+    id (*f)(id, SEL) = (id (*)(id, SEL))class_getMethodImplementation(object_getClass(obj), s);
+    return f(obj, s);
+}
+
 static int ADC_GetWorldWidth(id worldObject) {
     if (!worldObject) return 0;
     Ivar ivar = class_getInstanceVariable(object_getClass(worldObject), "worldWidthMacro");
@@ -61,6 +138,212 @@ static int ADC_GetWorldWidth(id worldObject) {
     return 0; 
 }
 
+/*
+ * Chat filter
+ * Banned words and phrases are compiled into one Aho-Corasick automaton,
+ * stored as a full DFA: bytes are folded to lower case and mapped to the
+ * classes that occur in the list, so a step is one table load and a message
+ * is scanned once whatever the list size. Every state keeps the longest
+ * pattern ending there, which is the span masked with '*'.
+ * The table is sized from the exact trie node count (the sorted list shares
+ * prefixes), and a list whose table would pass ADC_FILTER_MAX_CELLS is
+ * refused instead of allocated.
+ * The file is polled like banned_items.conf; a new automaton is built on the
+ * watcher thread and swapped in with one atomic store. The previous one is
+ * freed at the next swap, long after any decode that could still hold it.
+ */
+
+typedef struct {
+    int      cols;
+    int      states;
+    int      patterns;
+    uint8_t  cls[256];
+    int32_t* next;                  // states x cols
+    uint8_t* out;                   // Longest pattern ending in each state
+} ADC_Filter;
+
+static ADC_Filter* _Atomic g_ADC_Filter = NULL;
+static char g_ADC_FilterPath[512];
+
+static void ADC_FilterFree(ADC_Filter* f) {
+    if (!f) return;
+    free(f->next);
+    free(f->out);
+    free(f);
+}
+
+static int ADC_FilterCmp(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// Sorts words in place
+static ADC_Filter* ADC_FilterBuild(char** words, int count) {
+    ADC_Filter* f = calloc(1, sizeof(ADC_Filter));
+    if (!f) return NULL;
+    f->cols = 1;
+    for (int i = 0; i < count; i++) {
+        for (const uint8_t* p = (const uint8_t*)words[i]; *p; p++) {
+            if (!f->cls[*p] && f->cols < 256) f->cls[*p] = (uint8_t)f->cols++;
+        }
+    }
+    // Upper-case bytes take the class of their lower-case form
+    for (int c = 'A'; c <= 'Z'; c++) f->cls[c] = f->cls[c - 'A' + 'a'];
+
+    // Trie nodes: each word adds the bytes past what it shares with the one before
+    qsort(words, (size_t)count, sizeof(char*), ADC_FilterCmp);
+    size_t maxStates = 1;
+    for (int i = 0; i < count; i++) {
+        size_t shared = 0;
+        if (i > 0) while (words[i][shared] && words[i][shared] == words[i - 1][shared]) shared++;
+        maxStates += strlen(words[i]) - shared;
+    }
+    if (maxStates * (size_t)f->cols > ADC_FILTER_MAX_CELLS) {
+        printf("[ADC] Chat filter: %zu states x %d byte classes is over the %d cell limit, list not loaded.\n",
+               maxStates, f->cols, ADC_FILTER_MAX_CELLS);
+        ADC_FilterFree(f);
+        return NULL;
+    }
+    f->next = malloc(maxStates * (size_t)f->cols * sizeof(int32_t));
+    f->out = calloc(maxStates, 1);
+    int32_t* fail = malloc(maxStates * sizeof(int32_t));
+    int32_t* queue = malloc(maxStates * sizeof(int32_t));
+    if (!f->next || !f->out || !fail || !queue) {
+        free(fail);
+        free(queue);
+        ADC_FilterFree(f);
+        return NULL;
+    }
+    memset(f->next, 0xFF, maxStates * (size_t)f->cols * sizeof(int32_t));
+
+    f->states = 1;
+    for (int i = 0; i < count; i++) {
+        int st = 0;
+        size_t len = 0;
+        for (const uint8_t* p = (const uint8_t*)words[i]; *p; p++, len++) {
+            int32_t* t = &f->next[(size_t)st * f->cols + f->cls[*p]];
+            if (*t < 0) *t = f->states++;
+            st = *t;
+        }
+        if (len > f->out[st]) f->out[st] = (uint8_t)len;
+        f->patterns++;
+    }
+
+    // Breadth first: missing edges borrow the failure state's, outputs inherit along failure links
+    int head = 0, tail = 0;
+    for (int c = 0; c < f->cols; c++) {
+        int32_t* t = &f->next[c];
+        if (*t < 0) *t = 0;
+        else { fail[*t] = 0; queue[tail++] = *t; }
+    }
+    while (head < tail) {
+        int st = queue[head++];
+        for (int c = 0; c < f->cols; c++) {
+            int32_t* t = &f->next[(size_t)st * f->cols + c];
+            int32_t via = f->next[(size_t)fail[st] * f->cols + c];
+            if (*t < 0) {
+                *t = via;
+            } else {
+                fail[*t] = via;
+                if (f->out[via] > f->out[*t]) f->out[*t] = f->out[via];
+                queue[tail++] = *t;
+            }
+        }
+    }
+    free(fail);
+    free(queue);
+    return f;
+}
+
+// Returns the number of patterns, -1 if the file can't be read, -2 if the list can't be built
+static int ADC_FilterLoad(void) {
+    FILE* file = fopen(g_ADC_FilterPath, "r");
+    if (!file) return -1;
+    char** words = NULL;
+    int count = 0, cap = 0;
+    size_t chars = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char* p = line;
+        while (isspace((unsigned char)*p)) p++;
+        size_t len = strlen(p);
+        while (len > 0 && isspace((unsigned char)p[len - 1])) p[--len] = '\0';
+        if (len == 0) continue;
+        if (len > ADC_FILTER_MAX_LEN || chars + len > ADC_FILTER_MAX_CHARS) {
+            printf("[ADC] Chat filter: skipped '%.20s...' (too long or list full)\n", p);
+            continue;
+        }
+        for (char* q = p; *q; q++) *q = (char)tolower((unsigned char)*q);
+        if (count == cap) {
+            cap = cap ? cap * 2 : 256;
+            char** grown = realloc(words, sizeof(char*) * (size_t)cap);
+            if (!grown) break;
+            words = grown;
+        }
+        words[count++] = strdup(p);
+        chars += len;
+    }
+    fclose(file);
+
+    ADC_Filter* next = count > 0 ? ADC_FilterBuild(words, count) : NULL;
+    for (int i = 0; i < count; i++) free(words[i]);
+    free(words);
+    if (count > 0 && !next) return -2;
+
+    static ADC_Filter* retired = NULL;
+    ADC_FilterFree(retired);
+    retired = atomic_exchange_explicit(&g_ADC_Filter, next, memory_order_acq_rel);
+    return count;
+}
+
+static void* ADC_FilterWatch(void* arg) {
+    const char* cfg = getenv("BH_CHAT_FILTER");
+    const char* dir = getenv("BH_WORLD_DIR");
+    if (cfg && *cfg) snprintf(g_ADC_FilterPath, sizeof(g_ADC_FilterPath), "%s", cfg);
+    else if (dir && *dir) snprintf(g_ADC_FilterPath, sizeof(g_ADC_FilterPath), "%s/%s", dir, ADC_FILTER_NAME);
+    else snprintf(g_ADC_FilterPath, sizeof(g_ADC_FilterPath), "%s", ADC_FILTER_NAME);
+    if (access(g_ADC_FilterPath, F_OK) != 0) {
+        FILE* f = fopen(g_ADC_FilterPath, "w");
+        if (f) {
+            fputs("# Banned chat words and phrases, one per line (case-insensitive, masked with *)\n", f);
+            fclose(f);
+        }
+    }
+
+    struct stat last;
+    bool haveLast = false;
+    for (;;) {
+        struct stat st;
+        if (stat(g_ADC_FilterPath, &st) == 0 &&
+            !(haveLast && st.st_mtime == last.st_mtime && st.st_size == last.st_size && st.st_ino == last.st_ino)) {
+            last = st;
+            haveLast = true;
+            int count = ADC_FilterLoad();
+            if (count == -1) printf("[ADC] Cannot read %s, keeping the current chat filter.\n", g_ADC_FilterPath);
+            else if (count == -2) printf("[ADC] Cannot build the list in %s, keeping the current chat filter.\n", g_ADC_FilterPath);
+            else if (count > 0) printf("[ADC] Chat filter: %d word(s) loaded from %s\n", count, g_ADC_FilterPath);
+        }
+        sleep(ADC_FILTER_POLL_SEC);
+    }
+    return NULL;
+}
+
+// Masks banned spans in place; returns true if anything matched
+static bool ADC_FilterText(const ADC_Filter* f, char* text) {
+    bool hit = false;
+    int st = 0;
+    for (size_t i = 0; text[i]; i++) {
+        st = f->next[(size_t)st * f->cols + f->cls[(uint8_t)text[i]]];
+        uint8_t len = f->out[st];
+        if (len) {
+            memset(text + i + 1 - len, '*', len);
+            hit = true;
+        }
+    }
+    return hit;
+}
+
 static void ADC_SanitizePacket(id dict) {
     if (!dict) return;
     Class dictClass = object_getClass(dict);
@@ -75,14 +358,30 @@ static void ADC_SanitizePacket(id dict) {
     ADC_ID_SetObj_IMP fSet = (ADC_ID_SetObj_IMP)class_getMethodImplementation(dictClass, sSet);
     
     Class strClass = objc_getClass("NSString");
-    id kMsg = ADC_ID_Str("message");
-    id kAlias = ADC_ID_Str("alias");
+    pthread_once(&g_ADC_KeysOnce, ADC_KeysInit);
+    id kMsg = g_ADC_Keys.msg;
+    id kAlias = g_ADC_Keys.alias;
 
     id msgVal = fGet(dict, sObj, kMsg);
     if (msgVal) {
         BOOL (*fKind)(id, SEL, Class) = (BOOL (*)(id, SEL, Class))class_getMethodImplementation(object_getClass(msgVal), sKind);
         if (!fKind(msgVal, sKind, strClass)) {
-            fSet(dict, sSet, ADC_ID_Str(""), kMsg);
+            fSet(dict, sSet, g_ADC_Keys.empty, kMsg);
+        } else {
+            const ADC_Filter* filter = atomic_load_explicit(&g_ADC_Filter, memory_order_acquire);
+            SEL sUtf8 = sel_registerName("UTF8String");
+            const char* (*fUtf8)(id, SEL) = (const char* (*)(id, SEL))class_getMethodImplementation(object_getClass(msgVal), sUtf8);
+            const char* text = (filter && fUtf8) ? fUtf8(msgVal, sUtf8) : NULL;
+            char* copy = text ? strdup(text) : NULL;
+            if (copy && ADC_FilterText(filter, copy)) {
+                // nil if masking cut a multi-byte character (a pattern that is not valid UTF-8)
+                id masked = ADC_ID_Str(copy);
+                if (masked) {
+                    fSet(dict, sSet, masked, kMsg);
+                    ADC_ID_Release(masked);     // The dictionary holds it now
+                }
+            }
+            free(copy);
         }
     }
 
@@ -90,9 +389,705 @@ static void ADC_SanitizePacket(id dict) {
     if (aliasVal) {
         BOOL (*fKind)(id, SEL, Class) = (BOOL (*)(id, SEL, Class))class_getMethodImplementation(object_getClass(aliasVal), sKind);
         if (!fKind(aliasVal, sKind, strClass)) {
-            fSet(dict, sSet, ADC_ID_Str("Unknown"), kAlias);
+            fSet(dict, sSet, g_ADC_Keys.unknown, kAlias);
+        }
+    }
+}
+
+/*
+ * Plist predecode
+ * Client packets are decoded by the game right where it handles them, so the
+ * decode cannot be deferred. Instead every plist that arrives is decoded ahead
+ * of time: recvmsg()/recvfrom() hand the ENet payloads (fragments reassembled)
+ * to a small worker pool, which decodes and sanitizes them while ENet is still
+ * receiving and dispatching. When the game asks for the same bytes, the hook
+ * returns the finished dictionary instead of decoding it again.
+ * Each peer always goes to the same worker, and each worker has two
+ * single-producer/single-consumer rings (jobs in, results out), so a peer's
+ * packets are decoded in arrival order. A full ring or a plist that was never
+ * seen on the wire falls back to decoding on the calling thread as before.
+ * When the game asks for a plist that is not finished yet (queued or already
+ * being decoded), it decodes it right there and never waits on a worker; a
+ * queued job is taken back, a started one is thrown away when it completes.
+ * Off unless BH_PLIST_WORKERS is set.
+ */
+
+enum { ADC_PRE_FREE = 0, ADC_PRE_QUEUED = 1, ADC_PRE_DECODING = 2 };
+
+typedef struct ADC_PreJob {
+    uint64_t hash;
+    uint32_t len;
+    uint32_t posted;                // Slot in g_ADC_Posted
+    uint32_t seq;                   // Post number, tags the slot's state
+    unsigned long opt, fmt;
+    id       result;                // +1, sanitized mutable copy (nil if the decode failed)
+    uint64_t decodeNs;
+    uint64_t readyAt;
+    uint8_t  bytes[];
+} ADC_PreJob;
+
+typedef struct {
+    ADC_PreJob* slots[ADC_PRE_RING];
+    _Alignas(64) _Atomic uint32_t head;     // Producer
+    _Alignas(64) _Atomic uint32_t tail;     // Consumer
+} ADC_PreRing;
+
+typedef struct {
+    ADC_PreRing jobs;               // Network thread -> worker
+    ADC_PreRing done;               // Worker -> decoding thread
+    sem_t       wake;
+} ADC_PreWorker;
+
+typedef struct {
+    bool     used;
+    uint32_t ip;
+    uint16_t port;
+    uint8_t  channel;
+    uint16_t start;
+    uint32_t total, count, received;
+    uint8_t* data;
+    uint8_t* seen;
+    uint64_t at;
+} ADC_PreFrag;
+
+typedef struct {
+    uint64_t hash;
+    uint32_t len;
+    _Atomic uint32_t state;         // seq << 2 | ADC_PRE_*; the worker and the game thread race on it
+} ADC_PreKey;
+
+// Who sent a payload: the chat rate limit is keyed on the connection, not the alias in the packet
+typedef struct { uint64_t hash; uint32_t len; uint32_t ip; uint16_t port; } ADC_PreSender;
+
+static const uint8_t ADC_EnetCommandSize[13] = { 0, 8, 48, 44, 8, 4, 6, 8, 24, 8, 12, 16, 24 };
+
+static ADC_PreWorker g_ADC_Workers[ADC_PRE_WORKERS_MAX];
+static int           g_ADC_WorkerCount = 0;
+static atomic_bool   g_ADC_PreOn = false;
+static atomic_bool   g_ADC_RecvOn = false;          // Payloads are matched to senders
+static _Atomic unsigned long g_ADC_PreOpt = 0;      // Options the game decodes with
+
+// Producer side (g_ADC_PostLock)
+static pthread_mutex_t g_ADC_PostLock = PTHREAD_MUTEX_INITIALIZER;
+static ADC_PreKey    g_ADC_Posted[ADC_PRE_POSTED];
+static uint32_t      g_ADC_PostedNext = 0;
+static ADC_PreFrag   g_ADC_Frags[ADC_PRE_FRAGS];
+static ADC_PreSender g_ADC_Senders[ADC_RL_SENDERS];
+static uint32_t      g_ADC_SendersNext = 0;
+
+// Consumer side (g_ADC_TakeLock)
+static pthread_mutex_t g_ADC_TakeLock = PTHREAD_MUTEX_INITIALIZER;
+static ADC_PreJob*   g_ADC_Pending[ADC_PRE_PENDING];
+static int           g_ADC_PendingCount = 0;
+
+static _Atomic int64_t  g_ADC_InFlight = 0;
+static _Atomic uint64_t g_ADC_PreHits = 0, g_ADC_PreSync = 0, g_ADC_PreSaturated = 0, g_ADC_PreLate = 0;
+static _Atomic uint64_t g_ADC_PreDropped = 0, g_ADC_PreTakenBack = 0;
+static _Atomic int64_t  g_ADC_PreSavedNs = 0;
+
+static _Atomic uint8_t g_ADC_FdKind[ADC_PRE_MAX_FD];   // 0 unknown, 1 UDP, 2 other
+static ADC_RecvMsg_Func  ADC_Real_RecvMsg = NULL;
+static ADC_RecvFrom_Func ADC_Real_RecvFrom = NULL;
+
+static uint64_t ADC_NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static bool ADC_RingPush(ADC_PreRing* r, ADC_PreJob* job) {
+    uint32_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&r->tail, memory_order_acquire) >= ADC_PRE_RING) return false;
+    r->slots[head & (ADC_PRE_RING - 1)] = job;
+    atomic_store_explicit(&r->head, head + 1, memory_order_release);
+    return true;
+}
+
+static ADC_PreJob* ADC_RingPop(ADC_PreRing* r) {
+    uint32_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    if (tail == atomic_load_explicit(&r->head, memory_order_acquire)) return NULL;
+    ADC_PreJob* job = r->slots[tail & (ADC_PRE_RING - 1)];
+    atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+    return job;
+}
+
+// Sampled FNV-1a: candidates are confirmed with memcmp, this only has to spread them
+static uint64_t ADC_PreHash(const uint8_t* p, size_t len) {
+    uint64_t h = 1469598103934665603ull ^ len;
+    size_t step = len > 256 ? len / 128 : 1;
+    for (size_t i = 0; i < len; i += step) { h ^= p[i]; h *= 1099511628211ull; }
+    for (size_t i = len > 32 ? len - 32 : 0; i < len; i++) { h ^= p[i]; h *= 1099511628211ull; }
+    return h;
+}
+
+static void ADC_PreFree(ADC_PreJob* job) {
+    if (job->result) {
+        SEL s = sel_registerName("release");
+        void (*f)(id, SEL) = (void (*)(id, SEL))class_getMethodImplementation(object_getClass(job->result), s);
+        f(job->result, s);
+    }
+    free(job);
+}
+
+// --- Producer (network thread, g_ADC_PostLock held) ---
+
+static void ADC_PrePost(int worker, const uint8_t* payload, size_t len, uint64_t hash) {
+    ADC_PreJob* job = malloc(sizeof(ADC_PreJob) + len);
+    if (!job) return;
+    memcpy(job->bytes, payload, len);
+    job->hash = hash;
+    job->len = (uint32_t)len;
+    job->opt = atomic_load_explicit(&g_ADC_PreOpt, memory_order_relaxed);
+    job->fmt = 0;
+    job->result = nil;
+    job->seq = g_ADC_PostedNext++ & 0x3FFFFFFFu;
+    job->posted = job->seq % ADC_PRE_POSTED;
+
+    // Published before the push: the worker claims the job through this slot
+    ADC_PreKey* key = &g_ADC_Posted[job->posted];
+    key->hash = job->hash;
+    key->len = job->len;
+    atomic_store(&key->state, job->seq << 2 | ADC_PRE_QUEUED);
+
+    ADC_PreWorker* w = &g_ADC_Workers[worker];
+    if (!ADC_RingPush(&w->jobs, job)) {
+        atomic_store(&key->state, job->seq << 2 | ADC_PRE_FREE);
+        free(job);
+        atomic_fetch_add(&g_ADC_PreSaturated, 1);
+        return;
+    }
+    atomic_fetch_add(&g_ADC_InFlight, 1);
+    sem_post(&w->wake);
+}
+
+// Every plist payload is remembered with its sender; big ones go to a worker too
+static void ADC_PreSeen(int worker, uint32_t ip, uint16_t port, const uint8_t* payload, size_t len) {
+    // The game's NSData may skip a leading message ID byte or two
+    size_t k = 0;
+    while (k < 4 && k + 8 <= len && memcmp(payload + k, "bplist0", 7) != 0 &&
+           memcmp(payload + k, "<?xml", 5) != 0 && memcmp(payload + k, "<plist", 6) != 0) k++;
+    if (k == 4 || k + 8 > len) return;
+    payload += k;
+    len -= k;
+
+    uint64_t hash = ADC_PreHash(payload, len);
+    ADC_PreSender* s = &g_ADC_Senders[g_ADC_SendersNext++ % ADC_RL_SENDERS];
+    s->hash = hash;
+    s->len = (uint32_t)len;
+    s->ip = ip;
+    s->port = port;
+    if (len >= ADC_PRE_MIN_BYTES && len <= ADC_PRE_MAX_BYTES && atomic_load_explicit(&g_ADC_PreOn, memory_order_relaxed)) {
+        ADC_PrePost(worker, payload, len, hash);
+    }
+}
+
+static void ADC_PreFragment(int worker, uint32_t ip, uint16_t port, const uint8_t* c, const uint8_t* data, size_t dataLen) {
+    uint16_t start = (uint16_t)((c[4] << 8) | c[5]);
+    uint32_t count = ((uint32_t)c[8] << 24) | ((uint32_t)c[9] << 16) | ((uint32_t)c[10] << 8) | c[11];
+    uint32_t number = ((uint32_t)c[12] << 24) | ((uint32_t)c[13] << 16) | ((uint32_t)c[14] << 8) | c[15];
+    uint32_t total = ((uint32_t)c[16] << 24) | ((uint32_t)c[17] << 16) | ((uint32_t)c[18] << 8) | c[19];
+    uint32_t offset = ((uint32_t)c[20] << 24) | ((uint32_t)c[21] << 16) | ((uint32_t)c[22] << 8) | c[23];
+    if (count == 0 || number >= count || total > ADC_PRE_MAX_BYTES + 4 || offset > total || dataLen > total - offset) return;
+    // Fragments of small packets are not worth reassembling; only the first one shows the format
+    if (total < ADC_PRE_MIN_BYTES) return;
+
+    ADC_PreFrag* f = NULL;
+    ADC_PreFrag* victim = &g_ADC_Frags[0];
+    for (int i = 0; i < ADC_PRE_FRAGS; i++) {
+        ADC_PreFrag* e = &g_ADC_Frags[i];
+        if (e->used && e->ip == ip && e->port == port && e->channel == c[1] && e->start == start) { f = e; break; }
+        if (!e->used) victim = e;
+        else if (victim->used && e->at < victim->at) victim = e;
+    }
+    if (!f) {
+        if (number == 0 && memcmp(data, "bplist0", dataLen < 7 ? dataLen : 7) != 0 &&
+            memchr(data, '<', dataLen < 8 ? dataLen : 8) == NULL) return;
+        f = victim;
+        free(f->data);
+        free(f->seen);
+        memset(f, 0, sizeof(*f));
+        f->data = malloc(total);
+        f->seen = calloc(count, 1);
+        if (!f->data || !f->seen) {
+            free(f->data);
+            free(f->seen);
+            memset(f, 0, sizeof(*f));
+            return;
+        }
+        f->used = true;
+        f->ip = ip;
+        f->port = port;
+        f->channel = c[1];
+        f->start = start;
+        f->total = total;
+        f->count = count;
+    }
+    if (f->total != total || f->count != count) return;
+    f->at = ADC_NowNs();
+    if (f->seen[number]) return;
+    f->seen[number] = 1;
+    memcpy(f->data + offset, data, dataLen);
+    if (++f->received < f->count) return;
+
+    ADC_PreSeen(worker, ip, port, f->data, f->total);
+    free(f->data);
+    free(f->seen);
+    memset(f, 0, sizeof(*f));
+}
+
+static void ADC_PreOffer(const struct sockaddr* addr, const struct iovec* iov, size_t iovCount, size_t len) {
+    if (!addr || addr->sa_family != AF_INET || len < 4 || iovCount == 0) return;
+    const struct sockaddr_in* in = (const struct sockaddr_in*)addr;
+
+    uint8_t flat[1500];
+    const uint8_t* d = (const uint8_t*)iov[0].iov_base;
+    if (iov[0].iov_len < len) {
+        if (len > sizeof(flat)) return;
+        size_t off = 0;
+        for (size_t i = 0; i < iovCount && off < len; i++) {
+            size_t n = iov[i].iov_len < len - off ? iov[i].iov_len : len - off;
+            memcpy(flat + off, iov[i].iov_base, n);
+            off += n;
+        }
+        d = flat;
+    }
+    // Compressed datagrams are left to the game
+    if (d[0] & 0x40) return;
+
+    uint32_t ip = in->sin_addr.s_addr;
+    uint16_t port = in->sin_port;
+    uint32_t h = ip ^ ((uint32_t)port * 0x9E3779B1u);
+    int worker = g_ADC_WorkerCount ? (int)((h ^ (h >> 16)) % (uint32_t)g_ADC_WorkerCount) : 0;
+
+    pthread_mutex_lock(&g_ADC_PostLock);
+    size_t p = (d[0] & 0x80) ? 4 : 2;
+    while (p + 4 <= len) {
+        int cmd = d[p] & 0x0F;
+        if (cmd <= 0 || cmd > 12 || p + ADC_EnetCommandSize[cmd] > len) break;
+        size_t head = ADC_EnetCommandSize[cmd], data = 0;
+        if (cmd == 6) data = (size_t)((d[p + 4] << 8) | d[p + 5]);
+        else if (cmd == 7 || cmd == 8 || cmd == 9 || cmd == 12) data = (size_t)((d[p + 6] << 8) | d[p + 7]);
+        if (p + head + data > len) break;
+        if (data >= 8 && (cmd == 8 || cmd == 12)) ADC_PreFragment(worker, ip, port, d + p, d + p + head, data);
+        else if (data >= 8) ADC_PreSeen(worker, ip, port, d + p + head, data);
+        p += head + data;
+    }
+    pthread_mutex_unlock(&g_ADC_PostLock);
+}
+
+static bool ADC_IsUdp(int fd) {
+    if (fd < 0 || fd >= ADC_PRE_MAX_FD) return false;
+    uint8_t kind = atomic_load_explicit(&g_ADC_FdKind[fd], memory_order_relaxed);
+    if (kind == 0) {
+        int type = 0;
+        socklen_t len = sizeof(type);
+        kind = (getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &len) == 0 && type == SOCK_DGRAM) ? 1 : 2;
+        atomic_store_explicit(&g_ADC_FdKind[fd], kind, memory_order_relaxed);
+    }
+    return kind == 1;
+}
+
+ssize_t recvmsg(int fd, struct msghdr* msg, int flags) {
+    if (!ADC_Real_RecvMsg) ADC_Real_RecvMsg = (ADC_RecvMsg_Func)dlsym(RTLD_NEXT, "recvmsg");
+    ssize_t ret = ADC_Real_RecvMsg(fd, msg, flags);
+    if (ret > 0 && atomic_load_explicit(&g_ADC_RecvOn, memory_order_relaxed) && ADC_IsUdp(fd)) {
+        ADC_PreOffer((const struct sockaddr*)msg->msg_name, msg->msg_iov, msg->msg_iovlen, (size_t)ret);
+    }
+    return ret;
+}
+
+ssize_t recvfrom(int fd, void* buf, size_t size, int flags, struct sockaddr* addr, socklen_t* addrLen) {
+    if (!ADC_Real_RecvFrom) ADC_Real_RecvFrom = (ADC_RecvFrom_Func)dlsym(RTLD_NEXT, "recvfrom");
+    ssize_t ret = ADC_Real_RecvFrom(fd, buf, size, flags, addr, addrLen);
+    if (ret > 0 && atomic_load_explicit(&g_ADC_RecvOn, memory_order_relaxed) && ADC_IsUdp(fd)) {
+        struct iovec iov = { buf, (size_t)ret };
+        ADC_PreOffer(addr, &iov, 1, (size_t)ret);
+    }
+    return ret;
+}
+
+// --- Workers ---
+
+static void* ADC_PreWorkerMain(void* arg) {
+    ADC_PreWorker* w = (ADC_PreWorker*)arg;
+    ADC_RegThread_Func fReg = (ADC_RegThread_Func)dlsym(RTLD_DEFAULT, "GSRegisterCurrentThread");
+    if (fReg) fReg();
+
+    Class poolCls = objc_getClass("NSAutoreleasePool");
+    Class dataCls = objc_getClass("NSData");
+    Class plistCls = objc_getClass("NSPropertyListSerialization");
+    SEL sNew = sel_registerName("new");
+    SEL sDrain = sel_registerName("drain");
+    SEL sData = sel_registerName("dataWithBytesNoCopy:length:freeWhenDone:");
+    SEL sPlist = sel_registerName("propertyListWithData:options:format:error:");
+    SEL sMut = sel_registerName("mutableCopy");
+    id (*fNew)(id, SEL) = (id (*)(id, SEL))class_getMethodImplementation(object_getClass((id)poolCls), sNew);
+    id (*fData)(id, SEL, void*, unsigned long, BOOL) =
+        (id (*)(id, SEL, void*, unsigned long, BOOL))class_getMethodImplementation(object_getClass((id)dataCls), sData);
+
+    for (;;) {
+        sem_wait(&w->wake);
+        ADC_PreJob* job;
+        while ((job = ADC_RingPop(&w->jobs)) != NULL) {
+            _Atomic uint32_t* state = &g_ADC_Posted[job->posted].state;
+            uint32_t queued = job->seq << 2 | ADC_PRE_QUEUED;
+            uint32_t decoding = job->seq << 2 | ADC_PRE_DECODING;
+            if (!atomic_compare_exchange_strong(state, &queued, decoding)) {
+                // Taken back by the game thread, or so old its slot was reused
+                ADC_PreFree(job);
+                atomic_fetch_sub(&g_ADC_InFlight, 1);
+                continue;
+            }
+            uint64_t t0 = ADC_NowNs();
+            id pool = fNew((id)poolCls, sNew);
+            id data = fData((id)dataCls, sData, job->bytes, job->len, NO);
+            unsigned long fmt = 0;
+            id err = nil;
+            id result = ADC_Real_PlistWithData((id)plistCls, sPlist, data, job->opt, &fmt, &err);
+            if (result) {
+                id (*fMut)(id, SEL) = (id (*)(id, SEL))class_getMethodImplementation(object_getClass(result), sMut);
+                job->result = fMut(result, sMut);
+                ADC_SanitizePacket(job->result);
+            }
+            job->fmt = fmt;
+            void (*fDrain)(id, SEL) = (void (*)(id, SEL))class_getMethodImplementation(object_getClass(pool), sDrain);
+            fDrain(pool, sDrain);
+            job->readyAt = ADC_NowNs();
+            job->decodeNs = job->readyAt - t0;
+
+            if (!ADC_RingPush(&w->done, job)) {
+                ADC_PreFree(job);
+                atomic_fetch_add(&g_ADC_PreDropped, 1);
+                atomic_fetch_sub(&g_ADC_InFlight, 1);
+            }
+            // Frees the slot for ADC_PreClaim; a late result is never waited for
+            atomic_compare_exchange_strong(state, &decoding, decoding & ~3u);
+        }
+    }
+    return NULL;
+}
+
+// --- Consumer (g_ADC_TakeLock held) ---
+
+static void ADC_PreCollect(uint64_t now) {
+    for (int i = 0; i < g_ADC_WorkerCount; i++) {
+        ADC_PreJob* job;
+        while ((job = ADC_RingPop(&g_ADC_Workers[i].done)) != NULL) {
+            atomic_fetch_sub(&g_ADC_InFlight, 1);
+            if (g_ADC_PendingCount == ADC_PRE_PENDING) {
+                ADC_PreFree(g_ADC_Pending[0]);
+                memmove(g_ADC_Pending, g_ADC_Pending + 1, sizeof(ADC_PreJob*) * (ADC_PRE_PENDING - 1));
+                g_ADC_PendingCount--;
+                atomic_fetch_add(&g_ADC_PreDropped, 1);
+            }
+            g_ADC_Pending[g_ADC_PendingCount++] = job;
+        }
+    }
+    // Decoded but never asked for (retransmits, packets the game decodes differently)
+    int keep = 0;
+    for (int i = 0; i < g_ADC_PendingCount; i++) {
+        if (now - g_ADC_Pending[i]->readyAt > ADC_PRE_EXPIRE_NS) {
+            ADC_PreFree(g_ADC_Pending[i]);
+            atomic_fetch_add(&g_ADC_PreDropped, 1);
+        } else {
+            g_ADC_Pending[keep++] = g_ADC_Pending[i];
+        }
+    }
+    g_ADC_PendingCount = keep;
+}
+
+static ADC_PreJob* ADC_PreFind(uint64_t hash, unsigned long len, const void* bytes, unsigned long opt) {
+    for (int i = 0; i < g_ADC_PendingCount; i++) {
+        ADC_PreJob* job = g_ADC_Pending[i];
+        if (job->hash != hash || job->len != len || job->opt != opt || memcmp(job->bytes, bytes, len) != 0) continue;
+        memmove(g_ADC_Pending + i, g_ADC_Pending + i + 1, sizeof(ADC_PreJob*) * (size_t)(g_ADC_PendingCount - i - 1));
+        g_ADC_PendingCount--;
+        return job;
+    }
+    return NULL;
+}
+
+// ADC_PRE_QUEUED: taken back from its worker. ADC_PRE_DECODING: a worker is on it.
+// Either way the caller decodes it itself.
+static int ADC_PreClaim(uint64_t hash, unsigned long len) {
+    int result = ADC_PRE_FREE;
+    pthread_mutex_lock(&g_ADC_PostLock);
+    for (uint32_t i = 0; i < ADC_PRE_POSTED; i++) {
+        ADC_PreKey* k = &g_ADC_Posted[i];
+        if (k->hash != hash || k->len != len) continue;
+        uint32_t w = atomic_load(&k->state);
+        if ((w & 3) == ADC_PRE_QUEUED && atomic_compare_exchange_strong(&k->state, &w, w & ~3u)) {
+            result = ADC_PRE_QUEUED;
+            break;
         }
+        if ((w & 3) == ADC_PRE_DECODING) {
+            result = ADC_PRE_DECODING;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_ADC_PostLock);
+    return result;
+}
+
+static bool ADC_PreTake(id data, unsigned long len, unsigned long opt, unsigned long* fmt, id* out) {
+    if (opt != atomic_load_explicit(&g_ADC_PreOpt, memory_order_relaxed)) {
+        atomic_store_explicit(&g_ADC_PreOpt, opt, memory_order_relaxed);
+        return false;
     }
+    SEL sBytes = sel_registerName("bytes");
+    const void* (*fBytes)(id, SEL) = (const void* (*)(id, SEL))class_getMethodImplementation(object_getClass(data), sBytes);
+    const void* bytes = fBytes ? fBytes(data, sBytes) : NULL;
+    if (!bytes) return false;
+
+    uint64_t t0 = ADC_NowNs();
+    uint64_t hash = ADC_PreHash((const uint8_t*)bytes, len);
+    pthread_mutex_lock(&g_ADC_TakeLock);
+    ADC_PreCollect(t0);
+    ADC_PreJob* job = ADC_PreFind(hash, len, bytes, opt);
+    if (!job && atomic_load(&g_ADC_InFlight) > 0) {
+        // Nobody started on a queued job: the worker drops it when it gets there.
+        // A started one is not waited for: the game thread never spins on a worker.
+        int claim = ADC_PreClaim(hash, len);
+        if (claim == ADC_PRE_QUEUED) atomic_fetch_add(&g_ADC_PreTakenBack, 1);
+        else if (claim == ADC_PRE_DECODING) atomic_fetch_add(&g_ADC_PreLate, 1);
+    }
+    pthread_mutex_unlock(&g_ADC_TakeLock);
+
+    if (!job) {
+        atomic_fetch_add(&g_ADC_PreSync, 1);
+        return false;
+    }
+    pthread_mutex_lock(&g_ADC_PostLock);
+    ADC_PreKey* k = &g_ADC_Posted[job->posted];
+    if (atomic_load(&k->state) >> 2 == job->seq) {
+        k->hash = 0;
+        k->len = 0;
+    }
+    pthread_mutex_unlock(&g_ADC_PostLock);
+
+    *out = job->result;
+    if (fmt) *fmt = job->fmt;
+    job->result = nil;
+    atomic_fetch_add(&g_ADC_PreHits, 1);
+    atomic_fetch_add(&g_ADC_PreSavedNs, (int64_t)job->decodeNs - (int64_t)(ADC_NowNs() - t0));
+    ADC_PreFree(job);
+    return true;
+}
+
+static void ADC_PreStart(void) {
+    int workers = ADC_PRE_WORKERS;
+    const char* env = getenv("BH_PLIST_WORKERS");
+    if (env && *env) workers = atoi(env);
+    if (workers <= 0 || !ADC_Real_PlistWithData) return;
+    if (workers > ADC_PRE_WORKERS_MAX) workers = ADC_PRE_WORKERS_MAX;
+
+    for (int i = 0; i < workers; i++) {
+        sem_init(&g_ADC_Workers[i].wake, 0, 0);
+        pthread_t t;
+        if (pthread_create(&t, NULL, ADC_PreWorkerMain, &g_ADC_Workers[i]) != 0) break;
+        pthread_detach(t);
+        g_ADC_WorkerCount++;
+    }
+    if (g_ADC_WorkerCount == 0) return;
+    atomic_store(&g_ADC_PreOn, true);
+    printf("[ADC] Decoding client plists on %d worker threads.\n", g_ADC_WorkerCount);
+}
+
+static void ADC_PreReport(void) {
+    uint64_t lastHits = 0, lastSync = 0;
+    int64_t lastSaved = 0;
+    for (;;) {
+        sleep(ADC_PRE_REPORT_SEC);
+        uint64_t hits = atomic_load(&g_ADC_PreHits), sync = atomic_load(&g_ADC_PreSync);
+        int64_t saved = atomic_load(&g_ADC_PreSavedNs);
+        if (hits == lastHits && sync == lastSync) continue;
+        if (hits == 0 && sync >= 100) {
+            // The game decodes something other than the wire payloads; stop paying for it
+            atomic_store(&g_ADC_PreOn, false);
+            printf("[ADC] Plist predecode never matched a decode, turning it off.\n");
+            return;
+        }
+        printf("[ADC] Plist predecode: %llu hits, %llu decoded in place (%llu queue full, %llu taken back, %llu late), "
+               "%.1f ms saved on the game thread (%.2f ms/s), %llu unused\n",
+               (unsigned long long)(hits - lastHits), (unsigned long long)(sync - lastSync),
+               (unsigned long long)atomic_load(&g_ADC_PreSaturated),
+               (unsigned long long)atomic_load(&g_ADC_PreTakenBack), (unsigned long long)atomic_load(&g_ADC_PreLate),
+               (double)(saved - lastSaved) / 1e6, (double)(saved - lastSaved) / 1e6 / ADC_PRE_REPORT_SEC,
+               (unsigned long long)atomic_load(&g_ADC_PreDropped));
+        lastHits = hits;
+        lastSync = sync;
+        lastSaved = saved;
+    }
+}
+
+/*
+ * Chat rate limit
+ * Runs on the decoded dictionary (either path), so a predecoded packet that
+ * falls back to a synchronous decode is not counted twice. Buckets belong to
+ * the connection that sent the bytes (looked up in g_ADC_Senders, filled on
+ * the receive path); the alias in the packet is the client's to choose, so it
+ * only names the sender in the log. A message over its connection's bucket
+ * is blanked the way a non-string message is, before the game logs it,
+ * broadcasts it, or runs it through the command hooks and rank_manager.sh.
+ * A packet whose bytes were never seen on the wire (compressed datagram,
+ * framing we do not parse, pushed out of the ring) falls back to the bucket
+ * of the connection last seen with its alias, or to one keyed on the alias
+ * alone (port 0); those are counted per bucket as unmatched.
+ */
+
+enum { ADC_RL_CHAT = 0, ADC_RL_CMD = 1 };
+
+typedef struct {
+    bool     used;
+    uint32_t ip;
+    uint16_t port;
+    char     alias[32];             // Last one used, for the log
+    uint64_t seenNs;
+    double   level[2];
+    uint64_t at[2];
+    uint64_t passed, dropped, reported, unmatched;
+    uint64_t reportedNs;
+} ADC_RateSlot;
+
+static ADC_RateSlot g_ADC_Rate[ADC_RL_PLAYERS];
+static pthread_mutex_t g_ADC_RateLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Connection that most recently sent these plist bytes
+static bool ADC_SenderOf(const void* bytes, unsigned long len, uint32_t* ip, uint16_t* port) {
+    uint64_t hash = ADC_PreHash((const uint8_t*)bytes, len);
+    bool found = false;
+    pthread_mutex_lock(&g_ADC_PostLock);
+    for (uint32_t n = 1; n <= ADC_RL_SENDERS && !found; n++) {
+        ADC_PreSender* s = &g_ADC_Senders[(g_ADC_SendersNext - n) % ADC_RL_SENDERS];
+        if (s->hash != hash || s->len != len || !s->port) continue;
+        *ip = s->ip;
+        *port = s->port;
+        found = true;
+    }
+    pthread_mutex_unlock(&g_ADC_PostLock);
+    return found;
+}
+
+static ADC_RateSlot* ADC_RateSlotNew(ADC_RateSlot* r, uint32_t ip, uint16_t port, uint64_t now) {
+    memset(r, 0, sizeof(*r));
+    r->used = true;
+    r->ip = ip;
+    r->port = port;
+    r->at[0] = r->at[1] = now;
+    return r;
+}
+
+static ADC_RateSlot* ADC_RateSlotFor(uint32_t ip, uint16_t port, uint64_t now) {
+    uint32_t h = ip ^ ((uint32_t)port * 0x9E3779B1u);
+    h ^= h >> 16;
+    ADC_RateSlot* oldest = NULL;
+    for (int n = 0; n < ADC_RL_PLAYERS; n++) {
+        ADC_RateSlot* r = &g_ADC_Rate[(h + (uint32_t)n) % ADC_RL_PLAYERS];
+        if (r->used && r->ip == ip && r->port == port) return r;
+        if (!r->used) { oldest = r; break; }
+        if (!oldest || r->seenNs < oldest->seenNs) oldest = r;
+    }
+    return ADC_RateSlotNew(oldest, ip, port, now);
+}
+
+// No sender for the bytes: the connection last seen with this alias, else a bucket for the alias itself
+static ADC_RateSlot* ADC_RateSlotForAlias(const char* alias, uint64_t now) {
+    ADC_RateSlot* match = NULL;
+    for (int n = 0; n < ADC_RL_PLAYERS; n++) {
+        ADC_RateSlot* r = &g_ADC_Rate[n];
+        if (r->used && strcmp(r->alias, alias) == 0 && (!match || r->seenNs > match->seenNs)) match = r;
+    }
+    if (match) return match;
+
+    uint32_t h = 2166136261u;
+    for (const char* c = alias; *c; c++) h = (h ^ (uint8_t)*c) * 16777619u;
+    ADC_RateSlot* oldest = NULL;
+    for (int n = 0; n < ADC_RL_PLAYERS; n++) {
+        ADC_RateSlot* r = &g_ADC_Rate[(h + (uint32_t)n) % ADC_RL_PLAYERS];
+        if (!r->used) { oldest = r; break; }
+        if (!oldest || r->seenNs < oldest->seenNs) oldest = r;
+    }
+    ADC_RateSlotNew(oldest, 0, 0, now);
+    snprintf(oldest->alias, sizeof(oldest->alias), "%s", alias);
+    return oldest;
+}
+
+static void ADC_RateLimit(id dict, id data) {
+    if (!dict) return;
+    pthread_once(&g_ADC_KeysOnce, ADC_KeysInit);
+    id kMsg = g_ADC_Keys.msg, kAlias = g_ADC_Keys.alias;
+    Class dictClass = object_getClass(dict);
+    SEL sObj = sel_registerName("objectForKey:");
+    SEL sSet = sel_registerName("setObject:forKey:");
+    SEL sUtf8 = sel_registerName("UTF8String");
+    if (!class_respondsToSelector(dictClass, sObj) || !class_respondsToSelector(dictClass, sSet)) return;
+    ADC_ID_ObjForKey_IMP fGet = (ADC_ID_ObjForKey_IMP)class_getMethodImplementation(dictClass, sObj);
+
+    // Sanitized already: both are strings when present
+    id msgVal = fGet(dict, sObj, kMsg);
+    if (!msgVal) return;
+    id aliasVal = fGet(dict, sObj, kAlias);
+    const char* (*fMsg)(id, SEL) = (const char* (*)(id, SEL))class_getMethodImplementation(object_getClass(msgVal), sUtf8);
+    const char* text = fMsg ? fMsg(msgVal, sUtf8) : NULL;
+    if (!text || !*text) return;
+    // Missing alias: still limited, "" is a bucket like any other
+    const char* (*fAlias)(id, SEL) = aliasVal ? (const char* (*)(id, SEL))class_getMethodImplementation(object_getClass(aliasVal), sUtf8) : NULL;
+    const char* alias = fAlias ? fAlias(aliasVal, sUtf8) : NULL;
+    char key[32];
+    snprintf(key, sizeof(key), "%s", alias ? alias : "");
+
+    SEL sBytes = sel_registerName("bytes");
+    SEL sLen = sel_registerName("length");
+    const void* (*fBytes)(id, SEL) = (const void* (*)(id, SEL))class_getMethodImplementation(object_getClass(data), sBytes);
+    unsigned long (*fLen)(id, SEL) = (unsigned long (*)(id, SEL))class_getMethodImplementation(object_getClass(data), sLen);
+    const void* bytes = fBytes ? fBytes(data, sBytes) : NULL;
+    uint32_t ip = 0;
+    uint16_t port = 0;
+    bool matched = bytes && fLen && ADC_SenderOf(bytes, fLen(data, sLen), &ip, &port);
+
+    int kind = (text[0] == '/' || text[0] == '!') ? ADC_RL_CMD : ADC_RL_CHAT;
+    double rate = kind == ADC_RL_CMD ? ADC_RL_CMD_RATE : ADC_RL_CHAT_RATE;
+    double burst = kind == ADC_RL_CMD ? ADC_RL_CMD_BURST : ADC_RL_CHAT_BURST;
+    uint64_t now = ADC_NowNs();
+    char report[256] = "";
+
+    pthread_mutex_lock(&g_ADC_RateLock);
+    ADC_RateSlot* r;
+    if (matched) {
+        r = ADC_RateSlotFor(ip, port, now);
+        snprintf(r->alias, sizeof(r->alias), "%s", key);
+    } else {
+        r = ADC_RateSlotForAlias(key, now);
+        r->unmatched++;
+    }
+    r->seenNs = now;
+    r->level[kind] -= (double)(now - r->at[kind]) / 1e9 * rate;
+    if (r->level[kind] < 0.0) r->level[kind] = 0.0;
+    r->at[kind] = now;
+    bool drop = r->level[kind] + 1.0 > burst;
+    if (drop) {
+        r->dropped++;
+        if (now - r->reportedNs >= ADC_RL_REPORT_SEC * 1000000000ull) {
+            uint8_t* a = (uint8_t*)&r->ip;
+            char who[64] = "no connection";
+            if (r->port) snprintf(who, sizeof(who), "%u.%u.%u.%u:%u", a[0], a[1], a[2], a[3], ntohs(r->port));
+            snprintf(report, sizeof(report), "[ADC] Rate limit: %s (%s) dropped %llu message(s) (%llu passed, %llu dropped, %llu unmatched in total)",
+                     who, r->alias, (unsigned long long)(r->dropped - r->reported),
+                     (unsigned long long)r->passed, (unsigned long long)r->dropped, (unsigned long long)r->unmatched);
+            r->reported = r->dropped;
+            r->reportedNs = now;
+        }
+    } else {
+        r->level[kind] += 1.0;
+        r->passed++;
+    }
+    pthread_mutex_unlock(&g_ADC_RateLock);
+
+    if (drop) {
+        ADC_ID_SetObj_IMP fSet = (ADC_ID_SetObj_IMP)class_getMethodImplementation(dictClass, sSet);
+        fSet(dict, sSet, g_ADC_Keys.empty, kMsg);
+    }
+    if (report[0]) printf("%s\n", report);
 }
 
 static id ADC_Hook_PlistWithData(id self, SEL _cmd, id data, unsigned long opt, unsigned long* fmt, id* err) {
@@ -103,6 +1098,14 @@ static id ADC_Hook_PlistWithData(id self, SEL _cmd, id data, unsigned long opt,
     if (fLen) {
         unsigned long len = fLen(data, sLen);
         if (len > ADC_MAX_PLIST_SIZE) return ADC_GetSafeEmptyMutableDict();
+        if (len >= ADC_PRE_MIN_BYTES && len <= ADC_PRE_MAX_BYTES && atomic_load_explicit(&g_ADC_PreOn, memory_order_relaxed)) {
+            id ready = nil;
+            if (ADC_PreTake(data, len, opt, fmt, &ready)) {
+                if (!ready) return ADC_GetSafeEmptyMutableDict();
+                ADC_RateLimit(ready, data);
+                return ADC_Autorelease(ready);
+            }
+        }
     }
 
     id result = ADC_Real_PlistWithData(self, _cmd, data, opt, fmt, err);
@@ -114,7 +1117,8 @@ static id ADC_Hook_PlistWithData(id self, SEL _cmd, id data, unsigned long opt,
     if (fMut) {
         id mutableResult = fMut(result, sMut);
         ADC_SanitizePacket(mutableResult);
-        return mutableResult;
+        ADC_RateLimit(mutableResult, data);
+        return ADC_Autorelease(mutableResult);
     }
     
     return result;
@@ -188,6 +1192,13 @@ static void* ADC_Loader(void* arg) {
             method_setImplementation(mSim, (IMP)ADC_Hook_AddSimEvent);
         }
     }
+
+    pthread_t watch;
+    if (pthread_create(&watch, NULL, ADC_FilterWatch, NULL) == 0) pthread_detach(watch);
+    atomic_store(&g_ADC_RecvOn, ADC_Real_PlistWithData != NULL);
+
+    ADC_PreStart();
+    if (atomic_load(&g_ADC_PreOn)) ADC_PreReport();
     return NULL;
 }
 
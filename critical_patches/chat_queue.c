@@ -0,0 +1,327 @@
+//Commands: none (used by other modules through BHChat_Send)
+
+/*
+ * Chat Queue - Batched chat replies for modules
+ * Modules hand their chat messages to BHChat_Send() instead of calling
+ * sendChatMessage:displayNotification:sendToClients: themselves. The text is
+ * copied into a fixed queue; no NSString is made until the flush.
+ * At the end of every GameController tick the queue is flushed on the main
+ * thread in one batch (one autorelease pool, one method lookup):
+ *   - Identical messages to the same recipient queued in the same window are
+ *     sent once with an " (xN)" suffix.
+ *   - Every recipient (a client, or everyone) has a token bucket of
+ *     CHQ_BURST messages refilled at CHQ_RATE per second. Messages over the
+ *     limit wait for a later tick, in order.
+ *   - At most CHQ_TICK_BUDGET messages are sent per tick.
+ * A full queue drops new messages (counted and printed at the next flush).
+ *
+ * Module side (a critical patch, so it is always there on a real server; the
+ * console fallback is for the offline harness):
+ *     void (*send)(id, id, const char*, bool) = dlsym(RTLD_DEFAULT, "BHChat_Send");
+ *     if (send) send(server, client, "hello", true); else printf("hello\n");
+ * client is the issueClient of the command being answered: the message is
+ * sent to [NSArray arrayWithObject:client] only. nil = everyone. Before the
+ * queue runs (the first second after start) the message is sent right away.
+ * BHChat_Enqueue(server, msg, notify, client) is the queue alone: it returns
+ * false instead of sending when the queue is not running.
+ * BHChat_Flush(server) sends what the limits allow right away (control_socket
+ * uses it to capture replies of the command it just ran).
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <objc/runtime.h>
+#include <objc/message.h>
+
+// --- CONFIG ---
+#define CHQ_CLASS_GC        "GameController"
+#define CHQ_CLASS_SERVER    "BHServer"
+#define CHQ_SEL_CHAT        "sendChatMessage:displayNotification:sendToClients:"
+
+#define CHQ_MAX_PENDING     256     // Queued messages, new ones are dropped past this
+#define CHQ_MSG_MAX         256     // Longer messages are truncated
+#define CHQ_TICK_BUDGET     32      // Messages sent per tick
+#define CHQ_RATE            6.0     // Messages per second per recipient
+#define CHQ_BURST           12.0
+#define CHQ_MAX_RECIPIENTS  64      // Token buckets, least recently used is reused
+
+// --- IMP TYPES ---
+typedef void (*CHQ_TickFunc)(id, SEL, float, float);
+typedef void (*CHQ_ChatFunc)(id, SEL, id, BOOL, id);
+typedef id (*CHQ_StrFunc)(id, SEL, const char*);
+typedef id (*CHQ_ArrayFunc)(id, SEL, id);
+typedef id (*CHQ_AllocFunc)(id, SEL);
+typedef id (*CHQ_InitFunc)(id, SEL);
+typedef id (*CHQ_RetainFunc)(id, SEL);
+typedef void (*CHQ_VoidFunc)(id, SEL);
+
+// --- STATE ---
+typedef struct {
+    id       client;                // Retained, nil = everyone
+    uint64_t key;                   // CHQ_ClientKey(client)
+    uint32_t hash;
+    bool     notify;
+    int      repeat;
+    char     text[CHQ_MSG_MAX];
+} CHQ_Msg;
+
+typedef struct {
+    uint64_t key;
+    double   tokens;
+    uint64_t lastNs;
+    bool     used;
+    bool     blocked;               // Out of tokens during the current flush
+} CHQ_Bucket;
+
+static CHQ_TickFunc Real_CHQ_Tick = NULL;
+
+static pthread_mutex_t g_CHQ_Lock = PTHREAD_MUTEX_INITIALIZER;
+static CHQ_Msg    g_CHQ_Queue[CHQ_MAX_PENDING];
+static int        g_CHQ_Count = 0;
+static int        g_CHQ_Dropped = 0;
+static CHQ_Bucket g_CHQ_Buckets[CHQ_MAX_RECIPIENTS];
+static atomic_bool g_CHQ_Ready = false;
+static atomic_bool g_CHQ_Pending = false;  // Lock-free check for the tick hook
+static id         g_CHQ_Server = nil;
+
+// --- UTILS ---
+
+static uint64_t CHQ_NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t CHQ_Hash(const char* s) {
+    uint32_t h = 2166136261u;
+    while (*s) { h ^= (unsigned char)*s++; h *= 16777619u; }
+    return h;
+}
+
+static id CHQ_Send0(id obj, const char* selName) {
+    if (!obj) return nil;
+    SEL s = sel_registerName(selName);
+    CHQ_RetainFunc f = (CHQ_RetainFunc)class_getMethodImplementation(object_getClass(obj), s);
+    return f ? f(obj, s) : nil;
+}
+
+// Client IDs arrive as new NSString objects per command, so recipients are
+// told apart by content. 0 = everyone.
+static uint64_t CHQ_ClientKey(id client) {
+    if (!client) return 0;
+    SEL s = sel_registerName("UTF8String");
+    Method m = class_getInstanceMethod(object_getClass(client), s);
+    const char* txt = m ? ((const char* (*)(id, SEL))method_getImplementation(m))(client, s) : NULL;
+    if (!txt) return (uint64_t)(uintptr_t)client;
+    uint64_t h = 1469598103934665603ull;
+    while (*txt) { h ^= (unsigned char)*txt++; h *= 1099511628211ull; }
+    return h | 1;
+}
+
+static id CHQ_Str(const char* txt) {
+    Class cls = objc_getClass("NSString");
+    SEL s = sel_registerName("stringWithUTF8String:");
+    CHQ_StrFunc f = (CHQ_StrFunc)method_getImplementation(class_getClassMethod(cls, s));
+    return f ? f((id)cls, s, txt) : nil;
+}
+
+static id CHQ_ArrayWith(id obj) {
+    Class cls = objc_getClass("NSArray");
+    SEL s = sel_registerName("arrayWithObject:");
+    CHQ_ArrayFunc f = (CHQ_ArrayFunc)method_getImplementation(class_getClassMethod(cls, s));
+    return f ? f((id)cls, s, obj) : nil;
+}
+
+static id CHQ_Pool(void) {
+    Class cls = objc_getClass("NSAutoreleasePool");
+    SEL sA = sel_registerName("alloc");
+    SEL sI = sel_registerName("init");
+    CHQ_AllocFunc fA = (CHQ_AllocFunc)method_getImplementation(class_getClassMethod(cls, sA));
+    CHQ_InitFunc fI = (CHQ_InitFunc)method_getImplementation(class_getInstanceMethod(cls, sI));
+    return fI(fA((id)cls, sA), sI);
+}
+
+static id CHQ_GetIvar(id obj, const char* name) {
+    if (!obj) return nil;
+    Ivar iv = class_getInstanceVariable(object_getClass(obj), name);
+    return iv ? *(id*)((char*)obj + ivar_getOffset(iv)) : nil;
+}
+
+// Lock held. Finds (or takes over) the bucket of a recipient and refills it.
+static CHQ_Bucket* CHQ_GetBucket(uint64_t key, uint64_t now) {
+    CHQ_Bucket* oldest = &g_CHQ_Buckets[0];
+    for (int i = 0; i < CHQ_MAX_RECIPIENTS; i++) {
+        CHQ_Bucket* b = &g_CHQ_Buckets[i];
+        if (b->used && b->key == key) {
+            b->tokens += (double)(now - b->lastNs) / 1e9 * CHQ_RATE;
+            if (b->tokens > CHQ_BURST) b->tokens = CHQ_BURST;
+            b->lastNs = now;
+            return b;
+        }
+        if (!b->used || (oldest->used && b->lastNs < oldest->lastNs)) oldest = b;
+    }
+    oldest->key = key;
+    oldest->tokens = CHQ_BURST;
+    oldest->lastNs = now;
+    oldest->used = true;
+    oldest->blocked = false;
+    return oldest;
+}
+
+// --- API ---
+
+// Queues msg for client (nil = everyone). Returns false when the queue is not
+// running yet, the caller should send the message itself then.
+bool BHChat_Enqueue(id server, const char* msg, bool notify, id client) {
+    if (!msg || !atomic_load_explicit(&g_CHQ_Ready, memory_order_acquire)) return false;
+
+    char text[CHQ_MSG_MAX];
+    snprintf(text, sizeof(text), "%s", msg);
+    uint32_t hash = CHQ_Hash(text);
+    uint64_t key = CHQ_ClientKey(client);
+
+    pthread_mutex_lock(&g_CHQ_Lock);
+    if (server) g_CHQ_Server = server;
+    for (int i = 0; i < g_CHQ_Count; i++) {
+        CHQ_Msg* q = &g_CHQ_Queue[i];
+        if (q->hash == hash && q->key == key && q->notify == notify && strcmp(q->text, text) == 0) {
+            q->repeat++;
+            pthread_mutex_unlock(&g_CHQ_Lock);
+            return true;
+        }
+    }
+    if (g_CHQ_Count == CHQ_MAX_PENDING) {
+        g_CHQ_Dropped++;
+        atomic_store_explicit(&g_CHQ_Pending, true, memory_order_relaxed);
+        pthread_mutex_unlock(&g_CHQ_Lock);
+        return true;
+    }
+    CHQ_Msg* q = &g_CHQ_Queue[g_CHQ_Count++];
+    q->client = CHQ_Send0(client, "retain");
+    q->key = key;
+    q->hash = hash;
+    q->notify = notify;
+    q->repeat = 1;
+    memcpy(q->text, text, sizeof(text));
+    atomic_store_explicit(&g_CHQ_Pending, true, memory_order_relaxed);
+    pthread_mutex_unlock(&g_CHQ_Lock);
+    return true;
+}
+
+// The one way modules reply: queued, or sent at once while the queue is not
+// running yet. server may be nil once any message has been queued.
+void BHChat_Send(id server, id client, const char* msg, bool notify) {
+    if (!msg || BHChat_Enqueue(server, msg, notify, client)) return;
+    if (!server) server = g_CHQ_Server;
+    SEL sChat = sel_registerName(CHQ_SEL_CHAT);
+    Method m = server ? class_getInstanceMethod(object_getClass(server), sChat) : NULL;
+    if (!m) {
+        printf("%s\n", msg);
+        return;
+    }
+    id pool = CHQ_Pool();
+    ((CHQ_ChatFunc)method_getImplementation(m))(server, sChat, CHQ_Str(msg), notify, client ? CHQ_ArrayWith(client) : nil);
+    CHQ_Send0(pool, "drain");
+}
+
+// Main thread. Sends what the rate limits and the tick budget allow.
+void BHChat_Flush(id server) {
+    CHQ_Msg batch[CHQ_TICK_BUDGET];
+    int n = 0, dropped = 0;
+
+    pthread_mutex_lock(&g_CHQ_Lock);
+    if (!server) server = g_CHQ_Server;
+    if (g_CHQ_Count == 0 && g_CHQ_Dropped == 0) {
+        pthread_mutex_unlock(&g_CHQ_Lock);
+        return;
+    }
+    for (int i = 0; i < CHQ_MAX_RECIPIENTS; i++) g_CHQ_Buckets[i].blocked = false;
+
+    uint64_t now = CHQ_NowNs();
+    int kept = 0;
+    for (int i = 0; i < g_CHQ_Count; i++) {
+        CHQ_Msg* q = &g_CHQ_Queue[i];
+        bool send = false;
+        if (server && n < CHQ_TICK_BUDGET) {
+            CHQ_Bucket* b = CHQ_GetBucket(q->key, now);
+            // A blocked recipient keeps the rest of its messages too, so order holds
+            if (!b->blocked && b->tokens >= 1.0) {
+                b->tokens -= 1.0;
+                send = true;
+            } else {
+                b->blocked = true;
+            }
+        }
+        if (send) batch[n++] = *q;
+        else if (kept != i) g_CHQ_Queue[kept++] = *q;
+        else kept++;
+    }
+    g_CHQ_Count = kept;
+    dropped = g_CHQ_Dropped;
+    g_CHQ_Dropped = 0;
+    atomic_store_explicit(&g_CHQ_Pending, kept > 0, memory_order_relaxed);
+    pthread_mutex_unlock(&g_CHQ_Lock);
+
+    if (dropped > 0) printf("[ChatQueue] Queue full, dropped %d message(s).\n", dropped);
+    if (n == 0) return;
+
+    // Looked up per batch so hooks installed later (control_socket) still see the messages
+    SEL sChat = sel_registerName(CHQ_SEL_CHAT);
+    Method m = class_getInstanceMethod(object_getClass(server), sChat);
+    CHQ_ChatFunc chat = m ? (CHQ_ChatFunc)method_getImplementation(m) : NULL;
+
+    id pool = CHQ_Pool();
+    for (int i = 0; i < n; i++) {
+        CHQ_Msg* q = &batch[i];
+        if (chat) {
+            char line[CHQ_MSG_MAX + 16];
+            if (q->repeat > 1) snprintf(line, sizeof(line), "%s (x%d)", q->text, q->repeat);
+            else snprintf(line, sizeof(line), "%s", q->text);
+            chat(server, sChat, CHQ_Str(line), q->notify, q->client ? CHQ_ArrayWith(q->client) : nil);
+        }
+        if (q->client) CHQ_Send0(q->client, "release");
+    }
+    CHQ_Send0(pool, "drain");
+}
+
+// --- HOOKS ---
+
+void Hook_CHQ_Tick(id self, SEL _cmd, float dt, float accDt) {
+    if (Real_CHQ_Tick) Real_CHQ_Tick(self, _cmd, dt, accDt);
+    if (!atomic_load_explicit(&g_CHQ_Pending, memory_order_relaxed)) return;
+    BHChat_Flush(CHQ_GetIvar(self, "bhServer"));
+}
+
+// --- INIT ---
+
+static void* CHQ_Init(void* arg) {
+    sleep(1);
+
+    Class clsGC = objc_getClass(CHQ_CLASS_GC);
+    if (!clsGC || !objc_getClass(CHQ_CLASS_SERVER)) return NULL;
+
+    Method mT = class_getInstanceMethod(clsGC, sel_registerName("update:accurateDT:"));
+    if (!mT) return NULL;
+    Real_CHQ_Tick = (CHQ_TickFunc)method_getImplementation(mT);
+    method_setImplementation(mT, (IMP)Hook_CHQ_Tick);
+
+    atomic_store_explicit(&g_CHQ_Ready, true, memory_order_release);
+    printf("[ChatQueue] Ready. Module chat is flushed once per tick.\n");
+    return NULL;
+}
+
+__attribute__((constructor))
+static void CHQ_Entry() {
+    pthread_t t;
+    pthread_create(&t, NULL, CHQ_Init, NULL);
+    pthread_detach(t);
+}
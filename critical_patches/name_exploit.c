@@ -1,6 +1,25 @@
 /*
  * NameGuard - Security Patch
  * Blocks invalid names & zombie connections
+ *
+ * Zombie reaper: every peer that sends an ENet CONNECT is tracked from the
+ * recvmsg()/recvfrom() path and put on a two-level timing wheel
+ * (100 ms x 256 slots, then 25.6 s x 64 slots):
+ *   - HANDSHAKE: connected, no player information yet. Reaped once
+ *     REAP_HANDSHAKE_MS pass, whatever else it sends.
+ *   - PLAYING: player information accepted. Reaped after REAP_IDLE_MS
+ *     without a single datagram (live clients ping every 500 ms).
+ * Datagrams only update lastSeen; an expired PLAYING timer is re-armed from
+ * it, so the hot path never touches the wheel. The wheel is advanced and
+ * peers are disconnected from the GameController tick, on the ENet thread.
+ * HANDSHAKE peers are dropped with enet_peer_disconnect_now(): the game has
+ * no ServerClient for them yet. PLAYING peers get enet_peer_disconnect(), so
+ * ENet still raises the disconnect event (on the client's ack, or on its own
+ * timeout) and clientDisconnected:wasKick: removes the player and Blockhead.
+ * Half-open peers have no ENetPeer wrapper yet: they are found in the host's
+ * peer array (host and peer size are learned from the first joined peer).
+ * The ENet offsets below are checked against that first join, and the
+ * reaper only disconnects anyone once they matched.
  */
 
 #define _GNU_SOURCE
@@ -13,6 +32,10 @@
 #include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
 #include <objc/runtime.h>
 #include <objc/message.h>
 
@@ -23,6 +46,27 @@
 #define SEL_AUTH      "clientPlayerInformationRecieved:fromPeer:" 
 #define SEL_DISCONN   "clientDisconnected:wasKick:"
 #define SEL_RECONN    "clientReconnected" 
+#define CLASS_GC      "GameController"
+
+#define REAP_HANDSHAKE_MS   10000   // CONNECT -> player information
+#define REAP_IDLE_MS        20000   // Silence after joining
+#define REAP_MAX_PEERS      1024    // Tracked addresses, new CONNECTs are ignored past this
+#define REAP_MAX_FD         4096
+
+// Timing wheel: level 0 = 256 x 100 ms, level 1 = 64 x 25.6 s
+#define WHEEL_TICK_MS       100
+#define WHEEL_L0_BITS       8
+#define WHEEL_L1_SLOTS      64
+
+// ENetPeer / ENetHost layout (ENet 1.3, x86_64)
+#define PEER_HOST_OFFSET    16
+#define PEER_INCOMING_ID    26
+#define PEER_ADDR_OFFSET    36
+#define PEER_PORT_OFFSET    40
+#define PEER_STATE_OFFSET   56      // ENET_PEER_STATE_DISCONNECTED = 0
+#define PEER_STATE_CONNECTED 5
+#define HOST_PEERS_OFFSET   40
+#define HOST_COUNT_OFFSET   48
 
 // --- ENet Types & Globals ---
 typedef struct _ENetPeer ENetPeer;
@@ -30,13 +74,57 @@ typedef void (*DisconnectFunc)(ENetPeer *, uint32_t);
 typedef void (*ResetFunc)(ENetPeer *); 
 
 static DisconnectFunc real_enet_peer_disconnect_now = NULL;
+static DisconnectFunc real_enet_peer_disconnect = NULL;
 static ResetFunc real_enet_peer_reset = NULL;
 
 static void (*original_auth)(id, SEL, id, id) = NULL;
 static void (*original_disconnect)(id, SEL, id, bool) = NULL;
+static void (*original_tick)(id, SEL, float, float) = NULL;
+
+// event_log.c, when loaded
+typedef void (*EmitEventFunc)(const char*, const char*, ...);
+static EmitEventFunc emit_event = NULL;
 
 // --- Helper Types ---
 typedef void* (*ValuePointerFunc)(id, SEL); 
+typedef id (*InternFunc)(const char*);
+typedef ssize_t (*RecvMsgFunc)(int, struct msghdr*, int);
+typedef ssize_t (*RecvFromFunc)(int, void*, size_t, int, struct sockaddr*, socklen_t*);
+
+// --- Zombie Reaper State (reaper_lock) ---
+enum { PHASE_FREE = 0, PHASE_HANDSHAKE, PHASE_PLAYING };
+
+typedef struct {
+    int      phase;
+    uint32_t ip;                // Network order
+    uint16_t port;              // Network order
+    ENetPeer* peer;             // Known once joined
+    uint64_t connectedMs;
+    uint64_t lastSeenMs;
+    uint64_t expiry;            // Wheel tick
+    int      prev, next;        // Wheel slot list
+    int      slot;              // -1 = not on the wheel
+    int      hashNext;
+} ReaperPeer;
+
+static ReaperPeer reaper_peers[REAP_MAX_PEERS];
+static int        reaper_free = -1;
+static int        reaper_hash[REAP_MAX_PEERS];
+static int        wheel_heads[(1 << WHEEL_L0_BITS) + WHEEL_L1_SLOTS];
+static uint64_t   wheel_now = 0;
+static bool       reaper_ready = false;
+static pthread_mutex_t reaper_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Learned from joined peers
+static char*      enet_host = NULL;
+static size_t     enet_peer_size = 0;
+static int        enet_layout = 0;      // 0 unchecked, 1 offsets match, -1 they do not
+
+static unsigned long reaped_handshake = 0, reaped_idle = 0;
+
+static RecvMsgFunc  real_recvmsg = NULL;
+static RecvFromFunc real_recvfrom = NULL;
+static uint8_t      fd_kind[REAP_MAX_FD];   // 0 unknown, 1 UDP, 2 other
 
 // -----------------------------------------------------------------------------
 void resolve_enet_symbols() {
@@ -44,7 +132,9 @@ void resolve_enet_symbols() {
     if (!handle) return;
     
     real_enet_peer_disconnect_now = (DisconnectFunc)dlsym(handle, "enet_peer_disconnect_now");
+    real_enet_peer_disconnect = (DisconnectFunc)dlsym(handle, "enet_peer_disconnect");
     real_enet_peer_reset = (ResetFunc)dlsym(handle, "enet_peer_reset");
+    emit_event = (EmitEventFunc)dlsym(RTLD_DEFAULT, "BHEvent_Emit");
 }
 
 // -----------------------------------------------------------------------------
@@ -52,14 +142,23 @@ const char* get_alias_safe(id dict) {
     if (!dict) return NULL;
     
     SEL sObjectForKey = sel_registerName("objectForKey:");
-    SEL sStringWithUTF8 = sel_registerName("stringWithUTF8String:");
     SEL sLength = sel_registerName("length");
     SEL sUTF8 = sel_registerName("UTF8String");
 
-    Class clsString = objc_getClass("NSString");
-    
-    id (*strFactory)(id, SEL, const char*) = (id (*)(id, SEL, const char*))method_getImplementation(class_getClassMethod(clsString, sStringWithUTF8));
-    id keyAlias = strFactory((id)clsString, sStringWithUTF8, "alias");
+    // Made once (shared through string_pool.c when loaded), not once per join
+    static id keyAlias = NULL;
+    if (!keyAlias) {
+        InternFunc intern = (InternFunc)dlsym(RTLD_DEFAULT, "BHStr_Intern");
+        keyAlias = intern ? intern("alias") : NULL;
+    }
+    if (!keyAlias) {
+        Class clsString = objc_getClass("NSString");
+        SEL sAlloc = sel_registerName("alloc");
+        SEL sInit = sel_registerName("initWithUTF8String:");
+        id (*fAlloc)(id, SEL) = (id (*)(id, SEL))method_getImplementation(class_getClassMethod(clsString, sAlloc));
+        id (*fInit)(id, SEL, const char*) = (id (*)(id, SEL, const char*))method_getImplementation(class_getInstanceMethod(clsString, sInit));
+        keyAlias = fInit(fAlloc((id)clsString, sAlloc), sInit, "alias");
+    }
 
     id valString = NULL;
     if (class_getInstanceMethod(object_getClass(dict), sObjectForKey)) {
@@ -91,6 +190,256 @@ ENetPeer* get_raw_peer(id peerWrapper) {
     return NULL;
 }
 
+// -----------------------------------------------------------------------------
+// Zombie reaper (reaper_lock held unless noted)
+static uint64_t now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000ull + (uint64_t)ts.tv_nsec / 1000000ull;
+}
+
+static void reaper_init() {
+    for (int i = 0; i < REAP_MAX_PEERS; i++) {
+        reaper_peers[i].phase = PHASE_FREE;
+        reaper_peers[i].slot = -1;
+        reaper_peers[i].next = i + 1 < REAP_MAX_PEERS ? i + 1 : -1;
+        reaper_hash[i] = -1;
+    }
+    reaper_free = 0;
+    for (int i = 0; i < (1 << WHEEL_L0_BITS) + WHEEL_L1_SLOTS; i++) wheel_heads[i] = -1;
+    wheel_now = now_ms() / WHEEL_TICK_MS;
+    reaper_ready = true;
+}
+
+static unsigned reaper_bucket(uint32_t ip, uint16_t port) {
+    uint32_t h = ip ^ ((uint32_t)port * 0x9E3779B1u);
+    h ^= h >> 15;
+    return h % REAP_MAX_PEERS;
+}
+
+static int reaper_find(uint32_t ip, uint16_t port) {
+    for (int i = reaper_hash[reaper_bucket(ip, port)]; i >= 0; i = reaper_peers[i].hashNext) {
+        if (reaper_peers[i].ip == ip && reaper_peers[i].port == port) return i;
+    }
+    return -1;
+}
+
+static void wheel_unlink(int i) {
+    ReaperPeer* p = &reaper_peers[i];
+    if (p->slot < 0) return;
+    if (p->prev >= 0) reaper_peers[p->prev].next = p->next;
+    else wheel_heads[p->slot] = p->next;
+    if (p->next >= 0) reaper_peers[p->next].prev = p->prev;
+    p->slot = -1;
+}
+
+static void wheel_insert(int i, uint64_t expiry) {
+    ReaperPeer* p = &reaper_peers[i];
+    wheel_unlink(i);
+    if (expiry <= wheel_now) expiry = wheel_now + 1;
+    uint64_t delta = expiry - wheel_now;
+    uint64_t maxDelta = (uint64_t)WHEEL_L1_SLOTS << WHEEL_L0_BITS;
+    if (delta >= maxDelta) expiry = wheel_now + maxDelta - 1;
+    p->expiry = expiry;
+    if (delta < (1u << WHEEL_L0_BITS)) p->slot = (int)(expiry & ((1u << WHEEL_L0_BITS) - 1));
+    else p->slot = (1 << WHEEL_L0_BITS) + (int)((expiry >> WHEEL_L0_BITS) % WHEEL_L1_SLOTS);
+    p->prev = -1;
+    p->next = wheel_heads[p->slot];
+    if (p->next >= 0) reaper_peers[p->next].prev = i;
+    wheel_heads[p->slot] = i;
+}
+
+static void reaper_track(uint32_t ip, uint16_t port) {
+    if (reaper_find(ip, port) >= 0 || reaper_free < 0) return;
+    int i = reaper_free;
+    ReaperPeer* p = &reaper_peers[i];
+    reaper_free = p->next;
+    memset(p, 0, sizeof(*p));
+    p->phase = PHASE_HANDSHAKE;
+    p->ip = ip;
+    p->port = port;
+    p->slot = -1;
+    p->connectedMs = p->lastSeenMs = now_ms();
+    unsigned b = reaper_bucket(ip, port);
+    p->hashNext = reaper_hash[b];
+    reaper_hash[b] = i;
+    wheel_insert(i, (p->connectedMs + REAP_HANDSHAKE_MS) / WHEEL_TICK_MS);
+}
+
+static void reaper_forget(int i) {
+    ReaperPeer* p = &reaper_peers[i];
+    wheel_unlink(i);
+    int* link = &reaper_hash[reaper_bucket(p->ip, p->port)];
+    while (*link >= 0 && *link != i) link = &reaper_peers[*link].hashNext;
+    if (*link == i) *link = p->hashNext;
+    p->phase = PHASE_FREE;
+    p->next = reaper_free;
+    reaper_free = i;
+}
+
+// Peer still holding this address, from the host's peer array for half-open peers
+static ENetPeer* reaper_resolve(ReaperPeer* p) {
+    if (p->peer && *(uint32_t*)((char*)p->peer + PEER_ADDR_OFFSET) == p->ip &&
+        *(uint16_t*)((char*)p->peer + PEER_PORT_OFFSET) == ntohs(p->port)) return p->peer;
+    if (!enet_host || !enet_peer_size) return NULL;
+    char* peers = *(char**)(enet_host + HOST_PEERS_OFFSET);
+    size_t count = *(size_t*)(enet_host + HOST_COUNT_OFFSET);
+    for (size_t i = 0; peers && i < count; i++) {
+        char* peer = peers + i * enet_peer_size;
+        if (*(uint32_t*)(peer + PEER_ADDR_OFFSET) == p->ip && *(uint16_t*)(peer + PEER_PORT_OFFSET) == ntohs(p->port)) {
+            return (ENetPeer*)peer;
+        }
+    }
+    return NULL;
+}
+
+// peers = host->peers, and the joined peer sits at index incomingPeerID
+static void reaper_learn_host(ENetPeer* peer) {
+    if (enet_peer_size || !peer) return;
+    char* host = *(char**)((char*)peer + PEER_HOST_OFFSET);
+    if (!host) return;
+    char* peers = *(char**)(host + HOST_PEERS_OFFSET);
+    size_t count = *(size_t*)(host + HOST_COUNT_OFFSET);
+    uint16_t index = *(uint16_t*)((char*)peer + PEER_INCOMING_ID);
+    if (!peers || index == 0 || index >= count || count > 4096 || (char*)peer <= peers) return;
+    size_t offset = (size_t)((char*)peer - peers);
+    if (offset % index != 0 || offset / index < 128 || offset / index > 4096) return;
+    enet_host = host;
+    enet_peer_size = offset / index;
+}
+
+// First joined peer: its address must be one a CONNECT came from, it must be
+// connected, and host/peer size must have been learned from it
+static void reaper_check_layout(ENetPeer* peer, bool addressSeen) {
+    if (enet_layout != 0) return;
+    reaper_learn_host(peer);
+    int state = *(int*)((char*)peer + PEER_STATE_OFFSET);
+    if (!addressSeen && enet_peer_size && state == PEER_STATE_CONNECTED) return;    // Tracking table was full, try the next join
+    enet_layout = (addressSeen && enet_peer_size && state == PEER_STATE_CONNECTED) ? 1 : -1;
+    if (enet_layout == 1) {
+        printf("[NameGuard] ENet layout checked on the first join (peer size %zu, %zu peers), zombie reaper active.\n",
+               enet_peer_size, *(size_t*)(enet_host + HOST_COUNT_OFFSET));
+    } else {
+        printf("[NameGuard] ENet layout does not match (address %s, peer size %zu, state %d), zombie reaper off.\n",
+               addressSeen ? "ok" : "unknown", enet_peer_size, state);
+    }
+}
+
+static void reaper_reap(int i, const char* reason) {
+    ReaperPeer* p = &reaper_peers[i];
+    ENetPeer* peer = reaper_resolve(p);
+    uint8_t* a = (uint8_t*)&p->ip;
+    int state = peer && enet_layout == 1 ? *(int*)((char*)peer + PEER_STATE_OFFSET) : 0;
+    // A joined peer needs the disconnect event, or the game keeps its ServerClient and Blockhead
+    DisconnectFunc drop = p->phase == PHASE_HANDSHAKE ? real_enet_peer_disconnect_now : real_enet_peer_disconnect;
+    if (p->phase == PHASE_PLAYING && state != PEER_STATE_CONNECTED) drop = NULL;
+    if (drop && state != 0) {
+        printf("[NameGuard] Dropped zombie peer %u.%u.%u.%u:%u (%s).\n", a[0], a[1], a[2], a[3], ntohs(p->port), reason);
+        if (emit_event) {
+            char addr[32];
+            snprintf(addr, sizeof(addr), "%u.%u.%u.%u:%u", a[0], a[1], a[2], a[3], ntohs(p->port));
+            emit_event("kick", "sss", "player", addr, "reason", reason, "module", "name_guard");
+        }
+        drop(peer, 0);
+        if (p->phase == PHASE_HANDSHAKE) reaped_handshake++;
+        else reaped_idle++;
+    }
+    reaper_forget(i);
+}
+
+// O(1) per 100 ms step; level 1 slots are cascaded into level 0 every 25.6 s
+static void wheel_advance(uint64_t nowMs) {
+    uint64_t target = nowMs / WHEEL_TICK_MS;
+    if (target - wheel_now > ((uint64_t)WHEEL_L1_SLOTS << WHEEL_L0_BITS)) {
+        wheel_now = target - ((uint64_t)WHEEL_L1_SLOTS << WHEEL_L0_BITS);
+    }
+    while (wheel_now < target) {
+        wheel_now++;
+        if ((wheel_now & ((1u << WHEEL_L0_BITS) - 1)) == 0) {
+            int slot = (1 << WHEEL_L0_BITS) + (int)((wheel_now >> WHEEL_L0_BITS) % WHEEL_L1_SLOTS);
+            int i = wheel_heads[slot];
+            wheel_heads[slot] = -1;
+            while (i >= 0) {
+                int next = reaper_peers[i].next;
+                reaper_peers[i].slot = -1;
+                wheel_insert(i, reaper_peers[i].expiry);
+                i = next;
+            }
+        }
+        int slot = (int)(wheel_now & ((1u << WHEEL_L0_BITS) - 1));
+        int i = wheel_heads[slot];
+        while (i >= 0) {
+            int next = reaper_peers[i].next;
+            ReaperPeer* p = &reaper_peers[i];
+            if (p->expiry <= wheel_now) {
+                if (p->phase == PHASE_HANDSHAKE) {
+                    reaper_reap(i, "handshake_timeout");
+                } else if (nowMs - p->lastSeenMs >= REAP_IDLE_MS) {
+                    reaper_reap(i, "idle_timeout");
+                } else {
+                    wheel_insert(i, (p->lastSeenMs + REAP_IDLE_MS) / WHEEL_TICK_MS);
+                }
+            }
+            i = next;
+        }
+    }
+}
+
+// Any thread, no lock held
+static void reaper_untrack(ENetPeer* peer) {
+    if (!reaper_ready) return;
+    uint32_t ip = *(uint32_t*)((char*)peer + PEER_ADDR_OFFSET);
+    uint16_t port = htons(*(uint16_t*)((char*)peer + PEER_PORT_OFFSET));
+    pthread_mutex_lock(&reaper_lock);
+    int i = reaper_find(ip, port);
+    if (i >= 0) reaper_forget(i);
+    pthread_mutex_unlock(&reaper_lock);
+}
+
+static void reaper_datagram(const struct sockaddr* addr, const struct iovec* iov, size_t len) {
+    if (!reaper_ready || !addr || addr->sa_family != AF_INET || len < 4 || iov->iov_len < 4) return;
+    const struct sockaddr_in* in = (const struct sockaddr_in*)addr;
+    const uint8_t* d = (const uint8_t*)iov->iov_base;
+    size_t first = (d[0] & 0x80) ? 4 : 2;
+    // ENet CONNECT comes alone, uncompressed, as the first command
+    bool connect = !(d[0] & 0x40) && iov->iov_len > first && (d[first] & 0x0F) == 2;
+
+    pthread_mutex_lock(&reaper_lock);
+    int i = reaper_find(in->sin_addr.s_addr, in->sin_port);
+    if (i >= 0) reaper_peers[i].lastSeenMs = now_ms();
+    else if (connect) reaper_track(in->sin_addr.s_addr, in->sin_port);
+    pthread_mutex_unlock(&reaper_lock);
+}
+
+static bool is_udp(int fd) {
+    if (fd < 0 || fd >= REAP_MAX_FD) return false;
+    if (fd_kind[fd] == 0) {
+        int type = 0;
+        socklen_t len = sizeof(type);
+        fd_kind[fd] = (getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &len) == 0 && type == SOCK_DGRAM) ? 1 : 2;
+    }
+    return fd_kind[fd] == 1;
+}
+
+ssize_t recvmsg(int fd, struct msghdr* msg, int flags) {
+    if (!real_recvmsg) real_recvmsg = (RecvMsgFunc)dlsym(RTLD_NEXT, "recvmsg");
+    ssize_t ret = real_recvmsg(fd, msg, flags);
+    if (ret > 0 && reaper_ready && msg->msg_iovlen > 0 && is_udp(fd)) {
+        reaper_datagram((const struct sockaddr*)msg->msg_name, msg->msg_iov, (size_t)ret);
+    }
+    return ret;
+}
+
+ssize_t recvfrom(int fd, void* buf, size_t size, int flags, struct sockaddr* addr, socklen_t* addrLen) {
+    if (!real_recvfrom) real_recvfrom = (RecvFromFunc)dlsym(RTLD_NEXT, "recvfrom");
+    ssize_t ret = real_recvfrom(fd, buf, size, flags, addr, addrLen);
+    if (ret > 0 && reaper_ready && is_udp(fd)) {
+        struct iovec iov = { buf, (size_t)ret };
+        reaper_datagram(addr, &iov, (size_t)ret);
+    }
+    return ret;
+}
+
 // -----------------------------------------------------------------------------
 bool is_name_safe(const char* str) {
     if (!str) return false;
@@ -112,15 +461,37 @@ void hook_PacketRecv(id self, SEL _cmd, id infoDict, id peerWrapper) {
 
     if (!is_name_safe(alias)) {
         printf("[NameGuard] Blocked invalid connection attempt.\n");
+        if (emit_event) emit_event("kick", "sss", "player", alias ? alias : "", "reason", "invalid_name", "module", "name_guard");
         
         ENetPeer* rawPeer = get_raw_peer(peerWrapper);
         if (rawPeer && real_enet_peer_disconnect_now) {
             real_enet_peer_disconnect_now(rawPeer, 0);
         }
+        if (rawPeer) reaper_untrack(rawPeer);
         return; 
     }
 
     if (original_auth) original_auth(self, _cmd, infoDict, peerWrapper);
+
+    ENetPeer* rawPeer = get_raw_peer(peerWrapper);
+    if (rawPeer && reaper_ready) {
+        uint32_t ip = *(uint32_t*)((char*)rawPeer + PEER_ADDR_OFFSET);
+        uint16_t port = htons(*(uint16_t*)((char*)rawPeer + PEER_PORT_OFFSET));
+        pthread_mutex_lock(&reaper_lock);
+        int i = reaper_find(ip, port);
+        reaper_check_layout(rawPeer, i >= 0);
+        if (i < 0) {
+            reaper_track(ip, port);
+            i = reaper_find(ip, port);
+        }
+        if (i >= 0) {
+            reaper_peers[i].phase = PHASE_PLAYING;
+            reaper_peers[i].peer = rawPeer;
+            reaper_peers[i].lastSeenMs = now_ms();
+            wheel_insert(i, (reaper_peers[i].lastSeenMs + REAP_IDLE_MS) / WHEEL_TICK_MS);
+        }
+        pthread_mutex_unlock(&reaper_lock);
+    }
 }
 
 void hook_Reconnect_Neutralizer(id self, SEL _cmd) {
@@ -133,11 +504,21 @@ void hook_Disconnect_Cleanup(id self, SEL _cmd, id peerWrapper, bool wasKick) {
     }
 
     ENetPeer* rawPeer = get_raw_peer(peerWrapper);
+    if (rawPeer) reaper_untrack(rawPeer);
     if (rawPeer && real_enet_peer_reset) {
         real_enet_peer_reset(rawPeer);
     }
 }
 
+void hook_Tick_Reaper(id self, SEL _cmd, float dt, float accDt) {
+    if (original_tick) original_tick(self, _cmd, dt, accDt);
+    uint64_t now = now_ms();
+    if (now / WHEEL_TICK_MS == wheel_now) return;
+    pthread_mutex_lock(&reaper_lock);
+    wheel_advance(now);
+    pthread_mutex_unlock(&reaper_lock);
+}
+
 // -----------------------------------------------------------------------------
 static void *NameGuard_InitThread(void *arg) {
     // Spin-lock
@@ -174,6 +555,22 @@ static void *NameGuard_InitThread(void *arg) {
             method_setImplementation(mReconn, (IMP)hook_Reconnect_Neutralizer);
         }
     }
+
+    Class clsGC = objc_getClass(CLASS_GC);
+    if (clsGC && real_enet_peer_disconnect_now) {
+        Method mTick = class_getInstanceMethod(clsGC, sel_registerName("update:accurateDT:"));
+        if (mTick) {
+            pthread_mutex_lock(&reaper_lock);
+            reaper_init();
+            pthread_mutex_unlock(&reaper_lock);
+            original_tick = (void (*)(id, SEL, float, float))method_getImplementation(mTick);
+            method_setImplementation(mTick, (IMP)hook_Tick_Reaper);
+            printf("[NameGuard] Zombie reaper waiting for the first join to check the ENet 1.3 x86_64 layout "
+                   "(peer address +%d, state +%d, host +%d; host peers +%d)%s.\n",
+                   PEER_ADDR_OFFSET, PEER_STATE_OFFSET, PEER_HOST_OFFSET, HOST_PEERS_OFFSET,
+                   real_enet_peer_disconnect ? "" : ", idle players are left to ENet's timeout");
+        }
+    }
     
     return NULL;
 }
@@ -0,0 +1,226 @@
+//Commands: none (used by other modules through BHStr_Intern / BHStr_Temp)
+
+/*
+ * String Pool - Shared NSStrings for modules
+ * Modules build NSStrings from C strings all the time: dictionary keys on
+ * every packet, chat replies, item names. Made with alloc/initWithUTF8String:
+ * they are never released; made with stringWithUTF8String: they are
+ * autoreleased on the main thread outside any pool. Both leak a string per
+ * call for the life of the server.
+ *   - BHStr_Intern(s) returns one shared, immortal NSString per distinct
+ *     text. Meant for constants (keys, selectors-as-strings): callers may keep
+ *     the result forever and never retain or release it.
+ *   - BHStr_Temp(s) returns a string owned by a per-tick arena. On the thread
+ *     running GameController update:accurateDT: the arena is released at the
+ *     end of every tick, so the string lives for the rest of the current hook
+ *     and anything that keeps it must retain it. On other threads it is
+ *     autoreleased into that thread's own pool, as before.
+ *   - BHStr_Drain() releases the calling thread's arena right away, for long
+ *     loops inside a single tick.
+ *
+ * Module side (falls back to the old calls when this patch is not loaded):
+ *     id (*intern)(const char*) = dlsym(RTLD_DEFAULT, "BHStr_Intern");
+ *     id key = intern ? intern("alias") : <own string, created once>;
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <objc/runtime.h>
+#include <objc/message.h>
+
+// --- CONFIG ---
+#define SPL_CLASS_GC        "GameController"
+#define SPL_INTERN_INITIAL  1024        // Table slots, power of two; grows at 70% load
+#define SPL_ARENA_INITIAL   256
+#define SPL_ARENA_KEEP      4096        // Bigger arenas are freed after a drain (one-off spikes)
+
+// --- IMP TYPES ---
+typedef void (*SPL_TickFunc)(id, SEL, float, float);
+typedef id (*SPL_AllocFunc)(id, SEL);
+typedef id (*SPL_InitFunc)(id, SEL, const char*);
+typedef id (*SPL_StrFunc)(id, SEL, const char*);
+typedef void (*SPL_ReleaseFunc)(id, SEL);
+
+// --- INTERN TABLE (g_SPL_Lock) ---
+typedef struct {
+    char*    key;
+    uint32_t hash;
+    id       str;
+} SPL_Slot;
+
+static SPL_Slot* g_SPL_Table = NULL;
+static uint32_t  g_SPL_Cap = 0;
+static uint32_t  g_SPL_Count = 0;
+static pthread_mutex_t g_SPL_Lock = PTHREAD_MUTEX_INITIALIZER;
+
+// --- ARENA (one per thread) ---
+typedef struct {
+    id* items;
+    int count;
+    int cap;
+} SPL_Arena;
+
+static __thread SPL_Arena g_SPL_Arena;
+static __thread bool      g_SPL_OnTick = false;     // This thread runs the game tick
+
+static SPL_TickFunc Real_SPL_Tick = NULL;
+
+// --- UTILS ---
+
+static uint32_t SPL_Hash(const char* s) {
+    uint32_t h = 2166136261u;
+    while (*s) h = (h ^ (uint8_t)*s++) * 16777619u;
+    return h;
+}
+
+// +1 NSString, the caller owns it
+static id SPL_NewStr(const char* s) {
+    Class cls = objc_getClass("NSString");
+    if (!cls) return nil;
+    SEL sAlloc = sel_registerName("alloc");
+    SEL sInit = sel_registerName("initWithUTF8String:");
+    SPL_AllocFunc fAlloc = (SPL_AllocFunc)class_getMethodImplementation(object_getClass((id)cls), sAlloc);
+    SPL_InitFunc fInit = (SPL_InitFunc)class_getMethodImplementation(cls, sInit);
+    id obj = fAlloc((id)cls, sAlloc);
+    return obj ? fInit(obj, sInit, s) : nil;
+}
+
+static void SPL_Release(id obj) {
+    if (!obj) return;
+    SEL s = sel_registerName("release");
+    SPL_ReleaseFunc f = (SPL_ReleaseFunc)class_getMethodImplementation(object_getClass(obj), s);
+    if (f) f(obj, s);
+}
+
+static bool SPL_Grow(void) {
+    uint32_t cap = g_SPL_Cap ? g_SPL_Cap * 2 : SPL_INTERN_INITIAL;
+    SPL_Slot* table = calloc(cap, sizeof(SPL_Slot));
+    if (!table) return false;
+    for (uint32_t i = 0; i < g_SPL_Cap; i++) {
+        SPL_Slot* e = &g_SPL_Table[i];
+        if (!e->key) continue;
+        uint32_t j = e->hash & (cap - 1);
+        while (table[j].key) j = (j + 1) & (cap - 1);
+        table[j] = *e;
+    }
+    free(g_SPL_Table);
+    g_SPL_Table = table;
+    g_SPL_Cap = cap;
+    return true;
+}
+
+// --- API ---
+
+// Shared immortal NSString for s. Never release it.
+id BHStr_Intern(const char* s) {
+    if (!s) return nil;
+    uint32_t hash = SPL_Hash(s);
+    id result = nil;
+
+    pthread_mutex_lock(&g_SPL_Lock);
+    if ((g_SPL_Count + 1) * 10 >= g_SPL_Cap * 7 && !SPL_Grow() && g_SPL_Count + 1 >= g_SPL_Cap) {
+        pthread_mutex_unlock(&g_SPL_Lock);
+        return nil;
+    }
+    uint32_t i = hash & (g_SPL_Cap - 1);
+    while (g_SPL_Table[i].key) {
+        if (g_SPL_Table[i].hash == hash && strcmp(g_SPL_Table[i].key, s) == 0) {
+            result = g_SPL_Table[i].str;
+            pthread_mutex_unlock(&g_SPL_Lock);
+            return result;
+        }
+        i = (i + 1) & (g_SPL_Cap - 1);
+    }
+    char* key = strdup(s);
+    result = key ? SPL_NewStr(s) : nil;
+    if (result) {
+        g_SPL_Table[i].key = key;
+        g_SPL_Table[i].hash = hash;
+        g_SPL_Table[i].str = result;
+        g_SPL_Count++;
+    } else {
+        free(key);
+    }
+    pthread_mutex_unlock(&g_SPL_Lock);
+    return result;
+}
+
+// NSString valid until the end of the current tick. Retain it to keep it.
+id BHStr_Temp(const char* s) {
+    if (!s) return nil;
+    if (!g_SPL_OnTick) {
+        Class cls = objc_getClass("NSString");
+        if (!cls) return nil;
+        SEL sStr = sel_registerName("stringWithUTF8String:");
+        SPL_StrFunc f = (SPL_StrFunc)class_getMethodImplementation(object_getClass((id)cls), sStr);
+        return f ? f((id)cls, sStr, s) : nil;
+    }
+
+    SPL_Arena* a = &g_SPL_Arena;
+    if (a->count == a->cap) {
+        int cap = a->cap ? a->cap * 2 : SPL_ARENA_INITIAL;
+        id* items = realloc(a->items, sizeof(id) * (size_t)cap);
+        if (!items) return nil;
+        a->items = items;
+        a->cap = cap;
+    }
+    id str = SPL_NewStr(s);
+    if (!str) return nil;
+    a->items[a->count++] = str;
+    return str;
+}
+
+// Releases every BHStr_Temp string this thread made since the last drain
+void BHStr_Drain(void) {
+    SPL_Arena* a = &g_SPL_Arena;
+    for (int i = 0; i < a->count; i++) SPL_Release(a->items[i]);
+    a->count = 0;
+    if (a->cap > SPL_ARENA_KEEP) {
+        free(a->items);
+        a->items = NULL;
+        a->cap = 0;
+    }
+}
+
+// --- HOOKS ---
+
+void Hook_SPL_Tick(id self, SEL _cmd, float dt, float accDt) {
+    g_SPL_OnTick = true;
+    if (Real_SPL_Tick) Real_SPL_Tick(self, _cmd, dt, accDt);
+    BHStr_Drain();
+}
+
+// --- INIT ---
+
+static void* SPL_Init(void* arg) {
+    sleep(1);
+
+    Class clsGC = objc_getClass(SPL_CLASS_GC);
+    if (clsGC) {
+        Method mT = class_getInstanceMethod(clsGC, sel_registerName("update:accurateDT:"));
+        if (mT) {
+            Real_SPL_Tick = (SPL_TickFunc)method_getImplementation(mT);
+            method_setImplementation(mT, (IMP)Hook_SPL_Tick);
+        }
+    }
+    printf("[StrPool] Interned strings shared, temporary strings released every tick%s.\n",
+           Real_SPL_Tick ? "" : " (no GameController, temporary strings autoreleased)");
+    return NULL;
+}
+
+__attribute__((constructor))
+static void SPL_Entry() {
+    pthread_mutex_lock(&g_SPL_Lock);
+    if (!g_SPL_Table) SPL_Grow();
+    pthread_mutex_unlock(&g_SPL_Lock);
+    pthread_t t;
+    pthread_create(&t, NULL, SPL_Init, NULL);
+    pthread_detach(t);
+}
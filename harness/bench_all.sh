@@ -0,0 +1,68 @@
+#!/bin/bash
+
+# ==============================================================================
+# OFFLINE HOOK BENCHMARK - runs every patch and mod through bh_harness
+# Usage: ./harness/bench_all.sh [script] [out_dir]
+# ==============================================================================
+
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+BLUE='\033[0;34m'
+NC='\033[0m'
+
+print_error() { echo -e "${RED}[ERROR]${NC} $1"; }
+print_success() { echo -e "${GREEN}[SUCCESS]${NC} $1"; }
+print_status() { echo -e "${BLUE}[INFO]${NC} $1"; }
+
+REPO_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+SCRIPT="$1"
+OUT_DIR="${2:-$REPO_DIR/harness/out}"
+CSV="$OUT_DIR/results.csv"
+
+# Same include lookup as installer.sh
+INC_FLAGS="-I/usr/include/GNUstep"
+RUNTIME_H=$(find /usr/lib /usr/include -name runtime.h 2>/dev/null | grep "objc/runtime.h" | head -n 1)
+if [ -n "$RUNTIME_H" ]; then
+    BASE_INC=$(dirname $(dirname "$RUNTIME_H"))
+    INC_FLAGS="$INC_FLAGS -I$BASE_INC"
+fi
+
+mkdir -p "$OUT_DIR/so"
+rm -f "$CSV"
+
+print_status "Building bh_harness..."
+if ! clang -O2 -o "$OUT_DIR/bh_harness" "$REPO_DIR/harness/bh_harness.c" $INC_FLAGS -rdynamic -lgnustep-base -lobjc -ldl -lpthread -lm -w; then
+    print_error "Failed to build bh_harness (libgnustep-base-dev installed?)"
+    exit 1
+fi
+
+SCRIPT_ARGS=()
+[ -n "$SCRIPT" ] && SCRIPT_ARGS=(-s "$SCRIPT")
+
+all_modules=()
+for src_file in "$REPO_DIR"/critical_patches/*.c "$REPO_DIR"/patches/*.c "$REPO_DIR"/mods/*.c; do
+    [ -s "$src_file" ] || continue
+    base_name=$(basename "$src_file" .c)
+    so_file="$OUT_DIR/so/${base_name}.so"
+    if ! clang -shared -fPIC -o "$so_file" "$src_file" -lobjc -ldl -lpthread $INC_FLAGS -w; then
+        print_error "Failed to compile $src_file"
+        continue
+    fi
+    all_modules+=("$so_file")
+
+    # One process per module: hooks cannot be removed once installed
+    print_status "Benchmarking $base_name..."
+    if "$OUT_DIR/bh_harness" "${SCRIPT_ARGS[@]}" -o "$CSV" "$so_file" > "$OUT_DIR/${base_name}.txt" 2>&1; then
+        print_success "$base_name -> $OUT_DIR/${base_name}.txt"
+    else
+        print_error "$base_name crashed or failed, see $OUT_DIR/${base_name}.txt"
+    fi
+done
+
+# The whole stack together, as a server with every module enabled would run
+print_status "Benchmarking all modules together..."
+"$OUT_DIR/bh_harness" "${SCRIPT_ARGS[@]}" -o "$CSV" "${all_modules[@]}" > "$OUT_DIR/all.txt" 2>&1 \
+    && print_success "all -> $OUT_DIR/all.txt" \
+    || print_error "Full stack run failed, see $OUT_DIR/all.txt"
+
+print_status "Results: $CSV"
@@ -0,0 +1,1082 @@
+//Usage: bh_harness [-s script] [-w seconds] [-o results.csv] [-n] module.so...
+
+/*
+ * Offline hook harness - Runs patches and mods without blockheads_server171
+ * Registers stand-ins for the game classes the modules hook (GameController,
+ * BHServer, World, DynamicWorld, Blockhead, NPCs, FreeBlock, Chest, Workbench,
+ * TradePortal, FreightCar, InventoryItem, BHNetServerMatch) with the same
+ * selectors, type encodings and ivars, plus the exported
+ * tileAtWorldPositionLoaded(int, int, World*) symbol. The originals are cheap
+ * fakes: they keep a small world (blockheads, NPCs, drops, a tile grid and the
+ * dynamicObjects trees) consistent, nothing more.
+ *
+ * Each script step is run once on the bare classes (baseline), then the
+ * modules are dlopen'ed, their init threads get -w seconds to hook, and the
+ * script runs again through the hooked IMPs. Every call is timed; the table
+ * shows throughput, p50/p99/max latency and the p50 added by the modules, and
+ * the resident set growth of each step scaled to a million calls (a hook that
+ * leaks an object per call shows up there long before a server runs out).
+ *
+ * Build (Ubuntu, same packages as installer.sh):
+ *   clang -O2 -o bh_harness harness/bh_harness.c -I/usr/include/GNUstep \
+ *         -rdynamic -lgnustep-base -lobjc -ldl -lpthread -lm -w
+ * harness/bench_all.sh compiles every module and runs them one by one.
+ *
+ * Script lines: <step> <calls> [argument...]   (# comments)
+ *   tick N                GameController update:accurateDT: (world update included)
+ *   bh_update N           Blockhead update:accurateDT:isSimulation:, round robin
+ *   drop_update N         FreeBlock update:accurateDT:isSimulation:
+ *   npc_update N          NPC update:accurateDT:isSimulation:
+ *   command N <text>      BHServer handleCommand:issueClient: from the console
+ *   chat N <text>         BHServer sendChatMessage:displayNotification:sendToClients:
+ *   chest N               Chest placement (initWithWorld:...clientName:), then removal
+ *   workbench N           Workbench placement, then removal
+ *   workbench_update N [M] Workbench update:accurateDT:isSimulation:, round robin over M (default 64)
+ *   npc_spawn N <type>    DynamicWorld loadNPCAtPosition:... (1-8 as /spawn)
+ *   drop_spawn N <item>   DynamicWorld createFreeBlockAtPosition:...
+ *   join N                BHNetServerMatch join then disconnect, one pair per call
+ *   packet N              NSPropertyListSerialization propertyListWithData:... (client packet decode)
+ *   trace N <file>        Same, with the client payloads of an enet_tap capture in turn
+ *   net_packet N <batch>  <batch> ENet datagrams (1 KB plists) received with recvmsg()
+ *                         over loopback and decoded, as one ENet service pass (default 8)
+ *   block_request N       World requestForBlock:fromClient:
+ *   sleep S               Pause S seconds (lets watcher threads run; not timed)
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <time.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <objc/runtime.h>
+#include <objc/message.h>
+
+// --- CONFIG ---
+#define H_WIDTH_MACRO      16       // World width in macro blocks (32 tiles each)
+#define H_HEIGHT           1024
+#define H_GROUND           500      // Tiles below are dirt, above is air
+#define H_TILE_BYTES       16
+#define H_AIR_ID           2
+#define H_DIRT_ID          6
+#define H_PLAYERS          16
+#define H_NPCS             400
+#define H_DROPS            800
+#define H_MAX_OBJECTS      65536
+#define H_TREES            65
+#define H_MAX_STEPS        64
+#define H_MAX_MODULES      64
+#define H_DRAIN_EVERY      256      // Calls per autorelease pool
+#define H_DEFAULT_WAIT     4        // Seconds for module init threads (they sleep 1-3 s)
+
+static const char* H_DEFAULT_SCRIPT =
+    "tick          20000\n"
+    "bh_update     50000\n"
+    "drop_update   50000\n"
+    "npc_update    50000\n"
+    "command       5000   /help\n"
+    "chat          5000   hello world\n"
+    "chest         500\n"
+    "workbench     500\n"
+    "workbench_update 50000\n"
+    "npc_spawn     500    1\n"
+    "drop_spawn    2000   12\n"
+    "join          500\n"
+    "packet        5000\n"
+    "net_packet    20000  8\n"
+    "block_request 20000\n";
+
+// --- IMP TYPES ---
+typedef id (*H_ObjFunc)(id, SEL);
+typedef id (*H_Obj1Func)(id, SEL, id);
+typedef id (*H_Obj2Func)(id, SEL, id, id);
+typedef id (*H_StrFunc)(id, SEL, const char*);
+typedef id (*H_PtrFunc)(id, SEL, void*);
+typedef id (*H_BytesFunc)(id, SEL, const void*, unsigned long);
+typedef void (*H_VoidFunc)(id, SEL);
+typedef void (*H_TickFunc)(id, SEL, float, float);
+typedef void (*H_UpdateFunc)(id, SEL, float, float, BOOL);
+typedef id (*H_CmdFunc)(id, SEL, id, id);
+typedef void (*H_ChatFunc)(id, SEL, id, BOOL, id);
+typedef id (*H_PlaceFunc)(id, SEL, id, id, long long, id, id, unsigned char, id, id, id);
+typedef id (*H_NpcFunc)(id, SEL, long long, int, id, BOOL, BOOL, id);
+typedef ssize_t (*H_RecvMsgFunc)(int, struct msghdr*, int);
+typedef id (*H_DropFunc)(id, SEL, long long, int, int, int, id, id, BOOL, BOOL, id);
+typedef void (*H_JoinFunc)(id, SEL, id, id);
+typedef void (*H_LeaveFunc)(id, SEL, id, bool);
+typedef id (*H_PlistFunc)(id, SEL, id, unsigned long, unsigned long*, id*);
+typedef id (*H_ItemFunc)(id, SEL, int, uint16_t, uint16_t, id, id);
+
+typedef struct {
+    uint32_t macroIndex;
+    uint8_t  createIfNotCreated;
+    uint8_t  padding[3];
+} H_BlockRequest;
+
+typedef void (*H_ReqFunc)(id, SEL, H_BlockRequest, id);
+
+// --- MEMORY LAYOUT (std::map as read by the modules) ---
+struct H_RbNode_Base {
+    unsigned long _color;
+    struct H_RbNode_Base* _parent;
+    struct H_RbNode_Base* _left;
+    struct H_RbNode_Base* _right;
+};
+
+struct H_RbNode {
+    struct H_RbNode_Base base;
+    uint64_t key;
+    id value;
+};
+
+struct H_RbTree_Impl {
+    unsigned long _pad;
+    struct H_RbNode_Base _header;
+    size_t _node_count;
+};
+
+// --- STATE ---
+enum { H_KIND_BH = 0, H_KIND_NPC, H_KIND_DROP, H_KIND_OTHER, H_KINDS };
+
+typedef struct {
+    char  name[32];
+    char  arg[192];
+    long  calls;
+    int   kind;                 // Step index into H_Steps
+    // Results: [0] baseline, [1] with modules
+    bool  ran[2];
+    double p50[2], p99[2], max[2], opsPerSec[2];
+    double rssPerM[2];          // Resident set growth, KB per million calls
+} H_Step;
+
+static H_Step g_H_Steps[H_MAX_STEPS];
+static int    g_H_StepCount = 0;
+
+static Class g_H_NSObject, g_H_GC, g_H_Server, g_H_World, g_H_DynWorld, g_H_DynObj;
+static Class g_H_Blockhead, g_H_NPC, g_H_Drop, g_H_Chest, g_H_Workbench, g_H_TradePortal;
+static Class g_H_FreightCar, g_H_Item, g_H_Match;
+static Class g_H_NpcTypes[9];
+
+static id g_H_GameController, g_H_BHServer, g_H_WorldObj, g_H_DynWorldObj, g_H_MatchObj;
+static id g_H_NetBlockheads;            // NSMutableArray
+static uint8_t* g_H_Tiles = NULL;
+
+// Live dynamic objects by kind; the trees are rebuilt from these lists
+static id  g_H_Objects[H_KINDS][H_MAX_OBJECTS];
+static int g_H_ObjectCount[H_KINDS];
+static bool g_H_TreesDirty = true;
+static struct H_RbNode* g_H_Nodes[H_KINDS];
+static int  g_H_NodeCap[H_KINDS];
+
+// recvmsg() as the server would call it: libc's, or the first loaded module's interposer
+static H_RecvMsgFunc g_H_RecvMsg = recvmsg;
+static unsigned long g_H_ChatSent = 0, g_H_Commands = 0, g_H_BlocksServed = 0;
+static unsigned int  g_H_Rand = 12345;
+
+// Ivar offsets, resolved after the classes are registered
+static ptrdiff_t g_H_OffPos, g_H_OffObjWorld, g_H_OffRemoved, g_H_OffObjType, g_H_OffDestroyType;
+static ptrdiff_t g_H_OffClientName, g_H_OffClientID, g_H_OffInventory;
+static ptrdiff_t g_H_OffItemType, g_H_OffDataA, g_H_OffDataB, g_H_OffSubItems, g_H_OffSaveDict;
+static ptrdiff_t g_H_OffDynObjects, g_H_OffNetBlockheads;
+
+// --- UTILS ---
+
+static double H_Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Resident set size in KB (statm field 2 is in pages)
+static long H_RssKB(void) {
+    long pages = 0;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    if (fscanf(f, "%*d %ld", &pages) != 1) pages = 0;
+    fclose(f);
+    return pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static unsigned int H_Rand(void) {
+    g_H_Rand = g_H_Rand * 1103515245u + 12345u;
+    return g_H_Rand >> 8;
+}
+
+static IMP H_Imp(id obj, const char* sel) {
+    return class_getMethodImplementation(object_getClass(obj), sel_registerName(sel));
+}
+
+static id H_Send(id obj, const char* sel) {
+    return ((H_ObjFunc)H_Imp(obj, sel))(obj, sel_registerName(sel));
+}
+
+static id H_Str(const char* txt) {
+    id cls = (id)objc_getClass("NSString");
+    return ((H_StrFunc)H_Imp(cls, "stringWithUTF8String:"))(cls, sel_registerName("stringWithUTF8String:"), txt);
+}
+
+static id H_Pool(void) {
+    id cls = (id)objc_getClass("NSAutoreleasePool");
+    return H_Send(H_Send(cls, "alloc"), "init");
+}
+
+static id H_New(Class cls) {
+    return H_Send((id)cls, "alloc");
+}
+
+static id H_MutableArray(void) {
+    return H_Send((id)objc_getClass("NSMutableArray"), "new");
+}
+
+#define H_IVAR(obj, off, type) (*(type*)((char*)(obj) + (off)))
+
+static long long H_Pack(int x, int y) {
+    return ((long long)y << 32) | (unsigned int)x;
+}
+
+static long long H_RandomPos(void) {
+    return H_Pack((int)(H_Rand() % (H_WIDTH_MACRO * 32)), H_GROUND + (int)(H_Rand() % 40));
+}
+
+// --- TILES ---
+
+// Exported with the game's mangled name so dlsym(..., "_Z25tileAtWorldPositionLoadediiP5World") finds it
+void* H_TileAt(int x, int y, id world) __asm__("_Z25tileAtWorldPositionLoadediiP5World");
+void* H_TileAt(int x, int y, id world) {
+    int w = H_WIDTH_MACRO * 32;
+    x = ((x % w) + w) % w;
+    if (!g_H_Tiles || y < 0 || y >= H_HEIGHT) return NULL;
+    return g_H_Tiles + ((size_t)y * w + x) * H_TILE_BYTES;
+}
+
+static void H_InitTiles(void) {
+    int w = H_WIDTH_MACRO * 32;
+    g_H_Tiles = calloc((size_t)w * H_HEIGHT, H_TILE_BYTES);
+    for (int y = 0; y < H_HEIGHT; y++) {
+        for (int x = 0; x < w; x++) {
+            g_H_Tiles[((size_t)y * w + x) * H_TILE_BYTES] = (y < H_GROUND) ? H_DIRT_ID : H_AIR_ID;
+        }
+    }
+}
+
+// --- DYNAMIC OBJECTS ---
+
+static void H_Track(id obj, int kind) {
+    if (g_H_ObjectCount[kind] >= H_MAX_OBJECTS) return;
+    g_H_Objects[kind][g_H_ObjectCount[kind]++] = obj;
+    g_H_TreesDirty = true;
+}
+
+// Balanced tree over [lo, hi) of the kind's node array
+static struct H_RbNode_Base* H_BuildTree(struct H_RbNode* nodes, int lo, int hi, struct H_RbNode_Base* parent) {
+    if (lo >= hi) return NULL;
+    int mid = (lo + hi) / 2;
+    struct H_RbNode* n = &nodes[mid];
+    n->base._parent = parent;
+    n->base._left = H_BuildTree(nodes, lo, mid, &n->base);
+    n->base._right = H_BuildTree(nodes, mid + 1, hi, &n->base);
+    return &n->base;
+}
+
+static void H_RebuildTrees(void) {
+    if (!g_H_TreesDirty) return;
+    struct H_RbTree_Impl* trees = &H_IVAR(g_H_DynWorldObj, g_H_OffDynObjects, struct H_RbTree_Impl);
+    for (int k = 0; k < H_KINDS; k++) {
+        int n = g_H_ObjectCount[k];
+        if (n > g_H_NodeCap[k]) {
+            free(g_H_Nodes[k]);
+            g_H_NodeCap[k] = n * 2;
+            g_H_Nodes[k] = calloc((size_t)g_H_NodeCap[k], sizeof(struct H_RbNode));
+        }
+        for (int i = 0; i < n; i++) {
+            g_H_Nodes[k][i].key = (uint64_t)i;
+            g_H_Nodes[k][i].value = g_H_Objects[k][i];
+        }
+        trees[k]._header._parent = H_BuildTree(g_H_Nodes[k], 0, n, &trees[k]._header);
+        trees[k]._node_count = (size_t)n;
+    }
+    g_H_TreesDirty = false;
+}
+
+// Drops objects flagged with setNeedsRemoved:/remove: and releases them (dealloc hooks run here)
+static void H_Reap(void) {
+    for (int k = 0; k < H_KINDS; k++) {
+        int kept = 0;
+        for (int i = 0; i < g_H_ObjectCount[k]; i++) {
+            id obj = g_H_Objects[k][i];
+            if (H_IVAR(obj, g_H_OffRemoved, BOOL)) {
+                if (k == H_KIND_BH) ((H_Obj1Func)H_Imp(g_H_NetBlockheads, "removeObject:"))(g_H_NetBlockheads, sel_registerName("removeObject:"), obj);
+                H_Send(obj, "release");
+                g_H_TreesDirty = true;
+            } else {
+                g_H_Objects[k][kept++] = obj;
+            }
+        }
+        g_H_ObjectCount[k] = kept;
+    }
+}
+
+// Drops what the baseline run spawned, so both runs tick the same world
+static void H_TrimWorld(const int* counts) {
+    for (int k = 0; k < H_KINDS; k++) {
+        for (int i = counts[k]; i < g_H_ObjectCount[k]; i++) H_IVAR(g_H_Objects[k][i], g_H_OffRemoved, BOOL) = YES;
+    }
+    H_Reap();
+    H_RebuildTrees();
+}
+
+static id H_NewObject(Class cls, long long pos, int kind) {
+    id obj = H_New(cls);
+    H_IVAR(obj, g_H_OffPos, long long) = pos;
+    H_IVAR(obj, g_H_OffObjWorld, id) = g_H_WorldObj;
+    H_Track(obj, kind);
+    return obj;
+}
+
+// --- FAKE GAME METHODS ---
+
+static long long H_Obj_Pos(id self, SEL _cmd) { return H_IVAR(self, g_H_OffPos, long long); }
+static int H_Obj_ObjectType(id self, SEL _cmd) { return H_IVAR(self, g_H_OffObjType, int); }
+static int H_Obj_DestroyType(id self, SEL _cmd) { return H_IVAR(self, g_H_OffDestroyType, int); }
+static void H_Obj_SetRemoved(id self, SEL _cmd, BOOL r) { H_IVAR(self, g_H_OffRemoved, BOOL) = r; }
+static void H_Obj_Remove(id self, SEL _cmd, BOOL r) { H_IVAR(self, g_H_OffRemoved, BOOL) = 1; }
+static void H_Obj_Void(id self, SEL _cmd) {}
+
+// Objects wander one tile now and then
+static void H_Obj_Update(id self, SEL _cmd, float dt, float acc, BOOL sim) {
+    long long pos = H_IVAR(self, g_H_OffPos, long long);
+    if ((H_Rand() & 15) == 0) {
+        int x = (int)(pos & 0xFFFFFFFF) + ((H_Rand() & 1) ? 1 : -1);
+        int w = H_WIDTH_MACRO * 32;
+        H_IVAR(self, g_H_OffPos, long long) = H_Pack((x + w) % w, (int)(pos >> 32));
+    }
+}
+
+static id H_BH_ClientName(id self, SEL _cmd) { return H_IVAR(self, g_H_OffClientName, id); }
+static id H_BH_ClientID(id self, SEL _cmd) { return H_IVAR(self, g_H_OffClientID, id); }
+static BOOL H_BH_No(id self, SEL _cmd) { return 0; }
+static int H_BH_Traverse(id self, SEL _cmd) { return 0; }
+
+static void H_DW_Update(id self, SEL _cmd, float dt, float acc, BOOL sim) {
+    SEL s = sel_registerName("update:accurateDT:isSimulation:");
+    for (int k = 0; k < H_KINDS; k++) {
+        for (int i = 0; i < g_H_ObjectCount[k]; i++) {
+            id obj = g_H_Objects[k][i];
+            ((H_UpdateFunc)class_getMethodImplementation(object_getClass(obj), s))(obj, s, dt, acc, sim);
+        }
+    }
+}
+
+static id H_DW_NetBlockheads(id self, SEL _cmd) { return H_IVAR(self, g_H_OffNetBlockheads, id); }
+
+static id H_DW_LoadNPC(id self, SEL _cmd, long long pos, int type, id saveDict, BOOL adult, BOOL placed, id client) {
+    Class cls = (type >= 1 && type <= 8 && g_H_NpcTypes[type]) ? g_H_NpcTypes[type] : g_H_NPC;
+    id npc = H_NewObject(cls, pos, H_KIND_NPC);
+    H_IVAR(npc, g_H_OffObjType, int) = type;
+    return npc;
+}
+
+static id H_DW_CreateDrop(id self, SEL _cmd, long long pos, int type, int dA, int dB, id sub, id save, BOOL hovers, BOOL sound, id bh) {
+    id drop = H_NewObject(g_H_Drop, pos, H_KIND_DROP);
+    H_IVAR(drop, g_H_OffObjType, int) = type;
+    return drop;
+}
+
+static id H_World_DynWorld(id self, SEL _cmd) { return g_H_DynWorldObj; }
+static void H_World_Request(id self, SEL _cmd, H_BlockRequest req, id client) { g_H_BlocksServed++; }
+static void H_World_SimEvent(id self, SEL _cmd, int type, id bh, id extra) {}
+
+static void H_GC_Update(id self, SEL _cmd, float dt, float acc) {
+    H_Reap();
+    H_RebuildTrees();
+    SEL s = sel_registerName("update:accurateDT:isSimulation:");
+    ((H_UpdateFunc)class_getMethodImplementation(object_getClass(g_H_DynWorldObj), s))(g_H_DynWorldObj, s, dt, acc, 0);
+}
+
+static id H_Srv_Command(id self, SEL _cmd, id cmd, id client) { g_H_Commands++; return nil; }
+static void H_Srv_Chat(id self, SEL _cmd, id msg, BOOL notify, id clients) { g_H_ChatSent++; }
+static void H_Srv_Chat2(id self, SEL _cmd, id msg, id clients) { g_H_ChatSent++; }
+static void H_Srv_Boot(id self, SEL _cmd, id client, BOOL ban) {}
+static BOOL H_Srv_IsAdmin(id self, SEL _cmd, id client) { return 0; }
+
+static id H_Place_Init(id self, SEL _cmd, id w, id dw, long long pos, id cache, id item, unsigned char flip, id save, id client, id cName) {
+    H_IVAR(self, g_H_OffPos, long long) = pos;
+    H_IVAR(self, g_H_OffObjWorld, id) = w;
+    if (item) H_IVAR(self, g_H_OffObjType, int) = H_IVAR(item, g_H_OffItemType, int);
+    if (g_H_OffInventory >= 0 && object_getClass(self) == g_H_Chest) H_IVAR(self, g_H_OffInventory, id) = H_MutableArray();
+    return self;
+}
+
+static id H_Load_Init(id self, SEL _cmd, id w, id dw, id save, id cache) { return self; }
+static id H_FCPlace_Init(id self, SEL _cmd, id w, id dw, long long pos, id cache, id save, id client) { return self; }
+static id H_FCLoad_Init(id self, SEL _cmd, id w, id dw, id save, id chestSave, id cache) { return self; }
+static id H_FCNet_Init(id self, SEL _cmd, id w, id dw, id cache, id net) { return self; }
+
+static id H_Item_Init(id self, SEL _cmd, int type, uint16_t dA, uint16_t dB, id sub, id save) {
+    H_IVAR(self, g_H_OffItemType, int) = type;
+    H_IVAR(self, g_H_OffDataA, uint16_t) = dA;
+    H_IVAR(self, g_H_OffDataB, uint16_t) = dB;
+    if (sub) H_IVAR(self, g_H_OffSubItems, id) = H_Send(sub, "retain");
+    if (save) H_IVAR(self, g_H_OffSaveDict, id) = H_Send(save, "retain");
+    return self;
+}
+static int H_Item_Type(id self, SEL _cmd) { return H_IVAR(self, g_H_OffItemType, int); }
+static uint16_t H_Item_DataA(id self, SEL _cmd) { return H_IVAR(self, g_H_OffDataA, uint16_t); }
+static uint16_t H_Item_DataB(id self, SEL _cmd) { return H_IVAR(self, g_H_OffDataB, uint16_t); }
+static id H_Item_Sub(id self, SEL _cmd) { return H_IVAR(self, g_H_OffSubItems, id); }
+static id H_Item_Save(id self, SEL _cmd) { return H_IVAR(self, g_H_OffSaveDict, id); }
+
+static void H_Match_Join(id self, SEL _cmd, id info, id peer) {}
+static void H_Match_Leave(id self, SEL _cmd, id peer, bool kick) {}
+
+// --- CLASS SETUP ---
+
+static Class H_Class(const char* name, Class super) {
+    if (objc_getClass(name)) {
+        fprintf(stderr, "[Harness] Class %s already exists, is the game binary loaded?\n", name);
+        exit(1);
+    }
+    return objc_allocateClassPair(super, name, 0);
+}
+
+static void H_Ivar(Class cls, const char* name, size_t size, uint8_t alignLog2, const char* types) {
+    class_addIvar(cls, name, size, alignLog2, types);
+}
+
+static void H_Method(Class cls, const char* sel, IMP imp, const char* types) {
+    class_addMethod(cls, sel_registerName(sel), imp, types);
+}
+
+static ptrdiff_t H_Off(Class cls, const char* name) {
+    Ivar iv = class_getInstanceVariable(cls, name);
+    return iv ? ivar_getOffset(iv) : -1;
+}
+
+static void H_DefineClasses(void) {
+    g_H_NSObject = objc_getClass("NSObject");
+
+    g_H_GC = H_Class("GameController", g_H_NSObject);
+    H_Ivar(g_H_GC, "bhServer", sizeof(id), 3, "@");
+    H_Method(g_H_GC, "update:accurateDT:", (IMP)H_GC_Update, "v@:ff");
+    objc_registerClassPair(g_H_GC);
+
+    g_H_Server = H_Class("BHServer", g_H_NSObject);
+    H_Ivar(g_H_Server, "world", sizeof(id), 3, "@");
+    H_Method(g_H_Server, "handleCommand:issueClient:", (IMP)H_Srv_Command, "@@:@@");
+    H_Method(g_H_Server, "sendChatMessage:displayNotification:sendToClients:", (IMP)H_Srv_Chat, "v@:@c@");
+    H_Method(g_H_Server, "sendChatMessage:sendToClients:", (IMP)H_Srv_Chat2, "v@:@@");
+    H_Method(g_H_Server, "bootPlayer:wasBan:", (IMP)H_Srv_Boot, "v@:@c");
+    H_Method(g_H_Server, "playerIsAdminWithID:", (IMP)H_Srv_IsAdmin, "c@:@");
+    objc_registerClassPair(g_H_Server);
+
+    g_H_World = H_Class("World", g_H_NSObject);
+    H_Ivar(g_H_World, "dynamicWorld", sizeof(id), 3, "@");
+    H_Ivar(g_H_World, "worldWidthMacro", sizeof(int), 2, "i");
+    H_Ivar(g_H_World, "saveDelay", sizeof(int), 2, "i");
+    H_Method(g_H_World, "dynamicWorld", (IMP)H_World_DynWorld, "@@:");
+    H_Method(g_H_World, "requestForBlock:fromClient:", (IMP)H_World_Request, "v@:{?=IC[3C]}@");
+    H_Method(g_H_World, "addSimulationEventOfType:forBlockhead:extraData:", (IMP)H_World_SimEvent, "v@:i@@");
+    objc_registerClassPair(g_H_World);
+
+    char treeTypes[64];
+    snprintf(treeTypes, sizeof(treeTypes), "[%d{?=Q{?=Q^v^v^v}Q}]", H_TREES);
+    g_H_DynWorld = H_Class("DynamicWorld", g_H_NSObject);
+    H_Ivar(g_H_DynWorld, "dynamicObjects", sizeof(struct H_RbTree_Impl) * H_TREES, 3, treeTypes);
+    H_Ivar(g_H_DynWorld, "netBlockheads", sizeof(id), 3, "@");
+    H_Method(g_H_DynWorld, "update:accurateDT:isSimulation:", (IMP)H_DW_Update, "v@:ffc");
+    H_Method(g_H_DynWorld, "allBlockheadsIncludingNet", (IMP)H_DW_NetBlockheads, "@@:");
+    H_Method(g_H_DynWorld, "loadNPCAtPosition:type:saveDict:isAdult:wasPlaced:placedByClient:", (IMP)H_DW_LoadNPC, "@@:qi@cc@");
+    H_Method(g_H_DynWorld, "createFreeBlockAtPosition:ofType:dataA:dataB:subItems:dynamicObjectSaveDict:hovers:playSound:priorityBlockhead:",
+             (IMP)H_DW_CreateDrop, "@@:qiii@@cc@");
+    objc_registerClassPair(g_H_DynWorld);
+
+    g_H_DynObj = H_Class("DynamicObject", g_H_NSObject);
+    H_Ivar(g_H_DynObj, "pos", sizeof(long long), 3, "q");
+    H_Ivar(g_H_DynObj, "world", sizeof(id), 3, "@");
+    H_Ivar(g_H_DynObj, "objectType", sizeof(int), 2, "i");
+    H_Ivar(g_H_DynObj, "destroyItemType", sizeof(int), 2, "i");
+    H_Ivar(g_H_DynObj, "needsRemoved", sizeof(BOOL), 0, "c");
+    H_Method(g_H_DynObj, "pos", (IMP)H_Obj_Pos, "q@:");
+    H_Method(g_H_DynObj, "objectType", (IMP)H_Obj_ObjectType, "i@:");
+    H_Method(g_H_DynObj, "destroyItemType", (IMP)H_Obj_DestroyType, "i@:");
+    H_Method(g_H_DynObj, "setNeedsRemoved:", (IMP)H_Obj_SetRemoved, "v@:c");
+    H_Method(g_H_DynObj, "remove:", (IMP)H_Obj_Remove, "v@:c");
+    H_Method(g_H_DynObj, "removeFromMacroBlock", (IMP)H_Obj_Void, "v@:");
+    H_Method(g_H_DynObj, "update:accurateDT:isSimulation:", (IMP)H_Obj_Update, "v@:ffc");
+    H_Method(g_H_DynObj, "initWithWorld:dynamicWorld:saveDict:cache:", (IMP)H_Load_Init, "@@:@@@@");
+    objc_registerClassPair(g_H_DynObj);
+
+    g_H_Blockhead = H_Class("Blockhead", g_H_DynObj);
+    H_Ivar(g_H_Blockhead, "clientName", sizeof(id), 3, "@");
+    H_Ivar(g_H_Blockhead, "clientID", sizeof(id), 3, "@");
+    H_Method(g_H_Blockhead, "clientName", (IMP)H_BH_ClientName, "@@:");
+    H_Method(g_H_Blockhead, "clientID", (IMP)H_BH_ClientID, "@@:");
+    H_Method(g_H_Blockhead, "hasJetPackEquipped", (IMP)H_BH_No, "c@:");
+    H_Method(g_H_Blockhead, "canFly", (IMP)H_BH_No, "c@:");
+    H_Method(g_H_Blockhead, "traverseType", (IMP)H_BH_Traverse, "i@:");
+    H_Method(g_H_Blockhead, "update:accurateDT:isSimulation:", (IMP)H_Obj_Update, "v@:ffc");
+    objc_registerClassPair(g_H_Blockhead);
+
+    // NPC subclasses inherit update/setNeedsRemoved:/dealloc like the game's
+    g_H_NPC = H_Class("NPC", g_H_DynObj);
+    objc_registerClassPair(g_H_NPC);
+    const char* npcNames[9] = { NULL, "Dodo", "DropBear", "Donkey", "Fish", "Shark", "CaveTroll", "Scorpion", "Yak" };
+    for (int t = 1; t < 9; t++) {
+        g_H_NpcTypes[t] = H_Class(npcNames[t], g_H_NPC);
+        objc_registerClassPair(g_H_NpcTypes[t]);
+    }
+
+    g_H_Drop = H_Class("FreeBlock", g_H_DynObj);
+    objc_registerClassPair(g_H_Drop);
+
+    const char* placeSel = "initWithWorld:dynamicWorld:atPosition:cache:item:flipped:saveDict:placedByClient:clientName:";
+    const char* placeTypes = "@@:@@q@@C@@@";
+    g_H_Chest = H_Class("Chest", g_H_DynObj);
+    H_Ivar(g_H_Chest, "inventoryItems", sizeof(id), 3, "@");
+    H_Method(g_H_Chest, placeSel, (IMP)H_Place_Init, placeTypes);
+    H_Method(g_H_Chest, "contentsDidChange", (IMP)H_Obj_Void, "v@:");
+    objc_registerClassPair(g_H_Chest);
+
+    // Workbench and TradePortal override update like the game's, so hooking them stays class-local
+    g_H_Workbench = H_Class("Workbench", g_H_DynObj);
+    H_Method(g_H_Workbench, placeSel, (IMP)H_Place_Init, placeTypes);
+    H_Method(g_H_Workbench, "update:accurateDT:isSimulation:", (IMP)H_Obj_Update, "v@:ffc");
+    objc_registerClassPair(g_H_Workbench);
+
+    g_H_TradePortal = H_Class("TradePortal", g_H_DynObj);
+    H_Method(g_H_TradePortal, placeSel, (IMP)H_Place_Init, placeTypes);
+    H_Method(g_H_TradePortal, "update:accurateDT:isSimulation:", (IMP)H_Obj_Update, "v@:ffc");
+    objc_registerClassPair(g_H_TradePortal);
+
+    g_H_FreightCar = H_Class("FreightCar", g_H_DynObj);
+    H_Method(g_H_FreightCar, "initWithWorld:dynamicWorld:atPosition:cache:saveDict:placedByClient:", (IMP)H_FCPlace_Init, "@@:@@q@@@");
+    H_Method(g_H_FreightCar, "initWithWorld:dynamicWorld:saveDict:chestSaveDict:cache:", (IMP)H_FCLoad_Init, "@@:@@@@@");
+    H_Method(g_H_FreightCar, "initWithWorld:dynamicWorld:cache:netData:", (IMP)H_FCNet_Init, "@@:@@@@");
+    objc_registerClassPair(g_H_FreightCar);
+
+    g_H_Item = H_Class("InventoryItem", g_H_NSObject);
+    H_Ivar(g_H_Item, "itemType", sizeof(int), 2, "i");
+    H_Ivar(g_H_Item, "dataA", sizeof(uint16_t), 1, "S");
+    H_Ivar(g_H_Item, "dataB", sizeof(uint16_t), 1, "S");
+    H_Ivar(g_H_Item, "subItems", sizeof(id), 3, "@");
+    H_Ivar(g_H_Item, "dynamicObjectSaveDict", sizeof(id), 3, "@");
+    H_Method(g_H_Item, "initWithType:dataA:dataB:subItems:dynamicObjectSaveDict:", (IMP)H_Item_Init, "@@:iSS@@");
+    H_Method(g_H_Item, "itemType", (IMP)H_Item_Type, "i@:");
+    H_Method(g_H_Item, "dataA", (IMP)H_Item_DataA, "S@:");
+    H_Method(g_H_Item, "dataB", (IMP)H_Item_DataB, "S@:");
+    H_Method(g_H_Item, "subItems", (IMP)H_Item_Sub, "@@:");
+    H_Method(g_H_Item, "dynamicObjectSaveDict", (IMP)H_Item_Save, "@@:");
+    objc_registerClassPair(g_H_Item);
+
+    g_H_Match = H_Class("BHNetServerMatch", g_H_NSObject);
+    H_Method(g_H_Match, "clientPlayerInformationRecieved:fromPeer:", (IMP)H_Match_Join, "v@:@@");
+    H_Method(g_H_Match, "clientDisconnected:wasKick:", (IMP)H_Match_Leave, "v@:@c");
+    objc_registerClassPair(g_H_Match);
+
+    g_H_OffPos = H_Off(g_H_DynObj, "pos");
+    g_H_OffObjWorld = H_Off(g_H_DynObj, "world");
+    g_H_OffRemoved = H_Off(g_H_DynObj, "needsRemoved");
+    g_H_OffObjType = H_Off(g_H_DynObj, "objectType");
+    g_H_OffDestroyType = H_Off(g_H_DynObj, "destroyItemType");
+    g_H_OffClientName = H_Off(g_H_Blockhead, "clientName");
+    g_H_OffClientID = H_Off(g_H_Blockhead, "clientID");
+    g_H_OffInventory = H_Off(g_H_Chest, "inventoryItems");
+    g_H_OffItemType = H_Off(g_H_Item, "itemType");
+    g_H_OffDataA = H_Off(g_H_Item, "dataA");
+    g_H_OffDataB = H_Off(g_H_Item, "dataB");
+    g_H_OffSubItems = H_Off(g_H_Item, "subItems");
+    g_H_OffSaveDict = H_Off(g_H_Item, "dynamicObjectSaveDict");
+    g_H_OffDynObjects = H_Off(g_H_DynWorld, "dynamicObjects");
+    g_H_OffNetBlockheads = H_Off(g_H_DynWorld, "netBlockheads");
+}
+
+// --- WORLD SETUP ---
+
+static id H_NewItem(int type) {
+    id item = H_New(g_H_Item);
+    SEL s = sel_registerName("initWithType:dataA:dataB:subItems:dynamicObjectSaveDict:");
+    return ((H_ItemFunc)class_getMethodImplementation(g_H_Item, s))(item, s, type, 0, 0, nil, nil);
+}
+
+static void H_BuildWorld(void) {
+    H_InitTiles();
+
+    g_H_WorldObj = H_New(g_H_World);
+    g_H_DynWorldObj = H_New(g_H_DynWorld);
+    g_H_BHServer = H_New(g_H_Server);
+    g_H_GameController = H_New(g_H_GC);
+    g_H_MatchObj = H_New(g_H_Match);
+    H_IVAR(g_H_WorldObj, H_Off(g_H_World, "dynamicWorld"), id) = g_H_DynWorldObj;
+    H_IVAR(g_H_WorldObj, H_Off(g_H_World, "worldWidthMacro"), int) = H_WIDTH_MACRO;
+    H_IVAR(g_H_WorldObj, H_Off(g_H_World, "saveDelay"), int) = 60;
+    H_IVAR(g_H_BHServer, H_Off(g_H_Server, "world"), id) = g_H_WorldObj;
+    H_IVAR(g_H_GameController, H_Off(g_H_GC, "bhServer"), id) = g_H_BHServer;
+
+    g_H_NetBlockheads = H_MutableArray();
+    H_IVAR(g_H_DynWorldObj, g_H_OffNetBlockheads, id) = g_H_NetBlockheads;
+
+    SEL sAdd = sel_registerName("addObject:");
+    for (int i = 0; i < H_PLAYERS; i++) {
+        char name[32], cid[33];
+        snprintf(name, sizeof(name), "PLAYER%d", i);
+        snprintf(cid, sizeof(cid), "%032x", i + 1);
+        id bh = H_NewObject(g_H_Blockhead, H_RandomPos(), H_KIND_BH);
+        H_IVAR(bh, g_H_OffClientName, id) = H_Send(H_Str(name), "retain");
+        H_IVAR(bh, g_H_OffClientID, id) = H_Send(H_Str(cid), "retain");
+        ((H_Obj1Func)H_Imp(g_H_NetBlockheads, "addObject:"))(g_H_NetBlockheads, sAdd, bh);
+    }
+    for (int i = 0; i < H_NPCS; i++) {
+        id npc = H_NewObject(g_H_NpcTypes[1 + i % 8], H_RandomPos(), H_KIND_NPC);
+        H_IVAR(npc, g_H_OffObjType, int) = 1 + i % 8;
+    }
+    for (int i = 0; i < H_DROPS; i++) {
+        id drop = H_NewObject(g_H_Drop, H_RandomPos(), H_KIND_DROP);
+        H_IVAR(drop, g_H_OffObjType, int) = 1 + i % 100;
+    }
+    H_RebuildTrees();
+}
+
+// --- TRACES ---
+
+// Client->server ENet payloads of an enet_tap capture (patches/enet_tap.c), as NSData.
+// Compressed datagrams are skipped; checksummed servers are not supported.
+static int H_LoadTracePayloads(const char* path, id** out) {
+    static const uint8_t cmdSize[13] = { 0, 8, 48, 44, 8, 4, 6, 8, 24, 8, 12, 16, 24 };
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "[Harness] Cannot open trace %s\n", path);
+        return 0;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* buf = malloc((size_t)size);
+    if (!buf || fread(buf, 1, (size_t)size, f) != (size_t)size || size < 28 || memcmp(buf, "BHTR", 4) != 0) {
+        fclose(f);
+        free(buf);
+        fprintf(stderr, "[Harness] %s is not an enet_tap trace\n", path);
+        return 0;
+    }
+    fclose(f);
+
+    id cls = (id)objc_getClass("NSData");
+    SEL sData = sel_registerName("dataWithBytes:length:");
+    H_BytesFunc fData = (H_BytesFunc)H_Imp(cls, "dataWithBytes:length:");
+    int count = 0, cap = 0;
+    size_t recHeader = buf[6] | (buf[7] << 8);
+    long off = 28;
+    while (recHeader >= 14 && off + (long)recHeader <= size) {
+        const uint8_t* r = buf + off;
+        size_t len = r[12] | (r[13] << 8);
+        const uint8_t* d = r + recHeader;
+        off += (long)(recHeader + len);
+        if (off > size) break;
+        if (r[4] != 0 || len < 2 || (d[0] & 0x40)) continue;
+
+        size_t p = (d[0] & 0x80) ? 4 : 2;
+        while (p + 4 <= len) {
+            int cmd = d[p] & 0x0F;
+            if (cmd <= 0 || cmd > 12 || p + cmdSize[cmd] > len) break;
+            size_t head = cmdSize[cmd], data = 0;
+            if (cmd == 6) data = (d[p + 4] << 8) | d[p + 5];
+            else if (cmd == 7 || cmd == 8 || cmd == 9 || cmd == 12) data = (d[p + 6] << 8) | d[p + 7];
+            if (p + head + data > len) break;
+            if (data > 0) {
+                if (count == cap) {
+                    cap = cap ? cap * 2 : 1024;
+                    *out = realloc(*out, sizeof(id) * (size_t)cap);
+                }
+                (*out)[count++] = H_Send(fData(cls, sData, d + p + head, data), "retain");
+            }
+            p += head + data;
+        }
+    }
+    free(buf);
+    printf("[Harness] %s: %d client payloads\n", path, count);
+    return count;
+}
+
+// --- STEPS ---
+
+static int H_CompareDouble(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Runs one step `calls` times and records its latency spread in slot `pass`
+static void H_RunStep(H_Step* st, int pass) {
+    if (strcmp(st->name, "sleep") == 0) {
+        sleep((unsigned)st->calls);
+        return;
+    }
+
+    long rssBefore = H_RssKB();
+    double* samples = malloc(sizeof(double) * (size_t)st->calls);
+    if (!samples) return;
+
+    int bhIdx = 0, objIdx = 0;
+    id cmdStr = H_Send(H_Str(st->arg), "retain");
+    id pool = H_Pool();
+    id peerBuf = nil;
+    void* peer = calloc(1, 512);
+    {
+        id cls = (id)objc_getClass("NSValue");
+        peerBuf = H_Send(((H_PtrFunc)H_Imp(cls, "valueWithPointer:"))(cls, sel_registerName("valueWithPointer:"), peer), "retain");
+    }
+    id joinInfo = nil, plistData = nil, chestItem = nil, benchItem = nil;
+    id* payloads = NULL;
+    int payloadCount = 0;
+    id* benches = NULL;
+    int benchCount = 0;
+    int netTx = -1, netRx = -1, netBatch = 0;
+    struct sockaddr_in netAddr = { 0 };
+    if (strcmp(st->name, "join") == 0) {
+        id cls = (id)objc_getClass("NSMutableDictionary");
+        joinInfo = H_Send(H_Send(cls, "dictionary"), "retain");
+        ((H_Obj2Func)H_Imp(joinInfo, "setObject:forKey:"))(joinInfo, sel_registerName("setObject:forKey:"), H_Str("GUEST"), H_Str("alias"));
+    } else if (strcmp(st->name, "packet") == 0) {
+        static const char xml[] =
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?><plist version=\"1.0\"><dict>"
+            "<key>message</key><string>hello there</string><key>alias</key><string>PLAYER1</string>"
+            "<key>pos</key><integer>123456</integer></dict></plist>";
+        id cls = (id)objc_getClass("NSData");
+        plistData = H_Send(((H_BytesFunc)H_Imp(cls, "dataWithBytes:length:"))(cls, sel_registerName("dataWithBytes:length:"), xml, sizeof(xml) - 1), "retain");
+    } else if (strcmp(st->name, "trace") == 0) {
+        payloadCount = H_LoadTracePayloads(st->arg, &payloads);
+        if (payloadCount == 0) st->calls = 0;
+    } else if (strcmp(st->name, "net_packet") == 0) {
+        netBatch = atoi(st->arg) > 0 ? atoi(st->arg) : 8;
+        socklen_t addrLen = sizeof(netAddr);
+        netAddr.sin_family = AF_INET;
+        netAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        netTx = socket(AF_INET, SOCK_DGRAM, 0);
+        netRx = socket(AF_INET, SOCK_DGRAM, 0);
+        int rcvBuf = 4 << 20;
+        setsockopt(netRx, SOL_SOCKET, SO_RCVBUF, &rcvBuf, sizeof(rcvBuf));
+        if (netTx < 0 || netRx < 0 || bind(netRx, (struct sockaddr*)&netAddr, sizeof(netAddr)) != 0 ||
+            getsockname(netRx, (struct sockaddr*)&netAddr, &addrLen) != 0) {
+            fprintf(stderr, "[Harness] net_packet: no loopback socket\n");
+            st->calls = 0;
+        }
+    } else if (strcmp(st->name, "chest") == 0) {
+        chestItem = H_NewItem(atoi(st->arg) > 0 ? atoi(st->arg) : 16);
+    } else if (strcmp(st->name, "workbench") == 0) {
+        benchItem = H_NewItem(atoi(st->arg) > 0 ? atoi(st->arg) : 28);
+    } else if (strcmp(st->name, "workbench_update") == 0) {
+        // Standalone workbenches (not in dynamicObjects), so the other steps tick the same world
+        benchCount = atoi(st->arg) > 0 ? atoi(st->arg) : 64;
+        benches = calloc((size_t)benchCount, sizeof(id));
+        for (int k = 0; benches && k < benchCount; k++) {
+            benches[k] = H_New(g_H_Workbench);
+            H_IVAR(benches[k], g_H_OffPos, long long) = H_RandomPos();
+            H_IVAR(benches[k], g_H_OffObjWorld, id) = g_H_WorldObj;
+            H_IVAR(benches[k], g_H_OffObjType, int) = 28;
+            H_IVAR(benches[k], g_H_OffDestroyType, int) = 28;
+        }
+        if (!benches) st->calls = 0;
+    }
+
+    SEL sUpdate = sel_registerName("update:accurateDT:isSimulation:");
+    for (long i = 0; i < st->calls; i++) {
+        double t0 = 0.0, t1 = 0.0;
+
+        if (strcmp(st->name, "tick") == 0) {
+            SEL s = sel_registerName("update:accurateDT:");
+            H_TickFunc f = (H_TickFunc)H_Imp(g_H_GameController, "update:accurateDT:");
+            t0 = H_Now(); f(g_H_GameController, s, 1.0f / 60.0f, 1.0f / 60.0f); t1 = H_Now();
+        } else if (strcmp(st->name, "bh_update") == 0 || strcmp(st->name, "drop_update") == 0 || strcmp(st->name, "npc_update") == 0) {
+            int kind = st->name[0] == 'b' ? H_KIND_BH : (st->name[0] == 'd' ? H_KIND_DROP : H_KIND_NPC);
+            if (g_H_ObjectCount[kind] == 0) break;
+            id obj = g_H_Objects[kind][(bhIdx++) % g_H_ObjectCount[kind]];
+            H_UpdateFunc f = (H_UpdateFunc)class_getMethodImplementation(object_getClass(obj), sUpdate);
+            t0 = H_Now(); f(obj, sUpdate, 1.0f / 60.0f, 1.0f / 60.0f, 0); t1 = H_Now();
+        } else if (strcmp(st->name, "workbench_update") == 0) {
+            id obj = benches[(bhIdx++) % benchCount];
+            H_UpdateFunc f = (H_UpdateFunc)class_getMethodImplementation(g_H_Workbench, sUpdate);
+            t0 = H_Now(); f(obj, sUpdate, 1.0f / 60.0f, 1.0f / 60.0f, 0); t1 = H_Now();
+        } else if (strcmp(st->name, "command") == 0) {
+            SEL s = sel_registerName("handleCommand:issueClient:");
+            H_CmdFunc f = (H_CmdFunc)H_Imp(g_H_BHServer, "handleCommand:issueClient:");
+            t0 = H_Now(); f(g_H_BHServer, s, cmdStr, nil); t1 = H_Now();
+        } else if (strcmp(st->name, "chat") == 0) {
+            SEL s = sel_registerName("sendChatMessage:displayNotification:sendToClients:");
+            H_ChatFunc f = (H_ChatFunc)H_Imp(g_H_BHServer, "sendChatMessage:displayNotification:sendToClients:");
+            t0 = H_Now(); f(g_H_BHServer, s, cmdStr, 1, nil); t1 = H_Now();
+        } else if (strcmp(st->name, "chest") == 0 || strcmp(st->name, "workbench") == 0) {
+            Class cls = st->name[0] == 'c' ? g_H_Chest : g_H_Workbench;
+            id item = st->name[0] == 'c' ? chestItem : benchItem;
+            SEL s = sel_registerName("initWithWorld:dynamicWorld:atPosition:cache:item:flipped:saveDict:placedByClient:clientName:");
+            H_PlaceFunc f = (H_PlaceFunc)class_getMethodImplementation(cls, s);
+            id obj = H_New(cls);
+            id name = H_Str("PLAYER1");
+            t0 = H_Now();
+            id placed = f(obj, s, g_H_WorldObj, g_H_DynWorldObj, H_RandomPos(), nil, item, 0, nil, nil, name);
+            t1 = H_Now();
+            if (placed) H_Send(placed, "release");
+        } else if (strcmp(st->name, "npc_spawn") == 0) {
+            SEL s = sel_registerName("loadNPCAtPosition:type:saveDict:isAdult:wasPlaced:placedByClient:");
+            H_NpcFunc f = (H_NpcFunc)H_Imp(g_H_DynWorldObj, "loadNPCAtPosition:type:saveDict:isAdult:wasPlaced:placedByClient:");
+            int type = atoi(st->arg) > 0 ? atoi(st->arg) : 1;
+            t0 = H_Now(); f(g_H_DynWorldObj, s, H_RandomPos(), type, nil, 1, 1, nil); t1 = H_Now();
+        } else if (strcmp(st->name, "drop_spawn") == 0) {
+            SEL s = sel_registerName("createFreeBlockAtPosition:ofType:dataA:dataB:subItems:dynamicObjectSaveDict:hovers:playSound:priorityBlockhead:");
+            H_DropFunc f = (H_DropFunc)class_getMethodImplementation(object_getClass(g_H_DynWorldObj), s);
+            int type = atoi(st->arg) > 0 ? atoi(st->arg) : 12;
+            t0 = H_Now(); f(g_H_DynWorldObj, s, H_RandomPos(), type, 0, 0, nil, nil, 0, 0, nil); t1 = H_Now();
+        } else if (strcmp(st->name, "join") == 0) {
+            SEL sJ = sel_registerName("clientPlayerInformationRecieved:fromPeer:");
+            SEL sL = sel_registerName("clientDisconnected:wasKick:");
+            H_JoinFunc fJ = (H_JoinFunc)H_Imp(g_H_MatchObj, "clientPlayerInformationRecieved:fromPeer:");
+            H_LeaveFunc fL = (H_LeaveFunc)H_Imp(g_H_MatchObj, "clientDisconnected:wasKick:");
+            t0 = H_Now(); fJ(g_H_MatchObj, sJ, joinInfo, peerBuf); fL(g_H_MatchObj, sL, peerBuf, false); t1 = H_Now();
+        } else if (strcmp(st->name, "packet") == 0) {
+            id cls = (id)objc_getClass("NSPropertyListSerialization");
+            SEL s = sel_registerName("propertyListWithData:options:format:error:");
+            H_PlistFunc f = (H_PlistFunc)H_Imp(cls, "propertyListWithData:options:format:error:");
+            unsigned long fmt = 0;
+            id err = nil;
+            t0 = H_Now(); f(cls, s, plistData, 0, &fmt, &err); t1 = H_Now();
+        } else if (strcmp(st->name, "trace") == 0) {
+            id cls = (id)objc_getClass("NSPropertyListSerialization");
+            SEL s = sel_registerName("propertyListWithData:options:format:error:");
+            H_PlistFunc f = (H_PlistFunc)H_Imp(cls, "propertyListWithData:options:format:error:");
+            unsigned long fmt = 0;
+            id err = nil;
+            id data = payloads[i % payloadCount];
+            t0 = H_Now(); f(cls, s, data, 0, &fmt, &err); t1 = H_Now();
+        } else if (strcmp(st->name, "net_packet") == 0) {
+            // One ENet SEND_RELIABLE per datagram: message ID byte, then an XML plist
+            static const char body[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+            uint8_t dgrams[64][1400];
+            size_t sizes[64];
+            int batch = netBatch < 64 ? netBatch : 64;
+            for (int k = 0; k < batch; k++) {
+                uint8_t* d = dgrams[k];
+                char* xml = (char*)d + 9;
+                int n = snprintf(xml, 1300,
+                    "<?xml version=\"1.0\" encoding=\"UTF-8\"?><plist version=\"1.0\"><dict>"
+                    "<key>alias</key><string>PLAYER%d</string><key>seq</key><integer>%ld</integer><key>message</key><string>",
+                    k, i);
+                for (int r = 0; r < 12; r++) n += snprintf(xml + n, 1300 - (size_t)n, "%s", body);
+                n += snprintf(xml + n, 1300 - (size_t)n, "</string></dict></plist>");
+                uint16_t dataLen = (uint16_t)(n + 1);
+                d[0] = 0; d[1] = 0;
+                d[2] = 0x86; d[3] = 0; d[4] = (uint8_t)(i >> 8); d[5] = (uint8_t)i;
+                d[6] = (uint8_t)(dataLen >> 8); d[7] = (uint8_t)dataLen;
+                d[8] = 5;
+                sizes[k] = 8 + dataLen;
+            }
+            for (int k = 0; k < batch; k++) sendto(netTx, dgrams[k], sizes[k], 0, (struct sockaddr*)&netAddr, sizeof(netAddr));
+
+            id cls = (id)objc_getClass("NSPropertyListSerialization");
+            id dataCls = (id)objc_getClass("NSData");
+            SEL s = sel_registerName("propertyListWithData:options:format:error:");
+            SEL sData = sel_registerName("dataWithBytes:length:");
+            H_PlistFunc f = (H_PlistFunc)H_Imp(cls, "propertyListWithData:options:format:error:");
+            H_BytesFunc fData = (H_BytesFunc)H_Imp(dataCls, "dataWithBytes:length:");
+            uint8_t rx[64][1500];
+            ssize_t got[64];
+            t0 = H_Now();
+            for (int k = 0; k < batch; k++) {
+                struct sockaddr_in from;
+                struct iovec iov = { rx[k], sizeof(rx[k]) };
+                struct msghdr msg = { .msg_name = &from, .msg_namelen = sizeof(from), .msg_iov = &iov, .msg_iovlen = 1 };
+                got[k] = g_H_RecvMsg(netRx, &msg, 0);
+            }
+            for (int k = 0; k < batch; k++) {
+                if (got[k] <= 9) continue;
+                unsigned long fmt = 0;
+                id err = nil;
+                f(cls, s, fData(dataCls, sData, rx[k] + 9, (unsigned long)got[k] - 9), 0, &fmt, &err);
+            }
+            t1 = H_Now();
+        } else if (strcmp(st->name, "block_request") == 0) {
+            SEL s = sel_registerName("requestForBlock:fromClient:");
+            H_ReqFunc f = (H_ReqFunc)H_Imp(g_H_WorldObj, "requestForBlock:fromClient:");
+            H_BlockRequest req = { (uint32_t)(objIdx++ % (H_WIDTH_MACRO * 32)), 1, {0, 0, 0} };
+            t0 = H_Now(); f(g_H_WorldObj, s, req, nil); t1 = H_Now();
+        } else {
+            fprintf(stderr, "[Harness] Unknown step '%s'\n", st->name);
+            break;
+        }
+
+        samples[i] = t1 - t0;
+        if ((i + 1) % H_DRAIN_EVERY == 0) {
+            H_Send(pool, "drain");
+            pool = H_Pool();
+        }
+        // Spawned objects are reaped like the game does at tick start
+        if ((i + 1) % 64 == 0 && strcmp(st->name, "tick") != 0) {
+            H_Reap();
+            H_RebuildTrees();
+        }
+    }
+    H_Send(pool, "drain");
+
+    long n = st->calls;
+    double total = 0.0;
+    for (long i = 0; i < n; i++) total += samples[i];
+    qsort(samples, (size_t)n, sizeof(double), H_CompareDouble);
+    st->ran[pass] = n > 0;
+    if (n > 0) {
+        st->p50[pass] = samples[n / 2];
+        st->p99[pass] = samples[(long)((n - 1) * 0.99)];
+        st->max[pass] = samples[n - 1];
+        st->opsPerSec[pass] = total > 0.0 ? n / (total / 1e9) : 0.0;
+    }
+    free(samples);
+    H_Send(cmdStr, "release");
+    H_Send(peerBuf, "release");
+    if (joinInfo) H_Send(joinInfo, "release");
+    if (plistData) H_Send(plistData, "release");
+    for (int i = 0; i < payloadCount; i++) H_Send(payloads[i], "release");
+    free(payloads);
+    if (chestItem) H_Send(chestItem, "release");
+    if (benchItem) H_Send(benchItem, "release");
+    for (int i = 0; i < benchCount; i++) H_Send(benches[i], "release");
+    free(benches);
+    if (netTx >= 0) close(netTx);
+    if (netRx >= 0) close(netRx);
+    free(peer);
+    // Whatever a hook leaks per call stays resident once the step is torn down
+    if (n > 0) st->rssPerM[pass] = (H_RssKB() - rssBefore) * (1e6 / n);
+}
+
+static bool H_LoadScript(const char* path) {
+    char* buf = NULL;
+    if (path) {
+        FILE* f = fopen(path, "r");
+        if (!f) {
+            fprintf(stderr, "[Harness] Cannot open script %s\n", path);
+            return false;
+        }
+        size_t cap = 0;
+        if (getdelim(&buf, &cap, '\0', f) < 0) { fclose(f); free(buf); return false; }
+        fclose(f);
+    } else {
+        buf = strdup(H_DEFAULT_SCRIPT);
+    }
+
+    for (char* line = strtok(buf, "\n"); line && g_H_StepCount < H_MAX_STEPS; line = strtok(NULL, "\n")) {
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        H_Step* st = &g_H_Steps[g_H_StepCount];
+        memset(st, 0, sizeof(*st));
+        int used = 0;
+        if (sscanf(line, "%31s %ld %n", st->name, &st->calls, &used) < 2 || st->calls <= 0) continue;
+        snprintf(st->arg, sizeof(st->arg), "%s", line + used);
+        size_t len = strlen(st->arg);
+        while (len > 0 && (st->arg[len - 1] == ' ' || st->arg[len - 1] == '\r')) st->arg[--len] = '\0';
+        g_H_StepCount++;
+    }
+    free(buf);
+    return g_H_StepCount > 0;
+}
+
+static void H_Report(FILE* csv, const char* modules) {
+    printf("\n%-14s %8s %12s %10s %10s %10s %10s %10s %12s %12s\n",
+           "step", "calls", "ops/s", "base p50", "p50", "p99", "max", "+p50", "base rss/1M", "rss/1M");
+    for (int i = 0; i < g_H_StepCount; i++) {
+        H_Step* st = &g_H_Steps[i];
+        if (!st->ran[1]) continue;
+        double added = st->ran[0] ? st->p50[1] - st->p50[0] : 0.0;
+        printf("%-14s %8ld %12.0f %8.0fns %8.0fns %8.0fns %8.0fns %8.0fns %10.0fKB %10.0fKB\n",
+               st->name, st->calls, st->opsPerSec[1], st->ran[0] ? st->p50[0] : 0.0,
+               st->p50[1], st->p99[1], st->max[1], added, st->ran[0] ? st->rssPerM[0] : 0.0, st->rssPerM[1]);
+        if (csv) {
+            fprintf(csv, "%s,%s,%ld,%.0f,%.0f,%.0f,%.0f,%.0f,%.0f,%.0f,%.0f\n", modules, st->name, st->calls,
+                    st->opsPerSec[1], st->ran[0] ? st->p50[0] : 0.0, st->p50[1], st->p99[1], st->max[1], added,
+                    st->ran[0] ? st->rssPerM[0] : 0.0, st->rssPerM[1]);
+        }
+    }
+    printf("\n[Harness] Commands reached the server: %lu, chat lines sent: %lu, blocks served: %lu\n",
+           g_H_Commands, g_H_ChatSent, g_H_BlocksServed);
+}
+
+// gnustep-base sets up NSProcessInfo from main() in ObjC programs; this one is plain C
+extern void GSInitializeProcess(int argc, char** argv, char** envp) __attribute__((weak));
+
+int main(int argc, char** argv, char** envp) {
+    const char* script = NULL;
+    const char* csvPath = NULL;
+    int wait = H_DEFAULT_WAIT;
+    bool baseline = true;
+    int opt;
+    while ((opt = getopt(argc, argv, "s:w:o:n")) != -1) {
+        if (opt == 's') script = optarg;
+        else if (opt == 'w') wait = atoi(optarg);
+        else if (opt == 'o') csvPath = optarg;
+        else if (opt == 'n') baseline = false;
+        else {
+            fprintf(stderr, "Usage: %s [-s script] [-w seconds] [-o results.csv] [-n] module.so...\n", argv[0]);
+            return 2;
+        }
+    }
+    if (GSInitializeProcess) GSInitializeProcess(argc, argv, envp);
+    if (!H_LoadScript(script)) return 1;
+
+    // Modules write their configs and stats into the world folder
+    char worldDir[] = "/tmp/bh_harness_XXXXXX";
+    if (!getenv("BH_WORLD_DIR")) {
+        if (!mkdtemp(worldDir)) { perror("mkdtemp"); return 1; }
+        setenv("BH_WORLD_DIR", worldDir, 1);
+    }
+    printf("[Harness] World folder: %s\n", getenv("BH_WORLD_DIR"));
+
+    id pool = H_Pool();
+    H_DefineClasses();
+    H_BuildWorld();
+    H_Send(pool, "drain");
+
+    if (baseline) {
+        int built[H_KINDS];
+        memcpy(built, g_H_ObjectCount, sizeof(built));
+        printf("[Harness] Baseline run (no modules)...\n");
+        for (int i = 0; i < g_H_StepCount; i++) H_RunStep(&g_H_Steps[i], 0);
+        H_TrimWorld(built);
+    }
+
+    char modules[1024] = "";
+    int loaded = 0;
+    for (int i = optind; i < argc && loaded < H_MAX_MODULES; i++) {
+        void* handle = dlopen(argv[i], RTLD_NOW | RTLD_GLOBAL);
+        if (!handle) {
+            fprintf(stderr, "[Harness] %s\n", dlerror());
+            return 1;
+        }
+        // Under LD_PRELOAD the first module defining recvmsg() gets the server's calls
+        H_RecvMsgFunc fRecv = (H_RecvMsgFunc)dlsym(handle, "recvmsg");
+        if (fRecv && fRecv != recvmsg && g_H_RecvMsg == recvmsg) g_H_RecvMsg = fRecv;
+        const char* base = strrchr(argv[i], '/');
+        base = base ? base + 1 : argv[i];
+        size_t len = strlen(modules);
+        snprintf(modules + len, sizeof(modules) - len, "%s%s", loaded ? "+" : "", base);
+        loaded++;
+    }
+    if (!loaded) snprintf(modules, sizeof(modules), "none");
+    printf("[Harness] Loaded: %s. Waiting %d s for module init...\n", modules, wait);
+    sleep((unsigned)wait);
+
+    printf("[Harness] Run with modules...\n");
+    for (int i = 0; i < g_H_StepCount; i++) H_RunStep(&g_H_Steps[i], 1);
+
+    FILE* csv = NULL;
+    if (csvPath) {
+        bool fresh = access(csvPath, F_OK) != 0;
+        csv = fopen(csvPath, "a");
+        if (csv && fresh) fprintf(csv, "modules,step,calls,ops_per_sec,base_p50_ns,p50_ns,p99_ns,max_ns,added_p50_ns,base_rss_kb_per_m,rss_kb_per_m\n");
+    }
+    H_Report(csv, modules);
+    if (csv) fclose(csv);
+    fflush(stdout);
+
+    // Module threads are still running; skip destructors and atexit handlers
+    _exit(0);
+}
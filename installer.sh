@@ -40,8 +40,9 @@ RANK_MANAGER_URL="$REPO_RAW_URL/rank_manager.sh"
 
 # --- LISTAS ACTUALIZADAS ---
 # change_world_mode.c y change_world_size.c agregados a CRITICAL
-CRITICAL_PATCHES=("name_exploit.c" "super_repair_mode.c" "change_world_mode.c" "change_world_size.c" "anti_crash_nullifier.c")
-OPTIONAL_PATCHES=("freight_car_patch.c" "portal_chest_patch.c" "portal_patch.c" "trade_portal_patch.c" "anti_fly_patch.c")
+CRITICAL_PATCHES=("name_exploit.c" "super_repair_mode.c" "change_world_mode.c" "change_world_size.c" "anti_crash_nullifier.c" "string_pool.c" "chat_queue.c")
+OPTIONAL_PATCHES=("item_ban_policy.c" "anti_fly_patch.c" "tick_governor.c" "tick_profiler.c" "rank_engine.c" "control_socket.c" "log_sink.c" "event_log.c" "npc_census.c" "player_registry.c" "enet_tap.c" "net_stats.c" "net_coalesce.c")
+TOOLS_FILES=("playerdb.c")
 MODS_FILES=(
     "all_items_one_chest.c"
     "ban_all_new_drops.c"
@@ -59,12 +60,14 @@ declare -a PACKAGES_DEBIAN=(
     'libgnutls28-dev' 'libgcrypt20-dev' 'libxml2' 'libffi-dev' 'libnsl-dev' 'zlib1g'
     'libicu-dev' 'libstdc++6' 'libgcc-s1' 'wget' 'curl' 'tar' 'grep' 'screen' 'lsof'
     'inotify-tools' 'bc' 'build-essential' 'gobjc' 'libobjc-12-dev' 'libdispatch-dev'
+    'netcat-openbsd'
 )
 
 declare -a PACKAGES_ARCH=(
     'base-devel' 'git' 'cmake' 'ninja' 'clang' 'patchelf' 'gnustep-base' 'gcc-libs'
     'gnutls' 'libgcrypt' 'libxml2' 'libffi' 'libnsl' 'zlib' 'icu' 'libdispatch'
     'wget' 'curl' 'tar' 'grep' 'screen' 'lsof' 'inotify-tools' 'bc' 'gcc-objc'
+    'openbsd-netcat'
 )
 
 print_header "THE BLOCKHEADS LINUX SERVER INSTALLER"
@@ -137,6 +140,13 @@ download_server_files() {
     mkdir -p "patches/optional"
     print_status "Created organized patches directories (critical, mods, optional)."
 
+    # --- Retired patches (replaced by item_ban_policy) ---
+    for old in freight_car_patch portal_chest_patch portal_patch trade_portal_patch; do
+        rm -f "patches/optional/$old.c" "patches/optional/$old.so"
+    done
+    # chat_queue moved to the critical patches (modules reply through it)
+    rm -f "patches/optional/chat_queue.c" "patches/optional/chat_queue.so"
+
     # --- Descarga de Parches Críticos ---
     print_step "Downloading Critical Patches to patches/critical..."
     for patch in "${CRITICAL_PATCHES[@]}"; do
@@ -159,6 +169,18 @@ download_server_files() {
         fi
     done
 
+    # --- Descarga de Herramientas ---
+    mkdir -p "tools"
+    print_step "Downloading Tools to tools..."
+    for tool in "${TOOLS_FILES[@]}"; do
+        print_progress "Downloading $tool..."
+        if wget --timeout=30 --tries=3 -O "tools/$tool" "$REPO_RAW_URL/tools/$tool" 2>/dev/null; then
+            print_success "$tool downloaded."
+        else
+            print_warning "Failed to download $tool"
+        fi
+    done
+
     # --- Descarga de Mods ---
     print_step "Downloading Mods to patches/mods..."
     for mod in "${MODS_FILES[@]}"; do
@@ -314,10 +336,25 @@ if [ $count_compiled -eq 0 ]; then
 else
     print_success "$count_compiled patches and mods compiled and cleaned up."
 fi
+
+# Herramientas nativas (binarios, no LD_PRELOAD)
+for src_file in tools/*.c; do
+    [ -f "$src_file" ] || continue
+    bin_file="${src_file%.c}"
+    print_progress "Compiling: $src_file -> $bin_file..."
+    if clang -O2 -o "$bin_file" "$src_file" -w; then
+        print_success "Compiled: $bin_file"
+        rm -f "$src_file"
+        chown "$ORIGINAL_USER:$ORIGINAL_USER" "$bin_file" 2>/dev/null || true
+        chmod 755 "$bin_file" 2>/dev/null || true
+    else
+        print_error "Failed to compile $src_file"
+    fi
+done
 # -----------------------------------------------------
 
 print_step "[8/8] Setting ownership and permissions..."
-chown -R "$ORIGINAL_USER:$ORIGINAL_USER" "$SERVER_BINARY" "server_manager.sh" "rank_manager.sh" "patches" 2>/dev/null || true
+chown -R "$ORIGINAL_USER:$ORIGINAL_USER" "$SERVER_BINARY" "server_manager.sh" "rank_manager.sh" "patches" "tools" 2>/dev/null || true
 chmod 755 "$SERVER_BINARY" "server_manager.sh" "rank_manager.sh" 2>/dev/null || true
 chmod -R 755 "patches" 2>/dev/null || true
 
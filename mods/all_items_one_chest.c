@@ -1,6 +1,7 @@
 //Command: /godchest (then place an empty wood chest)
 
 #define _GNU_SOURCE
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -25,26 +26,36 @@
 // --- IMPS ---
 typedef id (*ZOD_Alloc)(id, SEL);
 typedef id (*ZOD_Init)(id, SEL);
-typedef id (*ZOD_InitCap)(id, SEL, unsigned long);
 typedef id (*ZOD_InitItem)(id, SEL, int, uint16_t, uint16_t, id, id);
-typedef void (*ZOD_AddObj)(id, SEL, id);
+typedef id (*ZOD_InitObjs)(id, SEL, id*, unsigned long);
 typedef void (*ZOD_Release)(id, SEL);
 typedef void (*ZOD_Drain)(id, SEL);
-typedef id (*ZOD_String)(id, SEL, const char*);
 typedef const char* (*ZOD_Utf8)(id, SEL);
 typedef void (*ZOD_Void)(id, SEL);
 
 // Hooks
 typedef id (*ZOD_Place_IMP)(id, SEL, id, id, long long, id, id, unsigned char, id, id, id);
 typedef id (*ZOD_Cmd_IMP)(id, SEL, id, id);
-typedef void (*ZOD_Chat_IMP)(id, SEL, id, BOOL, id);
+typedef void (*ZOD_Send_IMP)(id, id, const char*, bool);
 
 // --- GLOBALS ---
 static ZOD_Place_IMP ZOD_Real_Place = NULL;
 static ZOD_Cmd_IMP   ZOD_Real_Cmd = NULL;
-static ZOD_Chat_IMP  ZOD_Real_Chat = NULL;
+static ZOD_Send_IMP ZOD_Send = NULL; // BHChat_Send, chat_queue.c
 static bool          ZOD_Active = false;
 
+// --- ITEM FACTORY ---
+// IMPs resolved once; arrays are created already filled (initWithObjects:count:)
+static struct {
+    bool ready;
+    Class clsItem, clsArr, arrCls;
+    SEL sAlloc, sInitItem, sInitObjs;
+    ZOD_Alloc fItemAlloc, fArrAlloc;
+    ZOD_InitItem fInitItem;
+    ZOD_InitObjs fInitObjs;
+    unsigned long allocs;          // Objects created by the last fill
+} g_ZOD_F;
+
 // --- MEMORY HELPERS ---
 static void ZOD_ReleaseObj(id obj) {
     if (!obj) return;
@@ -72,13 +83,6 @@ static void ZOD_DrainPool(id pool) {
     if (f) f(pool, s);
 }
 
-static id ZOD_Str(const char* t) {
-    Class cls = objc_getClass("NSString");
-    SEL s = sel_registerName("stringWithUTF8String:");
-    ZOD_String f = (ZOD_String)method_getImplementation(class_getClassMethod(cls, s));
-    return f((id)cls, s, t);
-}
-
 static const char* ZOD_CStr(id str) {
     if (!str) return "";
     SEL s = sel_registerName("UTF8String");
@@ -86,52 +90,64 @@ static const char* ZOD_CStr(id str) {
     return f ? f(str, s) : "";
 }
 
-static void ZOD_Msg(id srv, const char* msg) {
-    if (srv && ZOD_Real_Chat) {
-        ZOD_Real_Chat(srv, sel_registerName("sendChatMessage:displayNotification:sendToClients:"), ZOD_Str(msg), true, nil);
-    }
+static void ZOD_Msg(id srv, id client, const char* msg) {
+    if (ZOD_Send) ZOD_Send(srv, client, msg, true);
+    else printf("%s\n", msg);
 }
 
 // --- LOGIC ---
+static bool ZOD_FactoryInit() {
+    if (g_ZOD_F.ready) return true;
+    g_ZOD_F.clsItem = objc_getClass(ZOD_ITEM_CLASS);
+    g_ZOD_F.clsArr = objc_getClass(ZOD_ARRAY_CLASS);
+    if (!g_ZOD_F.clsItem || !g_ZOD_F.clsArr) return false;
+    g_ZOD_F.sAlloc = sel_registerName("alloc");
+    g_ZOD_F.sInitItem = sel_registerName("initWithType:dataA:dataB:subItems:dynamicObjectSaveDict:");
+    g_ZOD_F.sInitObjs = sel_registerName("initWithObjects:count:");
+    g_ZOD_F.fItemAlloc = (ZOD_Alloc)method_getImplementation(class_getClassMethod(g_ZOD_F.clsItem, g_ZOD_F.sAlloc));
+    g_ZOD_F.fArrAlloc = (ZOD_Alloc)method_getImplementation(class_getClassMethod(g_ZOD_F.clsArr, g_ZOD_F.sAlloc));
+    g_ZOD_F.fInitItem = (ZOD_InitItem)method_getImplementation(class_getInstanceMethod(g_ZOD_F.clsItem, g_ZOD_F.sInitItem));
+    g_ZOD_F.ready = g_ZOD_F.fItemAlloc && g_ZOD_F.fArrAlloc && g_ZOD_F.fInitItem;
+    return g_ZOD_F.ready;
+}
+
 id ZOD_NewItem(int type) {
-    Class cls = objc_getClass(ZOD_ITEM_CLASS);
-    SEL sAlloc = sel_registerName("alloc");
-    SEL sInit = sel_registerName("initWithType:dataA:dataB:subItems:dynamicObjectSaveDict:");
-    ZOD_Alloc fA = (ZOD_Alloc)method_getImplementation(class_getClassMethod(cls, sAlloc));
-    ZOD_InitItem fI = (ZOD_InitItem)method_getImplementation(class_getInstanceMethod(cls, sInit));
-    return fI(fA((id)cls, sAlloc), sInit, type, 0, 0, nil, nil);
+    g_ZOD_F.allocs++;
+    return g_ZOD_F.fInitItem(g_ZOD_F.fItemAlloc((id)g_ZOD_F.clsItem, g_ZOD_F.sAlloc), g_ZOD_F.sInitItem, type, 0, 0, nil, nil);
 }
 
-id ZOD_NewArray(int cap) {
-    Class cls = objc_getClass(ZOD_ARRAY_CLASS);
-    SEL sAlloc = sel_registerName("alloc");
-    SEL sInit = sel_registerName("initWithCapacity:");
-    ZOD_Alloc fA = (ZOD_Alloc)method_getImplementation(class_getClassMethod(cls, sAlloc));
-    ZOD_InitCap fI = (ZOD_InitCap)method_getImplementation(class_getInstanceMethod(cls, sInit));
-    return fI(fA((id)cls, sAlloc), sInit, cap);
+// alloc may hand back a placeholder of another class; its init IMP is cached per class
+id ZOD_NewArrayWith(id* objs, int count) {
+    id arr = g_ZOD_F.fArrAlloc((id)g_ZOD_F.clsArr, g_ZOD_F.sAlloc);
+    if (!arr) return nil;
+    if (object_getClass(arr) != g_ZOD_F.arrCls) {
+        g_ZOD_F.arrCls = object_getClass(arr);
+        g_ZOD_F.fInitObjs = (ZOD_InitObjs)class_getMethodImplementation(g_ZOD_F.arrCls, g_ZOD_F.sInitObjs);
+    }
+    g_ZOD_F.allocs++;
+    return g_ZOD_F.fInitObjs(arr, g_ZOD_F.sInitObjs, objs, (unsigned long)count);
 }
 
 id ZOD_GenInventory() {
-    id mainInv = ZOD_NewArray(ZOD_SLOTS_MAX);
-    SEL sAdd = sel_registerName("addObject:");
-    ZOD_AddObj fAdd = (ZOD_AddObj)method_getImplementation(class_getInstanceMethod(object_getClass(mainInv), sAdd));
-
+    id slots[ZOD_SLOTS_MAX];
+    id items[ZOD_ITEMS_PER_SLOT];
     int cID = ZOD_START_ID;
+    int slotCount = 0;
 
     for (int i = 0; i < ZOD_SLOTS_MAX; i++) {
-        id slot = ZOD_NewArray(ZOD_ITEMS_PER_SLOT);
-        ZOD_AddObj fSlotAdd = (ZOD_AddObj)method_getImplementation(class_getInstanceMethod(object_getClass(slot), sAdd));
-
+        int n = 0;
         for (int k = 0; k < ZOD_ITEMS_PER_SLOT; k++) {
+            // Items are mutable: every slot of every chest gets its own
             id item = ZOD_NewItem(cID++);
-            if (item) {
-                fSlotAdd(slot, sAdd, item);
-                ZOD_ReleaseObj(item);
-            }
+            if (item) items[n++] = item;
         }
-        fAdd(mainInv, sAdd, slot);
-        ZOD_ReleaseObj(slot);
+        id slot = ZOD_NewArrayWith(items, n);
+        if (slot) slots[slotCount++] = slot;
+        for (int k = 0; k < n; k++) ZOD_ReleaseObj(items[k]);
     }
+
+    id mainInv = ZOD_NewArrayWith(slots, slotCount);
+    for (int i = 0; i < slotCount; i++) ZOD_ReleaseObj(slots[i]);
     return mainInv;
 }
 
@@ -142,7 +158,8 @@ id ZOD_Place(id self, SEL _cmd, id w, id dw, long long pos, id cache, id item, u
     if (ZOD_Active && chest) {
         id pool = ZOD_Pool();
         Ivar iv = class_getInstanceVariable(object_getClass(chest), "inventoryItems");
-        if (iv) {
+        if (iv && ZOD_FactoryInit()) {
+            g_ZOD_F.allocs = 0;
             id* ptr = (id*)((char*)chest + ivar_getOffset(iv));
             if (*ptr) ZOD_ReleaseObj(*ptr);
             *ptr = ZOD_GenInventory();
@@ -153,6 +170,8 @@ id ZOD_Place(id self, SEL _cmd, id w, id dw, long long pos, id cache, id item, u
                 ZOD_Void fUp = (ZOD_Void)method_getImplementation(mUp);
                 fUp(chest, sUp);
             }
+            printf("[GODCHEST] Chest filled: %lu objects allocated (%d with one object per item and array)\n",
+                   g_ZOD_F.allocs, 1 + ZOD_SLOTS_MAX * (1 + ZOD_ITEMS_PER_SLOT));
         }
         ZOD_DrainPool(pool);
     }
@@ -163,7 +182,7 @@ id ZOD_Cmd(id self, SEL _cmd, id cmdStr, id client) {
     const char* t = ZOD_CStr(cmdStr);
     if (t && strcasecmp(t, "/godchest") == 0) {
         ZOD_Active = !ZOD_Active;
-        ZOD_Msg(self, ZOD_Active ? "[GODCHEST] ON" : "[GODCHEST] OFF");
+        ZOD_Msg(self, client, ZOD_Active ? "[GODCHEST] ON" : "[GODCHEST] OFF");
         return nil;
     }
     return ZOD_Real_Cmd(self, _cmd, cmdStr, client);
@@ -179,8 +198,7 @@ static void* ZOD_Loader(void* arg) {
         ZOD_Real_Cmd = (ZOD_Cmd_IMP)method_getImplementation(class_getInstanceMethod(srv, sC));
         method_setImplementation(class_getInstanceMethod(srv, sC), (IMP)ZOD_Cmd);
         
-        SEL sM = sel_registerName("sendChatMessage:displayNotification:sendToClients:");
-        ZOD_Real_Chat = (ZOD_Chat_IMP)method_getImplementation(class_getInstanceMethod(srv, sM));
+        ZOD_Send = (ZOD_Send_IMP)dlsym(RTLD_DEFAULT, "BHChat_Send");
         
         SEL sP = sel_registerName("initWithWorld:dynamicWorld:atPosition:cache:item:flipped:saveDict:placedByClient:clientName:");
         ZOD_Real_Place = (ZOD_Place_IMP)method_getImplementation(class_getInstanceMethod(cht, sP));
@@ -41,17 +41,18 @@ struct RbTree_Impl {
 };
 
 // --- TYPE DEFINITIONS ---
-typedef id (*IMP_Str)(id, SEL, const char*);
 typedef const char* (*IMP_Utf8)(id, SEL);
 typedef void (*IMP_SetBool)(id, SEL, BOOL);
 typedef id (*IMP_Cmd)(id, SEL, id, id);
-typedef void (*IMP_Msg)(id, SEL, id, BOOL, id);
 typedef void (*IMP_Drop)(id, SEL, id);
+typedef void (*IMP_Event)(const char*, const char*, ...);
+typedef void (*IMP_Send)(id, id, const char*, bool);
 
 // --- GLOBAL STATE ---
 static IMP_Cmd  Real_HandleCommand = NULL;
-static IMP_Msg  Real_SendChat = NULL;
 static IMP_Drop Real_ClientDrop = NULL;
+static IMP_Event BH_Event = NULL; // event_log.c, when loaded
+static IMP_Send BH_Send = NULL; // BHChat_Send, chat_queue.c
 static bool     g_DropBanEnabled = false;
 
 // --- UTILITIES ---
@@ -62,14 +63,6 @@ static bool BH_IsValidPtr(void* ptr) {
     return (addr > 0x400000 && addr < 0x7fffffffffff && (addr % 8 == 0));
 }
 
-static id BH_CreateNSString(const char* cStr) {
-    if (!cStr) return nil;
-    Class cls = objc_getClass("NSString");
-    SEL s = sel_registerName("stringWithUTF8String:");
-    IMP_Str f = (IMP_Str)method_getImplementation(class_getClassMethod(cls, s));
-    return f ? f((id)cls, s, cStr) : nil;
-}
-
 static const char* BH_GetCString(id nsStr) {
     if (!nsStr) return "";
     SEL s = sel_registerName("UTF8String");
@@ -77,14 +70,9 @@ static const char* BH_GetCString(id nsStr) {
     return f ? f(nsStr, s) : "";
 }
 
-static void BH_Reply(id server, const char* msg) {
-    if (server && Real_SendChat) {
-        Real_SendChat(server, 
-                      sel_registerName("sendChatMessage:displayNotification:sendToClients:"), 
-                      BH_CreateNSString(msg), 
-                      true, 
-                      nil);
-    }
+static void BH_Reply(id server, id client, const char* msg) {
+    if (BH_Send) BH_Send(server, client, msg, true);
+    else printf("%s\n", msg);
 }
 
 // Retrieves IVAR value directly by offset, bypassing missing property getters
@@ -190,10 +178,11 @@ id Hook_HandleCommand(id self, SEL _cmd, id cmdStr, id client) {
             char msg[64];
             if (count >= 0) {
                 snprintf(msg, sizeof(msg), "[Admin] Cleaned %d items.", count);
+                if (BH_Event) BH_Event("drop_cleanup", "i", "removed", (long long)count);
             } else {
                 snprintf(msg, sizeof(msg), "[Admin] Error: Failed to access world data.");
             }
-            BH_Reply(self, msg);
+            BH_Reply(self, client, msg);
             return nil; // Consume command
         }
         
@@ -201,7 +190,7 @@ id Hook_HandleCommand(id self, SEL _cmd, id cmdStr, id client) {
             g_DropBanEnabled = !g_DropBanEnabled;
             char msg[64];
             snprintf(msg, sizeof(msg), "[Admin] Drop Ban: %s", g_DropBanEnabled ? "ENABLED" : "DISABLED");
-            BH_Reply(self, msg);
+            BH_Reply(self, client, msg);
             return nil; // Consume command
         }
     }
@@ -214,6 +203,8 @@ id Hook_HandleCommand(id self, SEL _cmd, id cmdStr, id client) {
 static void* BH_LoaderThread(void* arg) {
     // Wait for Objective-C Runtime to be fully initialized
     sleep(3);
+    BH_Event = (IMP_Event)dlsym(RTLD_DEFAULT, "BHEvent_Emit");
+    BH_Send = (IMP_Send)dlsym(RTLD_DEFAULT, "BHChat_Send");
     
     Class clsServer = objc_getClass(CLASS_SERVER);
     Class clsDynWorld = objc_getClass(CLASS_DYNWORLD);
@@ -226,13 +217,6 @@ static void* BH_LoaderThread(void* arg) {
             Real_HandleCommand = (IMP_Cmd)method_getImplementation(mCmd);
             method_setImplementation(mCmd, (IMP)Hook_HandleCommand);
         }
-
-        // Cache Send Message IMP
-        SEL sMsg = sel_registerName("sendChatMessage:displayNotification:sendToClients:");
-        Method mMsg = class_getInstanceMethod(clsServer, sMsg);
-        if (mMsg) {
-            Real_SendChat = (IMP_Msg)method_getImplementation(mMsg);
-        }
     }
 
     if (clsDynWorld) {
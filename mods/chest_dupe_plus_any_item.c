@@ -19,7 +19,8 @@
 
 // --- IMP TYPES ---
 typedef id (*ISP_CmdFunc)(id, SEL, id, id);
-typedef void (*ISP_ChatFunc)(id, SEL, id, BOOL, id);
+typedef void (*ISP_SendFunc)(id, id, const char*, bool);
+typedef id (*ISP_FindFunc)(const char*);
 typedef id (*ISP_PlaceFunc)(id, SEL, id, id, long long, id, id, unsigned char, id, id, id);
 typedef id (*ISP_SpawnFunc)(id, SEL, long long, int, int, int, id, id, BOOL, BOOL, id);
 
@@ -37,7 +38,8 @@ typedef long (*ISP_CompFunc)(id, SEL, id);
 
 // --- GLOBALS ---
 static ISP_CmdFunc   Real_ISP_HandleCmd = NULL;
-static ISP_ChatFunc  Real_ISP_SendChat = NULL;
+static ISP_SendFunc ISP_Send = NULL; // BHChat_Send, chat_queue.c
+static ISP_FindFunc ISP_FindByName = NULL; // player_registry.c, when loaded
 static ISP_PlaceFunc Real_ISP_ChestPlace = NULL;
 
 static bool g_ISP_DupeEnabled = false;
@@ -75,15 +77,17 @@ static const char* ISP_CStr(id str) {
     return f ? f(str, s) : "";
 }
 
-static void ISP_Chat(id server, const char* msg) {
-    if (server && Real_ISP_SendChat) {
-        Real_ISP_SendChat(server, sel_registerName("sendChatMessage:displayNotification:sendToClients:"), ISP_Str(msg), true, nil);
-    }
+static void ISP_Chat(id server, id client, const char* msg) {
+    if (ISP_Send) ISP_Send(server, client, msg, true);
+    else printf("%s\n", msg);
 }
 
 // --- LOGIC: FIND PLAYER (ClientName) ---
 id ISP_FindBlockhead(id dynWorld, const char* name) {
     if (!dynWorld || !name) return nil;
+    // nil may just mean the blockhead has not updated yet: scan the list
+    id found = ISP_FindByName ? ISP_FindByName(name) : nil;
+    if (found) return found;
     Ivar iv = class_getInstanceVariable(object_getClass(dynWorld), "netBlockheads");
     if (!iv) return nil;
     id list = *(id*)((char*)dynWorld + ivar_getOffset(iv));
@@ -228,7 +232,7 @@ id Hook_ISP_Cmd(id self, SEL _cmd, id cmdStr, id client) {
     if (world) object_getInstanceVariable(world, "dynamicWorld", (void**)&dynWorld);
 
     if (!dynWorld) {
-        ISP_Chat(self, "[Error] World not initialized.");
+        ISP_Chat(self, client, "[Error] World not initialized.");
         ISP_Drain(pool);
         return nil;
     }
@@ -251,7 +255,7 @@ id Hook_ISP_Cmd(id self, SEL _cmd, id cmdStr, id client) {
         
         char msg[128];
         snprintf(msg, 128, "[Dupe] %s. (Get 1 Original + %d Copies)", g_ISP_DupeEnabled ? "ON" : "OFF", g_ISP_DupeCount);
-        ISP_Chat(self, msg);
+        ISP_Chat(self, client, msg);
         ISP_Drain(pool);
         return nil;
     }
@@ -263,7 +267,7 @@ id Hook_ISP_Cmd(id self, SEL _cmd, id cmdStr, id client) {
     char *sForce = strtok_r(NULL, " ", &saveptr);
 
     if (!sID || !sPlayer) {
-        ISP_Chat(self, "[Usage] /item <ID> <QTY> <CLIENT_NAME> [force]");
+        ISP_Chat(self, client, "[Usage] /item <ID> <QTY> <CLIENT_NAME> [force]");
         ISP_Drain(pool);
         return nil;
     }
@@ -272,7 +276,7 @@ id Hook_ISP_Cmd(id self, SEL _cmd, id cmdStr, id client) {
     if (!targetBH) {
         char err[128];
         snprintf(err, 128, "[Error] Client '%s' not found.", sPlayer);
-        ISP_Chat(self, err);
+        ISP_Chat(self, client, err);
         ISP_Drain(pool);
         return nil;
     }
@@ -283,7 +287,7 @@ id Hook_ISP_Cmd(id self, SEL _cmd, id cmdStr, id client) {
     bool force = (sForce && strcasecmp(sForce, "force") == 0);
     if (!force && qty > 99) {
         qty = 99;
-        ISP_Chat(self, "[Warn] Capped at 99. Use 'force' to override.");
+        ISP_Chat(self, client, "[Warn] Capped at 99. Use 'force' to override.");
     }
 
     int itemID = atoi(sID);
@@ -293,7 +297,7 @@ id Hook_ISP_Cmd(id self, SEL _cmd, id cmdStr, id client) {
     
     char successMsg[128];
     snprintf(successMsg, 128, "[System] Gave %d x (ID: %d) to %s.", qty, itemID, sPlayer);
-    ISP_Chat(self, successMsg);
+    ISP_Chat(self, client, successMsg);
 
     ISP_Drain(pool);
     return nil;
@@ -307,8 +311,8 @@ static void* ISP_Init(void* arg) {
         Method mC = class_getInstanceMethod(clsServer, sel_registerName("handleCommand:issueClient:"));
         Real_ISP_HandleCmd = (ISP_CmdFunc)method_getImplementation(mC);
         method_setImplementation(mC, (IMP)Hook_ISP_Cmd);
-        Method mT = class_getInstanceMethod(clsServer, sel_registerName("sendChatMessage:displayNotification:sendToClients:"));
-        Real_ISP_SendChat = (ISP_ChatFunc)method_getImplementation(mT);
+        ISP_Send = (ISP_SendFunc)dlsym(RTLD_DEFAULT, "BHChat_Send");
+        ISP_FindByName = (ISP_FindFunc)dlsym(RTLD_DEFAULT, "BHPlayer_FindByName");
     }
     Class clsChest = objc_getClass(ISP_CHEST_CLASS);
     if (clsChest) {
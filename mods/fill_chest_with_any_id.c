@@ -22,21 +22,22 @@
 #define CF_ITEM_CLASS     "InventoryItem"
 #define CF_ARRAY_CLASS    "NSMutableArray"
 #define CF_BASKET_ID      12  // Basket ID used to fill the chest slots
+#define CF_SLOTS          16  // Chest slots, one basket each
+#define CF_BASKET_SLOTS   4
+#define CF_STACK          99
 
 // --- IMP DEFINITIONS (GNUstep Compatibility) ---
 // Method signatures mapped to function pointers for strict typing
 typedef id (*CF_PlaceFunc)(id, SEL, id, id, long long, id, id, unsigned char, id, id, id);
 typedef id (*CF_CmdFunc)(id, SEL, id, id);
-typedef void (*CF_ChatFunc)(id, SEL, id, BOOL, id);
+typedef void (*CF_SendFunc)(id, id, const char*, bool);
 
 // Memory & Object Accessors
 typedef id (*CF_AllocFunc)(id, SEL);
-typedef id (*CF_InitArrFunc)(id, SEL, unsigned long);
 typedef id (*CF_InitItemFunc)(id, SEL, int, uint16_t, uint16_t, id, id);
-typedef void (*CF_AddObjFunc)(id, SEL, id);
+typedef id (*CF_InitObjsFunc)(id, SEL, id*, unsigned long);
 typedef void (*CF_RelFunc)(id, SEL);
 typedef void (*CF_VoidFunc)(id, SEL);
-typedef id (*CF_StrFunc)(id, SEL, const char*);
 typedef const char* (*CF_Utf8Func)(id, SEL);
 
 // Getters for Item Properties
@@ -48,7 +49,7 @@ typedef id (*CF_IdxFunc)(id, SEL, int);
 // --- GLOBAL STATE ---
 static CF_PlaceFunc Real_CFill_Place = NULL;
 static CF_CmdFunc   Real_CFill_Cmd = NULL;
-static CF_ChatFunc  Real_CFill_Chat = NULL;
+static CF_SendFunc CFill_Send = NULL; // BHChat_Send, chat_queue.c
 
 // Logic Flags
 static bool g_CFill_Active = false;      // Mode: Manual ID Fill
@@ -63,6 +64,17 @@ static int  g_CFill_DataB = 0;
 // Used to send disable notification from Place hook
 static id g_ServerInstance = nil; 
 
+// Item factory: IMPs resolved once, arrays created already filled
+static struct {
+    bool ready;
+    Class clsItem, clsArr, arrCls;
+    SEL sAlloc, sInitItem, sInitObjs;
+    CF_AllocFunc fItemAlloc, fArrAlloc;
+    CF_InitItemFunc fInitItem;
+    CF_InitObjsFunc fInitObjs;
+    unsigned long allocs;   // Objects created by the last fill
+} g_CFill_F;
+
 // --- UTILITIES ---
 
 static void CFill_Release(id obj) {
@@ -88,14 +100,6 @@ static void CFill_Drain(id pool) {
     f(pool, s);
 }
 
-static id CFill_Str(const char* txt) {
-    if (!txt) return nil;
-    Class cls = objc_getClass("NSString");
-    SEL s = sel_registerName("stringWithUTF8String:");
-    CF_StrFunc f = (CF_StrFunc)method_getImplementation(class_getClassMethod(cls, s));
-    return f ? f((id)cls, s, txt) : nil;
-}
-
 static const char* CFill_CStr(id str) {
     if (!str) return "";
     SEL s = sel_registerName("UTF8String");
@@ -103,95 +107,91 @@ static const char* CFill_CStr(id str) {
     return f ? f(str, s) : "";
 }
 
-static void CFill_Msg(id server, const char* msg) {
-    if (server && Real_CFill_Chat) {
-        Real_CFill_Chat(server, sel_registerName("sendChatMessage:displayNotification:sendToClients:"), CFill_Str(msg), true, nil);
-    }
+static void CFill_Msg(id server, id client, const char* msg) {
+    if (CFill_Send) CFill_Send(server, client, msg, true);
+    else printf("%s\n", msg);
 }
 
 // --- OBJECT CREATION HELPERS ---
 
-id CFill_CreateArray(int cap) {
-    Class clsArr = objc_getClass(CF_ARRAY_CLASS);
-    SEL sAlloc = sel_registerName("alloc");
-    SEL sInit = sel_registerName("initWithCapacity:");
-    
-    CF_AllocFunc fAlloc = (CF_AllocFunc)method_getImplementation(class_getClassMethod(clsArr, sAlloc));
-    CF_InitArrFunc fInit = (CF_InitArrFunc)method_getImplementation(class_getInstanceMethod(clsArr, sInit));
-    
-    id arr = fAlloc((id)clsArr, sAlloc);
-    return fInit(arr, sInit, cap);
+static bool CFill_FactoryInit() {
+    if (g_CFill_F.ready) return true;
+    g_CFill_F.clsItem = objc_getClass(CF_ITEM_CLASS);
+    g_CFill_F.clsArr = objc_getClass(CF_ARRAY_CLASS);
+    if (!g_CFill_F.clsItem || !g_CFill_F.clsArr) return false;
+    g_CFill_F.sAlloc = sel_registerName("alloc");
+    g_CFill_F.sInitItem = sel_registerName("initWithType:dataA:dataB:subItems:dynamicObjectSaveDict:");
+    g_CFill_F.sInitObjs = sel_registerName("initWithObjects:count:");
+    g_CFill_F.fItemAlloc = (CF_AllocFunc)method_getImplementation(class_getClassMethod(g_CFill_F.clsItem, g_CFill_F.sAlloc));
+    g_CFill_F.fArrAlloc = (CF_AllocFunc)method_getImplementation(class_getClassMethod(g_CFill_F.clsArr, g_CFill_F.sAlloc));
+    g_CFill_F.fInitItem = (CF_InitItemFunc)method_getImplementation(class_getInstanceMethod(g_CFill_F.clsItem, g_CFill_F.sInitItem));
+    g_CFill_F.ready = g_CFill_F.fItemAlloc && g_CFill_F.fArrAlloc && g_CFill_F.fInitItem;
+    return g_CFill_F.ready;
+}
+
+// alloc may return a placeholder of another class; its init IMP is cached per class
+id CFill_CreateArray(id* objs, int count) {
+    id arr = g_CFill_F.fArrAlloc((id)g_CFill_F.clsArr, g_CFill_F.sAlloc);
+    if (!arr) return nil;
+    if (object_getClass(arr) != g_CFill_F.arrCls) {
+        g_CFill_F.arrCls = object_getClass(arr);
+        g_CFill_F.fInitObjs = (CF_InitObjsFunc)class_getMethodImplementation(g_CFill_F.arrCls, g_CFill_F.sInitObjs);
+    }
+    g_CFill_F.allocs++;
+    return g_CFill_F.fInitObjs(arr, g_CFill_F.sInitObjs, objs, (unsigned long)count);
 }
 
 id CFill_CreateItem(int type, int dA, int dB, id subItems, id saveDict) {
-    Class clsItem = objc_getClass(CF_ITEM_CLASS);
-    SEL sAlloc = sel_registerName("alloc");
-    SEL sInit = sel_registerName("initWithType:dataA:dataB:subItems:dynamicObjectSaveDict:");
-    
-    CF_AllocFunc fAlloc = (CF_AllocFunc)method_getImplementation(class_getClassMethod(clsItem, sAlloc));
-    CF_InitItemFunc fInit = (CF_InitItemFunc)method_getImplementation(class_getInstanceMethod(clsItem, sInit));
-    
-    id item = fAlloc((id)clsItem, sAlloc);
-    return fInit(item, sInit, type, (uint16_t)dA, (uint16_t)dB, subItems, saveDict);
+    id item = g_CFill_F.fItemAlloc((id)g_CFill_F.clsItem, g_CFill_F.sAlloc);
+    g_CFill_F.allocs++;
+    return g_CFill_F.fInitItem(item, g_CFill_F.sInitItem, type, (uint16_t)dA, (uint16_t)dB, subItems, saveDict);
 }
 
 // --- GENERATION LOGIC ---
 
+// One stack of CF_STACK items. Items are mutable, so each one is its own object.
+static id CFill_CreateStack(int itemID, int dA, int dB, id sourceSubItems, id sourceSaveDict) {
+    id items[CF_STACK];
+    int n = 0;
+    for (int k = 0; k < CF_STACK; k++) {
+        id item = CFill_CreateItem(itemID, dA, dB, sourceSubItems, sourceSaveDict);
+        if (item) items[n++] = item;
+    }
+    id stack = CFill_CreateArray(items, n);
+    for (int k = 0; k < n; k++) CFill_Release(items[k]);
+    return stack;
+}
+
 // This function creates a full inventory (16 slots) filled with Baskets, which are filled with 99x of the Target Item.
 id CFill_GenerateFullInventory(int itemID, int dA, int dB, id sourceSubItems, id sourceSaveDict) {
-    id mainArr = CFill_CreateArray(16);
-    if (!mainArr) return nil;
+    if (!CFill_FactoryInit()) return nil;
 
-    SEL sAdd = sel_registerName("addObject:");
-    Method mAdd = class_getInstanceMethod(object_getClass(mainArr), sAdd);
-    CF_AddObjFunc fAdd = (CF_AddObjFunc)method_getImplementation(mAdd);
-    
-    for(int i=0; i<16; i++) {
-        // 1. Create Basket SubItems container
-        id basketSubItems = CFill_CreateArray(4);
-        
-        for(int j=0; j<4; j++) {
-            // 2. Create the Slot Array (Stack of 99)
-            id slotArr = CFill_CreateArray(99); 
-            Method mSlotAdd = class_getInstanceMethod(object_getClass(slotArr), sAdd);
-            CF_AddObjFunc fSlotAdd = (CF_AddObjFunc)method_getImplementation(mSlotAdd);
-            
-            // 3. Create the base item content (The item to dupe)
-            // Note: We create a fresh instance for the first one to establish the base
-            id content = CFill_CreateItem(itemID, dA, dB, sourceSubItems, sourceSaveDict);
-            
-            if (content) {
-                fSlotAdd(slotArr, sAdd, content); // Add index 0
-                
-                // 4. Fill the rest of the stack (98 more)
-                // We create new instances for each to ensure independent memory pointers for saveDicts if needed
-                for(int k=0; k<98; k++) {
-                     id copy = CFill_CreateItem(itemID, dA, dB, sourceSubItems, sourceSaveDict);
-                     fSlotAdd(slotArr, sAdd, copy);
-                     CFill_Release(copy);
-                }
-                CFill_Release(content); 
-            }
-            
-            // Add slot to basket
-            fAdd(basketSubItems, sAdd, slotArr);
-            CFill_Release(slotArr);
+    id chestSlots[CF_SLOTS];
+    int slotCount = 0;
+    for (int i = 0; i < CF_SLOTS; i++) {
+        // 1. Basket contents: CF_BASKET_SLOTS stacks of the target item
+        id stacks[CF_BASKET_SLOTS];
+        int stackCount = 0;
+        for (int j = 0; j < CF_BASKET_SLOTS; j++) {
+            id stack = CFill_CreateStack(itemID, dA, dB, sourceSubItems, sourceSaveDict);
+            if (stack) stacks[stackCount++] = stack;
         }
-        
-        // 5. Create the Basket Item containing the filled subitems
+        id basketSubItems = CFill_CreateArray(stacks, stackCount);
+        for (int j = 0; j < stackCount; j++) CFill_Release(stacks[j]);
+
+        // 2. The basket itself (each basket owns its contents, never shared)
         id basket = CFill_CreateItem(CF_BASKET_ID, 0, 0, basketSubItems, nil);
         CFill_Release(basketSubItems);
-        
-        // 6. Create the Chest Slot (Stack of 1 Basket)
-        id chestSlot = CFill_CreateArray(1);
-        fAdd(chestSlot, sAdd, basket);
+        if (!basket) continue;
+
+        // 3. Chest slot: stack of 1 basket
+        id chestSlot = CFill_CreateArray(&basket, 1);
         CFill_Release(basket);
-        
-        // 7. Add to Chest Inventory
-        fAdd(mainArr, sAdd, chestSlot);
-        CFill_Release(chestSlot);
+        if (chestSlot) chestSlots[slotCount++] = chestSlot;
     }
-    
+
+    id mainArr = CFill_CreateArray(chestSlots, slotCount);
+    for (int i = 0; i < slotCount; i++) CFill_Release(chestSlots[i]);
     return mainArr;
 }
 
@@ -266,6 +266,7 @@ id Hook_CFill_Place(id self, SEL _cmd, id w, id dw, long long pos, id cache, id
         Ivar ivInv = class_getInstanceVariable(object_getClass(chestObj), "inventoryItems");
         if (ivInv) {
             id newInv = nil;
+            g_CFill_F.allocs = 0;
             
             if (g_Clone_Active) {
                 // Read from the chest itself (which contains the item placed by user)
@@ -287,6 +288,8 @@ id Hook_CFill_Place(id self, SEL _cmd, id w, id dw, long long pos, id cache, id
                     CF_VoidFunc fUp = (CF_VoidFunc)method_getImplementation(class_getInstanceMethod(object_getClass(chestObj), sUp));
                     fUp(chestObj, sUp);
                 }
+                printf("[Fill] Chest filled: %lu objects allocated (%d with one object per item and array)\n",
+                       g_CFill_F.allocs, 1 + CF_SLOTS * (3 + CF_BASKET_SLOTS * (1 + CF_STACK)));
                 success = true;
             }
         }
@@ -297,7 +300,7 @@ id Hook_CFill_Place(id self, SEL _cmd, id w, id dw, long long pos, id cache, id
             g_Clone_Active = false;
             // Optionally notify via global server instance if available
             if (g_ServerInstance) {
-                CFill_Msg(g_ServerInstance, "[System] Auto-disabled for safety. Type command again to reuse.");
+                CFill_Msg(g_ServerInstance, client, "[System] Auto-disabled for safety. Type command again to reuse.");
             }
         }
         
@@ -330,9 +333,9 @@ id Hook_CFill_Cmd(id self, SEL _cmd, id cmdStr, id client) {
             } else {
                 snprintf(msg, 256, "[Clone] ON (SINGLE USE). Will auto-disable after 1 chest. Add 'force' to override.");
             }
-            CFill_Msg(self, msg);
+            CFill_Msg(self, client, msg);
         } else {
-            CFill_Msg(self, "[Clone] OFF.");
+            CFill_Msg(self, client, "[Clone] OFF.");
         }
         
         CFill_Drain(pool);
@@ -353,7 +356,7 @@ id Hook_CFill_Cmd(id self, SEL _cmd, id cmdStr, id client) {
         if (!sID || strcasecmp(sID, "off") == 0) {
             g_CFill_Active = false;
             g_Clone_Active = false;
-            CFill_Msg(self, "[Fill] OFF.");
+            CFill_Msg(self, client, "[Fill] OFF.");
             CFill_Drain(pool);
             return nil;
         }
@@ -389,7 +392,7 @@ id Hook_CFill_Cmd(id self, SEL _cmd, id cmdStr, id client) {
         } else {
             snprintf(msg, 256, "[Fill] ON (SINGLE USE). ID: %d (%d, %d). Will auto-disable.", g_CFill_TargetID, g_CFill_DataA, g_CFill_DataB);
         }
-        CFill_Msg(self, msg);
+        CFill_Msg(self, client, msg);
         
         CFill_Drain(pool);
         return nil;
@@ -409,8 +412,7 @@ static void* CFill_Init(void* arg) {
         Real_CFill_Cmd = (CF_CmdFunc)method_getImplementation(mC);
         method_setImplementation(mC, (IMP)Hook_CFill_Cmd);
         
-        Method mT = class_getInstanceMethod(clsServer, sel_registerName("sendChatMessage:displayNotification:sendToClients:"));
-        Real_CFill_Chat = (CF_ChatFunc)method_getImplementation(mT);
+        CFill_Send = (CF_SendFunc)dlsym(RTLD_DEFAULT, "BHChat_Send");
     } else {
         printf("[Error] BHServer class not found.\n");
     }
@@ -10,14 +10,33 @@
 #include <pthread.h>
 #include <stdbool.h>
 #include <ctype.h>
+#include <stdint.h>
 #include <objc/runtime.h>
 #include <objc/message.h>
 
 #define MS_SERVER_CLASS "BHServer"
+#define MS_GC_CLASS     "GameController"
+#define MS_NPC_CLASS    "NPC"
+#define MS_SYM_TILE_AT  "_Z25tileAtWorldPositionLoadediiP5World"
+
+// --- SPAWN JOBS ---
+// /spawn queues a job; NPCs are created over the following ticks on free
+// tiles around the player instead of all at once on the player's position.
+#define MS_MAX_JOBS         8
+#define MS_TICK_BUDGET      4       // NPCs created per tick, all jobs together
+#define MS_JOB_MAX_QTY      1000    // Hard limit per command, even with 'force'
+#define MS_SEARCH_X         12      // Spot search box around the player (tiles)
+#define MS_SEARCH_Y         6
+#define MS_WATER_SEARCH     2       // Fish/sharks: only tiles right around the player
+#define MS_MAX_SPOTS        256
+#define MS_REGION_TILES     32      // Region = one macro block
+#define MS_REGION_CAP       24      // NPCs per region, 'force' does not lift it
+#define MS_MAX_REGIONS      8
+#define MS_AIR_ID           2
 
 // --- IMP TYPES ---
 typedef id (*MS_CmdFunc)(id, SEL, id, id);
-typedef void (*MS_ChatFunc)(id, SEL, id, BOOL, id);
+typedef void (*MS_ChatSendFunc)(id, id, const char*, bool);
 typedef id (*MS_SpawnFunc)(id, SEL, long long, int, id, BOOL, BOOL, id);
 typedef id (*MS_AllocFunc)(id, SEL);
 typedef id (*MS_InitFunc)(id, SEL);
@@ -30,9 +49,66 @@ typedef id (*MS_IdxFunc)(id, SEL, int);
 typedef id (*MS_GetterFunc)(id, SEL);
 typedef long (*MS_CompFunc)(id, SEL, id);
 typedef void (*MS_VoidFunc)(id, SEL);
+typedef void (*MS_TickFunc)(id, SEL, float, float);
+typedef id (*MS_SendFunc)(id, SEL);
+typedef void* (*MS_TileAtFunc)(int, int, id);
+typedef int (*MS_RegionCountFunc)(int, int);
+typedef id (*MS_FindFunc)(const char*);
+
+// --- MEMORY LAYOUTS (GCC x64, DynamicWorld dynamicObjects) ---
+struct MS_RbNode_Base {
+    unsigned long _color;
+    struct MS_RbNode_Base* _parent;
+    struct MS_RbNode_Base* _left;
+    struct MS_RbNode_Base* _right;
+};
+
+struct MS_RbNode {
+    struct MS_RbNode_Base base;
+    uint64_t key;
+    id value;
+};
+
+struct MS_RbTree_Impl {
+    unsigned long _pad;
+    struct MS_RbNode_Base _header;
+    size_t _node_count;
+};
+
+// Shared by every job touching the region, so concurrent jobs see each other's NPCs
+typedef struct { int rx, ry, count, users; bool fresh; } MS_Region;
+
+typedef struct {
+    bool         active;
+    id           server;                // Retained
+    id           client;                // Retained
+    id           dynWorld;              // Retained
+    id           dict;                  // Retained breed dict (or nil)
+    MS_SpawnFunc fLoad;
+    SEL          sLoad;
+    int          mobID, breed;
+    bool         baby;
+    int          total, remaining, spawned, skipped;
+    long long    spots[MS_MAX_SPOTS];   // Packed positions, nearest first
+    int          spotCount, next;
+    MS_Region*   regions[MS_MAX_REGIONS]; // Entries of g_MSpawn_Regions
+    int          regionCount;
+    char         mob[32];
+    char         player[64];
+} MS_Job;
 
 static MS_CmdFunc  Real_MSpawn_Cmd = NULL;
-static MS_ChatFunc Real_MSpawn_Chat = NULL;
+static MS_ChatSendFunc MSpawn_ChatSend = NULL; // BHChat_Send, chat_queue.c
+static MS_TickFunc Real_MSpawn_Tick = NULL;
+static MS_TileAtFunc MSpawn_TileAt = NULL;
+static MS_RegionCountFunc MSpawn_RegionCount = NULL; // npc_census.c, when loaded
+static MS_FindFunc MSpawn_FindByName = NULL; // player_registry.c, when loaded
+
+// Main thread only (command hook and tick hook)
+static MS_Job g_MSpawn_Jobs[MS_MAX_JOBS];
+static MS_Region g_MSpawn_Regions[MS_MAX_JOBS * MS_MAX_REGIONS];
+static int    g_MSpawn_ActiveJobs = 0;
+static ptrdiff_t g_MSpawn_NpcPosOff = -1;
 
 // --- UTILS ---
 static id MSpawn_Pool() {
@@ -66,10 +142,9 @@ static const char* MSpawn_CStr(id str) {
     return f ? f(str, s) : "";
 }
 
-static void MSpawn_Chat(id server, const char* msg) {
-    if (server && Real_MSpawn_Chat) {
-        Real_MSpawn_Chat(server, sel_registerName("sendChatMessage:displayNotification:sendToClients:"), MSpawn_Str(msg), true, nil);
-    }
+static void MSpawn_Chat(id server, id client, const char* msg) {
+    if (MSpawn_ChatSend) MSpawn_ChatSend(server, client, msg, true);
+    else printf("%s\n", msg);
 }
 
 static id MSpawn_MakeBreedDict(int breedVal) {
@@ -88,6 +163,9 @@ static id MSpawn_MakeBreedDict(int breedVal) {
 
 id MSpawn_FindPlayer(id dynWorld, const char* name) {
     if (!dynWorld) return nil;
+    // Not registered yet (no update since player_registry loaded): old scan
+    id found = MSpawn_FindByName ? MSpawn_FindByName(name) : nil;
+    if (found) return found;
     Ivar iv = class_getInstanceVariable(object_getClass(dynWorld), "netBlockheads");
     if (!iv) return nil;
     id list = *(id*)((char*)dynWorld + ivar_getOffset(iv));
@@ -192,15 +270,257 @@ int MSpawn_ParseDonkey(const char* v, bool isUnicorn) {
     return isUnicorn ? 23 : 0;
 }
 
-void MSpawn_Execute(id dynWorld, id player, int mobID, int qty, int breed, bool baby) {
+static id MSpawn_Send(id obj, const char* selName) {
+    if (!obj) return nil;
+    SEL s = sel_registerName(selName);
+    MS_SendFunc f = (MS_SendFunc)class_getMethodImplementation(object_getClass(obj), s);
+    return f ? f(obj, s) : nil;
+}
+
+static bool MSpawn_IsValidPtr(void* ptr) {
+    uintptr_t addr = (uintptr_t)ptr;
+    return (addr > 0x400000 && addr < 0x7fffffffffff && (addr % 8 == 0));
+}
+
+static long long MSpawn_Pack(int x, int y) {
+    return ((long long)y << 32) | (unsigned int)x;
+}
+
+static bool MSpawn_IsAir(id world, int x, int y) {
+    uint8_t* t = (uint8_t*)MSpawn_TileAt(x, y, world);
+    return t && t[0] == MS_AIR_ID;
+}
+
+// Free tiles around center, nearest first. Land mobs need air above and
+// ground below; fish and sharks only look at the tiles around the player.
+static int MSpawn_FindSpots(id world, long long center, bool aquatic, long long* out) {
+    int cx = (int)(center & 0xFFFFFFFF);
+    int cy = (int)(center >> 32);
+    int n = 0;
+
+    int width = 0;
+    Ivar ivW = class_getInstanceVariable(object_getClass(world), "worldWidthMacro");
+    if (ivW) width = *(int*)((char*)world + ivar_getOffset(ivW)) * MS_REGION_TILES;
+
+    int rx = aquatic ? MS_WATER_SEARCH : MS_SEARCH_X;
+    int ry = aquatic ? MS_WATER_SEARCH : MS_SEARCH_Y;
+
+    for (int d = 0; d <= rx + ry && n < MS_MAX_SPOTS && MSpawn_TileAt; d++) {
+        for (int dx = -d; dx <= d && n < MS_MAX_SPOTS; dx++) {
+            if (abs(dx) > rx) continue;
+            int ady = d - abs(dx);
+            if (ady > ry) continue;
+            for (int sign = 1; sign >= -1 && n < MS_MAX_SPOTS; sign -= 2) {
+                if (ady == 0 && sign < 0) break;
+                int x = cx + dx, y = cy + sign * ady;
+                if (width > 0) x = ((x % width) + width) % width; // World wraps
+                if (y < 1 || y > 1022) continue;
+
+                if (!MSpawn_IsAir(world, x, y)) continue;
+                if (!aquatic) {
+                    if (!MSpawn_IsAir(world, x, y + 1)) continue;
+                    uint8_t* below = (uint8_t*)MSpawn_TileAt(x, y - 1, world);
+                    if (!below || below[0] == MS_AIR_ID) continue;
+                }
+                out[n++] = MSpawn_Pack(x, y);
+            }
+        }
+    }
+    if (n == 0) out[n++] = center; // Nothing loaded or free: old behaviour
+    return n;
+}
+
+static MS_Region* MSpawn_Region(MS_Job* job, long long pos) {
+    int rx = (int)(pos & 0xFFFFFFFF) / MS_REGION_TILES;
+    int ry = (int)(pos >> 32) / MS_REGION_TILES;
+    for (int i = 0; i < job->regionCount; i++) {
+        if (job->regions[i]->rx == rx && job->regions[i]->ry == ry) return job->regions[i];
+    }
+    return NULL;
+}
+
+// The shared entry for the region of pos, taken by one more job. fresh = not counted yet.
+static MS_Region* MSpawn_TakeRegion(long long pos) {
+    int rx = (int)(pos & 0xFFFFFFFF) / MS_REGION_TILES;
+    int ry = (int)(pos >> 32) / MS_REGION_TILES;
+    MS_Region* free_ = NULL;
+    for (int i = 0; i < MS_MAX_JOBS * MS_MAX_REGIONS; i++) {
+        MS_Region* rg = &g_MSpawn_Regions[i];
+        if (rg->users == 0) {
+            if (!free_) free_ = rg;
+        } else if (rg->rx == rx && rg->ry == ry) {
+            rg->users++;
+            return rg;
+        }
+    }
+    // MS_MAX_REGIONS per job and MS_MAX_JOBS jobs: never full
+    free_->rx = rx;
+    free_->ry = ry;
+    free_->count = 0;
+    free_->users = 1;
+    free_->fresh = true;
+    return free_;
+}
+
+static bool MSpawn_IsNPC(Class cls, Class npcCls) {
+    for (; cls; cls = class_getSuperclass(cls)) {
+        if (cls == npcCls) return true;
+    }
+    return false;
+}
+
+static void MSpawn_CountWalk(struct MS_RbNode_Base* node, MS_Job* job, Class npcCls, int depth) {
+    if (!node || depth > 500 || !MSpawn_IsValidPtr(node)) return;
+    id obj = ((struct MS_RbNode*)node)->value;
+    if (obj && MSpawn_IsValidPtr(obj) && MSpawn_IsNPC(object_getClass(obj), npcCls)) {
+        if (g_MSpawn_NpcPosOff < 0) {
+            Ivar iv = class_getInstanceVariable(object_getClass(obj), "pos");
+            if (iv) g_MSpawn_NpcPosOff = ivar_getOffset(iv);
+        }
+        if (g_MSpawn_NpcPosOff >= 0) {
+            MS_Region* rg = MSpawn_Region(job, *(long long*)((char*)obj + g_MSpawn_NpcPosOff));
+            if (rg && rg->fresh) rg->count++;
+        }
+    }
+    MSpawn_CountWalk(node->_left, job, npcCls, depth + 1);
+    MSpawn_CountWalk(node->_right, job, npcCls, depth + 1);
+}
+
+// Regions touched by the job's spots, with the NPCs already living there.
+// Regions another job is using keep their count (which includes that job's
+// spawns); only regions new to every job are counted.
+static void MSpawn_CountRegions(MS_Job* job) {
+    job->regionCount = 0;
+    int kept = 0;
+    for (int i = 0; i < job->spotCount; i++) {
+        long long pos = job->spots[i];
+        if (!MSpawn_Region(job, pos)) {
+            if (job->regionCount == MS_MAX_REGIONS) continue; // Spot dropped
+            job->regions[job->regionCount++] = MSpawn_TakeRegion(pos);
+        }
+        job->spots[kept++] = pos;
+    }
+    job->spotCount = kept;
+
+    bool fresh = false;
+    for (int i = 0; i < job->regionCount; i++) fresh |= job->regions[i]->fresh;
+    if (!fresh) return;
+
+    // npc_census.c keeps these counts already; walk the world only without it
+    bool known = MSpawn_RegionCount != NULL;
+    for (int i = 0; i < job->regionCount && known; i++) {
+        MS_Region* rg = job->regions[i];
+        if (!rg->fresh) continue;
+        rg->count = MSpawn_RegionCount(rg->rx * MS_REGION_TILES, rg->ry * MS_REGION_TILES);
+        known = rg->count >= 0;
+    }
+    if (!known) {
+        for (int i = 0; i < job->regionCount; i++) {
+            if (job->regions[i]->fresh) job->regions[i]->count = 0;
+        }
+        Class npcCls = objc_getClass(MS_NPC_CLASS);
+        Ivar mapIvar = class_getInstanceVariable(object_getClass(job->dynWorld), "dynamicObjects");
+        if (npcCls && mapIvar) {
+            struct MS_RbTree_Impl* maps = (struct MS_RbTree_Impl*)((char*)job->dynWorld + ivar_getOffset(mapIvar));
+            for (int i = 0; i < 65; i++) {
+                if (maps[i]._node_count == 0 || maps[i]._node_count > 1000000) continue;
+                MSpawn_CountWalk(maps[i]._header._parent, job, npcCls, 0);
+            }
+        }
+    }
+    for (int i = 0; i < job->regionCount; i++) job->regions[i]->fresh = false;
+}
+
+static bool MSpawn_QueueJob(id server, id client, id world, id dynWorld, id player, int mobID, int qty, int breed, bool baby, const char* mob, const char* playerName) {
+    MS_Job* job = NULL;
+    for (int i = 0; i < MS_MAX_JOBS && !job; i++) {
+        if (!g_MSpawn_Jobs[i].active) job = &g_MSpawn_Jobs[i];
+    }
+    if (!job) return false;
+
     Ivar ivP = class_getInstanceVariable(object_getClass(player), "pos");
     long long pos = *(long long*)((char*)player + ivar_getOffset(ivP));
-    SEL sLoad = sel_registerName("loadNPCAtPosition:type:saveDict:isAdult:wasPlaced:placedByClient:");
-    MS_SpawnFunc fLoad = (MS_SpawnFunc)method_getImplementation(class_getInstanceMethod(object_getClass(dynWorld), sLoad));
-    id dict = MSpawn_MakeBreedDict(breed);
-    for(int i=0; i<qty; i++) {
-        fLoad(dynWorld, sLoad, pos, mobID, dict, !baby, 0, nil);
+
+    memset(job, 0, sizeof(*job));
+    job->server = MSpawn_Send(server, "retain");
+    job->client = MSpawn_Send(client, "retain");
+    job->dynWorld = MSpawn_Send(dynWorld, "retain");
+    job->dict = MSpawn_Send(MSpawn_MakeBreedDict(breed), "retain");
+    job->sLoad = sel_registerName("loadNPCAtPosition:type:saveDict:isAdult:wasPlaced:placedByClient:");
+    job->fLoad = (MS_SpawnFunc)method_getImplementation(class_getInstanceMethod(object_getClass(dynWorld), job->sLoad));
+    job->mobID = mobID;
+    job->breed = breed;
+    job->baby = baby;
+    job->total = job->remaining = qty;
+    job->spotCount = MSpawn_FindSpots(world, pos, mobID == 4 || mobID == 5, job->spots);
+    snprintf(job->mob, sizeof(job->mob), "%s", mob);
+    snprintf(job->player, sizeof(job->player), "%s", playerName);
+    MSpawn_CountRegions(job);
+
+    job->active = true;
+    g_MSpawn_ActiveJobs++;
+    return true;
+}
+
+static void MSpawn_FinishJob(MS_Job* job) {
+    char msg[192];
+    int n = snprintf(msg, sizeof(msg), "[Spawn] Summoned %d %s (%d) near %s.", job->spawned, job->mob, job->breed, job->player);
+    if (job->skipped > 0) snprintf(msg + n, sizeof(msg) - n, " %d skipped (area at %d mobs).", job->skipped, MS_REGION_CAP);
+    MSpawn_Chat(job->server, job->client, msg);
+
+    for (int i = 0; i < job->regionCount; i++) job->regions[i]->users--;
+    MSpawn_Send(job->server, "release");
+    MSpawn_Send(job->client, "release");
+    MSpawn_Send(job->dynWorld, "release");
+    MSpawn_Send(job->dict, "release");
+    job->active = false;
+    g_MSpawn_ActiveJobs--;
+}
+
+// One NPC for this job on the next spot whose region still has room
+static bool MSpawn_Step(MS_Job* job) {
+    for (int tries = 0; tries < job->spotCount; tries++) {
+        int idx = (job->next + tries) % job->spotCount;
+        MS_Region* rg = MSpawn_Region(job, job->spots[idx]);
+        if (rg && rg->count >= MS_REGION_CAP) continue;
+
+        if (job->fLoad) job->fLoad(job->dynWorld, job->sLoad, job->spots[idx], job->mobID, job->dict, !job->baby, 0, nil);
+        if (rg) rg->count++;
+        job->next = idx + 1;
+        job->spawned++;
+        job->remaining--;
+        return true;
+    }
+    job->skipped += job->remaining; // Every region is full
+    job->remaining = 0;
+    return false;
+}
+
+static void MSpawn_RunJobs() {
+    id pool = MSpawn_Pool();
+    int budget = MS_TICK_BUDGET;
+    bool progress = true;
+    // Round robin so one big job does not hold back the others
+    while (budget > 0 && progress) {
+        progress = false;
+        for (int i = 0; i < MS_MAX_JOBS && budget > 0; i++) {
+            MS_Job* job = &g_MSpawn_Jobs[i];
+            if (!job->active || job->remaining == 0) continue;
+            if (MSpawn_Step(job)) {
+                budget--;
+                progress = true;
+            }
+        }
     }
+    for (int i = 0; i < MS_MAX_JOBS; i++) {
+        if (g_MSpawn_Jobs[i].active && g_MSpawn_Jobs[i].remaining == 0) MSpawn_FinishJob(&g_MSpawn_Jobs[i]);
+    }
+    MSpawn_Drain(pool);
+}
+
+void Hook_MSpawn_Tick(id self, SEL _cmd, float dt, float accDt) {
+    if (Real_MSpawn_Tick) Real_MSpawn_Tick(self, _cmd, dt, accDt);
+    if (g_MSpawn_ActiveJobs > 0) MSpawn_RunJobs();
 }
 
 id Hook_MSpawn_Cmd(id self, SEL _cmd, id cmdStr, id client) {
@@ -223,7 +543,7 @@ id Hook_MSpawn_Cmd(id self, SEL _cmd, id cmdStr, id client) {
     // args[0]=mob, args[1]=qty, args[2]=player, args[3+]=options
     
     if (argCount < 3) {
-        MSpawn_Chat(self, "[Usage] /spawn <mob> <qty> <player> [variant/baby/force...]");
+        MSpawn_Chat(self, client, "[Usage] /spawn <mob> <qty> <player> [variant/baby/force...]");
         MSpawn_Drain(pool);
         return nil;
     }
@@ -239,13 +559,14 @@ id Hook_MSpawn_Cmd(id self, SEL _cmd, id cmdStr, id client) {
     
     id target = MSpawn_FindPlayer(dynWorld, sPl);
     if (!target) {
-        MSpawn_Chat(self, "[Error] Player not found.");
+        MSpawn_Chat(self, client, "[Error] Player not found.");
         MSpawn_Drain(pool);
         return nil;
     }
     
     int qty = atoi(sQty);
     if (qty < 1) qty = 1;
+    if (qty > MS_JOB_MAX_QTY) qty = MS_JOB_MAX_QTY;
     
     bool isBaby = false;
     bool force = false;
@@ -264,7 +585,7 @@ id Hook_MSpawn_Cmd(id self, SEL _cmd, id cmdStr, id client) {
     
     if (!force && qty > 10) {
         qty = 10;
-        MSpawn_Chat(self, "[Warn] Qty capped at 10. Use 'force' to override.");
+        MSpawn_Chat(self, client, "[Warn] Qty capped at 10. Use 'force' to override.");
     }
     
     int mobID = 0;
@@ -292,12 +613,15 @@ id Hook_MSpawn_Cmd(id self, SEL _cmd, id cmdStr, id client) {
     else if (strcasecmp(sMob, "cave_troll")==0) mobID = 6; // Alias
     
     if (mobID > 0) {
-        MSpawn_Execute(dynWorld, target, mobID, qty, breed, isBaby);
-        char msg[128];
-        snprintf(msg, 128, "[Spawn] Summoned %d %s (%d) near %s.", qty, sMob, breed, sPl);
-        MSpawn_Chat(self, msg);
+        if (!Real_MSpawn_Tick || !MSpawn_QueueJob(self, client, world, dynWorld, target, mobID, qty, breed, isBaby, sMob, sPl)) {
+            MSpawn_Chat(self, client, "[Error] Too many spawn jobs running, try again shortly.");
+        } else if (qty > MS_TICK_BUDGET) {
+            char msg[128];
+            snprintf(msg, 128, "[Spawn] Spawning %d %s near %s...", qty, sMob, sPl);
+            MSpawn_Chat(self, client, msg);
+        }
     } else {
-        MSpawn_Chat(self, "[Error] Unknown Mob.");
+        MSpawn_Chat(self, client, "[Error] Unknown Mob.");
     }
     
     MSpawn_Drain(pool);
@@ -312,8 +636,22 @@ static void* MSpawn_Init(void* arg) {
         Real_MSpawn_Cmd = (MS_CmdFunc)method_getImplementation(mC);
         method_setImplementation(mC, (IMP)Hook_MSpawn_Cmd);
         
-        Method mT = class_getInstanceMethod(cls, sel_registerName("sendChatMessage:displayNotification:sendToClients:"));
-        Real_MSpawn_Chat = (MS_ChatFunc)method_getImplementation(mT);
+        MSpawn_ChatSend = (MS_ChatSendFunc)dlsym(RTLD_DEFAULT, "BHChat_Send");
+        MSpawn_RegionCount = (MS_RegionCountFunc)dlsym(RTLD_DEFAULT, "BHNPC_RegionCount");
+        MSpawn_FindByName = (MS_FindFunc)dlsym(RTLD_DEFAULT, "BHPlayer_FindByName");
+
+        void* handle = dlopen(NULL, RTLD_LAZY);
+        if (handle) {
+            MSpawn_TileAt = (MS_TileAtFunc)dlsym(handle, MS_SYM_TILE_AT);
+            dlclose(handle);
+        }
+
+        Class clsGC = objc_getClass(MS_GC_CLASS);
+        Method mTick = clsGC ? class_getInstanceMethod(clsGC, sel_registerName("update:accurateDT:")) : NULL;
+        if (mTick) {
+            Real_MSpawn_Tick = (MS_TickFunc)method_getImplementation(mTick);
+            method_setImplementation(mTick, (IMP)Hook_MSpawn_Tick);
+        }
         printf("[MSpawn] Hooked!\n");
     }
     return NULL;
@@ -17,19 +17,18 @@
 
 // --- IMP TYPES ---
 typedef id (*PAUSE_CmdFunc)(id, SEL, id, id);
-typedef void (*PAUSE_ChatFunc)(id, SEL, id, BOOL, id);
+typedef void (*PAUSE_SendFunc)(id, id, const char*, bool);
 typedef void (*PAUSE_UpdateFunc)(id, SEL, float, bool);
 
 // Memory & Utils
 typedef id (*PAUSE_AllocFunc)(id, SEL);
 typedef id (*PAUSE_InitFunc)(id, SEL);
 typedef void (*PAUSE_VoidFunc)(id, SEL);
-typedef id (*PAUSE_StrFunc)(id, SEL, const char*);
 typedef const char* (*PAUSE_Utf8Func)(id, SEL);
 
 // --- GLOBALS ---
 static PAUSE_CmdFunc    Real_PAUSE_HandleCmd = NULL;
-static PAUSE_ChatFunc   Real_PAUSE_SendChat = NULL;
+static PAUSE_SendFunc PAUSE_Send = NULL; // BHChat_Send, chat_queue.c
 static PAUSE_UpdateFunc Real_PAUSE_Update = NULL;
 
 static bool g_PAUSE_Active = false;
@@ -51,14 +50,6 @@ static void PAUSE_Drain(id pool) {
     f(pool, s);
 }
 
-static id PAUSE_Str(const char* txt) {
-    if (!txt) return nil;
-    Class cls = objc_getClass("NSString");
-    SEL s = sel_registerName("stringWithUTF8String:");
-    PAUSE_StrFunc f = (PAUSE_StrFunc)method_getImplementation(class_getClassMethod(cls, s));
-    return f ? f((id)cls, s, txt) : nil;
-}
-
 static const char* PAUSE_CStr(id str) {
     if (!str) return "";
     SEL s = sel_registerName("UTF8String");
@@ -67,9 +58,8 @@ static const char* PAUSE_CStr(id str) {
 }
 
 static void PAUSE_Msg(id server, const char* msg) {
-    if (server && Real_PAUSE_SendChat) {
-        Real_PAUSE_SendChat(server, sel_registerName("sendChatMessage:displayNotification:sendToClients:"), PAUSE_Str(msg), true, nil);
-    }
+    if (PAUSE_Send) PAUSE_Send(server, nil, msg, true);
+    else printf("%s\n", msg);
 }
 
 // --- HOOKS ---
@@ -113,8 +103,7 @@ static void* PAUSE_Init(void* arg) {
         Real_PAUSE_HandleCmd = (PAUSE_CmdFunc)method_getImplementation(mC);
         method_setImplementation(mC, (IMP)Hook_PAUSE_Cmd);
         
-        Method mT = class_getInstanceMethod(clsSrv, sel_registerName("sendChatMessage:displayNotification:sendToClients:"));
-        Real_PAUSE_SendChat = (PAUSE_ChatFunc)method_getImplementation(mT);
+        PAUSE_Send = (PAUSE_SendFunc)dlsym(RTLD_DEFAULT, "BHChat_Send");
     }
     
     Class clsDW = objc_getClass(PAUSE_DYN_WORLD);
@@ -20,18 +20,17 @@
 // --- IMP TYPES ---
 typedef void (*OMNI_FillFunc)(id, SEL, void*, long long, int, uint16_t, uint16_t, id, id, id, id);
 typedef id (*OMNI_CmdFunc)(id, SEL, id, id);
-typedef void (*OMNI_ChatFunc)(id, SEL, id, BOOL, id);
+typedef void (*OMNI_SendFunc)(id, id, const char*, bool);
 
 typedef id (*OMNI_AllocFunc)(id, SEL);
 typedef id (*OMNI_InitFunc)(id, SEL);
 typedef void (*OMNI_VoidFunc)(id, SEL);
-typedef id (*OMNI_StrFunc)(id, SEL, const char*);
 typedef const char* (*OMNI_Utf8Func)(id, SEL);
 
 // --- GLOBALS ---
 static OMNI_FillFunc Real_OMNI_Fill = NULL;
 static OMNI_CmdFunc  Real_OMNI_Cmd = NULL;
-static OMNI_ChatFunc Real_OMNI_Chat = NULL;
+static OMNI_SendFunc OMNI_Send = NULL; // BHChat_Send, chat_queue.c
 
 static int  g_OMNI_Mode = 0; 
 static int  g_OMNI_TargetID = 0;
@@ -54,14 +53,6 @@ static void OMNI_Drain(id pool) {
     f(pool, s);
 }
 
-static id OMNI_Str(const char* txt) {
-    if (!txt) return nil;
-    Class cls = objc_getClass("NSString");
-    SEL s = sel_registerName("stringWithUTF8String:");
-    OMNI_StrFunc f = (OMNI_StrFunc)method_getImplementation(class_getClassMethod(cls, s));
-    return f ? f((id)cls, s, txt) : nil;
-}
-
 static const char* OMNI_CStr(id str) {
     if (!str) return "";
     SEL s = sel_registerName("UTF8String");
@@ -69,10 +60,9 @@ static const char* OMNI_CStr(id str) {
     return f ? f(str, s) : "";
 }
 
-static void OMNI_Msg(id server, const char* msg) {
-    if (server && Real_OMNI_Chat) {
-        Real_OMNI_Chat(server, sel_registerName("sendChatMessage:displayNotification:sendToClients:"), OMNI_Str(msg), true, nil);
-    }
+static void OMNI_Msg(id server, id client, const char* msg) {
+    if (OMNI_Send) OMNI_Send(server, client, msg, true);
+    else printf("%s\n", msg);
 }
 
 // --- ID PARSER (CORRECTED PRIORITY) ---
@@ -213,9 +203,9 @@ id Hook_OMNI_Cmd(id self, SEL _cmd, id cmdStr, id client) {
         if (!arg) {
             if (g_OMNI_Mode == 1) {
                 g_OMNI_Mode = 0;
-                OMNI_Msg(self, "[Omni] Place Mode OFF.");
+                OMNI_Msg(self, client, "[Omni] Place Mode OFF.");
             } else {
-                OMNI_Msg(self, "[Usage] /place <ID/Name>");
+                OMNI_Msg(self, client, "[Usage] /place <ID/Name>");
             }
             OMNI_Drain(pool);
             return nil;
@@ -223,7 +213,7 @@ id Hook_OMNI_Cmd(id self, SEL _cmd, id cmdStr, id client) {
         
         if (strcasecmp(arg, "off") == 0) {
             g_OMNI_Mode = 0;
-            OMNI_Msg(self, "[Omni] Place Mode OFF.");
+            OMNI_Msg(self, client, "[Omni] Place Mode OFF.");
             OMNI_Drain(pool);
             return nil;
         }
@@ -234,9 +224,9 @@ id Hook_OMNI_Cmd(id self, SEL _cmd, id cmdStr, id client) {
             char msg[128];
             const char* typeStr = g_OMNI_IsContent ? "Content (Auto-Base)" : "Block";
             snprintf(msg, 128, "[Omni] Place: %s (ID %d) [%s].", arg, g_OMNI_TargetID, typeStr);
-            OMNI_Msg(self, msg);
+            OMNI_Msg(self, client, msg);
         } else {
-            OMNI_Msg(self, "[Omni] Invalid Block Name/ID.");
+            OMNI_Msg(self, client, "[Omni] Invalid Block Name/ID.");
         }
         
         OMNI_Drain(pool);
@@ -248,9 +238,9 @@ id Hook_OMNI_Cmd(id self, SEL _cmd, id cmdStr, id client) {
         if (!arg) {
             if (g_OMNI_Mode == 2) {
                 g_OMNI_Mode = 0;
-                OMNI_Msg(self, "[Omni] Wall Mode OFF.");
+                OMNI_Msg(self, client, "[Omni] Wall Mode OFF.");
             } else {
-                OMNI_Msg(self, "[Usage] /wall <ID/Name>");
+                OMNI_Msg(self, client, "[Usage] /wall <ID/Name>");
             }
             OMNI_Drain(pool);
             return nil;
@@ -258,7 +248,7 @@ id Hook_OMNI_Cmd(id self, SEL _cmd, id cmdStr, id client) {
         
         if (strcasecmp(arg, "off") == 0) {
             g_OMNI_Mode = 0;
-            OMNI_Msg(self, "[Omni] Wall Mode OFF.");
+            OMNI_Msg(self, client, "[Omni] Wall Mode OFF.");
             OMNI_Drain(pool);
             return nil;
         }
@@ -269,9 +259,9 @@ id Hook_OMNI_Cmd(id self, SEL _cmd, id cmdStr, id client) {
             g_OMNI_Mode = 2; // Wall Mode
             char msg[128];
             snprintf(msg, 128, "[Omni] Wall: %s (ID %d).", arg, g_OMNI_TargetID);
-            OMNI_Msg(self, msg);
+            OMNI_Msg(self, client, msg);
         } else {
-            OMNI_Msg(self, "[Omni] Invalid Block.");
+            OMNI_Msg(self, client, "[Omni] Invalid Block.");
         }
         OMNI_Drain(pool);
         return nil;
@@ -290,8 +280,7 @@ static void* OMNI_Init(void* arg) {
         Real_OMNI_Cmd = (OMNI_CmdFunc)method_getImplementation(mC);
         method_setImplementation(mC, (IMP)Hook_OMNI_Cmd);
         
-        Method mT = class_getInstanceMethod(clsSrv, sel_registerName("sendChatMessage:displayNotification:sendToClients:"));
-        Real_OMNI_Chat = (OMNI_ChatFunc)method_getImplementation(mT);
+        OMNI_Send = (OMNI_SendFunc)dlsym(RTLD_DEFAULT, "BHChat_Send");
     }
     
     Class clsWorld = objc_getClass(OMNI_WORLD_CLASS);
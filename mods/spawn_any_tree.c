@@ -30,8 +30,7 @@ typedef void (*TREE_FillFunc)(id, SEL, void*, IntPair, int, uint16_t, uint16_t,
 // handleCommand...
 typedef id (*TREE_CmdFunc)(id, SEL, id, id);
 
-// sendChatMessage...
-typedef void (*TREE_ChatFunc)(id, SEL, id, BOOL, id);
+typedef void (*TREE_SendFunc)(id, id, const char*, bool);
 
 // loadTreeAtPosition... (For Normal Trees)
 typedef void (*TREE_LoadFunc)(id, SEL, IntPair, int, short, short, BOOL, float);
@@ -41,13 +40,12 @@ typedef id (*TREE_InitGemFunc)(id, SEL, id, id, IntPair, id, id, id, int);
 
 // Alloc/Init Utils
 typedef id (*TREE_AllocFunc)(id, SEL);
-typedef id (*TREE_StrFunc)(id, SEL, const char*);
 typedef const char* (*TREE_Utf8Func)(id, SEL);
 
 // --- GLOBALS ---
 static TREE_FillFunc Real_TREE_Fill = NULL;
 static TREE_CmdFunc  Real_TREE_Cmd = NULL;
-static TREE_ChatFunc Real_TREE_Chat = NULL;
+static TREE_SendFunc TREE_Send = NULL; // BHChat_Send, chat_queue.c
 
 static bool g_TREE_Active = false;
 static int  g_TREE_Type = 0;
@@ -80,14 +78,6 @@ static void TREE_Drain(id pool) {
     f(pool, s);
 }
 
-static id TREE_Str(const char* txt) {
-    if (!txt) return nil;
-    Class cls = objc_getClass("NSString");
-    SEL s = sel_registerName("stringWithUTF8String:");
-    TREE_StrFunc f = (TREE_StrFunc)method_getImplementation(class_getClassMethod(cls, s));
-    return f((id)cls, s, txt);
-}
-
 static const char* TREE_CStr(id str) {
     if (!str) return "";
     SEL s = sel_registerName("UTF8String");
@@ -95,10 +85,9 @@ static const char* TREE_CStr(id str) {
     return f(str, s);
 }
 
-static void TREE_Msg(id server, const char* msg) {
-    if (server && Real_TREE_Chat) {
-        Real_TREE_Chat(server, sel_registerName("sendChatMessage:displayNotification:sendToClients:"), TREE_Str(msg), true, nil);
-    }
+static void TREE_Msg(id server, id client, const char* msg) {
+    if (TREE_Send) TREE_Send(server, client, msg, true);
+    else printf("%s\n", msg);
 }
 
 // --- SPAWN LOGIC (FROM REFERENCE) ---
@@ -178,9 +167,9 @@ id Hook_TREE_Cmd(id self, SEL _cmd, id cmdStr, id client) {
         if (!arg) {
             if (g_TREE_Active) {
                 g_TREE_Active = false;
-                TREE_Msg(self, "[Tree] OFF.");
+                TREE_Msg(self, client, "[Tree] OFF.");
             } else {
-                TREE_Msg(self, "[Usage] /tree <type> (e.g. apple, diamond)");
+                TREE_Msg(self, client, "[Usage] /tree <type> (e.g. apple, diamond)");
             }
             TREE_Drain(pool);
             return nil;
@@ -188,7 +177,7 @@ id Hook_TREE_Cmd(id self, SEL _cmd, id cmdStr, id client) {
         
         if (strcasecmp(arg, "off") == 0) {
             g_TREE_Active = false;
-            TREE_Msg(self, "[Tree] OFF.");
+            TREE_Msg(self, client, "[Tree] OFF.");
             TREE_Drain(pool);
             return nil;
         }
@@ -218,7 +207,7 @@ id Hook_TREE_Cmd(id self, SEL _cmd, id cmdStr, id client) {
             else if (strcasecmp(arg, "diamond")==0) g_TREE_Type=15;
             else {
                 g_TREE_Active = false;
-                TREE_Msg(self, "[Tree] Unknown Type.");
+                TREE_Msg(self, client, "[Tree] Unknown Type.");
                 TREE_Drain(pool);
                 return nil;
             }
@@ -226,7 +215,7 @@ id Hook_TREE_Cmd(id self, SEL _cmd, id cmdStr, id client) {
         
         char msg[128];
         snprintf(msg, 128, "[Tree] %s selected. Place STONE to plant.", g_TREE_Name);
-        TREE_Msg(self, msg);
+        TREE_Msg(self, client, msg);
         
         TREE_Drain(pool);
         return nil;
@@ -254,8 +243,7 @@ static void* TREE_Init(void* arg) {
         Real_TREE_Cmd = (TREE_CmdFunc)method_getImplementation(mC);
         method_setImplementation(mC, (IMP)Hook_TREE_Cmd);
         
-        Method mT = class_getInstanceMethod(clsSrv, sel_registerName("sendChatMessage:displayNotification:sendToClients:"));
-        Real_TREE_Chat = (TREE_ChatFunc)method_getImplementation(mT);
+        TREE_Send = (TREE_SendFunc)dlsym(RTLD_DEFAULT, "BHChat_Send");
     }
     return NULL;
 }
@@ -56,7 +56,6 @@
 // Utils
 #define SEL_FILL_LONG   "fillTile:atPos:withType:dataA:dataB:placedByClient:saveDict:placedByBlockhead:placedByClientName:"
 #define SEL_CMD         "handleCommand:issueClient:"
-#define SEL_CHAT        "sendChatMessage:sendToClients:"
 #define SEL_UTF8        "UTF8String"
 #define SEL_STR         "stringWithUTF8String:"
 
@@ -68,6 +67,7 @@
 // --- CONSTANTS ---
 #define WE_SAFE_ID  1 
 #define WE_AIR_ID   2
+#define WE_EVENT_EVERY 5000 // Scanned blocks between we_job progress events
 
 enum WEMode { WE_OFF = 0, WE_MODE_P1, WE_MODE_P2 };
 
@@ -92,7 +92,6 @@ typedef void (*WE_RemBgContFunc)(id, SEL, void*, unsigned long long, id);
 typedef id (*WE_DynRemFunc)(id, SEL, unsigned long long); 
 typedef id (*WE_DynRemObjFunc)(id, SEL, unsigned long long, id); 
 typedef id   (*WE_CmdFunc)(id, SEL, id, id);
-typedef void (*WE_ChatFunc)(id, SEL, id, id);
 typedef const char* (*WE_StrFunc)(id, SEL);
 typedef id   (*WE_StrFactoryFunc)(id, SEL, const char*);
 typedef void* (*WE_TileAtFunc)(int, int, id);
@@ -102,6 +101,10 @@ typedef id   (*WE_AllocFunc)(id, SEL);
 typedef id   (*WE_InitFunc)(id, SEL);
 typedef void (*WE_DrainFunc)(id, SEL);
 
+typedef void (*WE_EventFunc)(const char*, const char*, ...);
+typedef void (*WE_SendFunc)(id, id, const char*, bool);
+typedef id (*WE_TempStrFunc)(const char*);
+
 // --- GLOBAL STATE ---
 static WE_FillTileFunc     WE_U_Real_Fill = NULL;
 static WE_RemTileFunc      WE_U_Real_RemTile = NULL;
@@ -110,8 +113,10 @@ static WE_RemBackFunc      WE_U_Real_RemBack = NULL;
 static WE_RemBgContFunc    WE_U_Real_RemBgCont = NULL;
 static WE_GetDynWorldFunc  WE_U_GetDynWorld = NULL;
 static WE_CmdFunc          WE_U_Real_Cmd = NULL;
-static WE_ChatFunc         WE_U_Real_Chat = NULL;
 static WE_TileAtFunc       WE_U_CppTileAt = NULL;
+static WE_EventFunc        WE_U_Event = NULL; // event_log.c, when loaded
+static WE_SendFunc         WE_U_Send = NULL; // BHChat_Send, chat_queue.c
+static WE_TempStrFunc      WE_U_TempStr = NULL; // string_pool.c, when loaded
 
 static id WE_U_World = NULL;
 static id WE_U_Server = NULL;
@@ -131,22 +136,22 @@ static const char* WE_GetStr(id strObj) {
 }
 
 static id WE_MkStr(const char* text) {
+    if (WE_U_TempStr) return WE_U_TempStr(text);
     Class cls = objc_getClass("NSString");
     SEL sel = sel_registerName(SEL_STR);
     WE_StrFactoryFunc f = (WE_StrFactoryFunc)method_getImplementation(class_getClassMethod(cls, sel));
     return f ? f((id)cls, sel, text) : NULL;
 }
 
-static void WE_Chat(const char* fmt, ...) {
-    if (!WE_U_Server || !WE_U_Real_Chat) {
-        printf("[WE_LOG] %s\n", fmt); return;
-    }
+static void WE_Chat(id client, const char* fmt, ...) {
     char buffer[256];
     va_list args;
     va_start(args, fmt);
     vsnprintf(buffer, sizeof(buffer), fmt, args);
     va_end(args);
-    WE_U_Real_Chat(WE_U_Server, sel_registerName(SEL_CHAT), WE_MkStr(buffer), NULL);
+    // World edit replies never raised a notification
+    if (WE_U_Send && WE_U_Server) WE_U_Send(WE_U_Server, client, buffer, false);
+    else printf("[WE_LOG] %s\n", buffer);
 }
 
 // --- FULL PARSER ---
@@ -390,7 +395,7 @@ static void WE_U_Place(WE_IntPair pos, WE_BlockDef def, id client, id safeStr) {
 }
 
 static void WE_U_RunOp(int operation, WE_BlockDef def1, WE_BlockDef def2, id client) {
-    if (!WE_U_HasP1 || !WE_U_HasP2) { WE_Chat("[WE] Error: Set P1 & P2 first."); return; }
+    if (!WE_U_HasP1 || !WE_U_HasP2) { WE_Chat(client, "[WE] Error: Set P1 & P2 first."); return; }
     
     int x1 = (WE_U_P1.x < WE_U_P2.x) ? WE_U_P1.x : WE_U_P2.x;
     int x2 = (WE_U_P1.x > WE_U_P2.x) ? WE_U_P1.x : WE_U_P2.x;
@@ -405,14 +410,18 @@ static void WE_U_RunOp(int operation, WE_BlockDef def1, WE_BlockDef def2, id cli
     if (operation == 2) limit = 5000;  // SET limit
 
     if (totalBlocks > limit) {
-        WE_Chat("[WE] Error: Selection too large (%d blocks). Max for this command is %d.", totalBlocks, limit);
+        WE_Chat(client, "[WE] Error: Selection too large (%d blocks). Max for this command is %d.", totalBlocks, limit);
         return;
     }
 
     int count = 0;
-    if (!WE_U_CppTileAt) { WE_Chat("[WE] Critical: Reader Error."); return; }
+    if (!WE_U_CppTileAt) { WE_Chat(client, "[WE] Critical: Reader Error."); return; }
 
-    WE_Chat("[WE] Processing area...");
+    WE_Chat(client, "[WE] Processing area...");
+
+    const char* opName = (operation == 1) ? "del" : (operation == 2) ? "set" : "replace";
+    int scanned = 0;
+    if (WE_U_Event) WE_U_Event("we_job", "ssi", "state", "start", "op", opName, "total", (long long)totalBlocks);
 
     // === MEMORY MANAGEMENT (CRASH FIX - Outer Pool) ===
     Class PoolClass = objc_getClass("NSAutoreleasePool");
@@ -444,6 +453,9 @@ static void WE_U_RunOp(int operation, WE_BlockDef def1, WE_BlockDef def2, id cli
                 innerPool = impInit(impAlloc((id)PoolClass, selAlloc), selInit);
             }
 
+            if (WE_U_Event && ++scanned % WE_EVENT_EVERY == 0)
+                WE_U_Event("we_job", "ssiii", "state", "progress", "op", opName, "done", (long long)scanned, "total", (long long)totalBlocks, "modified", (long long)count);
+
             WE_IntPair currentPos = {x, y};
             void* tilePtr = WE_GetPtr(currentPos);
             
@@ -501,7 +513,8 @@ static void WE_U_RunOp(int operation, WE_BlockDef def1, WE_BlockDef def2, id cli
     impDrain(innerPool, selDrain); 
     impDrain(outerPool, selDrain); // Safe string dies here, safely
 
-    WE_Chat("[WE] Done. Modified %d blocks.", count);
+    WE_Chat(client, "[WE] Done. Modified %d blocks.", count);
+    if (WE_U_Event) WE_U_Event("we_job", "ssii", "state", "done", "op", opName, "total", (long long)totalBlocks, "modified", (long long)count);
 }
 
 // --- HOOKS ---
@@ -517,9 +530,9 @@ void WE_U_Hook_Fill(id self, SEL _cmd, void* tilePtr, unsigned long long packedP
         
         if (WE_U_HasP2) {
             int area = (abs(WE_U_P1.x - WE_U_P2.x) + 1) * (abs(WE_U_P1.y - WE_U_P2.y) + 1);
-            WE_Chat("[WE] Point 1 set. Selection area: %d blocks.", area);
+            WE_Chat(client, "[WE] Point 1 set. Selection area: %d blocks.", area);
         } else {
-            WE_Chat("[WE] Point 1 set at (%d, %d).", x, y);
+            WE_Chat(client, "[WE] Point 1 set at (%d, %d).", x, y);
         }
     }
     else if (WE_U_Mode == WE_MODE_P2 && (type == 1 || type == 1024)) {
@@ -527,9 +540,9 @@ void WE_U_Hook_Fill(id self, SEL _cmd, void* tilePtr, unsigned long long packedP
         
         if (WE_U_HasP1) {
             int area = (abs(WE_U_P1.x - WE_U_P2.x) + 1) * (abs(WE_U_P1.y - WE_U_P2.y) + 1);
-            WE_Chat("[WE] Point 2 set. Selection area: %d blocks.", area);
+            WE_Chat(client, "[WE] Point 2 set. Selection area: %d blocks.", area);
         } else {
-            WE_Chat("[WE] Point 2 set at (%d, %d).", x, y);
+            WE_Chat(client, "[WE] Point 2 set at (%d, %d).", x, y);
         }
     }
     if (WE_U_Real_Fill) WE_U_Real_Fill(self, _cmd, tilePtr, packedPos, type, dA, dB, client, saveDict, bh, clientName);
@@ -549,25 +562,25 @@ id WE_U_Hook_Cmd(id self, SEL _cmd, id commandStr, id client) {
 
     if (strcasecmp(text, "/we") == 0) {
         WE_U_Mode = WE_OFF; WE_U_HasP1 = false; WE_U_HasP2 = false;
-        WE_Chat("[WE] Selection cleared."); return NULL;
+        WE_Chat(client, "[WE] Selection cleared."); return NULL;
     }
-    if (strcasecmp(text, "/p1") == 0) { WE_U_Mode = WE_MODE_P1; WE_Chat("[WE] Place a block to set Point 1."); return NULL; }
-    if (strcasecmp(text, "/p2") == 0) { WE_U_Mode = WE_MODE_P2; WE_Chat("[WE] Place a block to set Point 2."); return NULL; }
+    if (strcasecmp(text, "/p1") == 0) { WE_U_Mode = WE_MODE_P1; WE_Chat(client, "[WE] Place a block to set Point 1."); return NULL; }
+    if (strcasecmp(text, "/p2") == 0) { WE_U_Mode = WE_MODE_P2; WE_Chat(client, "[WE] Place a block to set Point 2."); return NULL; }
 
     if (WE_IsCommand(text, "/del")) {
         char* token = strtok(text, " "); char* arg = strtok(NULL, " "); 
         WE_BlockDef target = arg ? WE_Parse(arg) : (WE_BlockDef){-1,0,0};
-        WE_Chat("[WE] Deleting %s...", arg ? arg : "selection");
+        WE_Chat(client, "[WE] Deleting %s...", arg ? arg : "selection");
         WE_BlockDef dummy = {0}; WE_U_RunOp(1, target, dummy, client); return NULL;
     }
     
     if (WE_IsCommand(text, "/set")) {
         char* token = strtok(text, " "); char* arg = strtok(NULL, " ");
         if (arg) { 
-            WE_Chat("[WE] Setting %s...", arg);
+            WE_Chat(client, "[WE] Setting %s...", arg);
             WE_BlockDef def = WE_Parse(arg); WE_BlockDef dummy = {0}; 
             WE_U_RunOp(2, def, dummy, client); 
-        } else WE_Chat("[WE] Usage: /set <block>");
+        } else WE_Chat(client, "[WE] Usage: /set <block>");
         return NULL;
     }
 
@@ -576,7 +589,7 @@ id WE_U_Hook_Cmd(id self, SEL _cmd, id commandStr, id client) {
         if (arg1 && arg2) {
              WE_BlockDef d1 = WE_Parse(arg1); WE_BlockDef d2 = WE_Parse(arg2);
              WE_U_RunOp(3, d1, d2, client);
-        } else WE_Chat("[WE] Usage: /replace <old> <new>");
+        } else WE_Chat(client, "[WE] Usage: /replace <old> <new>");
         return NULL;
     }
 
@@ -590,6 +603,9 @@ static void* WE_U_Init(void* arg) {
         WE_U_CppTileAt = (WE_TileAtFunc)dlsym(handle, SYM_TILE_AT);
         dlclose(handle);
     }
+    WE_U_Event = (WE_EventFunc)dlsym(RTLD_DEFAULT, "BHEvent_Emit");
+    WE_U_Send = (WE_SendFunc)dlsym(RTLD_DEFAULT, "BHChat_Send");
+    WE_U_TempStr = (WE_TempStrFunc)dlsym(RTLD_DEFAULT, "BHStr_Temp");
     
     Class clsWorld = objc_getClass(TARGET_WORLD_CLASS);
     if (clsWorld) {
@@ -622,8 +638,6 @@ static void* WE_U_Init(void* arg) {
         Method mCmd = class_getInstanceMethod(clsServer, sel_registerName(SEL_CMD));
         WE_U_Real_Cmd = (WE_CmdFunc)method_getImplementation(mCmd);
         method_setImplementation(mCmd, (IMP)WE_U_Hook_Cmd);
-        Method mChat = class_getInstanceMethod(clsServer, sel_registerName(SEL_CHAT));
-        WE_U_Real_Chat = (WE_ChatFunc)method_getImplementation(mChat);
     }
     return NULL;
 }
@@ -31,10 +31,9 @@ typedef void (*ZAF_IMP)(id, SEL, ...);
 // Method Signatures
 typedef void (*ZAF_IMP_Boot)(id, SEL, id, bool); 
 typedef id (*ZAF_IMP_Str)(id, SEL);
-typedef id (*ZAF_IMP_MakeStr)(Class, SEL, const char*);
 typedef bool (*ZAF_IMP_Bool)(id, SEL); 
 typedef bool (*ZAF_IMP_IsAdmin)(id, SEL, id); 
-typedef void (*ZAF_IMP_Chat)(id, SEL, id, bool, id);
+typedef void (*ZAF_IMP_Send)(id, id, const char*, bool);
 typedef int (*ZAF_IMP_Int)(id, SEL);
 typedef const char* (*ZAF_IMP_UTF8)(id, SEL);
 typedef void (*ZAF_IMP_Cmd)(id, SEL, id, id);
@@ -63,7 +62,6 @@ static SEL ZAF_Sel_ClientID = NULL;
 static SEL ZAF_Sel_Boot = NULL;
 static SEL ZAF_Sel_UTF8 = NULL;
 static SEL ZAF_Sel_IsAdmin = NULL;
-static SEL ZAF_Sel_SendChat = NULL;
 
 static ZAF_IMP_Bool    ZAF_Func_HasJet = NULL;
 static ZAF_IMP_Bool    ZAF_Func_CanFly = NULL;
@@ -72,8 +70,10 @@ static ZAF_IMP_Str     ZAF_Func_ClientID = NULL;
 static ZAF_IMP_Boot    ZAF_Func_Boot = NULL;
 static ZAF_IMP_UTF8    ZAF_Func_UTF8 = NULL;
 static ZAF_IMP_IsAdmin ZAF_Func_IsAdmin = NULL;
-static ZAF_IMP_Chat    ZAF_Func_SendChat = NULL;
-static ZAF_IMP_MakeStr ZAF_Func_MakeStr = NULL;
+static ZAF_IMP_Send ZAF_Func_Send = NULL; // BHChat_Send, chat_queue.c
+
+typedef void (*ZAF_EventFunc)(const char*, const char*, ...);
+static ZAF_EventFunc ZAF_Event = NULL; // event_log.c, when loaded
 
 static ptrdiff_t ZAF_off_bhServer = 0;
 static bool ZAF_ready = false;
@@ -123,18 +123,9 @@ static const char* ZAF_ObjC_To_C(id nsStr) {
     return func(nsStr, sel);
 }
 
-static id ZAF_C_To_ObjC(const char* str) {
-    if (!str) return NULL;
-    Class cls = ZAF_objc_getClass("NSString");
-    SEL sel = ZAF_sel_registerName("stringWithUTF8String:");
-    return ZAF_Func_MakeStr(cls, sel, str);
-}
-
-static void ZAF_SendSystemMsg(const char* msg) {
-    if (ZAF_Global_BHServer && ZAF_Func_SendChat) {
-        id nsMsg = ZAF_C_To_ObjC(msg);
-        ZAF_Func_SendChat(ZAF_Global_BHServer, ZAF_Sel_SendChat, nsMsg, true, NULL);
-    }
+static void ZAF_SendSystemMsg(id client, const char* msg) {
+    if (ZAF_Func_Send) ZAF_Func_Send(ZAF_Global_BHServer, client, msg, true);
+    else printf("%s\n", msg);
 }
 
 // =============================================================
@@ -150,16 +141,16 @@ static void ZAF_Hook_Srv_HandleCmd(id self, SEL _cmd, id command, id issueClient
         if (strncasecmp(cmdStr, "/antifly off", 12) == 0) {
             ZAF_Enabled = false;
             printf("[Anti-Fly] System disabled via command.\n");
-            ZAF_SendSystemMsg("[Anti-Fly] System: DISABLED");
+            ZAF_SendSystemMsg(issueClient, "[Anti-Fly] System: DISABLED");
         } 
         else if (strncasecmp(cmdStr, "/antifly on", 11) == 0) {
             ZAF_Enabled = true;
             printf("[Anti-Fly] System enabled via command.\n");
-            ZAF_SendSystemMsg("[Anti-Fly] System: ENABLED");
+            ZAF_SendSystemMsg(issueClient, "[Anti-Fly] System: ENABLED");
         }
         else {
-            if (ZAF_Enabled) ZAF_SendSystemMsg("[Anti-Fly] Status: ACTIVE");
-            else ZAF_SendSystemMsg("[Anti-Fly] Status: INACTIVE");
+            if (ZAF_Enabled) ZAF_SendSystemMsg(issueClient, "[Anti-Fly] Status: ACTIVE");
+            else ZAF_SendSystemMsg(issueClient, "[Anti-Fly] Status: INACTIVE");
         }
         
         return; // Prevent "Unknown Command"
@@ -230,6 +221,7 @@ static void ZAF_Hook_BH_Update(id self, SEL _cmd, float dt, float accDt, bool is
 
                     if (player->kick_cooldown <= 0.0f) {
                         printf("[Anti-Fly] Kicking ID: %s (Illegal Flight/Item)\n", strID);
+                        if (ZAF_Event) ZAF_Event("kick", "sss", "player", strID, "reason", "flight", "module", "anti_fly");
                         ZAF_Func_Boot(ZAF_Global_BHServer, ZAF_Sel_Boot, nsID, false);
                         player->kick_cooldown = 2.0f;
                     }
@@ -254,6 +246,7 @@ static void* ZAF_install_thread(void* arg) {
     ZAF_method_getImplementation = dlsym(RTLD_DEFAULT, "method_getImplementation");
     ZAF_class_getInstanceVariable = dlsym(RTLD_DEFAULT, "class_getInstanceVariable");
     ZAF_ivar_getOffset = dlsym(RTLD_DEFAULT, "ivar_getOffset");
+    ZAF_Event = (ZAF_EventFunc)dlsym(RTLD_DEFAULT, "BHEvent_Emit");
 
     Class clsGC = ZAF_objc_getClass("GameController");
     Class clsBH = ZAF_objc_getClass("Blockhead");
@@ -264,10 +257,6 @@ static void* ZAF_install_thread(void* arg) {
         ZAF_Sel_UTF8 = ZAF_sel_registerName("UTF8String");
         Method mUTF8 = ZAF_class_getInstanceMethod(clsStr, ZAF_Sel_UTF8);
         if (mUTF8) ZAF_Func_UTF8 = (ZAF_IMP_UTF8)ZAF_method_getImplementation(mUTF8);
-
-        SEL selMake = ZAF_sel_registerName("stringWithUTF8String:");
-        Method mMake = ZAF_class_getClassMethod(clsStr, selMake);
-        if (mMake) ZAF_Func_MakeStr = (ZAF_IMP_MakeStr)ZAF_method_getImplementation(mMake);
     }
 
     if (clsGC) {
@@ -293,9 +282,7 @@ static void* ZAF_install_thread(void* arg) {
         if (mAdm) ZAF_Func_IsAdmin = (ZAF_IMP_IsAdmin)ZAF_method_getImplementation(mAdm);
 
         // Chat
-        ZAF_Sel_SendChat = ZAF_sel_registerName("sendChatMessage:displayNotification:sendToClients:");
-        Method mChat = ZAF_class_getInstanceMethod(clsSrv, ZAF_Sel_SendChat);
-        if (mChat) ZAF_Func_SendChat = (ZAF_IMP_Chat)ZAF_method_getImplementation(mChat);
+        ZAF_Func_Send = (ZAF_IMP_Send)dlsym(RTLD_DEFAULT, "BHChat_Send");
 
         // Command Hook
         Method mCmd = ZAF_class_getInstanceMethod(clsSrv, ZAF_sel_registerName("handleCommand:issueClient:"));
@@ -0,0 +1,560 @@
+//Commands: none (Unix socket at $BH_CONTROL_SOCKET, default $BH_WORLD_DIR/control.sock)
+
+/*
+ * Control Socket - Console commands without screen
+ * Serves a Unix-domain socket from inside the server. Each line a client
+ * writes is one request:
+ *     <request_id> <command>
+ * e.g. "r1 /admin STEVE" or "r2 Server restarting soon". Lines starting with
+ * '/' go through BHServer handleCommand:issueClient: as console commands,
+ * anything else is sent as a server chat message, like typing into the
+ * console. All queued requests run on the main thread at the end of the next
+ * tick, so a batch of commands applies in one tick. Every request gets one
+ * JSON line back (match them by id, malformed lines are answered at once):
+ *     {"id":"r1","ok":true,"tick":1234,"output":["..."]}
+ * "output" holds the chat messages the server sent while running it. The
+ * return value of handleCommand:issueClient: is not used: several hooks in
+ * the chain (anti_fly among them) return void, so it can be garbage.
+ * The client may send any number of lines and half-close; the connection is
+ * closed once all replies are written.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <objc/runtime.h>
+#include <objc/message.h>
+
+// --- CONFIG ---
+#define CTL_CLASS_GC        "GameController"
+#define CTL_CLASS_SERVER    "BHServer"
+#define CTL_SOCKET_NAME     "control.sock"
+
+#define CTL_MAX_CLIENTS     16
+#define CTL_LINE_MAX        1024
+#define CTL_ID_MAX          64
+#define CTL_MAX_QUEUED      4096    // Requests waiting for the main thread
+#define CTL_TICK_BUDGET     1024    // Requests run per tick, the rest wait for the next one
+#define CTL_OUTPUT_MAX      4096    // Captured chat per request (JSON, truncated)
+
+// --- IMP TYPES ---
+typedef void (*CTL_TickFunc)(id, SEL, float, float);
+typedef void (*CTL_CmdFunc)(id, SEL, id, id);
+typedef void (*CTL_ChatFunc)(id, SEL, id, BOOL, id);
+typedef id (*CTL_StrFunc)(id, SEL, const char*);
+typedef const char* (*CTL_Utf8Func)(id, SEL);
+typedef id (*CTL_AllocFunc)(id, SEL);
+typedef id (*CTL_InitFunc)(id, SEL);
+typedef void (*CTL_VoidFunc)(id, SEL);
+typedef void (*CTL_FlushFunc)(id);
+
+// --- QUEUES ---
+typedef struct CTL_Request {
+    struct CTL_Request* next;
+    int      client;                // Client slot
+    unsigned gen;                   // Slot generation, replies to a closed client are dropped
+    char     reqId[CTL_ID_MAX];
+    char     text[CTL_LINE_MAX];
+} CTL_Request;
+
+typedef struct CTL_Reply {
+    struct CTL_Reply* next;
+    int      client;
+    unsigned gen;
+    size_t   len;
+    char     data[];
+} CTL_Reply;
+
+typedef struct {
+    int      fd;                    // -1 = free
+    unsigned gen;
+    char     in[CTL_LINE_MAX + CTL_ID_MAX + 2];
+    size_t   inLen;
+    bool     overflow;              // Discarding the rest of an over-long line
+    int      outstanding;           // Requests queued but not answered yet
+    bool     eof;
+} CTL_Client;
+
+// --- GLOBALS ---
+static CTL_TickFunc Real_CTL_Tick = NULL;
+static CTL_ChatFunc Real_CTL_Chat = NULL;
+static CTL_FlushFunc CTL_ChatFlush = NULL;  // BHChat_Flush, chat_queue.c
+
+static pthread_mutex_t g_CTL_Lock = PTHREAD_MUTEX_INITIALIZER;
+static CTL_Request* g_CTL_ReqHead = NULL;
+static CTL_Request* g_CTL_ReqTail = NULL;
+static int          g_CTL_ReqCount = 0;
+static CTL_Reply*   g_CTL_RepHead = NULL;
+static CTL_Reply*   g_CTL_RepTail = NULL;
+static atomic_bool  g_CTL_Pending = false;
+
+static int  g_CTL_Wake[2] = { -1, -1 };     // Main thread -> socket thread: replies ready
+static char g_CTL_Path[512];                // Checked against sun_path before binding
+static unsigned long g_CTL_Tick = 0;
+
+static CTL_Client g_CTL_Clients[CTL_MAX_CLIENTS];
+
+// Chat capture while a request runs (main thread only)
+static bool   g_CTL_Capturing = false;
+static char   g_CTL_Output[CTL_OUTPUT_MAX];
+static size_t g_CTL_OutputLen = 0;
+static int    g_CTL_OutputCount = 0;
+
+// --- UTILS ---
+
+static id CTL_Str(const char* txt) {
+    if (!txt) return nil;
+    Class cls = objc_getClass("NSString");
+    SEL s = sel_registerName("stringWithUTF8String:");
+    CTL_StrFunc f = (CTL_StrFunc)method_getImplementation(class_getClassMethod(cls, s));
+    return f ? f((id)cls, s, txt) : nil;
+}
+
+static const char* CTL_CStr(id str) {
+    if (!str) return NULL;
+    SEL s = sel_registerName("UTF8String");
+    Method m = class_getInstanceMethod(object_getClass(str), s);
+    return m ? ((CTL_Utf8Func)method_getImplementation(m))(str, s) : NULL;
+}
+
+static id CTL_Pool(void) {
+    Class cls = objc_getClass("NSAutoreleasePool");
+    SEL sA = sel_registerName("alloc");
+    SEL sI = sel_registerName("init");
+    CTL_AllocFunc fA = (CTL_AllocFunc)method_getImplementation(class_getClassMethod(cls, sA));
+    CTL_InitFunc fI = (CTL_InitFunc)method_getImplementation(class_getInstanceMethod(cls, sI));
+    return fI(fA((id)cls, sA), sI);
+}
+
+static void CTL_Drain(id pool) {
+    if (!pool) return;
+    SEL s = sel_registerName("drain");
+    ((CTL_VoidFunc)method_getImplementation(class_getInstanceMethod(object_getClass(pool), s)))(pool, s);
+}
+
+static id CTL_GetIvar(id obj, const char* name) {
+    if (!obj) return nil;
+    Ivar iv = class_getInstanceVariable(object_getClass(obj), name);
+    return iv ? *(id*)((char*)obj + ivar_getOffset(iv)) : nil;
+}
+
+// Appends txt as a JSON string literal. Returns the new length (never past size - 1).
+static size_t CTL_JsonStr(char* out, size_t len, size_t size, const char* txt) {
+    if (len + 3 > size) return len;
+    out[len++] = '"';
+    for (const unsigned char* p = (const unsigned char*)txt; *p && len + 8 < size; p++) {
+        switch (*p) {
+            case '"':  out[len++] = '\\'; out[len++] = '"'; break;
+            case '\\': out[len++] = '\\'; out[len++] = '\\'; break;
+            case '\n': out[len++] = '\\'; out[len++] = 'n'; break;
+            case '\r': out[len++] = '\\'; out[len++] = 'r'; break;
+            case '\t': out[len++] = '\\'; out[len++] = 't'; break;
+            default:
+                if (*p < 0x20) len += snprintf(out + len, size - len, "\\u%04x", *p);
+                else out[len++] = (char)*p;
+        }
+    }
+    out[len++] = '"';
+    out[len] = '\0';
+    return len;
+}
+
+static CTL_Reply* CTL_MakeReply(int client, unsigned gen, const char* line) {
+    size_t len = strlen(line);
+    CTL_Reply* r = malloc(sizeof(CTL_Reply) + len + 1);
+    if (!r) return NULL;
+    r->next = NULL;
+    r->client = client;
+    r->gen = gen;
+    r->len = len;
+    memcpy(r->data, line, len + 1);
+    return r;
+}
+
+static void CTL_FormatError(char* out, size_t size, const char* reqId, const char* error) {
+    size_t n = (size_t)snprintf(out, size, "{\"id\":");
+    n = CTL_JsonStr(out, n, size, reqId);
+    n += snprintf(out + n, size - n, ",\"ok\":false,\"error\":");
+    n = CTL_JsonStr(out, n, size, error);
+    snprintf(out + n, size - n, "}\n");
+}
+
+// --- MAIN THREAD ---
+
+void Hook_CTL_Chat(id self, SEL _cmd, id msg, BOOL notify, id clients) {
+    if (g_CTL_Capturing && g_CTL_OutputLen + 4 < sizeof(g_CTL_Output)) {
+        const char* txt = CTL_CStr(msg);
+        if (txt) {
+            if (g_CTL_OutputCount++ > 0) g_CTL_Output[g_CTL_OutputLen++] = ',';
+            g_CTL_OutputLen = CTL_JsonStr(g_CTL_Output, g_CTL_OutputLen, sizeof(g_CTL_Output), txt);
+        }
+    }
+    if (Real_CTL_Chat) Real_CTL_Chat(self, _cmd, msg, notify, clients);
+}
+
+static CTL_Reply* CTL_Execute(id server, CTL_Request* req) {
+    g_CTL_OutputLen = 0;
+    g_CTL_OutputCount = 0;
+    g_CTL_Output[0] = '\0';
+    g_CTL_Capturing = true;
+
+    if (req->text[0] == '/') {
+        SEL s = sel_registerName("handleCommand:issueClient:");
+        Method m = class_getInstanceMethod(object_getClass(server), s);
+        if (m) ((CTL_CmdFunc)method_getImplementation(m))(server, s, CTL_Str(req->text), nil);
+    } else {
+        SEL s = sel_registerName("sendChatMessage:displayNotification:sendToClients:");
+        Method m = class_getInstanceMethod(object_getClass(server), s);
+        if (m) ((CTL_ChatFunc)method_getImplementation(m))(server, s, CTL_Str(req->text), true, nil);
+    }
+    if (CTL_ChatFlush) CTL_ChatFlush(server);  // Replies queued by modules belong to this request
+    g_CTL_Capturing = false;
+
+    char line[CTL_OUTPUT_MAX + CTL_LINE_MAX + 256];
+    size_t n = (size_t)snprintf(line, sizeof(line), "{\"id\":");
+    n = CTL_JsonStr(line, n, sizeof(line), req->reqId);
+    snprintf(line + n, sizeof(line) - n, ",\"ok\":true,\"tick\":%lu,\"output\":[%s]}\n", g_CTL_Tick, g_CTL_Output);
+
+    return CTL_MakeReply(req->client, req->gen, line);
+}
+
+static void CTL_RunQueued(id server) {
+    pthread_mutex_lock(&g_CTL_Lock);
+    CTL_Request* list = g_CTL_ReqHead;
+    CTL_Request* last = list;
+    int taken = 1;
+    if (!list) {
+        pthread_mutex_unlock(&g_CTL_Lock);
+        return;
+    }
+    while (last->next && taken < CTL_TICK_BUDGET) {
+        last = last->next;
+        taken++;
+    }
+    g_CTL_ReqHead = last->next;
+    if (!g_CTL_ReqHead) g_CTL_ReqTail = NULL;
+    g_CTL_ReqCount -= taken;
+    atomic_store(&g_CTL_Pending, g_CTL_ReqHead != NULL);
+    last->next = NULL;
+    pthread_mutex_unlock(&g_CTL_Lock);
+
+    CTL_Reply* head = NULL;
+    CTL_Reply* tail = NULL;
+    id pool = CTL_Pool();
+    for (CTL_Request* req = list; req;) {
+        CTL_Reply* rep = CTL_Execute(server, req);
+        if (rep) {
+            if (tail) tail->next = rep; else head = rep;
+            tail = rep;
+        }
+        CTL_Request* next = req->next;
+        free(req);
+        req = next;
+    }
+    CTL_Drain(pool);
+
+    if (!head) return;
+    pthread_mutex_lock(&g_CTL_Lock);
+    if (g_CTL_RepTail) g_CTL_RepTail->next = head; else g_CTL_RepHead = head;
+    g_CTL_RepTail = tail;
+    pthread_mutex_unlock(&g_CTL_Lock);
+
+    char b = 1;
+    if (write(g_CTL_Wake[1], &b, 1) < 0) { /* Pipe full: socket thread is awake anyway */ }
+}
+
+void Hook_CTL_Tick(id self, SEL _cmd, float dt, float accDt) {
+    if (Real_CTL_Tick) Real_CTL_Tick(self, _cmd, dt, accDt);
+    g_CTL_Tick++;
+
+    if (!atomic_load_explicit(&g_CTL_Pending, memory_order_relaxed)) return;
+    id server = CTL_GetIvar(self, "bhServer");
+    if (server) CTL_RunQueued(server);
+}
+
+// --- SOCKET THREAD ---
+
+static void CTL_Send(CTL_Client* c, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(c->fd, data, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno == EAGAIN) {
+            struct pollfd pfd = { .fd = c->fd, .events = POLLOUT };
+            if (poll(&pfd, 1, 1000) > 0) continue;
+        }
+        if (n <= 0) {
+            c->eof = true;  // Client gone, stop writing
+            return;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+static void CTL_CloseClient(CTL_Client* c) {
+    close(c->fd);
+    c->fd = -1;
+    c->gen++;
+    c->inLen = 0;
+    c->overflow = false;
+    c->outstanding = 0;
+    c->eof = false;
+}
+
+static void CTL_HandleLine(int slot, char* line) {
+    CTL_Client* c = &g_CTL_Clients[slot];
+    size_t len = strlen(line);
+    while (len > 0 && isspace((unsigned char)line[len - 1])) line[--len] = '\0';
+    while (isspace((unsigned char)*line)) line++;
+    if (!*line) return;
+
+    char* sp = line;
+    while (*sp && !isspace((unsigned char)*sp)) sp++;
+    char* text = sp;
+    while (isspace((unsigned char)*text)) text++;
+    *sp = '\0';
+
+    char err[CTL_ID_MAX + 128];
+    if (sp - line >= CTL_ID_MAX) {
+        CTL_FormatError(err, sizeof(err), "", "request id too long");
+        CTL_Send(c, err, strlen(err));
+        return;
+    }
+    if (!*text) {
+        CTL_FormatError(err, sizeof(err), line, "empty command");
+        CTL_Send(c, err, strlen(err));
+        return;
+    }
+
+    CTL_Request* req = malloc(sizeof(CTL_Request));
+    if (!req) return;
+    req->next = NULL;
+    req->client = slot;
+    req->gen = c->gen;
+    snprintf(req->reqId, sizeof(req->reqId), "%s", line);
+    snprintf(req->text, sizeof(req->text), "%s", text);
+
+    pthread_mutex_lock(&g_CTL_Lock);
+    bool full = g_CTL_ReqCount >= CTL_MAX_QUEUED;
+    if (!full) {
+        if (g_CTL_ReqTail) g_CTL_ReqTail->next = req; else g_CTL_ReqHead = req;
+        g_CTL_ReqTail = req;
+        g_CTL_ReqCount++;
+        atomic_store(&g_CTL_Pending, true);
+    }
+    pthread_mutex_unlock(&g_CTL_Lock);
+
+    if (full) {
+        CTL_FormatError(err, sizeof(err), req->reqId, "queue full");
+        CTL_Send(c, err, strlen(err));
+        free(req);
+        return;
+    }
+    c->outstanding++;
+}
+
+static void CTL_ReadClient(int slot) {
+    CTL_Client* c = &g_CTL_Clients[slot];
+    char buf[4096];
+    ssize_t n = recv(c->fd, buf, sizeof(buf), 0);
+    if (n < 0 && (errno == EINTR || errno == EAGAIN)) return;
+    if (n <= 0) {
+        c->eof = true;
+        return;
+    }
+
+    for (ssize_t i = 0; i < n; i++) {
+        char ch = buf[i];
+        if (ch == '\n') {
+            if (!c->overflow) {
+                c->in[c->inLen] = '\0';
+                CTL_HandleLine(slot, c->in);
+            } else {
+                char err[128];
+                CTL_FormatError(err, sizeof(err), "", "line too long");
+                CTL_Send(c, err, strlen(err));
+            }
+            c->inLen = 0;
+            c->overflow = false;
+        } else if (c->inLen + 1 < sizeof(c->in)) {
+            c->in[c->inLen++] = ch;
+        } else {
+            c->overflow = true;
+        }
+    }
+}
+
+static void CTL_FlushReplies(void) {
+    pthread_mutex_lock(&g_CTL_Lock);
+    CTL_Reply* list = g_CTL_RepHead;
+    g_CTL_RepHead = g_CTL_RepTail = NULL;
+    pthread_mutex_unlock(&g_CTL_Lock);
+
+    while (list) {
+        CTL_Client* c = &g_CTL_Clients[list->client];
+        if (c->fd >= 0 && c->gen == list->gen) {
+            CTL_Send(c, list->data, list->len);
+            c->outstanding--;
+        }
+        CTL_Reply* next = list->next;
+        free(list);
+        list = next;
+    }
+}
+
+static int CTL_Listen(void) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    // A truncated path would bind somewhere clients never look
+    if (strlen(g_CTL_Path) >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    memcpy(addr.sun_path, g_CTL_Path, strlen(g_CTL_Path) + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    unlink(g_CTL_Path);
+    mode_t old = umask(0077);   // Owner only: the socket has full console rights
+    int ok = bind(fd, (struct sockaddr*)&addr, sizeof(addr));
+    umask(old);
+    if (ok < 0 || listen(fd, 8) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void* CTL_SocketThread(void* arg) {
+    int lfd = CTL_Listen();
+    if (lfd < 0 && errno == ENAMETOOLONG) {
+        printf("[Control] Cannot listen on %s: the path is %zu bytes, Unix sockets allow %zu. "
+               "Set BH_CONTROL_SOCKET to a shorter path.\n",
+               g_CTL_Path, strlen(g_CTL_Path), sizeof(((struct sockaddr_un*)0)->sun_path) - 1);
+        return NULL;
+    }
+    if (lfd < 0) {
+        printf("[Control] Cannot listen on %s: %s\n", g_CTL_Path, strerror(errno));
+        return NULL;
+    }
+    printf("[Control] Listening on %s\n", g_CTL_Path);
+
+    for (int i = 0; i < CTL_MAX_CLIENTS; i++) g_CTL_Clients[i].fd = -1;
+
+    while (1) {
+        struct pollfd pfds[CTL_MAX_CLIENTS + 2];
+        int slots[CTL_MAX_CLIENTS + 2];
+        int n = 0;
+        pfds[n].fd = lfd; pfds[n].events = POLLIN; slots[n++] = -1;
+        pfds[n].fd = g_CTL_Wake[0]; pfds[n].events = POLLIN; slots[n++] = -1;
+        for (int i = 0; i < CTL_MAX_CLIENTS; i++) {
+            if (g_CTL_Clients[i].fd < 0 || g_CTL_Clients[i].eof) continue;
+            pfds[n].fd = g_CTL_Clients[i].fd;
+            pfds[n].events = POLLIN;
+            slots[n++] = i;
+        }
+
+        if (poll(pfds, n, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (pfds[1].revents & POLLIN) {
+            char drain[64];
+            while (read(g_CTL_Wake[0], drain, sizeof(drain)) > 0) {}
+            CTL_FlushReplies();
+        }
+
+        for (int i = 2; i < n; i++) {
+            if (pfds[i].revents & (POLLIN | POLLHUP | POLLERR)) CTL_ReadClient(slots[i]);
+        }
+
+        if (pfds[0].revents & POLLIN) {
+            int cfd = accept4(lfd, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK);
+            if (cfd >= 0) {
+                int slot = -1;
+                for (int i = 0; i < CTL_MAX_CLIENTS; i++) {
+                    if (g_CTL_Clients[i].fd < 0) { slot = i; break; }
+                }
+                if (slot < 0) {
+                    char err[128];
+                    CTL_FormatError(err, sizeof(err), "", "too many clients");
+                    send(cfd, err, strlen(err), MSG_NOSIGNAL);
+                    close(cfd);
+                } else {
+                    g_CTL_Clients[slot].fd = cfd;
+                }
+            }
+        }
+
+        // Close clients that are done sending and have all their replies
+        for (int i = 0; i < CTL_MAX_CLIENTS; i++) {
+            CTL_Client* c = &g_CTL_Clients[i];
+            if (c->fd >= 0 && c->eof && c->outstanding <= 0) CTL_CloseClient(c);
+        }
+    }
+    close(lfd);
+    return NULL;
+}
+
+// --- INIT ---
+
+static void* CTL_Init(void* arg) {
+    sleep(1);
+
+    const char* path = getenv("BH_CONTROL_SOCKET");
+    const char* dir = getenv("BH_WORLD_DIR");
+    if (path && *path) snprintf(g_CTL_Path, sizeof(g_CTL_Path), "%s", path);
+    else if (dir && *dir) snprintf(g_CTL_Path, sizeof(g_CTL_Path), "%s/%s", dir, CTL_SOCKET_NAME);
+    else snprintf(g_CTL_Path, sizeof(g_CTL_Path), "%s", CTL_SOCKET_NAME);
+
+    Class clsGC = objc_getClass(CTL_CLASS_GC);
+    Class clsSrv = objc_getClass(CTL_CLASS_SERVER);
+    if (!clsGC || !clsSrv) return NULL;
+
+    Method mT = class_getInstanceMethod(clsGC, sel_registerName("update:accurateDT:"));
+    if (!mT) return NULL;
+    Real_CTL_Tick = (CTL_TickFunc)method_getImplementation(mT);
+    method_setImplementation(mT, (IMP)Hook_CTL_Tick);
+
+    Method mC = class_getInstanceMethod(clsSrv, sel_registerName("sendChatMessage:displayNotification:sendToClients:"));
+    if (mC) {
+        Real_CTL_Chat = (CTL_ChatFunc)method_getImplementation(mC);
+        method_setImplementation(mC, (IMP)Hook_CTL_Chat);
+    }
+    CTL_ChatFlush = (CTL_FlushFunc)dlsym(RTLD_DEFAULT, "BHChat_Flush");
+
+    if (pipe2(g_CTL_Wake, O_NONBLOCK | O_CLOEXEC) < 0) return NULL;
+
+    pthread_t t;
+    pthread_create(&t, NULL, CTL_SocketThread, NULL);
+    pthread_detach(t);
+    return NULL;
+}
+
+__attribute__((constructor))
+static void CTL_Entry() {
+    pthread_t t;
+    pthread_create(&t, NULL, CTL_Init, NULL);
+}
+
+__attribute__((destructor))
+static void CTL_Exit() {
+    if (g_CTL_Path[0]) unlink(g_CTL_Path);
+}
@@ -0,0 +1,300 @@
+//Commands: none (ENet datagram capture in $BH_WORLD_DIR/enet_trace.bhtr, replay with tools/bh_replay)
+
+/*
+ * ENet Tap - Packet capture for offline replay
+ * ENet is linked into blockheads_server171 itself, so its own calls to
+ * enet_host_service/enet_peer_send never go through the PLT and cannot be
+ * interposed. Everything they put on the wire still leaves through libc:
+ * ENet's unix backend reads with recvmsg() and writes with sendmsg(). This
+ * module interposes those (plus recvfrom/sendto) and records every IPv4 UDP
+ * datagram with its peer address, direction and time.
+ *
+ * The hot path only copies the datagram into the active buffer under a mutex;
+ * a background thread swaps buffers and writes them every TAP_FLUSH_MS. A full
+ * buffer drops the datagram (counted and printed on the next flush). Capture
+ * stops at BH_TAP_MAX_MB.
+ *
+ * Trace file (little endian, shared with tools/bh_replay.c):
+ *     header: "BHTR", u16 version, u16 record header size,
+ *             u64 wall clock ns, u64 monotonic ns at start, u32 reserved
+ *     record: u32 us since previous record, u8 direction (0 client->server,
+ *             1 server->client), u8 reserved, u16 peer port, u32 peer IPv4
+ *             (network order), u16 length, then the datagram bytes
+ *
+ * Config (env): BH_TAP_FILE (default $BH_WORLD_DIR/enet_trace.bhtr),
+ * BH_TAP_MAX_MB (256).
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+
+// --- CONFIG ---
+#define TAP_FILE_NAME       "enet_trace.bhtr"
+#define TAP_MAGIC           "BHTR"
+#define TAP_VERSION         1
+#define TAP_REC_HEADER      14
+#define TAP_BUFFER_SIZE     (4 * 1024 * 1024)
+#define TAP_FLUSH_MS        100
+#define TAP_MAX_MB          256             // BH_TAP_MAX_MB
+#define TAP_MAX_DATAGRAM    4096            // ENet MTU is 1400; anything larger is not ENet
+#define TAP_MAX_FD          4096
+
+enum { TAP_DIR_IN = 0, TAP_DIR_OUT = 1 };
+
+// --- TYPES ---
+typedef ssize_t (*TAP_RecvMsgFunc)(int, struct msghdr*, int);
+typedef ssize_t (*TAP_SendMsgFunc)(int, const struct msghdr*, int);
+typedef ssize_t (*TAP_RecvFromFunc)(int, void*, size_t, int, struct sockaddr*, socklen_t*);
+typedef ssize_t (*TAP_SendToFunc)(int, const void*, size_t, int, const struct sockaddr*, socklen_t);
+typedef int (*TAP_SendMMsgFunc)(int, struct mmsghdr*, unsigned int, int);
+
+typedef struct {
+    uint8_t* data;
+    size_t   len;
+} TAP_Buffer;
+
+// --- GLOBALS ---
+static TAP_RecvMsgFunc  Real_TAP_RecvMsg = NULL;
+static TAP_SendMsgFunc  Real_TAP_SendMsg = NULL;
+static TAP_RecvFromFunc Real_TAP_RecvFrom = NULL;
+static TAP_SendToFunc   Real_TAP_SendTo = NULL;
+static TAP_SendMMsgFunc Real_TAP_SendMMsg = NULL;
+
+static atomic_bool      g_TAP_On = false;
+static pthread_mutex_t  g_TAP_Lock = PTHREAD_MUTEX_INITIALIZER;
+static TAP_Buffer       g_TAP_Buf[2];
+static int              g_TAP_Active = 0;
+static uint64_t         g_TAP_LastNs = 0;
+static uint64_t         g_TAP_Dropped = 0;
+static uint64_t         g_TAP_Records = 0;
+
+static int   g_TAP_Fd = -1;
+static char  g_TAP_Path[512];
+static long  g_TAP_Written = 0;
+static long  g_TAP_MaxBytes = (long)TAP_MAX_MB << 20;
+
+// Per-fd socket type: 0 unknown, 1 UDP, 2 other
+static _Atomic uint8_t  g_TAP_FdKind[TAP_MAX_FD];
+
+// --- UTILS ---
+
+static uint64_t TAP_NowNs(clockid_t clk) {
+    struct timespec ts;
+    clock_gettime(clk, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void TAP_Resolve(void) {
+    if (!Real_TAP_RecvMsg) Real_TAP_RecvMsg = (TAP_RecvMsgFunc)dlsym(RTLD_NEXT, "recvmsg");
+    if (!Real_TAP_SendMsg) Real_TAP_SendMsg = (TAP_SendMsgFunc)dlsym(RTLD_NEXT, "sendmsg");
+    if (!Real_TAP_RecvFrom) Real_TAP_RecvFrom = (TAP_RecvFromFunc)dlsym(RTLD_NEXT, "recvfrom");
+    if (!Real_TAP_SendTo) Real_TAP_SendTo = (TAP_SendToFunc)dlsym(RTLD_NEXT, "sendto");
+    if (!Real_TAP_SendMMsg) Real_TAP_SendMMsg = (TAP_SendMMsgFunc)dlsym(RTLD_NEXT, "sendmmsg");
+}
+
+static bool TAP_IsUdp(int fd) {
+    if (fd < 0 || fd >= TAP_MAX_FD) return false;
+    uint8_t kind = atomic_load_explicit(&g_TAP_FdKind[fd], memory_order_relaxed);
+    if (kind == 0) {
+        int type = 0;
+        socklen_t len = sizeof(type);
+        kind = (getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &len) == 0 && type == SOCK_DGRAM) ? 1 : 2;
+        atomic_store_explicit(&g_TAP_FdKind[fd], kind, memory_order_relaxed);
+    }
+    return kind == 1;
+}
+
+static void TAP_Put16(uint8_t* p, uint16_t v) { p[0] = v & 0xFF; p[1] = v >> 8; }
+static void TAP_Put32(uint8_t* p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = (v >> (8 * i)) & 0xFF; }
+static void TAP_Put64(uint8_t* p, uint64_t v) { for (int i = 0; i < 8; i++) p[i] = (v >> (8 * i)) & 0xFF; }
+
+// --- CAPTURE ---
+
+// Appends one datagram gathered from iov (len bytes in total)
+static void TAP_Record(int dir, const struct sockaddr* addr, const struct iovec* iov, size_t iovCount, size_t len) {
+    if (!addr || addr->sa_family != AF_INET || len == 0 || len > TAP_MAX_DATAGRAM) return;
+    const struct sockaddr_in* in = (const struct sockaddr_in*)addr;
+
+    pthread_mutex_lock(&g_TAP_Lock);
+    TAP_Buffer* b = &g_TAP_Buf[g_TAP_Active];
+    if (b->len + TAP_REC_HEADER + len > TAP_BUFFER_SIZE) {
+        g_TAP_Dropped++;
+        pthread_mutex_unlock(&g_TAP_Lock);
+        return;
+    }
+    uint64_t now = TAP_NowNs(CLOCK_MONOTONIC);
+    uint64_t dtUs = (now - g_TAP_LastNs) / 1000;
+    g_TAP_LastNs = now;
+
+    uint8_t* p = b->data + b->len;
+    TAP_Put32(p, dtUs > UINT32_MAX ? UINT32_MAX : (uint32_t)dtUs);
+    p[4] = (uint8_t)dir;
+    p[5] = 0;
+    TAP_Put16(p + 6, ntohs(in->sin_port));
+    memcpy(p + 8, &in->sin_addr.s_addr, 4);
+    TAP_Put16(p + 12, (uint16_t)len);
+    p += TAP_REC_HEADER;
+    size_t left = len;
+    for (size_t i = 0; i < iovCount && left > 0; i++) {
+        size_t n = iov[i].iov_len < left ? iov[i].iov_len : left;
+        memcpy(p, iov[i].iov_base, n);
+        p += n;
+        left -= n;
+    }
+    b->len += TAP_REC_HEADER + len;
+    g_TAP_Records++;
+    pthread_mutex_unlock(&g_TAP_Lock);
+}
+
+// --- INTERPOSED LIBC CALLS ---
+
+ssize_t recvmsg(int fd, struct msghdr* msg, int flags) {
+    TAP_Resolve();
+    ssize_t ret = Real_TAP_RecvMsg(fd, msg, flags);
+    if (ret > 0 && atomic_load_explicit(&g_TAP_On, memory_order_relaxed) && TAP_IsUdp(fd)) {
+        TAP_Record(TAP_DIR_IN, (const struct sockaddr*)msg->msg_name, msg->msg_iov, msg->msg_iovlen, (size_t)ret);
+    }
+    return ret;
+}
+
+ssize_t sendmsg(int fd, const struct msghdr* msg, int flags) {
+    TAP_Resolve();
+    ssize_t ret = Real_TAP_SendMsg(fd, msg, flags);
+    if (ret > 0 && atomic_load_explicit(&g_TAP_On, memory_order_relaxed) && TAP_IsUdp(fd)) {
+        TAP_Record(TAP_DIR_OUT, (const struct sockaddr*)msg->msg_name, msg->msg_iov, msg->msg_iovlen, (size_t)ret);
+    }
+    return ret;
+}
+
+ssize_t recvfrom(int fd, void* buf, size_t size, int flags, struct sockaddr* addr, socklen_t* addrLen) {
+    TAP_Resolve();
+    ssize_t ret = Real_TAP_RecvFrom(fd, buf, size, flags, addr, addrLen);
+    if (ret > 0 && atomic_load_explicit(&g_TAP_On, memory_order_relaxed) && TAP_IsUdp(fd)) {
+        struct iovec iov = { buf, (size_t)ret };
+        TAP_Record(TAP_DIR_IN, addr, &iov, 1, (size_t)ret);
+    }
+    return ret;
+}
+
+ssize_t sendto(int fd, const void* buf, size_t size, int flags, const struct sockaddr* addr, socklen_t addrLen) {
+    TAP_Resolve();
+    ssize_t ret = Real_TAP_SendTo(fd, buf, size, flags, addr, addrLen);
+    if (ret > 0 && atomic_load_explicit(&g_TAP_On, memory_order_relaxed) && TAP_IsUdp(fd)) {
+        struct iovec iov = { (void*)buf, (size_t)ret };
+        TAP_Record(TAP_DIR_OUT, addr, &iov, 1, (size_t)ret);
+    }
+    return ret;
+}
+
+// net_coalesce sends its batches this way
+int sendmmsg(int fd, struct mmsghdr* msgs, unsigned int count, int flags) {
+    TAP_Resolve();
+    int ret = Real_TAP_SendMMsg(fd, msgs, count, flags);
+    if (ret > 0 && atomic_load_explicit(&g_TAP_On, memory_order_relaxed) && TAP_IsUdp(fd)) {
+        for (int i = 0; i < ret; i++) {
+            const struct msghdr* m = &msgs[i].msg_hdr;
+            TAP_Record(TAP_DIR_OUT, (const struct sockaddr*)m->msg_name, m->msg_iov, m->msg_iovlen, msgs[i].msg_len);
+        }
+    }
+    return ret;
+}
+
+// --- WRITER ---
+
+static void TAP_Flush(void) {
+    pthread_mutex_lock(&g_TAP_Lock);
+    TAP_Buffer* b = &g_TAP_Buf[g_TAP_Active];
+    g_TAP_Active ^= 1;
+    uint64_t dropped = g_TAP_Dropped;
+    g_TAP_Dropped = 0;
+    pthread_mutex_unlock(&g_TAP_Lock);
+
+    size_t off = 0;
+    while (off < b->len) {
+        ssize_t w = write(g_TAP_Fd, b->data + off, b->len - off);
+        if (w <= 0) break;
+        off += (size_t)w;
+    }
+    g_TAP_Written += (long)b->len;
+    b->len = 0;
+
+    if (dropped) printf("[Tap] Buffer full, %llu datagrams dropped\n", (unsigned long long)dropped);
+    if (g_TAP_Written >= g_TAP_MaxBytes && atomic_load(&g_TAP_On)) {
+        atomic_store(&g_TAP_On, false);
+        printf("[Tap] Trace reached %ld MB, capture stopped (%llu datagrams)\n",
+               g_TAP_MaxBytes >> 20, (unsigned long long)g_TAP_Records);
+    }
+}
+
+static void* TAP_Writer(void* arg) {
+    while (1) {
+        usleep(TAP_FLUSH_MS * 1000);
+        TAP_Flush();
+    }
+    return NULL;
+}
+
+__attribute__((constructor))
+static void TAP_Entry() {
+    TAP_Resolve();
+
+    const char* file = getenv("BH_TAP_FILE");
+    const char* dir = getenv("BH_WORLD_DIR");
+    if (file && *file) snprintf(g_TAP_Path, sizeof(g_TAP_Path), "%s", file);
+    else if (dir && *dir) snprintf(g_TAP_Path, sizeof(g_TAP_Path), "%s/%s", dir, TAP_FILE_NAME);
+    else {
+        printf("[Tap] BH_WORLD_DIR and BH_TAP_FILE not set, disabled.\n");
+        return;
+    }
+    const char* v = getenv("BH_TAP_MAX_MB");
+    if (v && atoi(v) > 0) g_TAP_MaxBytes = (long)atoi(v) << 20;
+
+    g_TAP_Fd = open(g_TAP_Path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    g_TAP_Buf[0].data = malloc(TAP_BUFFER_SIZE);
+    g_TAP_Buf[1].data = malloc(TAP_BUFFER_SIZE);
+    if (g_TAP_Fd < 0 || !g_TAP_Buf[0].data || !g_TAP_Buf[1].data) {
+        printf("[Tap] Cannot open %s, disabled.\n", g_TAP_Path);
+        return;
+    }
+
+    uint8_t header[28];
+    memcpy(header, TAP_MAGIC, 4);
+    TAP_Put16(header + 4, TAP_VERSION);
+    TAP_Put16(header + 6, TAP_REC_HEADER);
+    TAP_Put64(header + 8, TAP_NowNs(CLOCK_REALTIME));
+    g_TAP_LastNs = TAP_NowNs(CLOCK_MONOTONIC);
+    TAP_Put64(header + 16, g_TAP_LastNs);
+    memset(header + 24, 0, 4);
+    if (write(g_TAP_Fd, header, sizeof(header)) != (ssize_t)sizeof(header)) {
+        printf("[Tap] Cannot write %s, disabled.\n", g_TAP_Path);
+        return;
+    }
+    g_TAP_Written = sizeof(header);
+
+    atomic_store(&g_TAP_On, true);
+    pthread_t t;
+    pthread_create(&t, NULL, TAP_Writer, NULL);
+    pthread_detach(t);
+    printf("[Tap] Capturing ENet traffic to %s (max %ld MB)\n", g_TAP_Path, g_TAP_MaxBytes >> 20);
+}
+
+__attribute__((destructor))
+static void TAP_Exit() {
+    if (g_TAP_Fd >= 0 && g_TAP_Buf[0].data) {
+        TAP_Flush();
+        TAP_Flush();
+    }
+}
@@ -0,0 +1,442 @@
+//Commands: none (typed events as NDJSON in $BH_WORLD_DIR/events.ndjson)
+
+/*
+ * Event Log - Machine-readable event stream
+ * Writes one JSON object per line to events.ndjson next to console.log, so
+ * tools can follow joins, kicks, commands and overruns without scraping the
+ * "[Tag] ..." text of each module:
+ *     {"seq":41,"t":183220145331,"type":"player_join","player":"STEVE","ip":"1.2.3.4"}
+ * "t" is CLOCK_MONOTONIC in ns; the first line of each run ("stream_start")
+ * also carries the wall clock so it can be converted. "seq" is global; lines
+ * are grouped per thread on disk, sort by seq for exact order.
+ *
+ * Emitting never blocks and never touches stdio: the event is formatted into
+ * a per-thread ring buffer and a background thread writes all rings with
+ * writev() every EVT_FLUSH_MS. A full ring drops the event (counted in the
+ * next "events_dropped").
+ *
+ * Events of its own: player_join, player_leave (kick flag), command (every
+ * handleCommand), tick_overrun (tick longer than BH_EVENT_TICK_MS, 100).
+ * Other modules emit theirs through the exported
+ *     void BHEvent_Emit(const char* type, const char* sig, ...)
+ * where sig holds one char per field, each followed by key and value:
+ * 's' string, 'i' long long, 'd' double, 'b' bool (int). Modules look it up
+ * with dlsym(RTLD_DEFAULT, "BHEvent_Emit") and skip events when it is absent:
+ *     Event("kick", "ss", "player", name, "reason", "flight");
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <objc/runtime.h>
+#include <objc/message.h>
+
+// --- CONFIG ---
+#define EVT_CLASS_GC        "GameController"
+#define EVT_CLASS_SERVER    "BHServer"
+#define EVT_CLASS_MATCH     "BHNetServerMatch"
+#define EVT_FILE_NAME       "events.ndjson"
+
+#define EVT_RING_SIZE       (64 * 1024)     // Per thread
+#define EVT_LINE_MAX        1024
+#define EVT_FLUSH_MS        100
+#define EVT_MAX_MB          32              // BH_EVENT_MAX_MB, then events.ndjson -> events.ndjson.1
+#define EVT_TICK_MS         100             // BH_EVENT_TICK_MS
+#define EVT_MAX_PEERS       256
+
+// ENetPeer layout (ENet 1.3, x86_64): ENetAddress.host (IPv4, network order)
+#define EVT_PEER_ADDR_OFFSET 36
+
+// --- IMP TYPES ---
+typedef void (*EVT_TickFunc)(id, SEL, float, float);
+typedef id (*EVT_CmdFunc)(id, SEL, id, id);
+typedef void (*EVT_AuthFunc)(id, SEL, id, id);
+typedef void (*EVT_DiscFunc)(id, SEL, id, bool);
+typedef id (*EVT_StrFunc)(id, SEL, const char*);
+typedef id (*EVT_ObjKeyFunc)(id, SEL, id);
+typedef const char* (*EVT_Utf8Func)(id, SEL);
+typedef void* (*EVT_PtrFunc)(id, SEL);
+
+// --- RINGS ---
+typedef struct EVT_Ring {
+    struct EVT_Ring* next;
+    _Atomic uint32_t head;          // Written by the owning thread
+    _Atomic uint32_t tail;          // Written by the flusher
+    atomic_bool      dead;          // Owner exited: free once drained
+    char             data[EVT_RING_SIZE];
+} EVT_Ring;
+
+static _Atomic(EVT_Ring*) g_EVT_Rings = NULL;
+static __thread EVT_Ring* t_EVT_Ring = NULL;
+static pthread_key_t      g_EVT_Key;
+
+static _Atomic uint64_t g_EVT_Seq = 0;
+static _Atomic uint64_t g_EVT_Dropped = 0;
+static atomic_bool      g_EVT_Ready = false;
+
+static pthread_mutex_t g_EVT_FlushLock = PTHREAD_MUTEX_INITIALIZER;
+static char  g_EVT_Path[512];
+static int   g_EVT_Fd = -1;
+static off_t g_EVT_Size = 0;
+static long  g_EVT_MaxBytes = (long)EVT_MAX_MB << 20;
+static double g_EVT_TickBudget = EVT_TICK_MS;
+
+// --- GLOBALS ---
+static EVT_TickFunc Real_EVT_Tick = NULL;
+static EVT_CmdFunc  Real_EVT_Cmd = NULL;
+static EVT_AuthFunc Real_EVT_Auth = NULL;
+static EVT_DiscFunc Real_EVT_Disc = NULL;
+
+typedef struct {
+    void* peer;
+    char  name[32];
+} EVT_Peer;
+
+static pthread_mutex_t g_EVT_PeerLock = PTHREAD_MUTEX_INITIALIZER;
+static EVT_Peer        g_EVT_Peers[EVT_MAX_PEERS];
+static uint64_t        g_EVT_Tick = 0;
+
+// --- UTILS ---
+
+static uint64_t EVT_NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static size_t EVT_JsonStr(char* out, size_t len, size_t size, const char* txt) {
+    if (len + 3 > size) return len;
+    out[len++] = '"';
+    for (const unsigned char* p = (const unsigned char*)(txt ? txt : ""); *p && len + 8 < size; p++) {
+        switch (*p) {
+            case '"':  out[len++] = '\\'; out[len++] = '"'; break;
+            case '\\': out[len++] = '\\'; out[len++] = '\\'; break;
+            case '\n': out[len++] = '\\'; out[len++] = 'n'; break;
+            case '\r': out[len++] = '\\'; out[len++] = 'r'; break;
+            case '\t': out[len++] = '\\'; out[len++] = 't'; break;
+            default:
+                if (*p < 0x20) len += snprintf(out + len, size - len, "\\u%04x", *p);
+                else out[len++] = (char)*p;
+        }
+    }
+    out[len++] = '"';
+    out[len] = '\0';
+    return len;
+}
+
+static void EVT_ThreadExit(void* ring) {
+    if (ring) atomic_store(&((EVT_Ring*)ring)->dead, true);
+}
+
+static EVT_Ring* EVT_MyRing(void) {
+    if (t_EVT_Ring) return t_EVT_Ring;
+    EVT_Ring* r = calloc(1, sizeof(EVT_Ring));
+    if (!r) return NULL;
+    r->next = atomic_load(&g_EVT_Rings);
+    while (!atomic_compare_exchange_weak(&g_EVT_Rings, &r->next, r)) { }
+    pthread_setspecific(g_EVT_Key, r);
+    t_EVT_Ring = r;
+    return r;
+}
+
+// --- EMIT ---
+
+static void EVT_Push(const char* line, size_t len) {
+    EVT_Ring* r = EVT_MyRing();
+    if (!r) {
+        atomic_fetch_add(&g_EVT_Dropped, 1);
+        return;
+    }
+    uint32_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+    if (EVT_RING_SIZE - (head - tail) < len) {
+        atomic_fetch_add(&g_EVT_Dropped, 1);
+        return;
+    }
+    size_t at = head % EVT_RING_SIZE;
+    size_t first = EVT_RING_SIZE - at < len ? EVT_RING_SIZE - at : len;
+    memcpy(r->data + at, line, first);
+    memcpy(r->data, line + first, len - first);
+    atomic_store_explicit(&r->head, head + (uint32_t)len, memory_order_release);
+}
+
+static void EVT_EmitV(const char* type, const char* sig, va_list ap) {
+    if (!atomic_load_explicit(&g_EVT_Ready, memory_order_relaxed)) return;
+
+    char line[EVT_LINE_MAX];
+    size_t n = (size_t)snprintf(line, sizeof(line), "{\"seq\":%llu,\"t\":%llu,\"type\":",
+                                (unsigned long long)atomic_fetch_add(&g_EVT_Seq, 1) + 1,
+                                (unsigned long long)EVT_NowNs());
+    n = EVT_JsonStr(line, n, sizeof(line), type);
+
+    for (const char* f = sig ? sig : ""; *f && n + 64 < sizeof(line); f++) {
+        const char* key = va_arg(ap, const char*);
+        line[n++] = ',';
+        // Short limit for the key, so the value always fits and the line stays valid JSON
+        n = EVT_JsonStr(line, n, sizeof(line) - 48, key);
+        line[n++] = ':';
+        switch (*f) {
+            case 's': n = EVT_JsonStr(line, n, sizeof(line) - 16, va_arg(ap, const char*)); break;
+            case 'i': n += (size_t)snprintf(line + n, sizeof(line) - n, "%lld", va_arg(ap, long long)); break;
+            case 'd': n += (size_t)snprintf(line + n, sizeof(line) - n, "%.3f", va_arg(ap, double)); break;
+            case 'b': n += (size_t)snprintf(line + n, sizeof(line) - n, "%s", va_arg(ap, int) ? "true" : "false"); break;
+            default:  n += (size_t)snprintf(line + n, sizeof(line) - n, "null"); break;
+        }
+    }
+    line[n++] = '}';
+    line[n++] = '\n';
+    EVT_Push(line, n);
+}
+
+// Exported for other modules (dlsym "BHEvent_Emit")
+void BHEvent_Emit(const char* type, const char* sig, ...) {
+    va_list ap;
+    va_start(ap, sig);
+    EVT_EmitV(type, sig, ap);
+    va_end(ap);
+}
+
+// --- FLUSHER ---
+
+static void EVT_OpenFile(void) {
+    g_EVT_Fd = open(g_EVT_Path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    struct stat st;
+    g_EVT_Size = (g_EVT_Fd >= 0 && fstat(g_EVT_Fd, &st) == 0) ? st.st_size : 0;
+}
+
+static void EVT_Rotate(void) {
+    char old[600];
+    snprintf(old, sizeof(old), "%s.1", g_EVT_Path);
+    if (g_EVT_Fd >= 0) close(g_EVT_Fd);
+    rename(g_EVT_Path, old);
+    EVT_OpenFile();
+}
+
+// Events (lines) held in ring bytes [tail, head)
+static uint64_t EVT_CountLines(const EVT_Ring* r, uint32_t tail, uint32_t head) {
+    uint64_t lines = 0;
+    for (uint32_t i = tail; i != head; i++) {
+        if (r->data[i % EVT_RING_SIZE] == '\n') lines++;
+    }
+    return lines;
+}
+
+static void EVT_FlushAll(void) {
+    uint64_t dropped = atomic_exchange(&g_EVT_Dropped, 0);
+    if (dropped) BHEvent_Emit("events_dropped", "i", "count", (long long)dropped);
+
+    pthread_mutex_lock(&g_EVT_FlushLock);
+    EVT_Ring* prev = NULL;
+    for (EVT_Ring* r = atomic_load(&g_EVT_Rings); r;) {
+        EVT_Ring* next = r->next;
+        bool dead = atomic_load(&r->dead);
+        uint32_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+        uint32_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+
+        if (head != tail && g_EVT_Fd >= 0 && g_EVT_Size > g_EVT_MaxBytes) EVT_Rotate();
+        // A short write is finished before the next ring, so lines never interleave
+        while (tail != head && g_EVT_Fd >= 0) {
+            struct iovec iov[2];
+            size_t at = tail % EVT_RING_SIZE, len = head - tail;
+            size_t first = EVT_RING_SIZE - at < len ? EVT_RING_SIZE - at : len;
+            iov[0] = (struct iovec){ r->data + at, first };
+            iov[1] = (struct iovec){ r->data, len - first };
+            ssize_t w = writev(g_EVT_Fd, iov, len > first ? 2 : 1);
+            if (w < 0 && errno == EINTR) continue;
+            if (w <= 0) break;
+            g_EVT_Size += w;
+            tail += (uint32_t)w;
+        }
+        // No file or a failed write: what is left is lost, and counted
+        if (tail != head) atomic_fetch_add(&g_EVT_Dropped, EVT_CountLines(r, tail, head));
+        atomic_store_explicit(&r->tail, head, memory_order_release);
+
+        // Only the flusher unlinks, and never the list head (pushes race there)
+        if (dead && prev) {
+            prev->next = next;
+            free(r);
+        } else {
+            prev = r;
+        }
+        r = next;
+    }
+    pthread_mutex_unlock(&g_EVT_FlushLock);
+}
+
+static void* EVT_Flusher(void* arg) {
+    while (1) {
+        usleep(EVT_FLUSH_MS * 1000);
+        EVT_FlushAll();
+    }
+    return NULL;
+}
+
+// --- OBJC HELPERS ---
+
+static id EVT_Str(const char* txt) {
+    Class cls = objc_getClass("NSString");
+    SEL s = sel_registerName("stringWithUTF8String:");
+    Method m = class_getClassMethod(cls, s);
+    return m ? ((EVT_StrFunc)method_getImplementation(m))((id)cls, s, txt) : nil;
+}
+
+static const char* EVT_CStr(id str) {
+    if (!str) return NULL;
+    SEL s = sel_registerName("UTF8String");
+    Method m = class_getInstanceMethod(object_getClass(str), s);
+    return m ? ((EVT_Utf8Func)method_getImplementation(m))(str, s) : NULL;
+}
+
+// Client of a command: "console" when nil, its text when it is a string,
+// its class name otherwise
+static const char* EVT_Describe(id client) {
+    if (!client) return "console";
+    const char* txt = EVT_CStr(client);
+    return txt ? txt : class_getName(object_getClass(client));
+}
+
+static void* EVT_RawPeer(id peerWrapper) {
+    if (!peerWrapper) return NULL;
+    SEL s = sel_registerName("pointerValue");
+    Method m = class_getInstanceMethod(object_getClass(peerWrapper), s);
+    return m ? ((EVT_PtrFunc)method_getImplementation(m))(peerWrapper, s) : NULL;
+}
+
+// --- HOOKS ---
+
+void Hook_EVT_Tick(id self, SEL _cmd, float dt, float accDt) {
+    uint64_t t0 = EVT_NowNs();
+    if (Real_EVT_Tick) Real_EVT_Tick(self, _cmd, dt, accDt);
+    g_EVT_Tick++;
+
+    double ms = (EVT_NowNs() - t0) / 1e6;
+    if (ms > g_EVT_TickBudget) {
+        BHEvent_Emit("tick_overrun", "idd", "tick", (long long)g_EVT_Tick, "ms", ms, "budget_ms", g_EVT_TickBudget);
+    }
+}
+
+id Hook_EVT_Cmd(id self, SEL _cmd, id commandStr, id client) {
+    const char* text = EVT_CStr(commandStr);
+    if (text) BHEvent_Emit("command", "ss", "client", EVT_Describe(client), "command", text);
+    return Real_EVT_Cmd ? Real_EVT_Cmd(self, _cmd, commandStr, client) : nil;
+}
+
+void Hook_EVT_Auth(id self, SEL _cmd, id infoDict, id peerWrapper) {
+    if (Real_EVT_Auth) Real_EVT_Auth(self, _cmd, infoDict, peerWrapper);
+
+    const char* alias = NULL;
+    if (infoDict) {
+        SEL s = sel_registerName("objectForKey:");
+        Method m = class_getInstanceMethod(object_getClass(infoDict), s);
+        if (m) alias = EVT_CStr(((EVT_ObjKeyFunc)method_getImplementation(m))(infoDict, s, EVT_Str("alias")));
+    }
+    void* peer = EVT_RawPeer(peerWrapper);
+    if (!alias || !peer) return;
+
+    char ip[INET_ADDRSTRLEN] = "unknown";
+    inet_ntop(AF_INET, (char*)peer + EVT_PEER_ADDR_OFFSET, ip, sizeof(ip));
+    BHEvent_Emit("player_join", "ss", "player", alias, "ip", ip);
+
+    pthread_mutex_lock(&g_EVT_PeerLock);
+    int slot = -1;
+    for (int i = 0; i < EVT_MAX_PEERS; i++) {
+        if (g_EVT_Peers[i].peer == peer) { slot = i; break; }
+        if (slot < 0 && !g_EVT_Peers[i].peer) slot = i;
+    }
+    if (slot >= 0) {
+        g_EVT_Peers[slot].peer = peer;
+        snprintf(g_EVT_Peers[slot].name, sizeof(g_EVT_Peers[slot].name), "%s", alias);
+    }
+    pthread_mutex_unlock(&g_EVT_PeerLock);
+}
+
+void Hook_EVT_Disconnect(id self, SEL _cmd, id peerWrapper, bool wasKick) {
+    void* peer = EVT_RawPeer(peerWrapper);
+    if (peer) {
+        char name[32] = "";
+        pthread_mutex_lock(&g_EVT_PeerLock);
+        for (int i = 0; i < EVT_MAX_PEERS; i++) {
+            if (g_EVT_Peers[i].peer != peer) continue;
+            snprintf(name, sizeof(name), "%s", g_EVT_Peers[i].name);
+            g_EVT_Peers[i].peer = NULL;
+            break;
+        }
+        pthread_mutex_unlock(&g_EVT_PeerLock);
+        if (name[0]) BHEvent_Emit("player_leave", "sb", "player", name, "kick", (int)wasKick);
+    }
+
+    if (Real_EVT_Disc) Real_EVT_Disc(self, _cmd, peerWrapper, wasKick);
+}
+
+// --- INIT ---
+
+static void EVT_Swap(Class cls, const char* selName, IMP hook, IMP* real) {
+    if (!cls) return;
+    Method m = class_getInstanceMethod(cls, sel_registerName(selName));
+    if (!m) return;
+    *real = method_getImplementation(m);
+    method_setImplementation(m, hook);
+}
+
+static void* EVT_Init(void* arg) {
+    sleep(1);
+
+    Class clsGC = objc_getClass(EVT_CLASS_GC);
+    Class clsServer = objc_getClass(EVT_CLASS_SERVER);
+    Class clsMatch = objc_getClass(EVT_CLASS_MATCH);
+    EVT_Swap(clsGC, "update:accurateDT:", (IMP)Hook_EVT_Tick, (IMP*)&Real_EVT_Tick);
+    EVT_Swap(clsServer, "handleCommand:issueClient:", (IMP)Hook_EVT_Cmd, (IMP*)&Real_EVT_Cmd);
+    EVT_Swap(clsMatch, "clientPlayerInformationRecieved:fromPeer:", (IMP)Hook_EVT_Auth, (IMP*)&Real_EVT_Auth);
+    EVT_Swap(clsMatch, "clientDisconnected:wasKick:", (IMP)Hook_EVT_Disconnect, (IMP*)&Real_EVT_Disc);
+
+    printf("[Events] Writing %s (tick overrun > %.0f ms)\n", g_EVT_Path, g_EVT_TickBudget);
+    return NULL;
+}
+
+__attribute__((constructor))
+static void EVT_Entry() {
+    const char* dir = getenv("BH_WORLD_DIR");
+    if (!dir || !*dir) {
+        printf("[Events] BH_WORLD_DIR not set, disabled.\n");
+        return;
+    }
+    snprintf(g_EVT_Path, sizeof(g_EVT_Path), "%s/%s", dir, EVT_FILE_NAME);
+    const char* v = getenv("BH_EVENT_MAX_MB");
+    if (v && atoi(v) > 0) g_EVT_MaxBytes = (long)atoi(v) << 20;
+    v = getenv("BH_EVENT_TICK_MS");
+    if (v && atof(v) > 0) g_EVT_TickBudget = atof(v);
+
+    pthread_key_create(&g_EVT_Key, EVT_ThreadExit);
+    EVT_OpenFile();
+    atomic_store(&g_EVT_Ready, true);
+
+    struct timespec wall;
+    clock_gettime(CLOCK_REALTIME, &wall);
+    BHEvent_Emit("stream_start", "ii", "pid", (long long)getpid(),
+                 "wall_ms", (long long)wall.tv_sec * 1000 + wall.tv_nsec / 1000000);
+
+    pthread_t t;
+    pthread_create(&t, NULL, EVT_Flusher, NULL);
+    pthread_detach(t);
+    pthread_create(&t, NULL, EVT_Init, NULL);
+    pthread_detach(t);
+}
+
+__attribute__((destructor))
+static void EVT_Exit() {
+    if (atomic_load(&g_EVT_Ready)) EVT_FlushAll();
+}
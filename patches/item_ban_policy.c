@@ -0,0 +1,567 @@
+//Commands: none (edit banned_items.conf in the world folder, changes apply within a few seconds)
+
+/*
+ * Item Ban Policy - One engine for every banned placeable
+ * Replaces portal_patch, trade_portal_patch, portal_chest_patch and
+ * freight_car_patch. Banned item IDs live in a 65536-bit set loaded from
+ * $BH_WORLD_DIR/banned_items.conf (or BH_BAN_CONFIG); a ban check is one bit test.
+ * Each placement/load initializer of the target classes is hooked once; what
+ * happens to a banned object depends on its class:
+ *   Workbench, TradePortal: placement refused, removed on load.
+ *   Chest:                  placed then removed, item given back to the player.
+ *   FreightCar:             placement refused, the freight car item is dropped.
+ * The file is watched; on change the new set is swapped in atomically and the
+ * objects already in the world are swept once on the next tick.
+ * Only those four object kinds are enforced: a banned ID can still be held in
+ * inventories, dropped, crafted or traded.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include <objc/runtime.h>
+#include <objc/message.h>
+
+// --- CONFIG ---
+#define IBP_CONFIG_NAME     "banned_items.conf"
+#define IBP_MAX_ID          65536
+#define IBP_POLL_SECONDS    2       // Config file mtime check interval
+#define IBP_MAX_HOOKS       16
+
+#define IBP_FREIGHT_ITEM    206     // FreightCar placement has no item, it is always this one
+
+// Selectors
+#define IBP_SEL_PLACE       "initWithWorld:dynamicWorld:atPosition:cache:item:flipped:saveDict:placedByClient:clientName:"
+#define IBP_SEL_LOAD        "initWithWorld:dynamicWorld:saveDict:cache:"
+#define IBP_SEL_FC_PLACE    "initWithWorld:dynamicWorld:atPosition:cache:saveDict:placedByClient:"
+#define IBP_SEL_FC_LOAD     "initWithWorld:dynamicWorld:saveDict:chestSaveDict:cache:"
+#define IBP_SEL_FC_NET      "initWithWorld:dynamicWorld:cache:netData:"
+#define IBP_SEL_SWEEP       "update:accurateDT:isSimulation:" // DynamicWorld, sweeps when one is pending
+#define IBP_SEL_SPAWN       "createFreeBlockAtPosition:ofType:dataA:dataB:subItems:dynamicObjectSaveDict:hovers:playSound:priorityBlockhead:"
+
+// Written when no config exists yet: the bans the old per-item patches hardcoded
+static const char* IBP_DEFAULT_CONFIG =
+    "# Banned item IDs, one per line. Ranges (134-139) and # comments are allowed.\n"
+    "# Enforced only where Workbench, TradePortal, Chest and FreightCar objects are placed\n"
+    "# or loaded; the items themselves can still be held, dropped, crafted and traded.\n"
+    "# Edits are picked up while the server runs; objects already in the world are swept.\n"
+    "\n"
+    "# Portals (Workbench)\n"
+    "134-139\n"
+    "\n"
+    "# Freight car\n"
+    "206\n"
+    "\n"
+    "# Trade portal\n"
+    "210\n"
+    "\n"
+    "# Portal chest\n"
+    "1074\n";
+
+// --- IMP TYPES ---
+typedef id (*IBP_PlaceFunc)(id, SEL, id, id, long long, id, id, unsigned char, id, id, id);
+typedef id (*IBP_LoadFunc)(id, SEL, id, id, id, id);
+typedef id (*IBP_FCPlaceFunc)(id, SEL, id, id, long long, id, id, id);
+typedef id (*IBP_FCLoadFunc)(id, SEL, id, id, id, id, id);
+typedef id (*IBP_FCNetFunc)(id, SEL, id, id, id, id);
+typedef void (*IBP_UpdateFunc)(id, SEL, float, float, bool);
+typedef id (*IBP_SpawnFunc)(id, SEL, long long, int, int, int, id, id, BOOL, BOOL, id);
+typedef int (*IBP_IntFunc)(id, SEL);
+typedef long long (*IBP_PosFunc)(id, SEL);
+typedef void (*IBP_VoidFunc)(id, SEL);
+typedef void (*IBP_BoolFunc)(id, SEL, BOOL);
+typedef id (*IBP_ObjFunc)(id, SEL);
+typedef unsigned long (*IBP_CountFunc)(id, SEL);
+typedef id (*IBP_IdxFunc)(id, SEL, unsigned long);
+typedef const char* (*IBP_Utf8Func)(id, SEL);
+
+// --- MEMORY LAYOUT (dynamicObjects, same as ban_all_new_drops) ---
+struct RbNode_Base {
+    unsigned long _color;
+    struct RbNode_Base* _parent;
+    struct RbNode_Base* _left;
+    struct RbNode_Base* _right;
+};
+
+struct RbNode {
+    struct RbNode_Base base;
+    uint64_t key;
+    id value;
+};
+
+struct RbTree_Impl {
+    unsigned long _pad;
+    struct RbNode_Base _header;
+    size_t _node_count;
+};
+
+// --- TARGETS ---
+typedef enum {
+    IBP_ACT_REJECT,     // Refuse placement, remove on load
+    IBP_ACT_REFUND,     // Let it place, then remove it and give the item back
+    IBP_ACT_FIXED       // The whole class is one item: refuse and drop that item
+} IBP_Action;
+
+typedef struct {
+    const char* className;
+    IBP_Action  action;
+    int         fixedID;        // IBP_ACT_FIXED: the item this class stands for
+    bool        typeFallback;   // Use objectType when destroyItemType is 0
+    bool        detachOnLoad;   // Also removeFromMacroBlock when removing on load
+    Class       cls;
+} IBP_Target;
+
+static IBP_Target g_IBP_Targets[] = {
+    { "Workbench",   IBP_ACT_REJECT, 0,                false, true,  Nil },
+    { "TradePortal", IBP_ACT_REJECT, 0,                true,  false, Nil },
+    { "Chest",       IBP_ACT_REFUND, 0,                false, false, Nil },
+    { "FreightCar",  IBP_ACT_FIXED,  IBP_FREIGHT_ITEM, false, false, Nil },
+};
+#define IBP_TARGET_COUNT ((int)(sizeof(g_IBP_Targets) / sizeof(g_IBP_Targets[0])))
+
+// --- GLOBALS ---
+// Two bitsets: the watcher fills the inactive one and swaps the pointer
+static uint64_t g_IBP_Bits[2][IBP_MAX_ID / 64];
+static _Atomic(uint64_t*) g_IBP_Active = g_IBP_Bits[0];
+static char g_IBP_Path[512];
+
+// One entry per hooked Method; inherited initializers are only hooked once
+typedef struct {
+    Method m;
+    IMP    real;
+} IBP_Hook;
+
+static IBP_Hook g_IBP_Hooks[IBP_MAX_HOOKS];
+static int      g_IBP_HookCount = 0;
+
+static IBP_UpdateFunc Real_IBP_Sweep = NULL;
+
+typedef void (*IBP_EventFunc)(const char*, const char*, ...);
+static IBP_EventFunc IBP_Event = NULL; // event_log.c, when loaded
+typedef id (*IBP_FindFunc)(const char*);
+static IBP_FindFunc IBP_FindByName = NULL; // player_registry.c, when loaded
+static atomic_bool    g_IBP_SweepPending = false;
+
+// --- POLICY ---
+
+static inline bool IBP_IsBanned(int itemID) {
+    const uint64_t* bits = atomic_load_explicit(&g_IBP_Active, memory_order_acquire);
+    return (unsigned)itemID < IBP_MAX_ID && ((bits[itemID >> 6] >> (itemID & 63)) & 1);
+}
+
+// Exported for other modules (dlsym "BHBan_IsBanned")
+bool BHBan_IsBanned(int itemID) {
+    return IBP_IsBanned(itemID);
+}
+
+// Returns the number of banned IDs, or -1 if the file can't be read
+static int IBP_Parse(const char* path, uint64_t* bits) {
+    FILE* f = fopen(path, "r");
+    if (!f) return -1;
+
+    memset(bits, 0, sizeof(g_IBP_Bits[0]));
+    char line[256];
+    int lineNo = 0;
+    int total = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        lineNo++;
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char* p = line;
+        while (*p) {
+            while (*p && (isspace((unsigned char)*p) || *p == ',')) p++;
+            if (!*p) break;
+
+            char* end;
+            long lo = strtol(p, &end, 10);
+            if (end == p) {
+                printf("[BanPolicy] %s:%d: not an item ID, rest of line ignored\n", path, lineNo);
+                break;
+            }
+            long hi = lo;
+            p = end;
+            if (*p == '-') {
+                p++;
+                hi = strtol(p, &end, 10);
+                if (end == p) {
+                    printf("[BanPolicy] %s:%d: incomplete range\n", path, lineNo);
+                    break;
+                }
+                p = end;
+            }
+            if (lo < 1 || hi >= IBP_MAX_ID || hi < lo) {
+                printf("[BanPolicy] %s:%d: ID out of range (1-%d)\n", path, lineNo, IBP_MAX_ID - 1);
+                continue;
+            }
+            for (long i = lo; i <= hi; i++) {
+                if (!(bits[i >> 6] & (1ULL << (i & 63)))) total++;
+                bits[i >> 6] |= 1ULL << (i & 63);
+            }
+        }
+    }
+    fclose(f);
+    return total;
+}
+
+static bool IBP_Reload(void) {
+    uint64_t* cur = atomic_load(&g_IBP_Active);
+    uint64_t* next = (cur == g_IBP_Bits[0]) ? g_IBP_Bits[1] : g_IBP_Bits[0];
+
+    int count = IBP_Parse(g_IBP_Path, next);
+    if (count < 0) {
+        printf("[BanPolicy] Cannot read %s, keeping current bans.\n", g_IBP_Path);
+        return false;
+    }
+    atomic_store_explicit(&g_IBP_Active, next, memory_order_release);
+    printf("[BanPolicy] %d banned item ID(s) loaded from %s\n", count, g_IBP_Path);
+    return true;
+}
+
+static void IBP_ResolvePath(void) {
+    const char* cfg = getenv("BH_BAN_CONFIG");
+    const char* dir = getenv("BH_WORLD_DIR");
+    if (cfg && *cfg) snprintf(g_IBP_Path, sizeof(g_IBP_Path), "%s", cfg);
+    else if (dir && *dir) snprintf(g_IBP_Path, sizeof(g_IBP_Path), "%s/%s", dir, IBP_CONFIG_NAME);
+    else snprintf(g_IBP_Path, sizeof(g_IBP_Path), "%s", IBP_CONFIG_NAME);
+
+    if (access(g_IBP_Path, F_OK) != 0) {
+        FILE* f = fopen(g_IBP_Path, "w");
+        if (f) {
+            fputs(IBP_DEFAULT_CONFIG, f);
+            fclose(f);
+            printf("[BanPolicy] Created default %s\n", g_IBP_Path);
+        }
+    }
+}
+
+// --- OBJC HELPERS ---
+
+static bool IBP_IsValidPtr(void* ptr) {
+    uintptr_t addr = (uintptr_t)ptr;
+    return (addr > 0x400000 && addr < 0x7fffffffffff && (addr % 8 == 0));
+}
+
+static IMP IBP_Method(id obj, const char* selName, SEL* outSel) {
+    if (!obj) return NULL;
+    SEL s = sel_registerName(selName);
+    Method m = class_getInstanceMethod(object_getClass(obj), s);
+    if (!m) return NULL;
+    *outSel = s;
+    return method_getImplementation(m);
+}
+
+static int IBP_GetInt(id obj, const char* selName) {
+    SEL s;
+    IBP_IntFunc f = (IBP_IntFunc)IBP_Method(obj, selName, &s);
+    return f ? f(obj, s) : 0;
+}
+
+static long long IBP_GetPos(id obj) {
+    SEL s;
+    IBP_PosFunc f = (IBP_PosFunc)IBP_Method(obj, "pos", &s);
+    return f ? f(obj, s) : -1;
+}
+
+static void IBP_SoftRemove(id obj) {
+    SEL s;
+    IBP_BoolFunc f = (IBP_BoolFunc)IBP_Method(obj, "setNeedsRemoved:", &s);
+    if (f) f(obj, s, 1);
+}
+
+static void IBP_Detach(id obj) {
+    SEL s;
+    IBP_VoidFunc f = (IBP_VoidFunc)IBP_Method(obj, "removeFromMacroBlock", &s);
+    if (f) f(obj, s);
+}
+
+static void IBP_ChestRemove(id obj) {
+    SEL s;
+    IBP_BoolFunc f = (IBP_BoolFunc)IBP_Method(obj, "remove:", &s);
+    if (f) f(obj, s, 1);
+}
+
+static void IBP_Spawn(id dynWorld, long long pos, int itemID, id blockhead) {
+    if (!dynWorld || pos == -1) return;
+    SEL s;
+    IBP_SpawnFunc f = (IBP_SpawnFunc)IBP_Method(dynWorld, IBP_SEL_SPAWN, &s);
+    if (f) f(dynWorld, s, pos, itemID, 0, 0, nil, nil, 1, 0, blockhead);
+}
+
+static const char* IBP_CStr(id str) {
+    SEL s;
+    IBP_Utf8Func f = (IBP_Utf8Func)IBP_Method(str, "UTF8String", &s);
+    return f ? f(str, s) : NULL;
+}
+
+static const char* IBP_BlockheadName(id bh) {
+    SEL s;
+    IBP_ObjFunc f = (IBP_ObjFunc)IBP_Method(bh, "clientName", &s);
+    if (f) return IBP_CStr(f(bh, s));
+
+    Ivar iv = class_getInstanceVariable(object_getClass(bh), "clientName");
+    return iv ? IBP_CStr(*(id*)((char*)bh + ivar_getOffset(iv))) : NULL;
+}
+
+static id IBP_ScanList(id list, const char* name) {
+    SEL sCount = NULL, sIdx = NULL;
+    IBP_CountFunc fCount = (IBP_CountFunc)IBP_Method(list, "count", &sCount);
+    IBP_IdxFunc fIdx = (IBP_IdxFunc)IBP_Method(list, "objectAtIndex:", &sIdx);
+    if (!fCount || !fIdx) return nil;
+
+    unsigned long count = fCount(list, sCount);
+    for (unsigned long i = 0; i < count; i++) {
+        id bh = fIdx(list, sIdx, i);
+        const char* bhName = bh ? IBP_BlockheadName(bh) : NULL;
+        if (bhName && strcasecmp(bhName, name) == 0) return bh;
+    }
+    return nil;
+}
+
+// Refunds go to the placing player's blockhead when it can be found
+static id IBP_FindBlockhead(id dynWorld, id clientName) {
+    const char* name = IBP_CStr(clientName);
+    if (!dynWorld || !name) return nil;
+    // The registry misses blockheads that have not updated since it loaded
+    id found = IBP_FindByName ? IBP_FindByName(name) : nil;
+    if (found) return found;
+
+    SEL s;
+    IBP_ObjFunc f = (IBP_ObjFunc)IBP_Method(dynWorld, "allBlockheadsIncludingNet", &s);
+    if (f) {
+        id list = f(dynWorld, s);
+        if (list) return IBP_ScanList(list, name);
+    }
+    Ivar iv = class_getInstanceVariable(object_getClass(dynWorld), "netBlockheads");
+    return iv ? IBP_ScanList(*(id*)((char*)dynWorld + ivar_getOffset(iv)), name) : nil;
+}
+
+// --- HOOK BOOKKEEPING ---
+
+// Original IMP for the initializer this hook was entered through. Walks up from
+// the object's class so subclasses calling [super init...] still find it.
+static IMP IBP_Real(id self, SEL _cmd) {
+    for (Class c = object_getClass(self); c; c = class_getSuperclass(c)) {
+        Method m = class_getInstanceMethod(c, _cmd);
+        for (int i = 0; i < g_IBP_HookCount; i++) {
+            if (g_IBP_Hooks[i].m == m) return g_IBP_Hooks[i].real;
+        }
+    }
+    return NULL;
+}
+
+static IBP_Target* IBP_FindTarget(id obj) {
+    if (!obj) return NULL;
+    for (Class c = object_getClass(obj); c; c = class_getSuperclass(c)) {
+        for (int i = 0; i < IBP_TARGET_COUNT; i++) {
+            if (g_IBP_Targets[i].cls == c) return &g_IBP_Targets[i];
+        }
+    }
+    return NULL;
+}
+
+static void IBP_Install(Class cls, const char* selName, IMP hook) {
+    Method m = class_getInstanceMethod(cls, sel_registerName(selName));
+    if (!m) return;
+    for (int i = 0; i < g_IBP_HookCount; i++) {
+        if (g_IBP_Hooks[i].m == m) return;
+    }
+    if (g_IBP_HookCount >= IBP_MAX_HOOKS) return;
+
+    g_IBP_Hooks[g_IBP_HookCount].m = m;
+    g_IBP_Hooks[g_IBP_HookCount].real = method_getImplementation(m);
+    g_IBP_HookCount++;
+    method_setImplementation(m, hook);
+}
+
+// --- ENFORCEMENT ---
+
+// Item ID an existing object stands for
+static int IBP_ObjectID(IBP_Target* t, id obj) {
+    if (t->action == IBP_ACT_FIXED) return t->fixedID;
+    int itemID = IBP_GetInt(obj, "destroyItemType");
+    if (itemID == 0 && t->typeFallback) itemID = IBP_GetInt(obj, "objectType");
+    return itemID;
+}
+
+// Removes an existing object if it is banned. Returns true if it was.
+static bool IBP_Enforce(IBP_Target* t, id obj, id dynWorld, bool detach) {
+    int itemID = IBP_ObjectID(t, obj);
+    if (!IBP_IsBanned(itemID)) return false;
+
+    switch (t->action) {
+        case IBP_ACT_REJECT:
+            if (detach) IBP_Detach(obj);
+            break;
+        case IBP_ACT_REFUND:
+        case IBP_ACT_FIXED:
+            IBP_Spawn(dynWorld, IBP_GetPos(obj), itemID, nil);
+            break;
+    }
+    IBP_SoftRemove(obj);
+    return true;
+}
+
+// --- HOOKS ---
+
+id IBP_Hook_Place(id self, SEL _cmd, id world, id dynWorld, long long pos, id cache, id item, unsigned char flipped, id saveDict, id client, id clientName) {
+    IBP_PlaceFunc real = (IBP_PlaceFunc)IBP_Real(self, _cmd);
+    IBP_Target* t = IBP_FindTarget(self);
+    int itemID = (t && item) ? IBP_GetInt(item, "itemType") : 0;
+    bool banned = IBP_IsBanned(itemID);
+
+    if (banned && t->action != IBP_ACT_REFUND) return NULL;
+
+    id obj = real ? real(self, _cmd, world, dynWorld, pos, cache, item, flipped, saveDict, client, clientName) : NULL;
+    if (!obj || !t) return obj;
+
+    if (banned) {
+        IBP_ChestRemove(obj);
+        IBP_Spawn(dynWorld, pos, itemID, IBP_FindBlockhead(dynWorld, clientName));
+    }
+    return obj;
+}
+
+id IBP_Hook_Load(id self, SEL _cmd, id world, id dynWorld, id saveDict, id cache) {
+    IBP_LoadFunc real = (IBP_LoadFunc)IBP_Real(self, _cmd);
+    id obj = real ? real(self, _cmd, world, dynWorld, saveDict, cache) : NULL;
+
+    IBP_Target* t = IBP_FindTarget(obj);
+    if (t) IBP_Enforce(t, obj, dynWorld, t->detachOnLoad);
+    return obj;
+}
+
+id IBP_Hook_FCPlace(id self, SEL _cmd, id world, id dynWorld, long long pos, id cache, id saveDict, id client) {
+    if (IBP_IsBanned(IBP_FREIGHT_ITEM)) {
+        IBP_Spawn(dynWorld, pos, IBP_FREIGHT_ITEM, nil);
+        return NULL;
+    }
+    IBP_FCPlaceFunc real = (IBP_FCPlaceFunc)IBP_Real(self, _cmd);
+    return real ? real(self, _cmd, world, dynWorld, pos, cache, saveDict, client) : NULL;
+}
+
+id IBP_Hook_FCLoad(id self, SEL _cmd, id world, id dynWorld, id saveDict, id chestDict, id cache) {
+    IBP_FCLoadFunc real = (IBP_FCLoadFunc)IBP_Real(self, _cmd);
+    id obj = real ? real(self, _cmd, world, dynWorld, saveDict, chestDict, cache) : NULL;
+
+    IBP_Target* t = IBP_FindTarget(obj);
+    if (t) IBP_Enforce(t, obj, dynWorld, t->detachOnLoad);
+    return obj;
+}
+
+id IBP_Hook_FCNet(id self, SEL _cmd, id world, id dynWorld, id cache, id netData) {
+    if (IBP_IsBanned(IBP_FREIGHT_ITEM)) return NULL;
+    IBP_FCNetFunc real = (IBP_FCNetFunc)IBP_Real(self, _cmd);
+    return real ? real(self, _cmd, world, dynWorld, cache, netData) : NULL;
+}
+
+// --- SWEEP ---
+// Objects loaded before the hooks, or placed before a ban was added, are found by
+// walking dynamicObjects once on the main thread. The DynamicWorld update hook is
+// installed once at init; between sweeps it costs one atomic load per world update.
+
+static int IBP_SweepNode(struct RbNode_Base* node, id dynWorld, int depth) {
+    if (!node || depth > 500 || !IBP_IsValidPtr(node)) return 0;
+    int removed = 0;
+
+    id obj = ((struct RbNode*)node)->value;
+    if (obj && IBP_IsValidPtr(obj)) {
+        IBP_Target* t = IBP_FindTarget(obj);
+        if (t && IBP_Enforce(t, obj, dynWorld, true)) removed++;
+    }
+
+    removed += IBP_SweepNode(node->_left, dynWorld, depth + 1);
+    removed += IBP_SweepNode(node->_right, dynWorld, depth + 1);
+    return removed;
+}
+
+static void IBP_SweepWorld(id dynWorld) {
+    Ivar mapIvar = class_getInstanceVariable(object_getClass(dynWorld), "dynamicObjects");
+    if (!mapIvar) return;
+
+    struct RbTree_Impl* maps = (struct RbTree_Impl*)((char*)dynWorld + ivar_getOffset(mapIvar));
+    int removed = 0;
+    for (int i = 0; i < 65; i++) {
+        if (maps[i]._node_count == 0 || maps[i]._node_count > 1000000) continue;
+        removed += IBP_SweepNode(maps[i]._header._parent, dynWorld, 0);
+    }
+    if (removed > 0) printf("[BanPolicy] Sweep removed %d banned object(s).\n", removed);
+    if (IBP_Event) IBP_Event("ban_sweep", "i", "removed", (long long)removed);
+}
+
+void IBP_Hook_Sweep(id self, SEL _cmd, float dt, float accDt, bool isSim) {
+    // Cleared before the pass: a request arriving during it is kept for the next one
+    if (atomic_load_explicit(&g_IBP_SweepPending, memory_order_relaxed) &&
+        atomic_exchange(&g_IBP_SweepPending, false)) {
+        IBP_SweepWorld(self);
+    }
+    if (Real_IBP_Sweep) Real_IBP_Sweep(self, _cmd, dt, accDt, isSim);
+}
+
+// --- INIT ---
+
+static void* IBP_InitThread(void* arg) {
+    sleep(2);
+
+    IBP_Event = (IBP_EventFunc)dlsym(RTLD_DEFAULT, "BHEvent_Emit");
+    IBP_FindByName = (IBP_FindFunc)dlsym(RTLD_DEFAULT, "BHPlayer_FindByName");
+    IBP_ResolvePath();
+    IBP_Reload();
+
+    for (int i = 0; i < IBP_TARGET_COUNT; i++) {
+        IBP_Target* t = &g_IBP_Targets[i];
+        t->cls = objc_getClass(t->className);
+        if (!t->cls) continue;
+
+        if (t->action == IBP_ACT_FIXED) {
+            IBP_Install(t->cls, IBP_SEL_FC_PLACE, (IMP)IBP_Hook_FCPlace);
+            IBP_Install(t->cls, IBP_SEL_FC_LOAD, (IMP)IBP_Hook_FCLoad);
+            IBP_Install(t->cls, IBP_SEL_FC_NET, (IMP)IBP_Hook_FCNet);
+        } else {
+            IBP_Install(t->cls, IBP_SEL_PLACE, (IMP)IBP_Hook_Place);
+            IBP_Install(t->cls, IBP_SEL_LOAD, (IMP)IBP_Hook_Load);
+        }
+    }
+    printf("[BanPolicy] %d initializer(s) hooked.\n", g_IBP_HookCount);
+
+    Class clsDW = objc_getClass("DynamicWorld");
+    Method mSweep = clsDW ? class_getInstanceMethod(clsDW, sel_registerName(IBP_SEL_SWEEP)) : NULL;
+    if (mSweep) {
+        Real_IBP_Sweep = (IBP_UpdateFunc)method_getImplementation(mSweep);
+        method_setImplementation(mSweep, (IMP)IBP_Hook_Sweep);
+        atomic_store(&g_IBP_SweepPending, true);
+    } else {
+        printf("[BanPolicy] DynamicWorld update not found, objects already in the world are not swept.\n");
+    }
+
+    // Watch the config file
+    struct stat last;
+    bool haveLast = (stat(g_IBP_Path, &last) == 0);
+    while (1) {
+        sleep(IBP_POLL_SECONDS);
+        struct stat st;
+        if (stat(g_IBP_Path, &st) != 0) continue;
+        if (haveLast && st.st_mtime == last.st_mtime && st.st_size == last.st_size && st.st_ino == last.st_ino) continue;
+        last = st;
+        haveLast = true;
+        if (IBP_Reload()) atomic_store(&g_IBP_SweepPending, true);
+    }
+    return NULL;
+}
+
+__attribute__((constructor))
+static void IBP_Entry() {
+    pthread_t t;
+    pthread_create(&t, NULL, IBP_InitThread, NULL);
+}
@@ -0,0 +1,543 @@
+//Commands: none (console.log writer; live tail on $BH_WORLD_DIR/console.sock)
+
+/*
+ * Log Sink - Batched console.log writer with rotation
+ * Replaces the `| tee -a console.log` of the start script. At load, stdout and
+ * stderr are pointed at a pipe drained by a small helper process forked from
+ * the server. The helper keeps the output in a ring buffer and writes it with
+ * one writev() per batch (SINK_BATCH_BYTES or SINK_FLUSH_MS, whichever comes
+ * first) to console.log and to the original terminal (the screen session).
+ * Living in its own process, it still drains and writes everything the server
+ * printed when the server crashes.
+ *
+ * console.log is rotated once it passes BH_LOG_MAX_MB or is BH_LOG_ROTATE_HOURS
+ * old: it is renamed to console.log.YYYYMMDD-HHMMSS, gzip'd in the background,
+ * and only the newest BH_LOG_KEEP archives are kept.
+ *
+ * Consumers can subscribe on console.sock instead of tail -F: after connecting
+ * they send one line, "raw" (plain lines, as in console.log) or "json"
+ *     {"seq":812,"ts":1760000000123,"line":"..."}
+ * and then receive every line as soon as the server writes it, without
+ * waiting for the disk batch. Subscribers that fall SINK_SUB_BACKLOG behind
+ * are dropped.
+ *
+ * Only active when BH_LOG_FILE is set (server_manager.sh does it when this
+ * patch is enabled).
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+// --- CONFIG ---
+#define SINK_SOCKET_NAME    "console.sock"
+#define SINK_RING_SIZE      (1 << 20)   // Bytes buffered between the pipe and the disk
+#define SINK_PIPE_SIZE      (1 << 20)   // F_SETPIPE_SZ request for the server side
+#define SINK_BATCH_BYTES    16384       // Flush once this much is pending...
+#define SINK_FLUSH_MS       50          // ...or the oldest pending byte is this old
+#define SINK_MAX_MB         64          // BH_LOG_MAX_MB
+#define SINK_ROTATE_HOURS   24          // BH_LOG_ROTATE_HOURS (0 = size only)
+#define SINK_KEEP           10          // BH_LOG_KEEP
+#define SINK_MAX_SUBS       16
+#define SINK_SUB_BACKLOG    (1 << 20)
+#define SINK_LINE_MAX       4096        // Longer lines are cut for subscribers
+
+// --- STATE (helper process) ---
+typedef struct {
+    int    fd;              // -1 = free
+    int    mode;            // 0 = waiting for the mode line, 1 = raw, 2 = json
+    bool   halfClosed;      // Peer is done writing, keep sending
+    char   req[16];
+    size_t reqLen;
+    char*  out;
+    size_t outLen;
+    size_t outCap;
+} SINK_Sub;
+
+static char     g_SINK_Ring[SINK_RING_SIZE];
+static uint64_t g_SINK_Head = 0;        // Bytes read from the pipe
+static uint64_t g_SINK_Tail = 0;        // Bytes written to console.log
+static uint64_t g_SINK_SubPos = 0;      // Bytes handed to subscribers (line aligned)
+static uint64_t g_SINK_Seq = 0;
+static double   g_SINK_PendingSince = 0;
+
+static SINK_Sub g_SINK_Subs[SINK_MAX_SUBS];
+
+static char   g_SINK_LogPath[512];
+static char   g_SINK_SockPath[512];
+static ino_t  g_SINK_SockIno = 0;
+static int    g_SINK_LogFd = -1;
+static int    g_SINK_TtyFd = -1;
+static off_t  g_SINK_LogSize = 0;
+static time_t g_SINK_OpenedAt = 0;
+static long   g_SINK_MaxBytes = (long)SINK_MAX_MB << 20;
+static int    g_SINK_RotateHours = SINK_ROTATE_HOURS;
+static int    g_SINK_Keep = SINK_KEEP;
+
+// --- UTILS ---
+
+static double SINK_NowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static int SINK_EnvInt(const char* name, int def) {
+    const char* v = getenv(name);
+    return (v && *v) ? atoi(v) : def;
+}
+
+static void SINK_WriteAll(int fd, struct iovec* iov, int cnt) {
+    while (cnt > 0) {
+        ssize_t n = writev(fd, iov, cnt);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;     // Disk full or terminal gone: drop rather than stall the server
+        }
+        while (cnt > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            cnt--;
+        }
+        if (cnt > 0) {
+            iov->iov_base = (char*)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+}
+
+// Up to two iovecs covering ring bytes [from, to)
+static int SINK_RingIov(uint64_t from, uint64_t to, struct iovec* iov) {
+    size_t start = (size_t)(from % SINK_RING_SIZE);
+    size_t len = (size_t)(to - from);
+    size_t first = SINK_RING_SIZE - start;
+    if (len <= first) {
+        iov[0] = (struct iovec){ g_SINK_Ring + start, len };
+        return len ? 1 : 0;
+    }
+    iov[0] = (struct iovec){ g_SINK_Ring + start, first };
+    iov[1] = (struct iovec){ g_SINK_Ring, len - first };
+    return 2;
+}
+
+// --- ROTATION ---
+
+static int SINK_CmpDesc(const void* a, const void* b) {
+    return strcmp(*(char* const*)b, *(char* const*)a);
+}
+
+// Archives are named console.log.YYYYMMDD-HHMMSS[.gz]: sorting names sorts by age
+static void SINK_Prune(void) {
+    char pattern[600];
+    snprintf(pattern, sizeof(pattern), "%s.*", g_SINK_LogPath);
+    glob_t g;
+    if (glob(pattern, 0, NULL, &g) != 0) return;
+    qsort(g.gl_pathv, g.gl_pathc, sizeof(char*), SINK_CmpDesc);
+    for (size_t i = (size_t)g_SINK_Keep; i < g.gl_pathc; i++) unlink(g.gl_pathv[i]);
+    globfree(&g);
+}
+
+// Time of the last rotation, taken from the newest archive name
+static time_t SINK_LastRotation(void) {
+    char pattern[600];
+    snprintf(pattern, sizeof(pattern), "%s.*", g_SINK_LogPath);
+    glob_t g;
+    time_t when = time(NULL);
+    if (glob(pattern, 0, NULL, &g) != 0) return when;
+    qsort(g.gl_pathv, g.gl_pathc, sizeof(char*), SINK_CmpDesc);
+
+    struct tm tm = { 0 };
+    const char* stamp = g.gl_pathv[0] + strlen(g_SINK_LogPath) + 1;
+    if (strptime(stamp, "%Y%m%d-%H%M%S", &tm)) {
+        tm.tm_isdst = -1;
+        when = mktime(&tm);
+    }
+    globfree(&g);
+    return when;
+}
+
+static void SINK_OpenLog(void) {
+    g_SINK_LogFd = open(g_SINK_LogPath, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    struct stat st;
+    g_SINK_LogSize = (g_SINK_LogFd >= 0 && fstat(g_SINK_LogFd, &st) == 0) ? st.st_size : 0;
+}
+
+static void SINK_Rotate(void) {
+    char stamp[32], archive[600];
+    time_t now = time(NULL);
+    struct tm tm;
+    localtime_r(&now, &tm);
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+    snprintf(archive, sizeof(archive), "%s.%s", g_SINK_LogPath, stamp);
+    char gz[610];
+    struct stat st;
+    for (int i = 1; snprintf(gz, sizeof(gz), "%s.gz", archive), stat(archive, &st) == 0 || stat(gz, &st) == 0; i++) {
+        snprintf(archive, sizeof(archive), "%s.%s_%d", g_SINK_LogPath, stamp, i);
+    }
+
+    if (g_SINK_LogFd >= 0) close(g_SINK_LogFd);
+    if (rename(g_SINK_LogPath, archive) == 0) {
+        // gzip runs without LD_PRELOAD, or every patch would start up inside it.
+        // The environment is built before fork(): only exec is safe in the child.
+        int n = 0;
+        while (environ[n]) n++;
+        char** env = malloc(sizeof(char*) * (size_t)(n + 1));
+        if (env) {
+            int k = 0;
+            for (int i = 0; i < n; i++) {
+                if (strncmp(environ[i], "LD_PRELOAD=", 11) != 0) env[k++] = environ[i];
+            }
+            env[k] = NULL;
+            char* argv[] = { "gzip", "-q", "-f", archive, NULL };
+            pid_t pid = fork();
+            if (pid == 0) {
+                execvpe("gzip", argv, env);
+                _exit(127);
+            }
+            free(env);
+        }
+    }
+    SINK_OpenLog();
+    g_SINK_OpenedAt = now;
+    SINK_Prune();
+}
+
+// --- DISK ---
+
+static void SINK_Flush(void) {
+    if (g_SINK_Head == g_SINK_Tail) return;
+
+    bool aged = g_SINK_RotateHours > 0 && time(NULL) - g_SINK_OpenedAt >= (time_t)g_SINK_RotateHours * 3600;
+    if (g_SINK_LogSize > 0 && (g_SINK_LogSize + (off_t)(g_SINK_Head - g_SINK_Tail) > g_SINK_MaxBytes || aged)) {
+        SINK_Rotate();
+    }
+
+    struct iovec iov[2];
+    int cnt = SINK_RingIov(g_SINK_Tail, g_SINK_Head, iov);
+    if (g_SINK_LogFd >= 0) {
+        struct iovec copy[2] = { iov[0], iov[1] };
+        SINK_WriteAll(g_SINK_LogFd, copy, cnt);
+    }
+    if (g_SINK_TtyFd >= 0) SINK_WriteAll(g_SINK_TtyFd, iov, cnt);
+
+    g_SINK_LogSize += (off_t)(g_SINK_Head - g_SINK_Tail);
+    g_SINK_Tail = g_SINK_Head;
+    g_SINK_PendingSince = 0;
+}
+
+// --- SUBSCRIBERS ---
+
+static void SINK_DropSub(SINK_Sub* s) {
+    close(s->fd);
+    free(s->out);
+    memset(s, 0, sizeof(*s));
+    s->fd = -1;
+}
+
+static void SINK_SubAppend(SINK_Sub* s, const char* data, size_t len) {
+    if (s->outLen + len > SINK_SUB_BACKLOG) {
+        SINK_DropSub(s);
+        return;
+    }
+    if (s->outLen + len > s->outCap) {
+        size_t cap = s->outCap ? s->outCap : 8192;
+        while (cap < s->outLen + len) cap *= 2;
+        char* p = realloc(s->out, cap);
+        if (!p) {
+            SINK_DropSub(s);
+            return;
+        }
+        s->out = p;
+        s->outCap = cap;
+    }
+    memcpy(s->out + s->outLen, data, len);
+    s->outLen += len;
+}
+
+static size_t SINK_JsonLine(char* out, size_t size, uint64_t seq, const char* line, size_t len) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    size_t n = (size_t)snprintf(out, size, "{\"seq\":%llu,\"ts\":%lld,\"line\":\"", (unsigned long long)seq,
+                                (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+    for (size_t i = 0; i < len && n + 8 < size; i++) {
+        unsigned char c = (unsigned char)line[i];
+        switch (c) {
+            case '"':  out[n++] = '\\'; out[n++] = '"'; break;
+            case '\\': out[n++] = '\\'; out[n++] = '\\'; break;
+            case '\r': out[n++] = '\\'; out[n++] = 'r'; break;
+            case '\t': out[n++] = '\\'; out[n++] = 't'; break;
+            default:
+                if (c < 0x20) n += (size_t)snprintf(out + n, size - n, "\\u%04x", c);
+                else out[n++] = (char)c;
+        }
+    }
+    n += (size_t)snprintf(out + n, size - n, "\"}\n");
+    return n < size ? n : size - 1;
+}
+
+// Hands every complete line read since the last call to the subscribers
+static void SINK_Publish(void) {
+    static char line[SINK_LINE_MAX + 1];
+    static char json[SINK_LINE_MAX * 6 + 96];
+
+    while (g_SINK_SubPos < g_SINK_Head) {
+        uint64_t avail = g_SINK_Head - g_SINK_SubPos;
+        size_t len = 0;
+        bool complete = false;
+        for (; len < avail && len < SINK_LINE_MAX; len++) {
+            char c = g_SINK_Ring[(g_SINK_SubPos + len) % SINK_RING_SIZE];
+            if (c == '\n') {
+                complete = true;
+                break;
+            }
+            line[len] = c;
+        }
+        if (!complete && len < SINK_LINE_MAX) return;   // Wait for the rest of the line
+        g_SINK_SubPos += len + (complete ? 1 : 0);
+        line[len] = '\n';
+        g_SINK_Seq++;
+
+        size_t jsonLen = 0;
+        for (int i = 0; i < SINK_MAX_SUBS; i++) {
+            SINK_Sub* s = &g_SINK_Subs[i];
+            if (s->fd < 0 || s->mode == 0) continue;
+            if (s->mode == 1) {
+                SINK_SubAppend(s, line, len + 1);
+            } else {
+                if (!jsonLen) jsonLen = SINK_JsonLine(json, sizeof(json), g_SINK_Seq, line, len);
+                SINK_SubAppend(s, json, jsonLen);
+            }
+        }
+    }
+}
+
+static void SINK_SubWrite(SINK_Sub* s) {
+    while (s->outLen > 0) {
+        ssize_t n = send(s->fd, s->out, s->outLen, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) SINK_DropSub(s);
+            return;
+        }
+        memmove(s->out, s->out + n, s->outLen - (size_t)n);
+        s->outLen -= (size_t)n;
+    }
+}
+
+static void SINK_SubRead(SINK_Sub* s) {
+    char buf[64];
+    ssize_t n = recv(s->fd, buf, sizeof(buf), 0);
+    if (n == 0 && s->mode == 0) {
+        SINK_DropSub(s);
+        return;
+    }
+    if (n == 0) s->halfClosed = true;       // Subscribers may half-close after the mode line
+    if (n <= 0 || s->mode != 0) return;
+
+    for (ssize_t i = 0; i < n && s->mode == 0; i++) {
+        if (buf[i] == '\n' || s->reqLen + 1 >= sizeof(s->req)) {
+            s->req[s->reqLen] = '\0';
+            if (s->reqLen && s->req[s->reqLen - 1] == '\r') s->req[--s->reqLen] = '\0';
+            if (strcmp(s->req, "raw") == 0) s->mode = 1;
+            else if (strcmp(s->req, "json") == 0) s->mode = 2;
+            else {
+                const char* err = "{\"error\":\"send raw or json\"}\n";
+                send(s->fd, err, strlen(err), MSG_NOSIGNAL);
+                SINK_DropSub(s);
+            }
+            return;
+        }
+        s->req[s->reqLen++] = buf[i];
+    }
+}
+
+// Empty when the path did not fit (SINK_Entry logged it): no tail socket then
+static int SINK_Listen(void) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    size_t len = strlen(g_SINK_SockPath);
+    if (len == 0 || len >= sizeof(addr.sun_path)) return -1;
+    memcpy(addr.sun_path, g_SINK_SockPath, len + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    unlink(g_SINK_SockPath);
+
+    mode_t old = umask(0077);
+    int ok = bind(fd, (struct sockaddr*)&addr, sizeof(addr));
+    umask(old);
+    struct stat st;
+    if (ok != 0 || listen(fd, 8) != 0 || stat(g_SINK_SockPath, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    g_SINK_SockIno = st.st_ino;
+    return fd;
+}
+
+// --- HELPER PROCESS ---
+
+static void SINK_Run(int pipeFd) {
+    for (int i = 0; i < SINK_MAX_SUBS; i++) g_SINK_Subs[i].fd = -1;
+    SINK_OpenLog();
+    g_SINK_OpenedAt = SINK_LastRotation();
+    int lfd = SINK_Listen();
+
+    struct pollfd pfds[2 + SINK_MAX_SUBS];
+    int map[2 + SINK_MAX_SUBS];
+    bool eof = false;
+
+    while (!eof || g_SINK_Head != g_SINK_Tail) {
+        int n = 0;
+        bool roomy = g_SINK_Head - g_SINK_Tail < SINK_RING_SIZE;
+        pfds[n++] = (struct pollfd){ .fd = (roomy && !eof) ? pipeFd : -1, .events = POLLIN };
+        pfds[n++] = (struct pollfd){ .fd = lfd, .events = POLLIN };
+        for (int i = 0; i < SINK_MAX_SUBS; i++) {
+            SINK_Sub* s = &g_SINK_Subs[i];
+            if (s->fd < 0) continue;
+            map[n] = i;
+            pfds[n++] = (struct pollfd){ .fd = s->fd, .events = (s->halfClosed ? 0 : POLLIN) | (s->outLen ? POLLOUT : 0) };
+        }
+
+        int timeout = -1;
+        if (eof || !roomy) timeout = 0;
+        else if (g_SINK_PendingSince > 0) {
+            timeout = (int)(g_SINK_PendingSince + SINK_FLUSH_MS - SINK_NowMs());
+            if (timeout < 0) timeout = 0;
+        }
+        if (poll(pfds, n, timeout) < 0 && errno != EINTR) break;
+        while (waitpid(-1, NULL, WNOHANG) > 0) { }
+
+        if (pfds[0].revents & (POLLIN | POLLHUP)) {
+            struct iovec iov[2];
+            int cnt = SINK_RingIov(g_SINK_Head, g_SINK_Tail + SINK_RING_SIZE, iov);
+            ssize_t got = readv(pipeFd, iov, cnt);
+            if (got > 0) {
+                if (g_SINK_PendingSince == 0) g_SINK_PendingSince = SINK_NowMs();
+                g_SINK_Head += (uint64_t)got;
+                SINK_Publish();
+            } else if (got == 0 || (errno != EINTR && errno != EAGAIN)) {
+                eof = true;
+            }
+        }
+
+        if (pfds[1].revents & POLLIN) {
+            int cfd = accept4(lfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (cfd >= 0) {
+                int slot = -1;
+                for (int i = 0; i < SINK_MAX_SUBS && slot < 0; i++) if (g_SINK_Subs[i].fd < 0) slot = i;
+                if (slot < 0) close(cfd);
+                else g_SINK_Subs[slot].fd = cfd;
+            }
+        }
+
+        for (int k = 2; k < n; k++) {
+            SINK_Sub* s = &g_SINK_Subs[map[k]];
+            if (s->fd != pfds[k].fd) continue;
+            if ((pfds[k].revents & (POLLERR | POLLNVAL)) || ((pfds[k].revents & POLLHUP) && s->halfClosed)) {
+                SINK_DropSub(s);
+                continue;
+            }
+            if (pfds[k].revents & (POLLIN | POLLHUP)) SINK_SubRead(s);
+            if (s->fd >= 0 && s->outLen) SINK_SubWrite(s);
+        }
+
+        bool due = g_SINK_PendingSince > 0 && SINK_NowMs() - g_SINK_PendingSince >= SINK_FLUSH_MS;
+        if (eof || !roomy || due || g_SINK_Head - g_SINK_Tail >= SINK_BATCH_BYTES) SINK_Flush();
+    }
+
+    for (int i = 0; i < SINK_MAX_SUBS; i++) {
+        if (g_SINK_Subs[i].fd >= 0) SINK_SubWrite(&g_SINK_Subs[i]);
+    }
+    // A restarted server may already have bound a new socket under the same name
+    struct stat st;
+    if (lfd >= 0 && stat(g_SINK_SockPath, &st) == 0 && st.st_ino == g_SINK_SockIno) unlink(g_SINK_SockPath);
+    if (g_SINK_LogFd >= 0) fsync(g_SINK_LogFd);
+}
+
+// --- INIT ---
+
+__attribute__((constructor))
+static void SINK_Entry() {
+    const char* file = getenv("BH_LOG_FILE");
+    if (!file || !*file) return;
+
+    snprintf(g_SINK_LogPath, sizeof(g_SINK_LogPath), "%s", file);
+    const char* sock = getenv("BH_LOG_SOCKET");
+    int sockLen;
+    if (sock && *sock) {
+        sockLen = snprintf(g_SINK_SockPath, sizeof(g_SINK_SockPath), "%s", sock);
+    } else {
+        char dir[512];
+        snprintf(dir, sizeof(dir), "%s", file);
+        char* slash = strrchr(dir, '/');
+        if (slash) *slash = '\0';
+        else snprintf(dir, sizeof(dir), ".");
+        sockLen = snprintf(g_SINK_SockPath, sizeof(g_SINK_SockPath), "%s/%s", dir, SINK_SOCKET_NAME);
+    }
+    // sun_path is 108 bytes; a truncated path would bind (and leave a socket file) where nobody looks
+    char sockError[640] = "";
+    if (sockLen >= (int)sizeof(((struct sockaddr_un*)0)->sun_path)) {
+        snprintf(sockError, sizeof(sockError), "[LogSink] No tail socket: %s is %d bytes, Unix sockets allow %zu. "
+                 "Set BH_LOG_SOCKET to a shorter path.",
+                 g_SINK_SockPath, sockLen, sizeof(((struct sockaddr_un*)0)->sun_path) - 1);
+        g_SINK_SockPath[0] = '\0';
+    }
+    g_SINK_MaxBytes = (long)SINK_EnvInt("BH_LOG_MAX_MB", SINK_MAX_MB) << 20;
+    g_SINK_RotateHours = SINK_EnvInt("BH_LOG_ROTATE_HOURS", SINK_ROTATE_HOURS);
+    g_SINK_Keep = SINK_EnvInt("BH_LOG_KEEP", SINK_KEEP);
+    unsetenv("BH_LOG_FILE");    // Child processes inherit LD_PRELOAD, not the sink (gzip gets neither)
+
+    int p[2];
+    if (pipe2(p, O_CLOEXEC) != 0) return;
+    fcntl(p[1], F_SETPIPE_SZ, SINK_PIPE_SIZE);
+
+    int tty = dup(STDOUT_FILENO);
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(p[0]);
+        close(p[1]);
+        close(tty);
+        return;
+    }
+    if (pid == 0) {
+        // Helper: outlives the server until the pipe is drained
+        signal(SIGINT, SIG_IGN);
+        signal(SIGTERM, SIG_IGN);
+        signal(SIGHUP, SIG_IGN);
+        signal(SIGPIPE, SIG_IGN);
+        close(p[1]);
+        dup2(tty, STDOUT_FILENO);
+        dup2(tty, STDERR_FILENO);
+        g_SINK_TtyFd = tty;
+        fcntl(p[0], F_SETFL, O_NONBLOCK);
+        SINK_Run(p[0]);
+        _exit(0);
+    }
+
+    close(p[0]);
+    close(tty);
+    dup2(p[1], STDOUT_FILENO);
+    dup2(p[1], STDERR_FILENO);
+    close(p[1]);
+    setvbuf(stdout, NULL, _IOLBF, 0);   // Module printf lines show up right away
+    printf("[LogSink] Writing %s (helper pid %d, tail socket %s)\n", g_SINK_LogPath, (int)pid, g_SINK_SockPath[0] ? g_SINK_SockPath : "off");
+    if (sockError[0]) printf("%s\n", sockError);
+}
@@ -0,0 +1,396 @@
+//Commands: /coalesce (send batching stats)
+
+/*
+ * Net Coalesce - Batched outbound ENet datagrams
+ * ENet is linked into the server binary, so enet_peer_send() cannot be
+ * interposed; what leaves the process are its libc sendmsg() calls, one per
+ * datagram. Busy ticks (explosions, WorldEdit jobs, crowds moving) end up as
+ * many small datagrams per client, each a syscall.
+ * This patch holds outbound UDP datagrams in a queue instead:
+ *   - A datagram for a client that already has one queued is appended to it
+ *     when both fit in NCO_MERGE_MTU: ENet datagrams are a header followed by
+ *     commands, so the commands are moved under the first header. Only
+ *     datagrams with the same sentTime (or none) are merged, since the
+ *     client echoes the header's sentTime in its acknowledgements and ENet
+ *     measures round trips from it. NCO_MERGE_MTU is ENet's protocol
+ *     minimum, so a merged datagram fits whatever MTU the client negotiated.
+ *     Channels and sequence numbers live in the commands and are untouched;
+ *     the client sees ordinary ENet datagrams.
+ *   - The queue is sent with one sendmmsg() when ENet goes back to receiving
+ *     on the socket, at the end of every GameController tick, when it is
+ *     full, or after NCO_FLUSH_US at the latest.
+ * Compressed datagrams are batched but never merged, and nothing is merged
+ * when the server uses ENet checksums (NCO_ENET_CHECKSUM).
+ * ENet has already counted a held datagram as sent, so one that sendmmsg()
+ * fails on is lost; those are counted and logged. Holding adds latency, so
+ * the patch only batches when BH_COALESCE=1 is set; /coalesce reports how
+ * long datagrams were held to judge whether that is worth it.
+ * enet_tap and net_stats interpose sendmmsg() too, so they keep seeing the
+ * traffic whichever order the patches are loaded in.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <objc/runtime.h>
+#include <objc/message.h>
+
+// --- CONFIG ---
+#define NCO_CLASS_GC        "GameController"
+#define NCO_CLASS_SERVER    "BHServer"
+
+#define NCO_QUEUE           256         // Datagrams held at once
+#define NCO_MTU             1400        // ENet's default host MTU, larger datagrams pass through
+#define NCO_MERGE_MTU       576         // ENET_PROTOCOL_MINIMUM_MTU, no merged datagram grows past it
+#define NCO_FLUSH_US        1000        // Longest a datagram waits
+#define NCO_FAIL_LOG_SEC    10
+#define NCO_MAX_FD          4096
+#define NCO_ENET_CHECKSUM   0           // 1 if the server enables ENet CRC32 checksums
+
+// --- IMP TYPES ---
+typedef void (*NCO_TickFunc)(id, SEL, float, float);
+typedef id (*NCO_CmdFunc)(id, SEL, id, id);
+typedef void (*NCO_SendFunc)(id, id, const char*, bool);
+typedef const char* (*NCO_Utf8Func)(id, SEL);
+
+typedef ssize_t (*NCO_SendMsgFunc)(int, const struct msghdr*, int);
+typedef ssize_t (*NCO_RecvMsgFunc)(int, struct msghdr*, int);
+typedef int (*NCO_SendMMsgFunc)(int, struct mmsghdr*, unsigned int, int);
+
+// --- QUEUE (g_NCO_Lock) ---
+typedef struct {
+    int      fd;
+    int      flags;
+    struct sockaddr_in addr;
+    uint16_t len;
+    uint64_t at;
+    uint8_t  data[NCO_MTU];
+} NCO_Datagram;
+
+static NCO_Datagram g_NCO_Queue[NCO_QUEUE];
+static int          g_NCO_Count = 0;
+static uint64_t     g_NCO_OldestNs = 0;
+static pthread_mutex_t g_NCO_Lock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_int   g_NCO_Queued = 0;               // g_NCO_Count, readable without the lock
+static atomic_bool  g_NCO_On = false;
+
+static _Atomic uint8_t g_NCO_FdKind[NCO_MAX_FD];    // 0 unknown, 1 UDP, 2 other
+
+// Stats
+static _Atomic uint64_t g_NCO_Calls = 0;            // sendmsg() calls by ENet
+static _Atomic uint64_t g_NCO_Merged = 0;           // Datagrams folded into a queued one
+static _Atomic uint64_t g_NCO_Sent = 0;             // Datagrams put on the wire
+static _Atomic uint64_t g_NCO_Syscalls = 0;
+static _Atomic uint64_t g_NCO_HeaderBytes = 0;      // ENet headers no longer sent
+static _Atomic uint64_t g_NCO_Failed = 0;           // Held datagrams sendmmsg() did not send
+static _Atomic uint64_t g_NCO_HoldNs = 0;           // Summed over g_NCO_Sent + g_NCO_Failed
+static _Atomic uint64_t g_NCO_HoldMaxNs = 0;
+static uint64_t         g_NCO_FailLogNs = 0;        // g_NCO_Lock
+
+static NCO_SendMsgFunc  Real_NCO_SendMsg = NULL;
+static NCO_RecvMsgFunc  Real_NCO_RecvMsg = NULL;
+static NCO_SendMMsgFunc Real_NCO_SendMMsg = NULL;
+
+static NCO_TickFunc  Real_NCO_Tick = NULL;
+static NCO_CmdFunc   Real_NCO_Cmd = NULL;
+static NCO_SendFunc NCO_Send = NULL;  // BHChat_Send, chat_queue.c
+
+// --- UTILS ---
+
+static uint64_t NCO_NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void NCO_Resolve(void) {
+    if (!Real_NCO_SendMsg) Real_NCO_SendMsg = (NCO_SendMsgFunc)dlsym(RTLD_NEXT, "sendmsg");
+    if (!Real_NCO_RecvMsg) Real_NCO_RecvMsg = (NCO_RecvMsgFunc)dlsym(RTLD_NEXT, "recvmsg");
+    if (!Real_NCO_SendMMsg) Real_NCO_SendMMsg = (NCO_SendMMsgFunc)dlsym(RTLD_NEXT, "sendmmsg");
+}
+
+static bool NCO_IsUdp(int fd) {
+    if (fd < 0 || fd >= NCO_MAX_FD) return false;
+    uint8_t kind = atomic_load_explicit(&g_NCO_FdKind[fd], memory_order_relaxed);
+    if (kind == 0) {
+        int type = 0;
+        socklen_t len = sizeof(type);
+        kind = (getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &len) == 0 && type == SOCK_DGRAM) ? 1 : 2;
+        atomic_store_explicit(&g_NCO_FdKind[fd], kind, memory_order_relaxed);
+    }
+    return kind == 1;
+}
+
+static const char* NCO_CStr(id str) {
+    if (!str) return "";
+    SEL s = sel_registerName("UTF8String");
+    NCO_Utf8Func f = (NCO_Utf8Func)class_getMethodImplementation(object_getClass(str), s);
+    const char* r = f ? f(str, s) : NULL;
+    return r ? r : "";
+}
+
+static void NCO_Msg(id server, id client, const char* msg) {
+    if (NCO_Send) NCO_Send(server, client, msg, false);
+    else printf("%s\n", msg);
+}
+
+// --- MERGE ---
+
+// Appends the commands of d under the header of q when they fit
+static bool NCO_Merge(NCO_Datagram* q, const uint8_t* d, size_t len) {
+    if (NCO_ENET_CHECKSUM) return false;
+    // Compressed (0x4000) or for another peer/session
+    if (((q->data[0] | d[0]) & 0x40) || ((q->data[0] ^ d[0]) & 0x3F) || q->data[1] != d[1]) return false;
+    // One has a sentTime (0x8000) and the other not, or they differ: acks would echo the wrong one
+    if ((q->data[0] ^ d[0]) & 0x80) return false;
+    size_t head = (d[0] & 0x80) ? 4 : 2;
+    if (len <= head || q->len < head) return false;
+    if (head == 4 && (q->data[2] != d[2] || q->data[3] != d[3])) return false;
+    if ((size_t)q->len + (len - head) > NCO_MERGE_MTU) return false;
+
+    memcpy(q->data + q->len, d + head, len - head);
+    q->len += (uint16_t)(len - head);
+    atomic_fetch_add_explicit(&g_NCO_HeaderBytes, head, memory_order_relaxed);
+    return true;
+}
+
+// --- FLUSH (g_NCO_Lock held) ---
+
+static void NCO_FlushLocked(void) {
+    if (g_NCO_Count == 0) return;
+    struct mmsghdr msgs[NCO_QUEUE];
+    struct iovec iovs[NCO_QUEUE];
+    uint64_t now = NCO_NowNs(), hold = 0, holdMax = 0;
+    int lost = 0, lostErr = 0;
+    for (int k = 0; k < g_NCO_Count; k++) {
+        uint64_t h = now - g_NCO_Queue[k].at;
+        hold += h;
+        if (h > holdMax) holdMax = h;
+    }
+    int i = 0;
+    while (i < g_NCO_Count) {
+        // One sendmmsg() per run of datagrams on the same socket
+        int fd = g_NCO_Queue[i].fd;
+        int n = 0;
+        while (i + n < g_NCO_Count && g_NCO_Queue[i + n].fd == fd) {
+            NCO_Datagram* q = &g_NCO_Queue[i + n];
+            iovs[n].iov_base = q->data;
+            iovs[n].iov_len = q->len;
+            memset(&msgs[n], 0, sizeof(msgs[n]));
+            msgs[n].msg_hdr.msg_name = &q->addr;
+            msgs[n].msg_hdr.msg_namelen = sizeof(q->addr);
+            msgs[n].msg_hdr.msg_iov = &iovs[n];
+            msgs[n].msg_hdr.msg_iovlen = 1;
+            n++;
+        }
+        int done = 0;
+        while (done < n) {
+            int r = Real_NCO_SendMMsg(fd, msgs + done, (unsigned int)(n - done), g_NCO_Queue[i].flags);
+            atomic_fetch_add_explicit(&g_NCO_Syscalls, 1, memory_order_relaxed);
+            if (r > 0) {
+                done += r;
+                continue;
+            }
+            if (r < 0 && errno == EINTR) continue;
+            lostErr = r < 0 ? errno : EAGAIN;
+            if (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS) {
+                // Something wrong with this one datagram (EMSGSIZE, unreachable): skip it, send the rest
+                lost++;
+                done++;
+                continue;
+            }
+            // Full socket buffer: the rest is lost as UDP would lose it, ENet resends reliable data
+            lost += n - done;
+            done = n;
+            break;
+        }
+        i += n;
+    }
+    atomic_fetch_add_explicit(&g_NCO_Sent, (uint64_t)(g_NCO_Count - lost), memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_NCO_HoldNs, hold, memory_order_relaxed);
+    if (holdMax > atomic_load_explicit(&g_NCO_HoldMaxNs, memory_order_relaxed)) {
+        atomic_store_explicit(&g_NCO_HoldMaxNs, holdMax, memory_order_relaxed);
+    }
+    if (lost > 0) {
+        // ENet already counted these as sent; reliable ones are resent, the rest are gone
+        uint64_t total = atomic_fetch_add_explicit(&g_NCO_Failed, (uint64_t)lost, memory_order_relaxed) + (uint64_t)lost;
+        if (g_NCO_FailLogNs == 0 || now - g_NCO_FailLogNs >= NCO_FAIL_LOG_SEC * 1000000000ull) {
+            g_NCO_FailLogNs = now;
+            printf("[Coalesce] sendmmsg() failed (%s): %d held datagrams dropped, %llu so far.\n",
+                   strerror(lostErr), lost, (unsigned long long)total);
+        }
+    }
+    g_NCO_Count = 0;
+    atomic_store_explicit(&g_NCO_Queued, 0, memory_order_relaxed);
+}
+
+static void NCO_Flush(void) {
+    if (atomic_load_explicit(&g_NCO_Queued, memory_order_relaxed) == 0) return;
+    pthread_mutex_lock(&g_NCO_Lock);
+    NCO_FlushLocked();
+    pthread_mutex_unlock(&g_NCO_Lock);
+}
+
+// --- INTERPOSED LIBC CALLS ---
+
+ssize_t sendmsg(int fd, const struct msghdr* msg, int flags) {
+    NCO_Resolve();
+    if (!atomic_load_explicit(&g_NCO_On, memory_order_relaxed) || !Real_NCO_SendMMsg || !msg ||
+        !msg->msg_name || msg->msg_namelen < sizeof(struct sockaddr_in) || msg->msg_controllen ||
+        ((const struct sockaddr*)msg->msg_name)->sa_family != AF_INET || !NCO_IsUdp(fd)) {
+        NCO_Flush();
+        return Real_NCO_SendMsg(fd, msg, flags);
+    }
+    size_t len = 0;
+    for (size_t i = 0; i < msg->msg_iovlen; i++) len += msg->msg_iov[i].iov_len;
+    if (len < 2 || len > NCO_MTU) {
+        NCO_Flush();
+        return Real_NCO_SendMsg(fd, msg, flags);
+    }
+
+    // ENet sends header and commands in separate iovecs
+    uint8_t flat[NCO_MTU];
+    size_t off = 0;
+    for (size_t i = 0; i < msg->msg_iovlen; i++) {
+        memcpy(flat + off, msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+        off += msg->msg_iov[i].iov_len;
+    }
+    const struct sockaddr_in* to = (const struct sockaddr_in*)msg->msg_name;
+    atomic_fetch_add_explicit(&g_NCO_Calls, 1, memory_order_relaxed);
+
+    pthread_mutex_lock(&g_NCO_Lock);
+    for (int i = g_NCO_Count - 1; i >= 0; i--) {
+        NCO_Datagram* q = &g_NCO_Queue[i];
+        if (q->fd != fd || q->addr.sin_addr.s_addr != to->sin_addr.s_addr || q->addr.sin_port != to->sin_port) continue;
+        // Only the latest datagram for this client, so its datagrams keep their order
+        if (NCO_Merge(q, flat, len)) {
+            atomic_fetch_add_explicit(&g_NCO_Merged, 1, memory_order_relaxed);
+            pthread_mutex_unlock(&g_NCO_Lock);
+            return (ssize_t)len;
+        }
+        break;
+    }
+    if (g_NCO_Count == NCO_QUEUE) NCO_FlushLocked();
+    if (g_NCO_Count == 0) g_NCO_OldestNs = NCO_NowNs();
+    NCO_Datagram* q = &g_NCO_Queue[g_NCO_Count++];
+    q->fd = fd;
+    q->flags = flags;
+    q->addr = *to;
+    q->len = (uint16_t)len;
+    q->at = g_NCO_Count == 1 ? g_NCO_OldestNs : NCO_NowNs();
+    memcpy(q->data, flat, len);
+    atomic_store_explicit(&g_NCO_Queued, g_NCO_Count, memory_order_relaxed);
+    pthread_mutex_unlock(&g_NCO_Lock);
+    return (ssize_t)len;
+}
+
+ssize_t recvmsg(int fd, struct msghdr* msg, int flags) {
+    NCO_Resolve();
+    // ENet sends everything it has before it receives: that is the end of a send burst
+    NCO_Flush();
+    return Real_NCO_RecvMsg(fd, msg, flags);
+}
+
+// --- HOOKS ---
+
+void Hook_NCO_Tick(id self, SEL _cmd, float dt, float accDt) {
+    if (Real_NCO_Tick) Real_NCO_Tick(self, _cmd, dt, accDt);
+    NCO_Flush();
+}
+
+id Hook_NCO_Cmd(id self, SEL _cmd, id commandStr, id client) {
+    const char* raw = NCO_CStr(commandStr);
+    if (strncasecmp(raw, "/coalesce", 9) != 0 || (raw[9] && raw[9] != ' ')) {
+        return Real_NCO_Cmd ? Real_NCO_Cmd(self, _cmd, commandStr, client) : nil;
+    }
+    uint64_t calls = atomic_load(&g_NCO_Calls), merged = atomic_load(&g_NCO_Merged);
+    uint64_t sent = atomic_load(&g_NCO_Sent), syscalls = atomic_load(&g_NCO_Syscalls);
+    char msg[256];
+    snprintf(msg, sizeof(msg), "[Coalesce] %llu sends -> %llu datagrams in %llu syscalls (%.1f per call)",
+             (unsigned long long)calls, (unsigned long long)sent, (unsigned long long)syscalls,
+             syscalls ? (double)sent / (double)syscalls : 0.0);
+    NCO_Msg(self, client, msg);
+    uint64_t failed = atomic_load(&g_NCO_Failed);
+    snprintf(msg, sizeof(msg), "[Coalesce] Saved %llu datagrams, %llu syscalls, %llu KB of headers | %llu lost on failed sends",
+             (unsigned long long)merged, (unsigned long long)(calls > syscalls ? calls - syscalls : 0),
+             (unsigned long long)(atomic_load(&g_NCO_HeaderBytes) >> 10), (unsigned long long)failed);
+    NCO_Msg(self, client, msg);
+    snprintf(msg, sizeof(msg), "[Coalesce] Held %.0f us on average, %.0f us at most",
+             sent + failed ? (double)atomic_load(&g_NCO_HoldNs) / 1e3 / (double)(sent + failed) : 0.0,
+             (double)atomic_load(&g_NCO_HoldMaxNs) / 1e3);
+    NCO_Msg(self, client, msg);
+    return nil;
+}
+
+// --- INIT ---
+
+static void* NCO_FlushThread(void* arg) {
+    for (;;) {
+        usleep(NCO_FLUSH_US / 2);
+        if (atomic_load_explicit(&g_NCO_Queued, memory_order_relaxed) == 0) continue;
+        pthread_mutex_lock(&g_NCO_Lock);
+        if (g_NCO_Count > 0 && NCO_NowNs() - g_NCO_OldestNs >= NCO_FLUSH_US * 1000ull) NCO_FlushLocked();
+        pthread_mutex_unlock(&g_NCO_Lock);
+    }
+    return NULL;
+}
+
+static void* NCO_Init(void* arg) {
+    sleep(1);
+
+    NCO_Resolve();
+    const char* env = getenv("BH_COALESCE");
+    if (!env || atoi(env) != 1) {
+        printf("[Coalesce] Off, datagrams are sent as they come (BH_COALESCE=1 batches them).\n");
+        return NULL;
+    }
+    if (!Real_NCO_SendMMsg) {
+        printf("[Coalesce] sendmmsg() not available, datagrams are sent as they come.\n");
+        return NULL;
+    }
+    Class clsGC = objc_getClass(NCO_CLASS_GC);
+    Class clsSrv = objc_getClass(NCO_CLASS_SERVER);
+    if (clsGC) {
+        Method mT = class_getInstanceMethod(clsGC, sel_registerName("update:accurateDT:"));
+        if (mT) {
+            Real_NCO_Tick = (NCO_TickFunc)method_getImplementation(mT);
+            method_setImplementation(mT, (IMP)Hook_NCO_Tick);
+        }
+    }
+    if (clsSrv) {
+        Method mC = class_getInstanceMethod(clsSrv, sel_registerName("handleCommand:issueClient:"));
+        if (mC) {
+            Real_NCO_Cmd = (NCO_CmdFunc)method_getImplementation(mC);
+            method_setImplementation(mC, (IMP)Hook_NCO_Cmd);
+        }
+        NCO_Send = (NCO_SendFunc)dlsym(RTLD_DEFAULT, "BHChat_Send");
+    }
+
+    pthread_t t;
+    pthread_create(&t, NULL, NCO_FlushThread, NULL);
+    pthread_detach(t);
+    atomic_store(&g_NCO_On, true);
+    printf("[Coalesce] Batching outbound datagrams (flush after %d us at most).\n", NCO_FLUSH_US);
+    return NULL;
+}
+
+__attribute__((constructor))
+static void NCO_Entry() {
+    NCO_Resolve();
+    pthread_t t;
+    pthread_create(&t, NULL, NCO_Init, NULL);
+    pthread_detach(t);
+}
@@ -0,0 +1,663 @@
+//Commands: /netstats (top talkers)   /netstats <player> (one peer)
+
+/*
+ * Net Stats - Per-peer network telemetry
+ * ENet lives inside the server binary, so its own send/receive calls cannot be
+ * interposed; its unix backend goes through libc recvmsg()/sendmsg() though
+ * (recvfrom/sendto are covered as well). Every UDP datagram is parsed as ENet
+ * and counted on the slot of its peer address:
+ *   - datagrams, ENet packets and bytes in both directions
+ *   - packets per channel (0-7, system commands on 0xFF)
+ *   - packets per message type, the first payload byte of each client packet
+ *     (the game's message ID, which picks how the payload - usually a plist -
+ *     is decoded)
+ * Slots are cache-line aligned. Only the network thread receives, so inbound
+ * counters are plain relaxed stores; outbound ones use locked increments since
+ * net_coalesce flushes its batches from its own thread. The address index is a
+ * small open-addressing table under a mutex that the hot path holds only for
+ * the lookup. Joins give slots their player name (address read from the
+ * ENetPeer); peers that left are forgotten after NST_FORGET_SECONDS.
+ *
+ * NSPropertyListSerialization propertyListWithData:... (the decode that
+ * anti_crash_nullifier sanitizes) is timed as well. Decodes are not tied to
+ * a peer there, so they are reported as server totals.
+ *
+ * Once a second a background thread turns the counters into rates and
+ * rewrites $BH_WORLD_DIR/net_stats.stats, one line per peer, busiest first.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <objc/runtime.h>
+#include <objc/message.h>
+
+// --- CONFIG ---
+#define NST_CLASS_SERVER    "BHServer"
+#define NST_CLASS_MATCH     "BHNetServerMatch"
+#define NST_STATS_NAME      "net_stats.stats"
+
+#define NST_SLOTS           256         // Tracked peer addresses
+#define NST_INDEX_SIZE      1024        // Power of two
+#define NST_CHANNELS        9           // 0-7, [8] = system (0xFF)
+#define NST_TYPES           256
+#define NST_FORGET_SECONDS  60
+#define NST_TOP             5           // Peers listed by /netstats
+#define NST_MAX_FD          4096
+#define NST_ENET_CHECKSUM   0           // 1 if the server enables ENet CRC32 checksums
+
+// ENetPeer layout (ENet 1.3, x86_64): ENetAddress { u32 host (network order); u16 port }
+#define NST_PEER_ADDR_OFFSET 36
+#define NST_PEER_PORT_OFFSET 40
+
+// --- IMP TYPES ---
+typedef id (*NST_CmdFunc)(id, SEL, id, id);
+typedef void (*NST_SendFunc)(id, id, const char*, bool);
+typedef void (*NST_AuthFunc)(id, SEL, id, id);
+typedef void (*NST_DiscFunc)(id, SEL, id, bool);
+typedef id (*NST_PlistFunc)(id, SEL, id, unsigned long, unsigned long*, id*);
+typedef unsigned long (*NST_LenFunc)(id, SEL);
+typedef id (*NST_StrFunc)(id, SEL, const char*);
+typedef id (*NST_ObjKeyFunc)(id, SEL, id);
+typedef const char* (*NST_Utf8Func)(id, SEL);
+typedef void* (*NST_PtrFunc)(id, SEL);
+
+typedef ssize_t (*NST_RecvMsgFunc)(int, struct msghdr*, int);
+typedef ssize_t (*NST_SendMsgFunc)(int, const struct msghdr*, int);
+typedef ssize_t (*NST_RecvFromFunc)(int, void*, size_t, int, struct sockaddr*, socklen_t*);
+typedef ssize_t (*NST_SendToFunc)(int, const void*, size_t, int, const struct sockaddr*, socklen_t);
+typedef int (*NST_SendMMsgFunc)(int, struct mmsghdr*, unsigned int, int);
+
+// --- SLOTS ---
+enum { NST_RX = 0, NST_TX = 1 };
+
+// Written by the network thread only
+typedef struct __attribute__((aligned(64))) {
+    _Atomic uint64_t datagrams[2];
+    _Atomic uint64_t packets[2];
+    _Atomic uint64_t bytes[2];
+    _Atomic uint64_t compressed[2];         // Datagrams whose packets could not be counted
+    _Atomic uint64_t lastSeen;              // Monotonic seconds
+    _Atomic uint32_t channel[2][NST_CHANNELS];
+    _Atomic uint32_t types[NST_TYPES];      // Client packets by message ID
+} NST_Counters;
+
+// Under g_NST_Lock
+typedef struct {
+    bool     used;
+    bool     online;
+    uint32_t ip;                            // Network order
+    uint16_t port;                          // Host order
+    char     name[32];
+    uint64_t goneAt;
+    // Rates of the last second (stats thread)
+    uint64_t prevPackets[2], prevBytes[2];
+    double   pps[2], bps[2];
+} NST_Peer;
+
+static NST_Counters g_NST_Counters[NST_SLOTS];
+static NST_Peer     g_NST_Peers[NST_SLOTS];
+static int16_t      g_NST_Index[NST_INDEX_SIZE];    // Slot, -1 empty, -2 deleted
+static int          g_NST_Deleted = 0;
+static pthread_mutex_t g_NST_Lock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_bool  g_NST_On = false;
+static _Atomic uint64_t g_NST_Untracked = 0;        // Datagrams with no free slot
+
+static _Atomic uint8_t g_NST_FdKind[NST_MAX_FD];    // 0 unknown, 1 UDP, 2 other
+
+// Plist decodes (any thread)
+static _Atomic uint64_t g_NST_Decodes = 0, g_NST_DecodeBytes = 0, g_NST_DecodeFails = 0, g_NST_DecodeNs = 0;
+
+static NST_RecvMsgFunc  Real_NST_RecvMsg = NULL;
+static NST_SendMsgFunc  Real_NST_SendMsg = NULL;
+static NST_RecvFromFunc Real_NST_RecvFrom = NULL;
+static NST_SendToFunc   Real_NST_SendTo = NULL;
+static NST_SendMMsgFunc Real_NST_SendMMsg = NULL;
+
+static NST_CmdFunc   Real_NST_Cmd = NULL;
+static NST_AuthFunc  Real_NST_Auth = NULL;
+static NST_DiscFunc  Real_NST_Disc = NULL;
+static NST_PlistFunc Real_NST_Plist = NULL;
+static NST_SendFunc NST_Send = NULL;  // BHChat_Send, chat_queue.c
+
+// --- UTILS ---
+
+static uint64_t NST_NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Sends can come from net_coalesce's flush thread as well, receives only from the network thread
+static void NST_Add64(int dir, _Atomic uint64_t* c, uint64_t v) {
+    if (dir == NST_TX) atomic_fetch_add_explicit(c, v, memory_order_relaxed);
+    else atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + v, memory_order_relaxed);
+}
+
+static void NST_Add32(int dir, _Atomic uint32_t* c) {
+    if (dir == NST_TX) atomic_fetch_add_explicit(c, 1, memory_order_relaxed);
+    else atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+static uint64_t NST_Load(_Atomic uint64_t* c) {
+    return atomic_load_explicit(c, memory_order_relaxed);
+}
+
+static id NST_Str(const char* txt) {
+    Class cls = objc_getClass("NSString");
+    SEL s = sel_registerName("stringWithUTF8String:");
+    NST_StrFunc f = (NST_StrFunc)method_getImplementation(class_getClassMethod(cls, s));
+    return f ? f((id)cls, s, txt) : nil;
+}
+
+static const char* NST_CStr(id str) {
+    if (!str) return "";
+    SEL s = sel_registerName("UTF8String");
+    NST_Utf8Func f = (NST_Utf8Func)class_getMethodImplementation(object_getClass(str), s);
+    return f ? f(str, s) : "";
+}
+
+static void NST_Msg(id server, id client, const char* msg) {
+    if (NST_Send) NST_Send(server, client, msg, true);
+    else printf("%s\n", msg);
+}
+
+static void NST_Resolve(void) {
+    if (!Real_NST_RecvMsg) Real_NST_RecvMsg = (NST_RecvMsgFunc)dlsym(RTLD_NEXT, "recvmsg");
+    if (!Real_NST_SendMsg) Real_NST_SendMsg = (NST_SendMsgFunc)dlsym(RTLD_NEXT, "sendmsg");
+    if (!Real_NST_RecvFrom) Real_NST_RecvFrom = (NST_RecvFromFunc)dlsym(RTLD_NEXT, "recvfrom");
+    if (!Real_NST_SendTo) Real_NST_SendTo = (NST_SendToFunc)dlsym(RTLD_NEXT, "sendto");
+    if (!Real_NST_SendMMsg) Real_NST_SendMMsg = (NST_SendMMsgFunc)dlsym(RTLD_NEXT, "sendmmsg");
+}
+
+static bool NST_IsUdp(int fd) {
+    if (fd < 0 || fd >= NST_MAX_FD) return false;
+    uint8_t kind = atomic_load_explicit(&g_NST_FdKind[fd], memory_order_relaxed);
+    if (kind == 0) {
+        int type = 0;
+        socklen_t len = sizeof(type);
+        kind = (getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &len) == 0 && type == SOCK_DGRAM) ? 1 : 2;
+        atomic_store_explicit(&g_NST_FdKind[fd], kind, memory_order_relaxed);
+    }
+    return kind == 1;
+}
+
+// --- ADDRESS INDEX (g_NST_Lock held) ---
+
+static unsigned NST_Hash(uint32_t ip, uint16_t port) {
+    uint32_t h = ip ^ ((uint32_t)port * 0x9E3779B1u);
+    h ^= h >> 15;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    return h & (NST_INDEX_SIZE - 1);
+}
+
+static void NST_Rebuild(void) {
+    memset(g_NST_Index, 0xFF, sizeof(g_NST_Index));
+    g_NST_Deleted = 0;
+    for (int s = 0; s < NST_SLOTS; s++) {
+        if (!g_NST_Peers[s].used) continue;
+        unsigned h = NST_Hash(g_NST_Peers[s].ip, g_NST_Peers[s].port);
+        while (g_NST_Index[h] != -1) h = (h + 1) & (NST_INDEX_SIZE - 1);
+        g_NST_Index[h] = (int16_t)s;
+    }
+}
+
+static int NST_Find(uint32_t ip, uint16_t port, bool claim) {
+    unsigned h = NST_Hash(ip, port);
+    int freeAt = -1;
+    for (int probe = 0; probe < NST_INDEX_SIZE; probe++, h = (h + 1) & (NST_INDEX_SIZE - 1)) {
+        int16_t s = g_NST_Index[h];
+        if (s == -1) break;
+        if (s == -2) {
+            if (freeAt < 0) freeAt = (int)h;
+            continue;
+        }
+        if (g_NST_Peers[s].ip == ip && g_NST_Peers[s].port == port) return s;
+    }
+    if (!claim) return -1;
+
+    int slot = -1;
+    for (int s = 0; s < NST_SLOTS; s++) {
+        if (!g_NST_Peers[s].used) { slot = s; break; }
+    }
+    if (slot < 0) return -1;
+    if (freeAt < 0) freeAt = (int)h;
+    else g_NST_Deleted--;
+
+    NST_Peer* p = &g_NST_Peers[slot];
+    memset(p, 0, sizeof(*p));
+    p->used = true;
+    p->ip = ip;
+    p->port = port;
+    memset(&g_NST_Counters[slot], 0, sizeof(NST_Counters));
+    g_NST_Index[freeAt] = (int16_t)slot;
+    return slot;
+}
+
+static void NST_Forget(int slot) {
+    NST_Peer* p = &g_NST_Peers[slot];
+    unsigned h = NST_Hash(p->ip, p->port);
+    for (int probe = 0; probe < NST_INDEX_SIZE; probe++, h = (h + 1) & (NST_INDEX_SIZE - 1)) {
+        if (g_NST_Index[h] == -1) break;
+        if (g_NST_Index[h] == slot) {
+            g_NST_Index[h] = -2;
+            g_NST_Deleted++;
+            break;
+        }
+    }
+    p->used = false;
+    if (g_NST_Deleted > NST_INDEX_SIZE / 4) NST_Rebuild();
+}
+
+// --- DATAGRAMS ---
+
+static const uint8_t NST_CommandSize[13] = { 0, 8, 48, 44, 8, 4, 6, 8, 24, 8, 12, 16, 24 };
+
+static void NST_Count(int dir, const struct sockaddr* addr, const struct iovec* iov, size_t iovCount, size_t len) {
+    if (!addr || addr->sa_family != AF_INET || len < 2 || iovCount == 0) return;
+    const struct sockaddr_in* in = (const struct sockaddr_in*)addr;
+
+    pthread_mutex_lock(&g_NST_Lock);
+    int slot = NST_Find(in->sin_addr.s_addr, ntohs(in->sin_port), true);
+    pthread_mutex_unlock(&g_NST_Lock);
+    if (slot < 0) {
+        atomic_fetch_add_explicit(&g_NST_Untracked, 1, memory_order_relaxed);
+        return;
+    }
+    NST_Counters* c = &g_NST_Counters[slot];
+    NST_Add64(dir, &c->datagrams[dir], 1);
+    NST_Add64(dir, &c->bytes[dir], len);
+    atomic_store_explicit(&c->lastSeen, NST_NowNs() / 1000000000ull, memory_order_relaxed);
+
+    // ENet sends header and commands in separate iovecs; received datagrams are one buffer
+    uint8_t flat[1500];
+    const uint8_t* d = (const uint8_t*)iov[0].iov_base;
+    if (iov[0].iov_len < len) {
+        if (len > sizeof(flat)) return;
+        size_t off = 0;
+        for (size_t i = 0; i < iovCount && off < len; i++) {
+            size_t n = iov[i].iov_len < len - off ? iov[i].iov_len : len - off;
+            memcpy(flat + off, iov[i].iov_base, n);
+            off += n;
+        }
+        d = flat;
+    }
+
+    uint16_t peerID = (uint16_t)((d[0] << 8) | d[1]);
+    if (peerID & 0x4000) {
+        NST_Add64(dir, &c->compressed[dir], 1);
+        return;
+    }
+    size_t p = 2 + ((peerID & 0x8000) ? 2 : 0) + (NST_ENET_CHECKSUM ? 4 : 0);
+    while (p + 4 <= len) {
+        int cmd = d[p] & 0x0F;
+        if (cmd <= 0 || cmd > 12 || p + NST_CommandSize[cmd] > len) break;
+        size_t head = NST_CommandSize[cmd], data = 0;
+        if (cmd == 6) data = (size_t)((d[p + 4] << 8) | d[p + 5]);
+        else if (cmd == 7 || cmd == 8 || cmd == 9 || cmd == 12) data = (size_t)((d[p + 6] << 8) | d[p + 7]);
+        if (p + head + data > len) break;
+
+        uint8_t ch = d[p + 1];
+        NST_Add32(dir, &c->channel[dir][ch < 8 ? ch : 8]);
+        if (data > 0) {
+            // Fragments: only the first one starts a packet
+            bool first = !(cmd == 8 || cmd == 12) || (d[p + 12] | d[p + 13] | d[p + 14] | d[p + 15]) == 0;
+            if (first) {
+                NST_Add64(dir, &c->packets[dir], 1);
+                if (dir == NST_RX) NST_Add32(NST_RX, &c->types[d[p + head]]);
+            }
+        }
+        p += head + data;
+    }
+}
+
+// --- INTERPOSED LIBC CALLS ---
+
+ssize_t recvmsg(int fd, struct msghdr* msg, int flags) {
+    NST_Resolve();
+    ssize_t ret = Real_NST_RecvMsg(fd, msg, flags);
+    if (ret > 0 && atomic_load_explicit(&g_NST_On, memory_order_relaxed) && NST_IsUdp(fd)) {
+        NST_Count(NST_RX, (const struct sockaddr*)msg->msg_name, msg->msg_iov, msg->msg_iovlen, (size_t)ret);
+    }
+    return ret;
+}
+
+ssize_t sendmsg(int fd, const struct msghdr* msg, int flags) {
+    NST_Resolve();
+    ssize_t ret = Real_NST_SendMsg(fd, msg, flags);
+    if (ret > 0 && atomic_load_explicit(&g_NST_On, memory_order_relaxed) && NST_IsUdp(fd)) {
+        NST_Count(NST_TX, (const struct sockaddr*)msg->msg_name, msg->msg_iov, msg->msg_iovlen, (size_t)ret);
+    }
+    return ret;
+}
+
+ssize_t recvfrom(int fd, void* buf, size_t size, int flags, struct sockaddr* addr, socklen_t* addrLen) {
+    NST_Resolve();
+    ssize_t ret = Real_NST_RecvFrom(fd, buf, size, flags, addr, addrLen);
+    if (ret > 0 && atomic_load_explicit(&g_NST_On, memory_order_relaxed) && NST_IsUdp(fd)) {
+        struct iovec iov = { buf, (size_t)ret };
+        NST_Count(NST_RX, addr, &iov, 1, (size_t)ret);
+    }
+    return ret;
+}
+
+ssize_t sendto(int fd, const void* buf, size_t size, int flags, const struct sockaddr* addr, socklen_t addrLen) {
+    NST_Resolve();
+    ssize_t ret = Real_NST_SendTo(fd, buf, size, flags, addr, addrLen);
+    if (ret > 0 && atomic_load_explicit(&g_NST_On, memory_order_relaxed) && NST_IsUdp(fd)) {
+        struct iovec iov = { (void*)buf, (size_t)ret };
+        NST_Count(NST_TX, addr, &iov, 1, (size_t)ret);
+    }
+    return ret;
+}
+
+// net_coalesce sends its batches this way
+int sendmmsg(int fd, struct mmsghdr* msgs, unsigned int count, int flags) {
+    NST_Resolve();
+    int ret = Real_NST_SendMMsg(fd, msgs, count, flags);
+    if (ret > 0 && atomic_load_explicit(&g_NST_On, memory_order_relaxed) && NST_IsUdp(fd)) {
+        for (int i = 0; i < ret; i++) {
+            const struct msghdr* m = &msgs[i].msg_hdr;
+            NST_Count(NST_TX, (const struct sockaddr*)m->msg_name, m->msg_iov, m->msg_iovlen, msgs[i].msg_len);
+        }
+    }
+    return ret;
+}
+
+// --- HOOKS ---
+
+static bool NST_PeerAddress(id peerWrapper, uint32_t* ip, uint16_t* port) {
+    if (!peerWrapper) return false;
+    SEL s = sel_registerName("pointerValue");
+    if (!class_respondsToSelector(object_getClass(peerWrapper), s)) return false;
+    uint8_t* peer = (uint8_t*)((NST_PtrFunc)class_getMethodImplementation(object_getClass(peerWrapper), s))(peerWrapper, s);
+    if (!peer) return false;
+    memcpy(ip, peer + NST_PEER_ADDR_OFFSET, 4);
+    memcpy(port, peer + NST_PEER_PORT_OFFSET, 2);
+    return true;
+}
+
+void Hook_NST_Auth(id self, SEL _cmd, id infoDict, id peerWrapper) {
+    uint32_t ip;
+    uint16_t port;
+    if (infoDict && NST_PeerAddress(peerWrapper, &ip, &port)) {
+        SEL sKey = sel_registerName("objectForKey:");
+        const char* alias = "";
+        if (class_respondsToSelector(object_getClass(infoDict), sKey)) {
+            id v = ((NST_ObjKeyFunc)class_getMethodImplementation(object_getClass(infoDict), sKey))(infoDict, sKey, NST_Str("alias"));
+            alias = NST_CStr(v);
+        }
+        pthread_mutex_lock(&g_NST_Lock);
+        int slot = NST_Find(ip, port, true);
+        if (slot >= 0) {
+            snprintf(g_NST_Peers[slot].name, sizeof(g_NST_Peers[slot].name), "%s", alias);
+            g_NST_Peers[slot].online = true;
+        }
+        pthread_mutex_unlock(&g_NST_Lock);
+    }
+    Real_NST_Auth(self, _cmd, infoDict, peerWrapper);
+}
+
+void Hook_NST_Disconnect(id self, SEL _cmd, id peerWrapper, bool wasKick) {
+    uint32_t ip;
+    uint16_t port;
+    if (NST_PeerAddress(peerWrapper, &ip, &port)) {
+        pthread_mutex_lock(&g_NST_Lock);
+        int slot = NST_Find(ip, port, false);
+        if (slot >= 0) {
+            g_NST_Peers[slot].online = false;
+            g_NST_Peers[slot].goneAt = NST_NowNs() / 1000000000ull;
+        }
+        pthread_mutex_unlock(&g_NST_Lock);
+    }
+    Real_NST_Disc(self, _cmd, peerWrapper, wasKick);
+}
+
+id Hook_NST_Plist(id self, SEL _cmd, id data, unsigned long opt, unsigned long* fmt, id* err) {
+    uint64_t t0 = NST_NowNs();
+    id result = Real_NST_Plist(self, _cmd, data, opt, fmt, err);
+    atomic_fetch_add_explicit(&g_NST_DecodeNs, NST_NowNs() - t0, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_NST_Decodes, 1, memory_order_relaxed);
+    if (!result) atomic_fetch_add_explicit(&g_NST_DecodeFails, 1, memory_order_relaxed);
+    if (data) {
+        SEL sLen = sel_registerName("length");
+        NST_LenFunc f = (NST_LenFunc)class_getMethodImplementation(object_getClass(data), sLen);
+        if (f) atomic_fetch_add_explicit(&g_NST_DecodeBytes, f(data, sLen), memory_order_relaxed);
+    }
+    return result;
+}
+
+// --- STATS ---
+
+static void NST_PeerLabel(int slot, char* out, size_t size) {
+    NST_Peer* p = &g_NST_Peers[slot];
+    char ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &p->ip, ip, sizeof(ip));
+    snprintf(out, size, "%s %s:%u", p->name[0] ? p->name : "-", ip, p->port);
+}
+
+// Most frequent client message IDs of a slot, "t12:340 t3:88"
+static void NST_TopTypes(int slot, char* out, size_t size, int count) {
+    uint32_t seen[NST_TYPES];
+    for (int t = 0; t < NST_TYPES; t++) seen[t] = atomic_load_explicit(&g_NST_Counters[slot].types[t], memory_order_relaxed);
+    int n = 0;
+    out[0] = '\0';
+    for (int k = 0; k < count; k++) {
+        int best = -1;
+        for (int t = 0; t < NST_TYPES; t++) if (seen[t] && (best < 0 || seen[t] > seen[best])) best = t;
+        if (best < 0) break;
+        n += snprintf(out + n, size - (size_t)n, "%st%d:%u", n ? " " : "", best, seen[best]);
+        seen[best] = 0;
+        if ((size_t)n >= size) break;
+    }
+}
+
+// Slots by received bytes per second, highest first (g_NST_Lock held)
+static int NST_Sorted(int* order) {
+    int n = 0;
+    for (int s = 0; s < NST_SLOTS; s++) if (g_NST_Peers[s].used) order[n++] = s;
+    for (int i = 1; i < n; i++) {
+        int v = order[i], j = i - 1;
+        while (j >= 0 && g_NST_Peers[order[j]].bps[NST_RX] < g_NST_Peers[v].bps[NST_RX]) { order[j + 1] = order[j]; j--; }
+        order[j + 1] = v;
+    }
+    return n;
+}
+
+// Rates, expiry and the stats file body (g_NST_Lock held)
+static int NST_Refresh(char* out, size_t size) {
+    uint64_t now = NST_NowNs() / 1000000000ull;
+    for (int s = 0; s < NST_SLOTS; s++) {
+        NST_Peer* p = &g_NST_Peers[s];
+        if (!p->used) continue;
+        NST_Counters* c = &g_NST_Counters[s];
+        for (int d = 0; d < 2; d++) {
+            uint64_t pk = NST_Load(&c->packets[d]), by = NST_Load(&c->bytes[d]);
+            p->pps[d] = (double)(pk - p->prevPackets[d]);
+            p->bps[d] = (double)(by - p->prevBytes[d]);
+            p->prevPackets[d] = pk;
+            p->prevBytes[d] = by;
+        }
+        uint64_t last = NST_Load(&c->lastSeen);
+        if (!p->online && now - (p->goneAt > last ? p->goneAt : last) > NST_FORGET_SECONDS) NST_Forget(s);
+    }
+
+    int order[NST_SLOTS];
+    int count = NST_Sorted(order);
+    uint64_t decodes = atomic_load(&g_NST_Decodes);
+    int n = snprintf(out, size,
+        "peers=%d\nuntracked_datagrams=%llu\nplist_decodes=%llu\nplist_bytes=%llu\nplist_failed=%llu\nplist_avg_us=%.1f\n"
+        "# name ip:port online rx_pps rx_Bps tx_pps tx_Bps rx_packets rx_bytes tx_packets tx_bytes rx_compressed channels(rx) top_types\n",
+        count, (unsigned long long)NST_Load(&g_NST_Untracked), (unsigned long long)decodes,
+        (unsigned long long)atomic_load(&g_NST_DecodeBytes), (unsigned long long)atomic_load(&g_NST_DecodeFails),
+        decodes ? (double)atomic_load(&g_NST_DecodeNs) / (double)decodes / 1000.0 : 0.0);
+
+    for (int i = 0; i < count && n > 0 && (size_t)n < size; i++) {
+        int s = order[i];
+        NST_Peer* p = &g_NST_Peers[s];
+        NST_Counters* c = &g_NST_Counters[s];
+        char label[96], types[96], chans[96];
+        NST_PeerLabel(s, label, sizeof(label));
+        NST_TopTypes(s, types, sizeof(types), 4);
+        int cn = 0;
+        for (int ch = 0; ch < NST_CHANNELS && cn < (int)sizeof(chans); ch++) {
+            cn += snprintf(chans + cn, sizeof(chans) - (size_t)cn, "%s%u", ch ? "," : "",
+                           atomic_load_explicit(&c->channel[NST_RX][ch], memory_order_relaxed));
+        }
+        n += snprintf(out + n, size - (size_t)n, "%s %d %.0f %.0f %.0f %.0f %llu %llu %llu %llu %llu %s %s\n",
+                      label, p->online, p->pps[NST_RX], p->bps[NST_RX], p->pps[NST_TX], p->bps[NST_TX],
+                      (unsigned long long)NST_Load(&c->packets[NST_RX]), (unsigned long long)NST_Load(&c->bytes[NST_RX]),
+                      (unsigned long long)NST_Load(&c->packets[NST_TX]), (unsigned long long)NST_Load(&c->bytes[NST_TX]),
+                      (unsigned long long)NST_Load(&c->compressed[NST_RX]), chans, types[0] ? types : "-");
+    }
+    return n;
+}
+
+static void* NST_StatsThread(void* arg) {
+    char path[512];
+    char tmp[520];
+    const char* dir = getenv("BH_WORLD_DIR");
+    if (dir && *dir) snprintf(path, sizeof(path), "%s/%s", dir, NST_STATS_NAME);
+    else snprintf(path, sizeof(path), "%s", NST_STATS_NAME);
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    static char buf[64 * 1024];
+    while (1) {
+        sleep(1);
+        pthread_mutex_lock(&g_NST_Lock);
+        int n = NST_Refresh(buf, sizeof(buf));
+        pthread_mutex_unlock(&g_NST_Lock);
+        if (n <= 0) continue;
+        if ((size_t)n > sizeof(buf)) n = (int)sizeof(buf);
+        FILE* f = fopen(tmp, "w");
+        if (!f) continue;
+        fwrite(buf, 1, (size_t)n, f);
+        fclose(f);
+        rename(tmp, path);
+    }
+    return NULL;
+}
+
+// --- COMMANDS ---
+
+id Hook_NST_Cmd(id self, SEL _cmd, id cmdStr, id client) {
+    const char* raw = NST_CStr(cmdStr);
+    if (strncasecmp(raw, "/netstats", 9) != 0 || (raw[9] != '\0' && raw[9] != ' ')) {
+        return Real_NST_Cmd(self, _cmd, cmdStr, client);
+    }
+    const char* who = raw + 9;
+    while (*who == ' ') who++;
+
+    char lines[NST_TOP + 1][256];
+    int lineCount = 0;
+    pthread_mutex_lock(&g_NST_Lock);
+    int order[NST_SLOTS];
+    int count = NST_Sorted(order);
+    if (*who) {
+        for (int i = 0; i < count; i++) {
+            int s = order[i];
+            if (strcasecmp(g_NST_Peers[s].name, who) != 0) continue;
+            NST_Peer* p = &g_NST_Peers[s];
+            NST_Counters* c = &g_NST_Counters[s];
+            char label[96], types[96];
+            NST_PeerLabel(s, label, sizeof(label));
+            NST_TopTypes(s, types, sizeof(types), 4);
+            snprintf(lines[lineCount++], sizeof(lines[0]), "[NetStats] %s | in %.0f pkt/s %.1f KB/s | out %.0f pkt/s %.1f KB/s",
+                     label, p->pps[NST_RX], p->bps[NST_RX] / 1024.0, p->pps[NST_TX], p->bps[NST_TX] / 1024.0);
+            snprintf(lines[lineCount++], sizeof(lines[0]), "[NetStats] Total in %llu pkts %llu KB | out %llu pkts %llu KB | types %s",
+                     (unsigned long long)NST_Load(&c->packets[NST_RX]), (unsigned long long)(NST_Load(&c->bytes[NST_RX]) >> 10),
+                     (unsigned long long)NST_Load(&c->packets[NST_TX]), (unsigned long long)(NST_Load(&c->bytes[NST_TX]) >> 10),
+                     types[0] ? types : "-");
+            break;
+        }
+        if (lineCount == 0) snprintf(lines[lineCount++], sizeof(lines[0]), "[NetStats] No traffic from %s.", who);
+    } else {
+        double in = 0.0, out = 0.0;
+        for (int i = 0; i < count; i++) {
+            in += g_NST_Peers[order[i]].bps[NST_RX];
+            out += g_NST_Peers[order[i]].bps[NST_TX];
+        }
+        snprintf(lines[lineCount++], sizeof(lines[0]), "[NetStats] %d peers | in %.1f KB/s | out %.1f KB/s | plist decodes %llu",
+                 count, in / 1024.0, out / 1024.0, (unsigned long long)atomic_load(&g_NST_Decodes));
+        for (int i = 0; i < count && lineCount <= NST_TOP; i++) {
+            int s = order[i];
+            char label[96];
+            NST_PeerLabel(s, label, sizeof(label));
+            snprintf(lines[lineCount++], sizeof(lines[0]), "[NetStats] %s: in %.0f pkt/s %.1f KB/s, out %.1f KB/s",
+                     label, g_NST_Peers[s].pps[NST_RX], g_NST_Peers[s].bps[NST_RX] / 1024.0, g_NST_Peers[s].bps[NST_TX] / 1024.0);
+        }
+    }
+    pthread_mutex_unlock(&g_NST_Lock);
+
+    for (int i = 0; i < lineCount; i++) NST_Msg(self, client, lines[i]);
+    return nil;
+}
+
+// --- INIT ---
+
+static void* NST_Init(void* arg) {
+    sleep(1);
+
+    Class clsSrv = objc_getClass(NST_CLASS_SERVER);
+    Class clsMatch = objc_getClass(NST_CLASS_MATCH);
+    if (clsSrv) {
+        Method mC = class_getInstanceMethod(clsSrv, sel_registerName("handleCommand:issueClient:"));
+        if (mC) {
+            Real_NST_Cmd = (NST_CmdFunc)method_getImplementation(mC);
+            method_setImplementation(mC, (IMP)Hook_NST_Cmd);
+        }
+        NST_Send = (NST_SendFunc)dlsym(RTLD_DEFAULT, "BHChat_Send");
+    }
+    if (clsMatch) {
+        Method mA = class_getInstanceMethod(clsMatch, sel_registerName("clientPlayerInformationRecieved:fromPeer:"));
+        if (mA) {
+            Real_NST_Auth = (NST_AuthFunc)method_getImplementation(mA);
+            method_setImplementation(mA, (IMP)Hook_NST_Auth);
+        }
+        Method mD = class_getInstanceMethod(clsMatch, sel_registerName("clientDisconnected:wasKick:"));
+        if (mD) {
+            Real_NST_Disc = (NST_DiscFunc)method_getImplementation(mD);
+            method_setImplementation(mD, (IMP)Hook_NST_Disconnect);
+        }
+    }
+    Class clsPlist = objc_getClass("NSPropertyListSerialization");
+    if (clsPlist) {
+        Method mP = class_getClassMethod(clsPlist, sel_registerName("propertyListWithData:options:format:error:"));
+        if (mP) {
+            Real_NST_Plist = (NST_PlistFunc)method_getImplementation(mP);
+            method_setImplementation(mP, (IMP)Hook_NST_Plist);
+        }
+    }
+
+    pthread_t t;
+    pthread_create(&t, NULL, NST_StatsThread, NULL);
+    pthread_detach(t);
+    printf("[NetStats] Counting ENet traffic per peer (%s).\n", NST_STATS_NAME);
+    return NULL;
+}
+
+__attribute__((constructor))
+static void NST_Entry() {
+    NST_Resolve();
+    memset(g_NST_Index, 0xFF, sizeof(g_NST_Index));
+    atomic_store(&g_NST_On, true);
+
+    pthread_t t;
+    pthread_create(&t, NULL, NST_Init, NULL);
+    pthread_detach(t);
+}
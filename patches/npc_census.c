@@ -0,0 +1,644 @@
+//Commands: /npcs (counts and caps)   /npcs reload (re-read npc_caps.conf)
+
+/*
+ * NPC Census - Population counts, caps and culling
+ * Keeps a table of every live NPC (dodos, donkeys, trolls...) with its type
+ * and region (one 32x32 macro block):
+ *   - DynamicWorld loadNPCAtPosition:... adds NPCs as they are created.
+ *   - NPC setNeedsRemoved: and dealloc take them out again.
+ *   - A walk of dynamicObjects when the world is attached and every
+ *     CEN_RESEED_SECONDS picks up NPCs created any other way.
+ * Counters per type, the total and a flat per-region array (indexed by macro
+ * block) are kept up to date; regions of moving NPCs are refreshed a few per
+ * tick. Caps come from $BH_WORLD_DIR/npc_caps.conf, created count-only (no
+ * caps). While a cap is exceeded and someone is online, up to CEN_CULL_BATCH
+ * NPCs are removed every CEN_CHECK_TICKS ticks, farthest from any player
+ * first, then oldest. Culling never goes below a cap, and never touches an NPC
+ * a player placed (wasPlaced or placedByClient); tamed animals loaded from the
+ * save cannot be told apart, which is why no cap is on by default.
+ * Exported for other modules (dlsym):
+ *   int BHNPC_Count(int type)          type 1-8 as in /spawn, -1 = total
+ *   int BHNPC_RegionCount(int x, int y) NPCs in the region of tile x,y (-1 = unknown)
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <objc/runtime.h>
+#include <objc/message.h>
+
+// --- CONFIG ---
+#define CEN_CLASS_GC        "GameController"
+#define CEN_CLASS_SERVER    "BHServer"
+#define CEN_CLASS_DYNWORLD  "DynamicWorld"
+#define CEN_CLASS_NPC       "NPC"
+#define CEN_CONFIG_NAME     "npc_caps.conf"
+#define CEN_SEL_LOAD        "loadNPCAtPosition:type:saveDict:isAdult:wasPlaced:placedByClient:"
+
+#define CEN_TABLE_SIZE      16384   // Tracked NPC slots (power of two), half of it is used at most
+#define CEN_REGION_TILES    32
+#define CEN_REGION_ROWS     32      // 1024 tiles of world height
+#define CEN_SCAN_PER_TICK   64      // Region refreshes per tick
+#define CEN_CHECK_TICKS     10      // Cap check interval
+#define CEN_CULL_BATCH      8       // NPCs removed per check at most
+#define CEN_RESEED_SECONDS  30
+#define CEN_MAX_PLAYERS     128
+#define CEN_TYPES           9       // 0 = unknown, 1-8 as mob_spawner
+
+static const char* CEN_TypeNames[CEN_TYPES] = {
+    "other", "dodo", "dropbear", "donkey", "fish", "shark", "troll", "scorpion", "yak"
+};
+
+// Used for NPCs found by the walk, where the type argument is not known
+static const char* CEN_TypeClasses[CEN_TYPES] = {
+    NULL, "Dodo", "DropBear", "Donkey", "Fish", "Shark", "CaveTroll", "Scorpion", "Yak"
+};
+
+// Count-only: culling cannot tell a tamed donkey or yak from a wild one
+static const char* CEN_DEFAULT_CONFIG =
+    "# NPC caps: <name> <max>. 0 = no cap for that entry.\n"
+    "# Names: dodo dropbear donkey fish shark troll scorpion yak other,\n"
+    "# total (all NPCs) and region (NPCs in one 32x32 block area).\n"
+    "# Over a cap, the NPCs farthest from players are removed a few at a time while\n"
+    "# someone is online. NPCs placed by a player are never removed, but tamed\n"
+    "# animals loaded from the save can be: cap donkeys and yaks with care.\n"
+    "# All caps are off by default; suggested values:\n"
+    "total 0      # 800\n"
+    "region 0     # 40\n"
+    "dodo 0       # 200\n"
+    "donkey 0     # 150\n"
+    "yak 0        # 150\n"
+    "dropbear 0   # 100\n"
+    "scorpion 0   # 80\n"
+    "troll 0      # 60\n"
+    "shark 0      # 60\n"
+    "fish 0       # 200\n";
+
+// --- IMP TYPES ---
+typedef void (*CEN_TickFunc)(id, SEL, float, float);
+typedef id (*CEN_LoadFunc)(id, SEL, long long, int, id, BOOL, BOOL, id);
+typedef void (*CEN_BoolFunc)(id, SEL, BOOL);
+typedef void (*CEN_VoidFunc)(id, SEL);
+typedef id (*CEN_CmdFunc)(id, SEL, id, id);
+typedef void (*CEN_SendFunc)(id, id, const char*, bool);
+typedef void (*CEN_EventFunc)(const char*, const char*, ...);
+typedef const char* (*CEN_Utf8Func)(id, SEL);
+typedef long long (*CEN_PosFunc)(id, SEL);
+typedef unsigned long (*CEN_CountFunc)(id, SEL);
+typedef id (*CEN_IdxFunc)(id, SEL, unsigned long);
+
+// --- MEMORY LAYOUT (dynamicObjects, same as ban_all_new_drops) ---
+struct RbNode_Base {
+    unsigned long _color;
+    struct RbNode_Base* _parent;
+    struct RbNode_Base* _left;
+    struct RbNode_Base* _right;
+};
+
+struct RbNode {
+    struct RbNode_Base base;
+    uint64_t key;
+    id value;
+};
+
+struct RbTree_Impl {
+    unsigned long _pad;
+    struct RbNode_Base _header;
+    size_t _node_count;
+};
+
+// --- STATE ---
+enum { CEN_EMPTY = 0, CEN_LIVE, CEN_GONE, CEN_TOMB };   // GONE: uncounted, slot kept until dealloc
+
+typedef struct {
+    id       npc;
+    int32_t  region;                // -1 = unknown
+    uint8_t  type;
+    uint8_t  state;
+    bool     placed;                // Placed by a player, never culled
+    uint64_t born;                  // Tick
+} CEN_Rec;
+
+static CEN_TickFunc Real_CEN_Tick = NULL;
+static CEN_LoadFunc Real_CEN_Load = NULL;
+static CEN_BoolFunc Real_CEN_SetRemoved = NULL;
+static CEN_VoidFunc Real_CEN_Dealloc = NULL;
+static CEN_CmdFunc  Real_CEN_Cmd = NULL;
+static CEN_SendFunc CEN_Send = NULL;  // BHChat_Send, chat_queue.c
+static CEN_EventFunc   CEN_Event = NULL;    // event_log.c, when loaded
+
+// dealloc can come from any thread that drains a pool
+static pthread_mutex_t g_CEN_Lock = PTHREAD_MUTEX_INITIALIZER;
+static CEN_Rec   g_CEN_Table[CEN_TABLE_SIZE];
+static int       g_CEN_Used = 0;            // LIVE + GONE + TOMB slots
+static int       g_CEN_Type[CEN_TYPES];
+static int       g_CEN_Total = 0;
+static uint16_t* g_CEN_Regions = NULL;      // [macroX * CEN_REGION_ROWS + macroY]
+static int       g_CEN_RegionCount = 0;
+static int       g_CEN_WidthTiles = 0;
+static unsigned  g_CEN_Cursor = 0;
+
+static int g_CEN_CapType[CEN_TYPES];
+static int g_CEN_CapTotal = 0;
+static int g_CEN_CapRegion = 0;
+static char g_CEN_Path[512];
+
+static id  g_CEN_World = nil;
+static id  g_CEN_DynWorld = nil;
+static Class g_CEN_NpcClass = Nil;
+static Class g_CEN_TypeClass[CEN_TYPES];
+static uint64_t g_CEN_Ticks = 0;
+static time_t   g_CEN_LastSeed = 0;
+static unsigned long long g_CEN_Culled = 0;
+
+// --- UTILS ---
+
+static const char* CEN_CStr(id str) {
+    if (!str) return "";
+    SEL s = sel_registerName("UTF8String");
+    CEN_Utf8Func f = (CEN_Utf8Func)class_getMethodImplementation(object_getClass(str), s);
+    return f ? f(str, s) : "";
+}
+
+static void CEN_Msg(id server, id client, const char* msg) {
+    if (CEN_Send) CEN_Send(server, client, msg, true);
+    else printf("%s\n", msg);
+}
+
+static id CEN_GetIvar(id obj, const char* name) {
+    if (!obj) return nil;
+    Ivar iv = class_getInstanceVariable(object_getClass(obj), name);
+    return iv ? *(id*)((char*)obj + ivar_getOffset(iv)) : nil;
+}
+
+static bool CEN_IsValidPtr(void* ptr) {
+    uintptr_t addr = (uintptr_t)ptr;
+    return (addr > 0x400000 && addr < 0x7fffffffffff && (addr % 8 == 0));
+}
+
+static bool CEN_IsKind(Class cls, Class target) {
+    if (!target) return false;
+    for (; cls; cls = class_getSuperclass(cls)) {
+        if (cls == target) return true;
+    }
+    return false;
+}
+
+static long long CEN_GetPos(id obj) {
+    SEL s = sel_registerName("pos");
+    CEN_PosFunc f = (CEN_PosFunc)class_getMethodImplementation(object_getClass(obj), s);
+    return f ? f(obj, s) : -1;
+}
+
+static int CEN_RegionOf(long long pos) {
+    if (!g_CEN_Regions || pos == -1) return -1;
+    int x = (int)(pos & 0xFFFFFFFF);
+    int y = (int)(pos >> 32);
+    if (x < 0 || x >= g_CEN_WidthTiles || y < 0 || y >= CEN_REGION_ROWS * CEN_REGION_TILES) return -1;
+    return (x / CEN_REGION_TILES) * CEN_REGION_ROWS + y / CEN_REGION_TILES;
+}
+
+// --- CAPS ---
+
+static void CEN_LoadCaps(void) {
+    const char* dir = getenv("BH_WORLD_DIR");
+    if (dir && *dir) snprintf(g_CEN_Path, sizeof(g_CEN_Path), "%s/%s", dir, CEN_CONFIG_NAME);
+    else snprintf(g_CEN_Path, sizeof(g_CEN_Path), "%s", CEN_CONFIG_NAME);
+
+    if (access(g_CEN_Path, F_OK) != 0) {
+        FILE* f = fopen(g_CEN_Path, "w");
+        if (f) {
+            fputs(CEN_DEFAULT_CONFIG, f);
+            fclose(f);
+            printf("[NPCCensus] Created default %s\n", g_CEN_Path);
+        }
+    }
+
+    FILE* f = fopen(g_CEN_Path, "r");
+    if (!f) {
+        printf("[NPCCensus] Cannot read %s, keeping current caps.\n", g_CEN_Path);
+        return;
+    }
+    int capType[CEN_TYPES] = {0};
+    int capTotal = 0, capRegion = 0;
+    char line[256];
+    int lineNo = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineNo++;
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char name[64];
+        int value;
+        if (sscanf(line, "%63s %d", name, &value) != 2) {
+            if (sscanf(line, "%63s", name) == 1) printf("[NPCCensus] %s:%d: expected <name> <max>\n", g_CEN_Path, lineNo);
+            continue;
+        }
+        if (value < 0) value = 0;
+        if (strcasecmp(name, "total") == 0) { capTotal = value; continue; }
+        if (strcasecmp(name, "region") == 0) { capRegion = value; continue; }
+        int t = 0;
+        while (t < CEN_TYPES && strcasecmp(name, CEN_TypeNames[t]) != 0) t++;
+        if (t == CEN_TYPES) printf("[NPCCensus] %s:%d: unknown name '%s'\n", g_CEN_Path, lineNo, name);
+        else capType[t] = value;
+    }
+    fclose(f);
+
+    pthread_mutex_lock(&g_CEN_Lock);
+    memcpy(g_CEN_CapType, capType, sizeof(capType));
+    g_CEN_CapTotal = capTotal;
+    g_CEN_CapRegion = capRegion;
+    pthread_mutex_unlock(&g_CEN_Lock);
+    printf("[NPCCensus] Caps loaded from %s (total %d, region %d).\n", g_CEN_Path, capTotal, capRegion);
+}
+
+// --- TABLE (lock held) ---
+
+static size_t CEN_Hash(id npc) {
+    uintptr_t k = (uintptr_t)npc;
+    k ^= k >> 17;
+    k *= 0x9E3779B97F4A7C15ull;
+    return (size_t)(k >> 32) & (CEN_TABLE_SIZE - 1);
+}
+
+static CEN_Rec* CEN_Find(id npc) {
+    size_t h = CEN_Hash(npc);
+    for (size_t i = 0; i < CEN_TABLE_SIZE; i++) {
+        CEN_Rec* r = &g_CEN_Table[(h + i) & (CEN_TABLE_SIZE - 1)];
+        if (r->state == CEN_EMPTY) return NULL;
+        if (r->state != CEN_TOMB && r->npc == npc) return r;
+    }
+    return NULL;
+}
+
+static void CEN_Uncount(CEN_Rec* r) {
+    if (r->state != CEN_LIVE) return;
+    g_CEN_Type[r->type]--;
+    g_CEN_Total--;
+    if (r->region >= 0 && g_CEN_Regions[r->region] > 0) g_CEN_Regions[r->region]--;
+    r->state = CEN_GONE;
+}
+
+// Rebuilds the table without tombstones
+static void CEN_Rehash(void) {
+    static CEN_Rec old[CEN_TABLE_SIZE];
+    memcpy(old, g_CEN_Table, sizeof(old));
+    memset(g_CEN_Table, 0, sizeof(g_CEN_Table));
+    g_CEN_Used = 0;
+    for (int i = 0; i < CEN_TABLE_SIZE; i++) {
+        if (old[i].state != CEN_LIVE && old[i].state != CEN_GONE) continue;
+        size_t h = CEN_Hash(old[i].npc);
+        while (g_CEN_Table[h].state != CEN_EMPTY) h = (h + 1) & (CEN_TABLE_SIZE - 1);
+        g_CEN_Table[h] = old[i];
+        g_CEN_Used++;
+    }
+}
+
+static void CEN_Track(id npc, int type, bool placed) {
+    if (!npc || CEN_Find(npc)) return;
+    if (g_CEN_Used >= CEN_TABLE_SIZE / 2) {
+        CEN_Rehash();
+        if (g_CEN_Used >= CEN_TABLE_SIZE / 2) return; // Full: NPC stays untracked
+    }
+    size_t h = CEN_Hash(npc);
+    while (g_CEN_Table[h].state == CEN_LIVE || g_CEN_Table[h].state == CEN_GONE) h = (h + 1) & (CEN_TABLE_SIZE - 1);
+    CEN_Rec* r = &g_CEN_Table[h];
+    if (r->state == CEN_EMPTY) g_CEN_Used++;
+    r->npc = npc;
+    r->type = (uint8_t)((type > 0 && type < CEN_TYPES) ? type : 0);
+    r->state = CEN_LIVE;
+    r->placed = placed;
+    r->born = g_CEN_Ticks;
+    r->region = CEN_RegionOf(CEN_GetPos(npc));
+    g_CEN_Type[r->type]++;
+    g_CEN_Total++;
+    if (r->region >= 0 && g_CEN_Regions[r->region] < UINT16_MAX) g_CEN_Regions[r->region]++;
+}
+
+static int CEN_TypeOfClass(Class cls) {
+    for (int t = 1; t < CEN_TYPES; t++) {
+        if (CEN_IsKind(cls, g_CEN_TypeClass[t])) return t;
+    }
+    return 0;
+}
+
+static void CEN_SeedWalk(struct RbNode_Base* node, int depth) {
+    if (!node || depth > 500 || !CEN_IsValidPtr(node)) return;
+    id obj = ((struct RbNode*)node)->value;
+    if (obj && CEN_IsValidPtr(obj)) {
+        Class cls = object_getClass(obj);
+        if (CEN_IsKind(cls, g_CEN_NpcClass) && !CEN_Find(obj)) CEN_Track(obj, CEN_TypeOfClass(cls), false);
+    }
+    CEN_SeedWalk(node->_left, depth + 1);
+    CEN_SeedWalk(node->_right, depth + 1);
+}
+
+static void CEN_Seed(void) {
+    Ivar mapIvar = class_getInstanceVariable(object_getClass(g_CEN_DynWorld), "dynamicObjects");
+    if (!mapIvar || !g_CEN_NpcClass) return;
+    struct RbTree_Impl* maps = (struct RbTree_Impl*)((char*)g_CEN_DynWorld + ivar_getOffset(mapIvar));
+    for (int i = 0; i < 65; i++) {
+        if (maps[i]._node_count == 0 || maps[i]._node_count > 1000000) continue;
+        CEN_SeedWalk(maps[i]._header._parent, 0);
+    }
+}
+
+// NPCs move; a few regions are re-read per tick
+static void CEN_RefreshRegions(void) {
+    if (!g_CEN_Regions) return;
+    for (int n = 0; n < CEN_SCAN_PER_TICK; n++) {
+        CEN_Rec* r = &g_CEN_Table[g_CEN_Cursor++ & (CEN_TABLE_SIZE - 1)];
+        if (r->state != CEN_LIVE) continue;
+        int region = CEN_RegionOf(CEN_GetPos(r->npc));
+        if (region == r->region) continue;
+        if (r->region >= 0 && g_CEN_Regions[r->region] > 0) g_CEN_Regions[r->region]--;
+        if (region >= 0 && g_CEN_Regions[region] < UINT16_MAX) g_CEN_Regions[region]++;
+        r->region = region;
+    }
+}
+
+static bool CEN_OverCap(CEN_Rec* r) {
+    if (g_CEN_CapTotal > 0 && g_CEN_Total > g_CEN_CapTotal) return true;
+    if (g_CEN_CapType[r->type] > 0 && g_CEN_Type[r->type] > g_CEN_CapType[r->type]) return true;
+    return g_CEN_CapRegion > 0 && r->region >= 0 && g_CEN_Regions[r->region] > g_CEN_CapRegion;
+}
+
+// --- CULLING ---
+
+// Fills victims (farthest from players, then oldest) and uncounts them. Lock held.
+static int CEN_PickVictims(id* victims, const int* px, const int* py, int players) {
+    CEN_Rec* best[CEN_CULL_BATCH];
+    double score[CEN_CULL_BATCH];
+    int n = 0;
+
+    for (int i = 0; i < CEN_TABLE_SIZE; i++) {
+        CEN_Rec* r = &g_CEN_Table[i];
+        if (r->state != CEN_LIVE || r->placed || !CEN_OverCap(r)) continue;
+
+        long long pos = CEN_GetPos(r->npc);
+        int x = (int)(pos & 0xFFFFFFFF), y = (int)(pos >> 32);
+        double dist = 1e9;
+        for (int p = 0; p < players; p++) {
+            int dx = abs(x - px[p]);
+            if (g_CEN_WidthTiles > 0 && dx > g_CEN_WidthTiles / 2) dx = g_CEN_WidthTiles - dx; // World wraps
+            double d = (double)dx + (double)abs(y - py[p]);
+            if (d < dist) dist = d;
+        }
+        double sc = dist * 1e9 + (double)(g_CEN_Ticks - r->born);
+
+        int at = n < CEN_CULL_BATCH ? n++ : CEN_CULL_BATCH;
+        if (at == CEN_CULL_BATCH) {
+            if (sc <= score[CEN_CULL_BATCH - 1]) continue;
+            at = CEN_CULL_BATCH - 1;
+        }
+        while (at > 0 && score[at - 1] < sc) {
+            best[at] = best[at - 1];
+            score[at] = score[at - 1];
+            at--;
+        }
+        best[at] = r;
+        score[at] = sc;
+    }
+
+    // Re-checked one by one so culling stops exactly at the caps
+    int picked = 0;
+    for (int i = 0; i < n; i++) {
+        if (!CEN_OverCap(best[i])) continue;
+        victims[picked++] = best[i]->npc;
+        CEN_Uncount(best[i]);
+    }
+    return picked;
+}
+
+static int CEN_SamplePlayers(int* px, int* py) {
+    id list = CEN_GetIvar(g_CEN_DynWorld, "netBlockheads");
+    if (!list) return 0;
+    SEL sCount = sel_registerName("count");
+    SEL sIdx = sel_registerName("objectAtIndex:");
+    CEN_CountFunc fCount = (CEN_CountFunc)class_getMethodImplementation(object_getClass(list), sCount);
+    CEN_IdxFunc fIdx = (CEN_IdxFunc)class_getMethodImplementation(object_getClass(list), sIdx);
+    if (!fCount || !fIdx) return 0;
+
+    int n = 0;
+    unsigned long count = fCount(list, sCount);
+    for (unsigned long i = 0; i < count && n < CEN_MAX_PLAYERS; i++) {
+        id bh = fIdx(list, sIdx, i);
+        if (!bh) continue;
+        long long pos = CEN_GetPos(bh);
+        px[n] = (int)(pos & 0xFFFFFFFF);
+        py[n] = (int)(pos >> 32);
+        n++;
+    }
+    return n;
+}
+
+static void CEN_Cull(void) {
+    int px[CEN_MAX_PLAYERS], py[CEN_MAX_PLAYERS];
+    int players = CEN_SamplePlayers(px, py);
+    // Nobody to protect from lag, and no way to tell which NPCs are out of sight
+    if (players == 0) return;
+
+    id victims[CEN_CULL_BATCH];
+    pthread_mutex_lock(&g_CEN_Lock);
+    int n = CEN_PickVictims(victims, px, py, players);
+    int total = g_CEN_Total;
+    pthread_mutex_unlock(&g_CEN_Lock);
+    if (n == 0) return;
+
+    // Outside the lock: the setNeedsRemoved: hook takes it again
+    SEL s = sel_registerName("setNeedsRemoved:");
+    for (int i = 0; i < n; i++) {
+        CEN_BoolFunc f = (CEN_BoolFunc)class_getMethodImplementation(object_getClass(victims[i]), s);
+        if (f) f(victims[i], s, 1);
+    }
+    g_CEN_Culled += (unsigned long long)n;
+    if (CEN_Event) CEN_Event("npc_cull", "ii", "removed", (long long)n, "total", (long long)total);
+}
+
+// --- API ---
+
+int BHNPC_Count(int type) {
+    if (type < 0) return g_CEN_Total;
+    return type < CEN_TYPES ? g_CEN_Type[type] : 0;
+}
+
+int BHNPC_RegionCount(int x, int y) {
+    int region = CEN_RegionOf(((long long)y << 32) | (unsigned int)x);
+    return region >= 0 ? g_CEN_Regions[region] : -1;
+}
+
+// --- HOOKS ---
+
+id Hook_CEN_Load(id self, SEL _cmd, long long pos, int type, id saveDict, BOOL adult, BOOL placed, id client) {
+    id npc = Real_CEN_Load ? Real_CEN_Load(self, _cmd, pos, type, saveDict, adult, placed, client) : nil;
+    if (npc && g_CEN_DynWorld) {
+        pthread_mutex_lock(&g_CEN_Lock);
+        CEN_Track(npc, type, placed || client);
+        pthread_mutex_unlock(&g_CEN_Lock);
+    }
+    return npc;
+}
+
+void Hook_CEN_SetRemoved(id self, SEL _cmd, BOOL removed) {
+    if (removed) {
+        pthread_mutex_lock(&g_CEN_Lock);
+        CEN_Rec* r = CEN_Find(self);
+        if (r) CEN_Uncount(r);
+        pthread_mutex_unlock(&g_CEN_Lock);
+    }
+    if (Real_CEN_SetRemoved) Real_CEN_SetRemoved(self, _cmd, removed);
+}
+
+void Hook_CEN_Dealloc(id self, SEL _cmd) {
+    pthread_mutex_lock(&g_CEN_Lock);
+    CEN_Rec* r = CEN_Find(self);
+    if (r) {
+        CEN_Uncount(r);
+        r->state = CEN_TOMB;
+        r->npc = nil;
+    }
+    pthread_mutex_unlock(&g_CEN_Lock);
+    if (Real_CEN_Dealloc) Real_CEN_Dealloc(self, _cmd);
+}
+
+// Resolves BHServer -> World -> DynamicWorld and seeds the table
+static void CEN_Attach(id gameController) {
+    id server = CEN_GetIvar(gameController, "bhServer");
+    id world = CEN_GetIvar(server, "world");
+    id dynWorld = CEN_GetIvar(world, "dynamicWorld");
+    if (!dynWorld) return;
+
+    Ivar ivW = class_getInstanceVariable(object_getClass(world), "worldWidthMacro");
+    int widthMacro = ivW ? *(int*)((char*)world + ivar_getOffset(ivW)) : 0;
+
+    pthread_mutex_lock(&g_CEN_Lock);
+    if (widthMacro > 0) {
+        g_CEN_Regions = calloc((size_t)widthMacro * CEN_REGION_ROWS, sizeof(uint16_t));
+        if (g_CEN_Regions) {
+            g_CEN_RegionCount = widthMacro * CEN_REGION_ROWS;
+            g_CEN_WidthTiles = widthMacro * CEN_REGION_TILES;
+        }
+    }
+    g_CEN_World = world;
+    g_CEN_DynWorld = dynWorld;
+    CEN_Seed();
+    g_CEN_LastSeed = time(NULL);
+    pthread_mutex_unlock(&g_CEN_Lock);
+    printf("[NPCCensus] World attached: %d NPC(s), %d regions.\n", g_CEN_Total, g_CEN_RegionCount);
+}
+
+void Hook_CEN_Tick(id self, SEL _cmd, float dt, float accDt) {
+    if (Real_CEN_Tick) Real_CEN_Tick(self, _cmd, dt, accDt);
+    g_CEN_Ticks++;
+
+    if (!g_CEN_DynWorld) {
+        CEN_Attach(self);
+        return;
+    }
+
+    pthread_mutex_lock(&g_CEN_Lock);
+    CEN_RefreshRegions();
+    time_t now = time(NULL);
+    if (now - g_CEN_LastSeed >= CEN_RESEED_SECONDS) {
+        g_CEN_LastSeed = now;
+        CEN_Seed();
+    }
+    pthread_mutex_unlock(&g_CEN_Lock);
+
+    if (g_CEN_Ticks % CEN_CHECK_TICKS == 0) CEN_Cull();
+}
+
+id Hook_CEN_Cmd(id self, SEL _cmd, id cmdStr, id client) {
+    const char* raw = CEN_CStr(cmdStr);
+    if (strncasecmp(raw, "/npcs", 5) != 0 || (raw[5] != '\0' && raw[5] != ' ')) {
+        return Real_CEN_Cmd(self, _cmd, cmdStr, client);
+    }
+
+    if (strcasecmp(raw, "/npcs reload") == 0) {
+        CEN_LoadCaps();
+        CEN_Msg(self, client, "[NPCs] Caps reloaded.");
+        return nil;
+    }
+
+    char msg[256];
+    int n = snprintf(msg, sizeof(msg), "[NPCs] Total %d", g_CEN_Total);
+    if (g_CEN_CapTotal > 0) n += snprintf(msg + n, sizeof(msg) - n, "/%d", g_CEN_CapTotal);
+    n += snprintf(msg + n, sizeof(msg) - n, " | Region cap %d | Culled %llu", g_CEN_CapRegion, g_CEN_Culled);
+    CEN_Msg(self, client, msg);
+
+    n = snprintf(msg, sizeof(msg), "[NPCs]");
+    for (int t = 0; t < CEN_TYPES && n < (int)sizeof(msg); t++) {
+        if (g_CEN_Type[t] == 0 && g_CEN_CapType[t] == 0) continue;
+        n += snprintf(msg + n, sizeof(msg) - n, " %s %d", CEN_TypeNames[t], g_CEN_Type[t]);
+        if (g_CEN_CapType[t] > 0 && n < (int)sizeof(msg)) n += snprintf(msg + n, sizeof(msg) - n, "/%d", g_CEN_CapType[t]);
+    }
+    CEN_Msg(self, client, msg);
+    return nil;
+}
+
+// --- INIT ---
+
+// Hooks the method on cls itself. If it is only inherited, an override is added
+// so the superclass (and every other subclass) keeps its original code.
+static IMP CEN_HookOwn(Class cls, SEL sel, IMP hook) {
+    Method m = class_getInstanceMethod(cls, sel);
+    if (!m) return NULL;
+    IMP orig = method_getImplementation(m);
+    if (class_addMethod(cls, sel, hook, method_getTypeEncoding(m))) return orig;
+    return method_setImplementation(class_getInstanceMethod(cls, sel), hook);
+}
+
+static void* CEN_Init(void* arg) {
+    sleep(1);
+
+    Class clsGC = objc_getClass(CEN_CLASS_GC);
+    Class clsSrv = objc_getClass(CEN_CLASS_SERVER);
+    Class clsDW = objc_getClass(CEN_CLASS_DYNWORLD);
+    g_CEN_NpcClass = objc_getClass(CEN_CLASS_NPC);
+    if (!clsGC || !clsSrv || !clsDW || !g_CEN_NpcClass) {
+        printf("[NPCCensus] NPC classes not found, census disabled.\n");
+        return NULL;
+    }
+    for (int t = 1; t < CEN_TYPES; t++) g_CEN_TypeClass[t] = objc_getClass(CEN_TypeClasses[t]);
+
+    CEN_LoadCaps();
+    CEN_Send = (CEN_SendFunc)dlsym(RTLD_DEFAULT, "BHChat_Send");
+    CEN_Event = (CEN_EventFunc)dlsym(RTLD_DEFAULT, "BHEvent_Emit");
+
+    Method mL = class_getInstanceMethod(clsDW, sel_registerName(CEN_SEL_LOAD));
+    if (mL) {
+        Real_CEN_Load = (CEN_LoadFunc)method_getImplementation(mL);
+        method_setImplementation(mL, (IMP)Hook_CEN_Load);
+    }
+    Real_CEN_SetRemoved = (CEN_BoolFunc)CEN_HookOwn(g_CEN_NpcClass, sel_registerName("setNeedsRemoved:"), (IMP)Hook_CEN_SetRemoved);
+    Real_CEN_Dealloc = (CEN_VoidFunc)CEN_HookOwn(g_CEN_NpcClass, sel_registerName("dealloc"), (IMP)Hook_CEN_Dealloc);
+
+    Method mC = class_getInstanceMethod(clsSrv, sel_registerName("handleCommand:issueClient:"));
+    if (mC) {
+        Real_CEN_Cmd = (CEN_CmdFunc)method_getImplementation(mC);
+        method_setImplementation(mC, (IMP)Hook_CEN_Cmd);
+    }
+
+    Method mTick = class_getInstanceMethod(clsGC, sel_registerName("update:accurateDT:"));
+    if (mTick) {
+        Real_CEN_Tick = (CEN_TickFunc)method_getImplementation(mTick);
+        method_setImplementation(mTick, (IMP)Hook_CEN_Tick);
+    }
+    printf("[NPCCensus] Ready.\n");
+    return NULL;
+}
+
+__attribute__((constructor))
+static void CEN_Entry() {
+    pthread_t t;
+    pthread_create(&t, NULL, CEN_Init, NULL);
+    pthread_detach(t);
+}
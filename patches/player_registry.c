@@ -0,0 +1,314 @@
+//Commands: (none, used by other mods)
+
+/*
+ * Player Registry - Name and client ID index of the world's blockheads
+ * Blockheads are added the first time they update (new joins, respawns and
+ * anyone already online when the module loads) and dropped when they are
+ * marked for removal or freed. Names and client IDs are read once per
+ * blockhead, case-folded and hashed, so finding a player is one table lookup
+ * with no ObjC string calls.
+ * Exported for other modules (dlsym), main thread:
+ *   id BHPlayer_FindByName(const char* name)          case-insensitive
+ *   id BHPlayer_FindByClientID(const char* clientID)
+ * Both return nil when no blockhead matches. A player with several
+ * blockheads resolves to the first one registered, like the old list scans.
+ * A blockhead is only known after its first update, so callers fall back to
+ * their own list scan on nil.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <objc/runtime.h>
+#include <objc/message.h>
+
+// --- CONFIG ---
+#define PREG_CLASS_BH      "Blockhead"
+#define PREG_MAX_BH        512     // Blockheads tracked at once
+#define PREG_INDEX_SIZE    2048    // Slots per index (power of two, 4x PREG_MAX_BH)
+#define PREG_NAME_MAX      64
+#define PREG_GONE_MAX      64
+
+// --- IMP TYPES ---
+typedef void (*PREG_UpdateFunc)(id, SEL, float, float, BOOL);
+typedef void (*PREG_BoolFunc)(id, SEL, BOOL);
+typedef void (*PREG_VoidFunc)(id, SEL);
+typedef id (*PREG_GetterFunc)(id, SEL);
+typedef const char* (*PREG_Utf8Func)(id, SEL);
+
+// --- STATE ---
+typedef struct {
+    id       bh;                    // nil = free
+    uint32_t nameHash;
+    uint32_t idHash;
+    uint32_t seq;                   // Registration order, lowest wins on lookup
+    char     name[PREG_NAME_MAX];   // Case-folded
+    char     clientID[PREG_NAME_MAX];
+} PREG_Entry;
+
+static PREG_UpdateFunc Real_PREG_Update = NULL;
+static PREG_BoolFunc   Real_PREG_SetRemoved = NULL;
+static PREG_VoidFunc   Real_PREG_Dealloc = NULL;
+
+// dealloc may run on any thread
+static pthread_mutex_t g_PREG_Lock = PTHREAD_MUTEX_INITIALIZER;
+static PREG_Entry g_PREG_Entries[PREG_MAX_BH];
+static uint32_t   g_PREG_Seq = 0;
+
+// Open-addressing indexes into g_PREG_Entries: entry + 1, 0 = empty, -1 = deleted
+enum { PREG_IDX_PTR = 0, PREG_IDX_NAME, PREG_IDX_ID, PREG_IDX_COUNT };
+static int16_t g_PREG_Index[PREG_IDX_COUNT][PREG_INDEX_SIZE];
+static int     g_PREG_Deleted = 0;
+
+// Removed blockheads still update until the world drops them, and blockheads
+// without a client never get a name; neither is looked at again.
+static id  g_PREG_Gone[PREG_GONE_MAX];
+static int g_PREG_GoneNext = 0;
+
+// --- UTILS ---
+
+static const char* PREG_CStr(id str) {
+    if (!str) return NULL;
+    SEL s = sel_registerName("UTF8String");
+    PREG_Utf8Func f = (PREG_Utf8Func)class_getMethodImplementation(object_getClass(str), s);
+    return f ? f(str, s) : NULL;
+}
+
+static id PREG_Get(id obj, const char* selName, const char* ivarName) {
+    SEL s = sel_registerName(selName);
+    Method m = class_getInstanceMethod(object_getClass(obj), s);
+    if (m) return ((PREG_GetterFunc)method_getImplementation(m))(obj, s);
+    Ivar iv = class_getInstanceVariable(object_getClass(obj), ivarName);
+    return iv ? *(id*)((char*)obj + ivar_getOffset(iv)) : nil;
+}
+
+// Case-folds src into dst and returns its FNV-1a hash (0 = empty)
+static uint32_t PREG_Fold(const char* src, char* dst) {
+    uint32_t h = 2166136261u;
+    int n = 0;
+    for (; src && src[n] && n < PREG_NAME_MAX - 1; n++) {
+        dst[n] = (char)tolower((unsigned char)src[n]);
+        h = (h ^ (unsigned char)dst[n]) * 16777619u;
+    }
+    dst[n] = '\0';
+    return n ? (h | 1) : 0;
+}
+
+// --- INDEXES (lock held) ---
+
+static uint32_t PREG_Key(int index, const PREG_Entry* e) {
+    if (index == PREG_IDX_NAME) return e->nameHash;
+    if (index == PREG_IDX_ID) return e->idHash;
+    uintptr_t k = (uintptr_t)e->bh;
+    return (uint32_t)((k >> 4) ^ (k >> 20));
+}
+
+static void PREG_IndexAdd(int index, int entry) {
+    uint32_t h = PREG_Key(index, &g_PREG_Entries[entry]);
+    for (int i = 0; i < PREG_INDEX_SIZE; i++) {
+        int16_t* slot = &g_PREG_Index[index][(h + i) & (PREG_INDEX_SIZE - 1)];
+        if (*slot > 0) continue;
+        if (*slot < 0) g_PREG_Deleted--;
+        *slot = (int16_t)(entry + 1);
+        return;
+    }
+}
+
+static void PREG_IndexDel(int index, int entry) {
+    uint32_t h = PREG_Key(index, &g_PREG_Entries[entry]);
+    for (int i = 0; i < PREG_INDEX_SIZE; i++) {
+        int16_t* slot = &g_PREG_Index[index][(h + i) & (PREG_INDEX_SIZE - 1)];
+        if (*slot == 0) return;
+        if (*slot == entry + 1) {
+            *slot = -1;
+            g_PREG_Deleted++;
+            return;
+        }
+    }
+}
+
+// Deleted markers lengthen every probe; rebuilt once they pile up
+static void PREG_Rebuild(void) {
+    memset(g_PREG_Index, 0, sizeof(g_PREG_Index));
+    g_PREG_Deleted = 0;
+    for (int e = 0; e < PREG_MAX_BH; e++) {
+        if (!g_PREG_Entries[e].bh) continue;
+        for (int index = 0; index < PREG_IDX_COUNT; index++) {
+            if (index == PREG_IDX_ID && !g_PREG_Entries[e].idHash) continue;
+            PREG_IndexAdd(index, e);
+        }
+    }
+}
+
+static int PREG_FindPtr(id bh) {
+    uintptr_t k = (uintptr_t)bh;
+    uint32_t h = (uint32_t)((k >> 4) ^ (k >> 20));
+    for (int i = 0; i < PREG_INDEX_SIZE; i++) {
+        int16_t v = g_PREG_Index[PREG_IDX_PTR][(h + i) & (PREG_INDEX_SIZE - 1)];
+        if (v == 0) return -1;
+        if (v > 0 && g_PREG_Entries[v - 1].bh == bh) return v - 1;
+    }
+    return -1;
+}
+
+static void PREG_Add(id bh, uint32_t nameHash, const char* name, uint32_t idHash, const char* cid) {
+    int e = 0;
+    while (e < PREG_MAX_BH && g_PREG_Entries[e].bh) e++;
+    if (e == PREG_MAX_BH) return; // Full: this blockhead stays unregistered
+
+    PREG_Entry* ent = &g_PREG_Entries[e];
+    ent->bh = bh;
+    ent->nameHash = nameHash;
+    ent->idHash = idHash;
+    ent->seq = g_PREG_Seq++;
+    memcpy(ent->name, name, PREG_NAME_MAX);
+    memcpy(ent->clientID, cid, PREG_NAME_MAX);
+    PREG_IndexAdd(PREG_IDX_PTR, e);
+    PREG_IndexAdd(PREG_IDX_NAME, e);
+    if (idHash) PREG_IndexAdd(PREG_IDX_ID, e);
+}
+
+static void PREG_Drop(id bh) {
+    int e = PREG_FindPtr(bh);
+    if (e < 0) return;
+    PREG_IndexDel(PREG_IDX_PTR, e);
+    PREG_IndexDel(PREG_IDX_NAME, e);
+    if (g_PREG_Entries[e].idHash) PREG_IndexDel(PREG_IDX_ID, e);
+    g_PREG_Entries[e].bh = nil;
+    if (g_PREG_Deleted > PREG_INDEX_SIZE / 4) PREG_Rebuild();
+}
+
+static bool PREG_IsGone(id bh) {
+    for (int i = 0; i < PREG_GONE_MAX; i++) {
+        if (g_PREG_Gone[i] == bh) return true;
+    }
+    return false;
+}
+
+static void PREG_MarkGone(id bh) {
+    g_PREG_Gone[g_PREG_GoneNext] = bh;
+    g_PREG_GoneNext = (g_PREG_GoneNext + 1) % PREG_GONE_MAX;
+}
+
+static id PREG_Lookup(int index, uint32_t hash, const char* folded) {
+    PREG_Entry* best = NULL;
+    for (int i = 0; i < PREG_INDEX_SIZE; i++) {
+        int16_t v = g_PREG_Index[index][(hash + i) & (PREG_INDEX_SIZE - 1)];
+        if (v == 0) break;
+        if (v < 0) continue;
+        PREG_Entry* e = &g_PREG_Entries[v - 1];
+        if ((index == PREG_IDX_NAME ? e->nameHash : e->idHash) != hash) continue;
+        if (strcmp(index == PREG_IDX_NAME ? e->name : e->clientID, folded) != 0) continue;
+        if (!best || e->seq < best->seq) best = e;
+    }
+    return best ? best->bh : nil;
+}
+
+// --- API ---
+
+id BHPlayer_FindByName(const char* name) {
+    char folded[PREG_NAME_MAX];
+    uint32_t h = PREG_Fold(name, folded);
+    if (!h) return nil;
+    pthread_mutex_lock(&g_PREG_Lock);
+    id bh = PREG_Lookup(PREG_IDX_NAME, h, folded);
+    pthread_mutex_unlock(&g_PREG_Lock);
+    return bh;
+}
+
+id BHPlayer_FindByClientID(const char* clientID) {
+    char folded[PREG_NAME_MAX];
+    uint32_t h = PREG_Fold(clientID, folded);
+    if (!h) return nil;
+    pthread_mutex_lock(&g_PREG_Lock);
+    id bh = PREG_Lookup(PREG_IDX_ID, h, folded);
+    pthread_mutex_unlock(&g_PREG_Lock);
+    return bh;
+}
+
+// --- HOOKS ---
+
+void Hook_PREG_Update(id self, SEL _cmd, float dt, float accDt, BOOL isSim) {
+    pthread_mutex_lock(&g_PREG_Lock);
+    bool known = PREG_FindPtr(self) >= 0 || PREG_IsGone(self);
+    pthread_mutex_unlock(&g_PREG_Lock);
+
+    if (!known) {
+        // Strings are read outside the lock
+        char name[PREG_NAME_MAX], cid[PREG_NAME_MAX];
+        uint32_t nameHash = PREG_Fold(PREG_CStr(PREG_Get(self, "clientName", "clientName")), name);
+        uint32_t idHash = PREG_Fold(PREG_CStr(PREG_Get(self, "clientID", "clientID")), cid);
+
+        pthread_mutex_lock(&g_PREG_Lock);
+        if (!nameHash) PREG_MarkGone(self);
+        else if (PREG_FindPtr(self) < 0) PREG_Add(self, nameHash, name, idHash, cid);
+        pthread_mutex_unlock(&g_PREG_Lock);
+    }
+
+    if (Real_PREG_Update) Real_PREG_Update(self, _cmd, dt, accDt, isSim);
+}
+
+void Hook_PREG_SetRemoved(id self, SEL _cmd, BOOL removed) {
+    if (removed) {
+        pthread_mutex_lock(&g_PREG_Lock);
+        PREG_Drop(self);
+        PREG_MarkGone(self);
+        pthread_mutex_unlock(&g_PREG_Lock);
+    }
+    if (Real_PREG_SetRemoved) Real_PREG_SetRemoved(self, _cmd, removed);
+}
+
+void Hook_PREG_Dealloc(id self, SEL _cmd) {
+    pthread_mutex_lock(&g_PREG_Lock);
+    PREG_Drop(self);
+    // The address can be reused by a new blockhead
+    for (int i = 0; i < PREG_GONE_MAX; i++) {
+        if (g_PREG_Gone[i] == self) g_PREG_Gone[i] = nil;
+    }
+    pthread_mutex_unlock(&g_PREG_Lock);
+    if (Real_PREG_Dealloc) Real_PREG_Dealloc(self, _cmd);
+}
+
+// --- INIT ---
+
+// Hooks the method on cls itself; an inherited method gets an override on cls
+// so other DynamicObject subclasses keep their original code.
+static IMP PREG_HookOwn(Class cls, SEL sel, IMP hook) {
+    Method m = class_getInstanceMethod(cls, sel);
+    if (!m) return NULL;
+    IMP orig = method_getImplementation(m);
+    if (class_addMethod(cls, sel, hook, method_getTypeEncoding(m))) return orig;
+    return method_setImplementation(class_getInstanceMethod(cls, sel), hook);
+}
+
+static void* PREG_Init(void* arg) {
+    sleep(1);
+    Class clsBH = objc_getClass(PREG_CLASS_BH);
+    if (!clsBH) {
+        printf("[PlayerRegistry] Blockhead class not found, registry disabled.\n");
+        return NULL;
+    }
+
+    Real_PREG_SetRemoved = (PREG_BoolFunc)PREG_HookOwn(clsBH, sel_registerName("setNeedsRemoved:"), (IMP)Hook_PREG_SetRemoved);
+    Real_PREG_Dealloc = (PREG_VoidFunc)PREG_HookOwn(clsBH, sel_registerName("dealloc"), (IMP)Hook_PREG_Dealloc);
+    Real_PREG_Update = (PREG_UpdateFunc)PREG_HookOwn(clsBH, sel_registerName("update:accurateDT:isSimulation:"), (IMP)Hook_PREG_Update);
+    if (!Real_PREG_Update) {
+        printf("[PlayerRegistry] Blockhead update not found, registry disabled.\n");
+        return NULL;
+    }
+    printf("[PlayerRegistry] Ready.\n");
+    return NULL;
+}
+
+__attribute__((constructor))
+static void PREG_Entry_Point() {
+    pthread_t t;
+    pthread_create(&t, NULL, PREG_Init, NULL);
+    pthread_detach(t);
+}
@@ -0,0 +1,683 @@
+//Commands: none (ranks follow players.log; rank_manager.sh keeps handling passwords and IP checks)
+
+/*
+ * Rank Engine - In-process rank sync for players.log
+ * Replaces the md5sum polling loop of rank_manager.sh. players.log is parsed
+ * once into a hash index (name -> first IP, password set, rank) and re-parsed
+ * only when inotify reports a write or rename in the world folder. When
+ * tools/playerdb keeps players.db next to it, that store is read instead.
+ * Joins and leaves are taken from the server's own hooks, so the peer IP is
+ * exact.
+ * Rank changes are applied on the main thread through BHServer's command
+ * handler (/admin, /mod, ...), the same commands rank_manager.sh typed into
+ * the screen session.
+ *
+ * A player gets their rank while connected, when the IP matches first_ip and a
+ * password is set. It is removed 10s after leaving (1s if never verified).
+ * While loaded, $BH_WORLD_DIR/rank_engine.active holds the server PID and
+ * rank_manager.sh leaves rank sync to this module.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <poll.h>
+#include <arpa/inet.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include <objc/runtime.h>
+#include <objc/message.h>
+
+// --- CONFIG ---
+#define RANK_CLASS_GC       "GameController"
+#define RANK_CLASS_MATCH    "BHNetServerMatch"
+#define RANK_LOG_NAME       "players.log"
+#define RANK_DB_NAME        "players.db"    // tools/playerdb store, preferred when present
+#define RANK_MARKER_NAME    "rank_engine.active"
+#define RANK_CLOUD_LIST     "GNUstep/Library/ApplicationSupport/TheBlockheads/cloudWideOwnedAdminlist.txt"
+
+#define RANK_NAME_MAX       32
+#define RANK_MAX_PLAYERS    256     // Connected (or just left) players tracked at once
+#define RANK_JOIN_DELAY     1.0     // Seconds after join before the rank is granted
+#define RANK_LEAVE_DELAY    10.0    // Seconds after leaving before a verified rank is removed
+#define RANK_LEAVE_FAST     1.0     // Same, for players that were never verified
+#define RANK_POLL_MS        1000    // Fallback stat() poll when inotify is unavailable
+
+// players.db layout (tools/playerdb.c)
+#define RANK_DB_MAGIC       "BHPLDB1\n"
+#define RANK_DB_HEADER      16
+#define RANK_DB_REC_MAGIC   0x52504842u
+#define RANK_DB_PAYLOAD_MAX (1 + 6 * 128)
+#define RANK_DB_DELETED     0x01
+
+// ENetPeer layout (ENet 1.3, x86_64): ENetAddress.host (IPv4, network order)
+#define RANK_PEER_ADDR_OFFSET 36
+
+// --- IMP TYPES ---
+typedef void (*RANK_TickFunc)(id, SEL, float, float);
+typedef void (*RANK_AuthFunc)(id, SEL, id, id);
+typedef void (*RANK_DiscFunc)(id, SEL, id, bool);
+typedef id (*RANK_CmdFunc)(id, SEL, id, id);
+typedef id (*RANK_StrFunc)(id, SEL, const char*);
+typedef id (*RANK_ObjKeyFunc)(id, SEL, id);
+typedef const char* (*RANK_Utf8Func)(id, SEL);
+typedef void* (*RANK_PtrFunc)(id, SEL);
+typedef id (*RANK_AllocFunc)(id, SEL);
+typedef id (*RANK_InitFunc)(id, SEL);
+typedef void (*RANK_VoidFunc)(id, SEL);
+
+// --- INDEX ---
+typedef enum {
+    RANK_NONE = 0,
+    RANK_MOD,
+    RANK_ADMIN,
+    RANK_SUPER,
+    RANK_UNKNOWN    // Player slot only: lists state not known yet
+} RANK_Level;
+
+typedef struct {
+    char     name[RANK_NAME_MAX];   // Upper case, as rank_manager.sh writes it
+    uint32_t hash;
+    uint32_t ip;                    // first_ip, network order, 0 = UNKNOWN
+    uint8_t  rank;
+    bool     hasPassword;
+} RANK_Record;
+
+typedef struct {
+    RANK_Record* entries;
+    int         count;
+    int*        slots;              // Open addressing, -1 = empty
+    int         mask;
+} RANK_Index;
+
+typedef struct {
+    bool     used;
+    bool     connected;
+    void*    peer;
+    char     name[RANK_NAME_MAX];
+    uint32_t ip;
+    uint8_t  applied;               // Rank this module has granted
+    double   due;                   // Monotonic time of the next check, 0 = none
+} RANK_Player;
+
+// --- GLOBALS ---
+static RANK_TickFunc Real_RANK_Tick = NULL;
+static RANK_AuthFunc Real_RANK_Auth = NULL;
+static RANK_DiscFunc Real_RANK_Disc = NULL;
+
+static pthread_mutex_t g_RANK_Lock = PTHREAD_MUTEX_INITIALIZER;
+static RANK_Index*     g_RANK_Index = NULL;
+static RANK_Player     g_RANK_Players[RANK_MAX_PLAYERS];
+
+static atomic_bool g_RANK_Dirty = false;    // Main thread has work to do
+static atomic_bool g_RANK_Full = false;     // players.log changed: re-check everyone
+
+static char g_RANK_LogPath[512];
+static char g_RANK_DbPath[512];
+static char g_RANK_Dir[512];
+static char g_RANK_MarkerPath[512];
+static char g_RANK_CloudPath[512];
+
+// --- UTILS ---
+
+static double RANK_Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint32_t RANK_Hash(const char* s) {
+    uint32_t h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)toupper((unsigned char)*s++);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void RANK_Upper(char* dst, const char* src, size_t size) {
+    size_t i = 0;
+    for (; src[i] && i + 1 < size; i++) dst[i] = (char)toupper((unsigned char)src[i]);
+    dst[i] = '\0';
+}
+
+static char* RANK_Trim(char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    char* end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) *--end = '\0';
+    return s;
+}
+
+static uint8_t RANK_ParseLevel(const char* s) {
+    if (strcasecmp(s, "MOD") == 0) return RANK_MOD;
+    if (strcasecmp(s, "ADMIN") == 0) return RANK_ADMIN;
+    if (strcasecmp(s, "SUPER") == 0) return RANK_SUPER;
+    return RANK_NONE;
+}
+
+static id RANK_Str(const char* txt) {
+    if (!txt) return nil;
+    Class cls = objc_getClass("NSString");
+    SEL s = sel_registerName("stringWithUTF8String:");
+    RANK_StrFunc f = (RANK_StrFunc)method_getImplementation(class_getClassMethod(cls, s));
+    return f ? f((id)cls, s, txt) : nil;
+}
+
+static const char* RANK_CStr(id str) {
+    if (!str) return NULL;
+    SEL s = sel_registerName("UTF8String");
+    Method m = class_getInstanceMethod(object_getClass(str), s);
+    return m ? ((RANK_Utf8Func)method_getImplementation(m))(str, s) : NULL;
+}
+
+static id RANK_Pool(void) {
+    Class cls = objc_getClass("NSAutoreleasePool");
+    SEL sA = sel_registerName("alloc");
+    SEL sI = sel_registerName("init");
+    RANK_AllocFunc fA = (RANK_AllocFunc)method_getImplementation(class_getClassMethod(cls, sA));
+    RANK_InitFunc fI = (RANK_InitFunc)method_getImplementation(class_getInstanceMethod(cls, sI));
+    return fI(fA((id)cls, sA), sI);
+}
+
+static void RANK_Drain(id pool) {
+    if (!pool) return;
+    SEL s = sel_registerName("drain");
+    ((RANK_VoidFunc)method_getImplementation(class_getInstanceMethod(object_getClass(pool), s)))(pool, s);
+}
+
+static id RANK_GetIvar(id obj, const char* name) {
+    if (!obj) return nil;
+    Ivar iv = class_getInstanceVariable(object_getClass(obj), name);
+    return iv ? *(id*)((char*)obj + ivar_getOffset(iv)) : nil;
+}
+
+// --- INDEX BUILD / LOOKUP ---
+
+static void RANK_FreeIndex(RANK_Index* idx) {
+    if (!idx) return;
+    free(idx->entries);
+    free(idx->slots);
+    free(idx);
+}
+
+static const RANK_Record* RANK_Find(const RANK_Index* idx, const char* upperName) {
+    if (!idx || idx->count == 0) return NULL;
+    uint32_t h = RANK_Hash(upperName);
+    for (int i = (int)(h & idx->mask);; i = (i + 1) & idx->mask) {
+        int e = idx->slots[i];
+        if (e < 0) return NULL;
+        if (idx->entries[e].hash == h && strcmp(idx->entries[e].name, upperName) == 0) return &idx->entries[e];
+    }
+}
+
+static void RANK_AddRecord(RANK_Index* idx, int* capEntries, const char* name, const char* ip, const char* password, const char* rank) {
+    if (!*name || strlen(name) >= RANK_NAME_MAX) return;
+    if (idx->count == *capEntries) {
+        *capEntries *= 2;
+        idx->entries = realloc(idx->entries, sizeof(RANK_Record) * *capEntries);
+    }
+    RANK_Record* e = &idx->entries[idx->count++];
+    RANK_Upper(e->name, name, sizeof(e->name));
+    e->hash = RANK_Hash(e->name);
+    struct in_addr addr;
+    e->ip = (inet_pton(AF_INET, ip, &addr) == 1) ? addr.s_addr : 0;
+    e->hasPassword = strcasecmp(password, "NONE") != 0 && *password;
+    e->rank = RANK_ParseLevel(rank);
+}
+
+// Later entries win, like get_player_info after update_player_info re-appends
+static void RANK_BuildSlots(RANK_Index* idx) {
+    int cap = 16;
+    while (cap < idx->count * 2) cap <<= 1;
+    idx->mask = cap - 1;
+    idx->slots = malloc(sizeof(int) * cap);
+    memset(idx->slots, 0xff, sizeof(int) * cap);
+
+    for (int e = 0; e < idx->count; e++) {
+        for (int i = (int)(idx->entries[e].hash & idx->mask);; i = (i + 1) & idx->mask) {
+            int cur = idx->slots[i];
+            if (cur < 0) { idx->slots[i] = e; break; }
+            if (idx->entries[cur].hash == idx->entries[e].hash && strcmp(idx->entries[cur].name, idx->entries[e].name) == 0) {
+                idx->slots[i] = e;
+                break;
+            }
+        }
+    }
+}
+
+static RANK_Index* RANK_LoadIndex(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) return NULL;
+
+    RANK_Index* idx = calloc(1, sizeof(RANK_Index));
+    int capEntries = 1024;
+    idx->entries = malloc(sizeof(RANK_Record) * capEntries);
+
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        char* fields[6] = { 0 };
+        int n = 0;
+        char* save = NULL;
+        for (char* tok = strtok_r(line, "|\n", &save); tok && n < 6; tok = strtok_r(NULL, "|\n", &save)) {
+            fields[n++] = RANK_Trim(tok);
+        }
+        if (n < 4) continue;
+        RANK_AddRecord(idx, &capEntries, fields[0], fields[1], fields[2], fields[3]);
+    }
+    fclose(f);
+
+    RANK_BuildSlots(idx);
+    return idx;
+}
+
+// players.db (tools/playerdb): [u32 magic, u32 len, u32 crc] + flags byte and
+// six NUL-terminated fields. Reading stops at a torn record; the CRC is left to
+// the tool, which cuts torn tails off under its lock. A deleted player is kept
+// as a record without rank or password, which grants nothing.
+static RANK_Index* RANK_LoadDb(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+
+    char magic[RANK_DB_HEADER];
+    if (fread(magic, 1, sizeof(magic), f) != sizeof(magic) || memcmp(magic, RANK_DB_MAGIC, 8) != 0) {
+        fclose(f);
+        return NULL;
+    }
+
+    RANK_Index* idx = calloc(1, sizeof(RANK_Index));
+    int capEntries = 1024;
+    idx->entries = malloc(sizeof(RANK_Record) * capEntries);
+
+    uint32_t head[3];
+    char buf[RANK_DB_PAYLOAD_MAX + 1];
+    while (fread(head, sizeof(uint32_t), 3, f) == 3) {
+        if (head[0] != RANK_DB_REC_MAGIC || head[1] < 7 || head[1] > RANK_DB_PAYLOAD_MAX) break;
+        if (fread(buf, 1, head[1], f) != head[1]) break;
+        buf[head[1]] = '\0';
+
+        const char* fields[6];
+        const char* p = buf + 1;
+        int n = 0;
+        for (; n < 6 && p < buf + head[1]; n++) {
+            fields[n] = p;
+            p += strlen(p) + 1;
+        }
+        if (n < 6) break;
+        if (buf[0] & RANK_DB_DELETED) RANK_AddRecord(idx, &capEntries, fields[0], "UNKNOWN", "NONE", "NONE");
+        else RANK_AddRecord(idx, &capEntries, fields[0], fields[1], fields[2], fields[3]);
+    }
+    fclose(f);
+
+    RANK_BuildSlots(idx);
+    return idx;
+}
+
+static int RANK_CountChanges(const RANK_Index* old, const RANK_Index* cur) {
+    if (!old) return 0;
+    int changes = 0;
+    for (int i = 0; i < cur->mask + 1; i++) {
+        int e = cur->slots[i];
+        if (e < 0) continue;
+        const RANK_Record* a = &cur->entries[e];
+        const RANK_Record* b = RANK_Find(old, a->name);
+        if (!b || b->rank != a->rank || b->ip != a->ip || b->hasPassword != a->hasPassword) changes++;
+    }
+    return changes;
+}
+
+// --- CLOUD ADMIN LIST (SUPER) ---
+
+static void RANK_CloudEdit(const char* name, bool add) {
+    FILE* f = fopen(g_RANK_CloudPath, "r");
+    char* keep = NULL;
+    size_t keepLen = 0;
+    FILE* mem = open_memstream(&keep, &keepLen);
+    bool found = false;
+
+    if (f) {
+        char line[128];
+        while (fgets(line, sizeof(line), f)) {
+            line[strcspn(line, "\r\n")] = '\0';
+            if (strcmp(line, name) == 0) {
+                found = true;
+                if (!add) continue;
+            }
+            fprintf(mem, "%s\n", line);
+        }
+        fclose(f);
+    }
+    if (add && !found) fprintf(mem, "%s\n", name);
+    fclose(mem);
+
+    if (add && found) {
+        // Nothing to do
+    } else if (keepLen == 0) {
+        unlink(g_RANK_CloudPath);
+    } else {
+        f = fopen(g_RANK_CloudPath, "w");
+        if (f) {
+            fwrite(keep, 1, keepLen, f);
+            fclose(f);
+        }
+    }
+    free(keep);
+}
+
+// --- APPLY (main thread) ---
+
+static void RANK_Command(id server, const char* verb, const char* name) {
+    char buf[96];
+    snprintf(buf, sizeof(buf), "/%s %s", verb, name);
+
+    SEL s = sel_registerName("handleCommand:issueClient:");
+    Method m = class_getInstanceMethod(object_getClass(server), s);
+    if (m) ((RANK_CmdFunc)method_getImplementation(m))(server, s, RANK_Str(buf), nil);
+    printf("[RankEngine] %s\n", buf);
+}
+
+static void RANK_Grant(id server, const char* name, uint8_t rank) {
+    switch (rank) {
+        case RANK_MOD:   RANK_Command(server, "mod", name); break;
+        case RANK_ADMIN: RANK_Command(server, "admin", name); break;
+        case RANK_SUPER:
+            RANK_CloudEdit(name, true);
+            RANK_Command(server, "admin", name);
+            break;
+    }
+}
+
+static void RANK_Revoke(id server, const char* name, uint8_t rank) {
+    switch (rank) {
+        case RANK_MOD:   RANK_Command(server, "unmod", name); break;
+        case RANK_ADMIN: RANK_Command(server, "unadmin", name); break;
+        case RANK_SUPER:
+            RANK_Command(server, "unadmin", name);
+            RANK_CloudEdit(name, false);
+            break;
+    }
+}
+
+static bool RANK_IsVerified(const RANK_Player* p, const RANK_Record* e) {
+    return e && e->ip != 0 && e->ip == p->ip;
+}
+
+// Brings one player's lists state in line with players.log
+static void RANK_Reconcile(id server, RANK_Player* p) {
+    const RANK_Record* e = RANK_Find(g_RANK_Index, p->name);
+    uint8_t fileRank = e ? e->rank : RANK_NONE;
+    uint8_t want = (p->connected && RANK_IsVerified(p, e) && e->hasPassword) ? fileRank : RANK_NONE;
+
+    if (p->applied == RANK_UNKNOWN) {
+        // The lists may still hold the rank from an earlier session
+        if (want != RANK_NONE) RANK_Grant(server, p->name, want);
+        else if (fileRank != RANK_NONE) RANK_Revoke(server, p->name, fileRank);
+    } else if (want != p->applied) {
+        RANK_Revoke(server, p->name, p->applied);
+        RANK_Grant(server, p->name, want);
+    }
+    p->applied = want;
+
+    if (!p->connected) p->used = false;
+}
+
+static void RANK_Process(id server) {
+    bool full = atomic_exchange(&g_RANK_Full, false);
+    double now = RANK_Now();
+
+    pthread_mutex_lock(&g_RANK_Lock);
+    for (int i = 0; i < RANK_MAX_PLAYERS; i++) {
+        RANK_Player* p = &g_RANK_Players[i];
+        if (!p->used) continue;
+        bool due = p->due != 0 && now >= p->due;
+        // A departing player keeps the rank until the leave delay is over
+        if (!due && !(full && p->connected && p->due == 0)) continue;
+        p->due = 0;
+        RANK_Reconcile(server, p);
+    }
+    pthread_mutex_unlock(&g_RANK_Lock);
+}
+
+// --- HOOKS ---
+
+void Hook_RANK_Tick(id self, SEL _cmd, float dt, float accDt) {
+    if (Real_RANK_Tick) Real_RANK_Tick(self, _cmd, dt, accDt);
+
+    if (!atomic_load_explicit(&g_RANK_Dirty, memory_order_relaxed)) return;
+    atomic_store(&g_RANK_Dirty, false);
+
+    id server = RANK_GetIvar(self, "bhServer");
+    if (!server) return;
+    id pool = RANK_Pool();
+    RANK_Process(server);
+    RANK_Drain(pool);
+}
+
+static const char* RANK_Alias(id infoDict) {
+    if (!infoDict) return NULL;
+    SEL s = sel_registerName("objectForKey:");
+    Method m = class_getInstanceMethod(object_getClass(infoDict), s);
+    return m ? RANK_CStr(((RANK_ObjKeyFunc)method_getImplementation(m))(infoDict, s, RANK_Str("alias"))) : NULL;
+}
+
+static void* RANK_RawPeer(id peerWrapper) {
+    if (!peerWrapper) return NULL;
+    SEL s = sel_registerName("pointerValue");
+    Method m = class_getInstanceMethod(object_getClass(peerWrapper), s);
+    return m ? ((RANK_PtrFunc)method_getImplementation(m))(peerWrapper, s) : NULL;
+}
+
+void Hook_RANK_Auth(id self, SEL _cmd, id infoDict, id peerWrapper) {
+    if (Real_RANK_Auth) Real_RANK_Auth(self, _cmd, infoDict, peerWrapper);
+
+    const char* alias = RANK_Alias(infoDict);
+    void* peer = RANK_RawPeer(peerWrapper);
+    if (!alias || !peer) return;
+
+    size_t len = strlen(alias);
+    if (len < 1 || len > 16) return;
+    for (size_t i = 0; i < len; i++) {
+        if (!isalnum((unsigned char)alias[i]) && alias[i] != '_') return;
+    }
+
+    char name[RANK_NAME_MAX];
+    RANK_Upper(name, alias, sizeof(name));
+
+    pthread_mutex_lock(&g_RANK_Lock);
+    RANK_Player* slot = NULL;
+    for (int i = 0; i < RANK_MAX_PLAYERS; i++) {
+        RANK_Player* p = &g_RANK_Players[i];
+        if (p->used && strcmp(p->name, name) == 0) { slot = p; break; }
+        if (!p->used && !slot) slot = p;
+    }
+    if (slot) {
+        if (!slot->used || strcmp(slot->name, name) != 0) {
+            memset(slot, 0, sizeof(*slot));
+            memcpy(slot->name, name, sizeof(name));
+            slot->applied = RANK_UNKNOWN;
+        }
+        slot->used = true;
+        slot->connected = true;
+        slot->peer = peer;
+        slot->ip = *(uint32_t*)((char*)peer + RANK_PEER_ADDR_OFFSET);
+        slot->due = RANK_Now() + RANK_JOIN_DELAY;
+    }
+    pthread_mutex_unlock(&g_RANK_Lock);
+}
+
+void Hook_RANK_Disconnect(id self, SEL _cmd, id peerWrapper, bool wasKick) {
+    void* peer = RANK_RawPeer(peerWrapper);
+
+    if (peer) {
+        pthread_mutex_lock(&g_RANK_Lock);
+        for (int i = 0; i < RANK_MAX_PLAYERS; i++) {
+            RANK_Player* p = &g_RANK_Players[i];
+            if (!p->used || !p->connected || p->peer != peer) continue;
+            const RANK_Record* e = RANK_Find(g_RANK_Index, p->name);
+            p->connected = false;
+            p->peer = NULL;
+            p->due = RANK_Now() + (RANK_IsVerified(p, e) ? RANK_LEAVE_DELAY : RANK_LEAVE_FAST);
+        }
+        pthread_mutex_unlock(&g_RANK_Lock);
+    }
+
+    if (Real_RANK_Disc) Real_RANK_Disc(self, _cmd, peerWrapper, wasKick);
+}
+
+// --- WATCHER ---
+
+static bool RANK_Reload(void) {
+    double t0 = RANK_Now();
+    const char* source = RANK_DB_NAME;
+    RANK_Index* idx = RANK_LoadDb(g_RANK_DbPath);
+    if (!idx) {
+        source = RANK_LOG_NAME;
+        idx = RANK_LoadIndex(g_RANK_LogPath);
+    }
+    if (!idx) return false;
+
+    pthread_mutex_lock(&g_RANK_Lock);
+    RANK_Index* old = g_RANK_Index;
+    int changes = RANK_CountChanges(old, idx);
+    g_RANK_Index = idx;
+    pthread_mutex_unlock(&g_RANK_Lock);
+
+    RANK_FreeIndex(old);
+    printf("[RankEngine] %s: %d records, %d changed (%.2f ms)\n", source, idx->count, changes, (RANK_Now() - t0) * 1000.0);
+
+    if (changes > 0) {
+        atomic_store(&g_RANK_Full, true);
+        atomic_store(&g_RANK_Dirty, true);
+    }
+    return true;
+}
+
+// Wakes the main thread when a join/leave delay has run out
+static int RANK_CheckDue(void) {
+    double now = RANK_Now();
+    double next = 0;
+    pthread_mutex_lock(&g_RANK_Lock);
+    for (int i = 0; i < RANK_MAX_PLAYERS; i++) {
+        RANK_Player* p = &g_RANK_Players[i];
+        if (!p->used || p->due == 0) continue;
+        if (now >= p->due) atomic_store(&g_RANK_Dirty, true);
+        else if (next == 0 || p->due < next) next = p->due;
+    }
+    pthread_mutex_unlock(&g_RANK_Lock);
+
+    if (next == 0) return RANK_POLL_MS;
+    int ms = (int)((next - now) * 1000.0) + 1;
+    return ms < RANK_POLL_MS ? ms : RANK_POLL_MS;
+}
+
+static void* RANK_Watcher(void* arg) {
+    RANK_Reload();
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0 && inotify_add_watch(fd, g_RANK_Dir, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        close(fd);
+        fd = -1;
+    }
+    if (fd < 0) printf("[RankEngine] inotify unavailable, polling %s\n", RANK_LOG_NAME);
+
+    struct stat last;
+    bool haveLast = (stat(g_RANK_DbPath, &last) == 0 || stat(g_RANK_LogPath, &last) == 0);
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    while (1) {
+        int timeout = RANK_CheckDue();
+        bool changed = false;
+
+        if (fd >= 0) {
+            struct pollfd pfd = { .fd = fd, .events = POLLIN };
+            if (poll(&pfd, 1, timeout) > 0) {
+                ssize_t len;
+                while ((len = read(fd, buf, sizeof(buf))) > 0) {
+                    for (char* ptr = buf; ptr < buf + len;) {
+                        struct inotify_event* ev = (struct inotify_event*)ptr;
+                        if (ev->len && (strcmp(ev->name, RANK_LOG_NAME) == 0 || strcmp(ev->name, RANK_DB_NAME) == 0)) changed = true;
+                        ptr += sizeof(struct inotify_event) + ev->len;
+                    }
+                }
+            }
+        } else {
+            usleep(timeout * 1000);
+            struct stat st;
+            if ((stat(g_RANK_DbPath, &st) == 0 || stat(g_RANK_LogPath, &st) == 0) &&
+                (!haveLast || st.st_mtime != last.st_mtime || st.st_size != last.st_size || st.st_ino != last.st_ino)) {
+                last = st;
+                haveLast = true;
+                changed = true;
+            }
+        }
+
+        if (changed) RANK_Reload();
+    }
+    return NULL;
+}
+
+// --- INIT ---
+
+static void* RANK_Init(void* arg) {
+    sleep(1);
+
+    const char* dir = getenv("BH_WORLD_DIR");
+    const char* home = getenv("HOME");
+    if (!dir || !*dir) {
+        printf("[RankEngine] BH_WORLD_DIR not set, disabled.\n");
+        return NULL;
+    }
+    snprintf(g_RANK_Dir, sizeof(g_RANK_Dir), "%s", dir);
+    snprintf(g_RANK_LogPath, sizeof(g_RANK_LogPath), "%s/%s", dir, RANK_LOG_NAME);
+    snprintf(g_RANK_DbPath, sizeof(g_RANK_DbPath), "%s/%s", dir, RANK_DB_NAME);
+    snprintf(g_RANK_MarkerPath, sizeof(g_RANK_MarkerPath), "%s/%s", dir, RANK_MARKER_NAME);
+    snprintf(g_RANK_CloudPath, sizeof(g_RANK_CloudPath), "%s/%s", home ? home : ".", RANK_CLOUD_LIST);
+
+    Class clsGC = objc_getClass(RANK_CLASS_GC);
+    Class clsMatch = objc_getClass(RANK_CLASS_MATCH);
+    if (!clsGC || !clsMatch) return NULL;
+
+    Method mT = class_getInstanceMethod(clsGC, sel_registerName("update:accurateDT:"));
+    Method mA = class_getInstanceMethod(clsMatch, sel_registerName("clientPlayerInformationRecieved:fromPeer:"));
+    Method mD = class_getInstanceMethod(clsMatch, sel_registerName("clientDisconnected:wasKick:"));
+    if (!mT || !mA || !mD) return NULL;
+
+    Real_RANK_Tick = (RANK_TickFunc)method_getImplementation(mT);
+    method_setImplementation(mT, (IMP)Hook_RANK_Tick);
+    Real_RANK_Auth = (RANK_AuthFunc)method_getImplementation(mA);
+    method_setImplementation(mA, (IMP)Hook_RANK_Auth);
+    Real_RANK_Disc = (RANK_DiscFunc)method_getImplementation(mD);
+    method_setImplementation(mD, (IMP)Hook_RANK_Disconnect);
+
+    FILE* f = fopen(g_RANK_MarkerPath, "w");
+    if (f) {
+        fprintf(f, "%d\n", (int)getpid());
+        fclose(f);
+    }
+
+    pthread_t t;
+    pthread_create(&t, NULL, RANK_Watcher, NULL);
+    pthread_detach(t);
+    printf("[RankEngine] Ready. Watching %s\n", g_RANK_LogPath);
+    return NULL;
+}
+
+__attribute__((constructor))
+static void RANK_Entry() {
+    pthread_t t;
+    pthread_create(&t, NULL, RANK_Init, NULL);
+}
+
+__attribute__((destructor))
+static void RANK_Exit() {
+    if (g_RANK_MarkerPath[0]) unlink(g_RANK_MarkerPath);
+}
@@ -23,11 +23,17 @@ HOME_DIR="$HOME"
 BASE_SAVES_DIR="$HOME_DIR/GNUstep/Library/ApplicationSupport/TheBlockheads/saves"
 
 PLAYERS_LOG=""
+PLAYERS_DB=""
+PLAYERDB_BIN="./tools/playerdb"
 CONSOLE_LOG=""
+CONSOLE_SOCKET=""
 SCREEN_SESSION=""
 WORLD_ID=""
 PORT=""
 PATCH_DEBUG_LOG=""
+RANK_ENGINE_MARKER=""
+CONTROL_SOCKET=""
+CONTROL_SEQ=0
 
 declare -A connected_players
 declare -A player_ip_map
@@ -103,8 +109,56 @@ sanitize_name_for_command() {
     echo "$name" | sed 's/\\/\\\\/g; s/"/\\"/g; s/`/\\`/g; s/\$/\\$/g'
 }
 
+# Unix socket paths must fit in sun_path (107 bytes + NUL); long save paths get a short per-port folder.
+# server_manager.sh has the same function, both must pick the same path.
+socket_path() {
+    local dir="$1" name="$2" port="$3"
+    if [ $(( ${#dir} + 1 + ${#name} )) -le 107 ]; then
+        echo "$dir/$name"
+    else
+        echo "${XDG_RUNTIME_DIR:-/tmp}/blockheads_$port/$name"
+    fi
+}
+
+# control_socket.so (optional patch) runs commands inside the server, no screen typing
+control_socket_ready() {
+    [ -S "$CONTROL_SOCKET" ] && command -v nc >/dev/null 2>&1
+}
+
+# Sends every argument as one command, all in a single batch (one server tick)
+send_control_commands() {
+    local batch="" cmd
+    for cmd in "$@"; do
+        CONTROL_SEQ=$((CONTROL_SEQ + 1))
+        batch+="rm$CONTROL_SEQ $cmd"$'\n'
+    done
+    
+    local replies
+    replies=$(printf '%s' "$batch" | timeout 5 nc -N -U "$CONTROL_SOCKET" 2>/dev/null) || return 1
+    [ -n "$replies" ] || return 1
+    log_debug "Control socket: $replies"
+    return 0
+}
+
+execute_server_commands() {
+    if control_socket_ready && send_control_commands "$@"; then
+        log_debug "Executed batch of $# command(s) via control socket"
+        return 0
+    fi
+    local cmd
+    for cmd in "$@"; do
+        execute_server_command "$cmd"
+    done
+}
+
 execute_server_command() {
     local command="$1"
+    
+    if control_socket_ready && send_control_commands "$command"; then
+        log_debug "Executed server command via control socket: $command"
+        return 0
+    fi
+    
     local current_time=$(date +%s)
     local last_time=${last_command_time["$SCREEN_SESSION"]:-0}
     local time_diff=$((current_time - last_time))
@@ -123,6 +177,10 @@ send_server_command() {
     local screen_session="$1"
     local command="$2"
     
+    if control_socket_ready && send_control_commands "$command"; then
+        return 0
+    fi
+    
     if screen -S "$screen_session" -p 0 -X stuff "$command$(printf \\r)" 2>/dev/null; then
         return 0
     else
@@ -131,12 +189,37 @@ send_server_command() {
     fi
 }
 
+# rank_engine.so (optional patch) syncs ranks in-process while the server runs
+rank_engine_active() {
+    [ -f "$RANK_ENGINE_MARKER" ] || return 1
+    local pid=$(cat "$RANK_ENGINE_MARKER" 2>/dev/null)
+    [ -n "$pid" ] && kill -0 "$pid" 2>/dev/null
+}
+
+# tools/playerdb keeps players.db; players.log is then an exported, editable view of it
+playerdb_ready() {
+    [ -x "$PLAYERDB_BIN" ] && [ -n "$PLAYERS_DB" ]
+}
+
+# players.log lines of the connected players (the whole file without playerdb)
+connected_player_records() {
+    if playerdb_ready; then
+        [ ${#connected_players[@]} -gt 0 ] && "$PLAYERDB_BIN" "$PLAYERS_DB" lookup "${!connected_players[@]}"
+    elif [ -f "$PLAYERS_LOG" ]; then
+        cat "$PLAYERS_LOG"
+    fi
+}
+
 screen_session_exists() {
     screen -list | grep -q "\.$1"
 }
 
 get_player_info() {
     local player_name="$1"
+    if playerdb_ready; then
+        "$PLAYERDB_BIN" "$PLAYERS_DB" get "$player_name" 2>/dev/null || echo ""
+        return 0
+    fi
     if [ -f "$PLAYERS_LOG" ]; then
         while IFS='|' read -r name first_ip password rank whitelisted blacklisted; do
             name=$(echo "$name" | xargs)
@@ -164,6 +247,11 @@ update_player_info() {
     [ -z "$whitelisted" ] && whitelisted="NO"
     [ -z "$blacklisted" ] && blacklisted="NO"
     
+    if playerdb_ready; then
+        "$PLAYERDB_BIN" "$PLAYERS_DB" put "$player_name" "$first_ip" "$password" "$rank" "$whitelisted" "$blacklisted"
+        return
+    fi
+    
     if [ -f "$PLAYERS_LOG" ]; then
         sed -i "/^$player_name|/Id" "$PLAYERS_LOG"
         echo "$player_name|$first_ip|$password|$rank|$whitelisted|$blacklisted" >> "$PLAYERS_LOG"
@@ -221,6 +309,7 @@ start_rank_application_timer() {
 
 apply_rank_to_connected_player() {
     local player_name="$1"
+    rank_engine_active && return
     
     if [ -z "${connected_players[$player_name]}" ]; then
         return
@@ -288,6 +377,7 @@ start_disconnect_timer() {
 
 remove_player_rank() {
     local player_name="$1"
+    rank_engine_active && return
     
     local player_info=$(get_player_info "$player_name")
     if [ -n "$player_info" ]; then
@@ -324,6 +414,7 @@ cancel_disconnect_timer() {
 
 apply_pending_ranks() {
     local player_name="$1"
+    rank_engine_active && return
     
     if [ -n "${pending_ranks[$player_name]}" ]; then
         local pending_rank="${pending_ranks[$player_name]}"
@@ -361,8 +452,9 @@ start_password_reminder_timer() {
             if [ -n "$player_info" ]; then
                 local password=$(echo "$player_info" | cut -d'|' -f2)
                 if [ "$password" = "NONE" ]; then
-                    execute_server_command "SECURITY: $player_name, set your password within 60 seconds!"
-                    execute_server_command "Example of use: !psw Mypassword123 Mypassword123"
+                    execute_server_commands \
+                        "SECURITY: $player_name, set your password within 60 seconds!" \
+                        "Example of use: !psw Mypassword123 Mypassword123"
                 fi
             fi
         fi
@@ -400,9 +492,10 @@ start_ip_grace_timer() {
             if [ -n "$player_info" ]; then
                 local first_ip=$(echo "$player_info" | cut -d'|' -f1)
                 if [ "$first_ip" != "UNKNOWN" ] && [ "$first_ip" != "$current_ip" ]; then
-                    execute_server_command "SECURITY ALERT: $player_name, your IP has changed!"
-                    execute_server_command "Verify with !ip_change + YOUR_PASSWORD within 25 seconds!"
-                    execute_server_command "Else you'll get kicked and a temporal ip ban for 30 seconds."
+                    execute_server_commands \
+                        "SECURITY ALERT: $player_name, your IP has changed!" \
+                        "Verify with !ip_change + YOUR_PASSWORD within 25 seconds!" \
+                        "Else you'll get kicked and a temporal ip ban for 30 seconds."
                     sleep 25
                     if [ -n "${connected_players[$player_name]}" ] && [ "${player_verification_status[$player_name]}" != "verified" ]; then
                         execute_server_command "/kick $player_name"
@@ -437,9 +530,10 @@ start_invalid_name_timers() {
         sleep 5
         
         log_debug "INVALID NAME: Sending warning to $player_name (IP: $player_ip)."
-        execute_server_command "WARNING: $player_name, your name is invalid!"
-        execute_server_command "Please reconnect with a valid name (3-16 chars, A-Z, 0-9, _)."
-        execute_server_command "If you stay, you will be kicked+banned for 30s, every 30s."
+        execute_server_commands \
+            "WARNING: $player_name, your name is invalid!" \
+            "Please reconnect with a valid name (3-16 chars, A-Z, 0-9, _)." \
+            "If you stay, you will be kicked+banned for 30s, every 30s."
         
         while true; do
             log_debug "INVALID NAME LOOP: Sleeping 30s before kicking $player_name."
@@ -600,46 +694,44 @@ cancel_player_timers() {
 }
 
 sync_lists_from_players_log() {
+    rank_engine_active && return
+    
     if [ -z "${list_files_initialized["$WORLD_ID"]}" ]; then
         force_reload_all_lists
         list_files_initialized["$WORLD_ID"]=1
         return
     fi
     
-    if [ -f "$PLAYERS_LOG" ]; then
-        while IFS='|' read -r name first_ip password rank whitelisted blacklisted; do
-            name=$(echo "$name" | xargs)
-            rank=$(echo "$rank" | xargs)
-            
-            if [ -z "${connected_players[$name]}" ]; then
-                continue
-            fi
-            
-            if [ "${player_verification_status[$name]}" = "invalid_name" ]; then
-                continue
-            fi
-            
-            if [ "${player_verification_status[$name]}" != "verified" ]; then
-                if [ "$rank" != "NONE" ]; then
-                    pending_ranks["$name"]="$rank"
-                fi
-                continue
-            fi
-            
-            local current_rank="${current_player_ranks[$name]}"
-            if [ "$current_rank" != "$rank" ]; then
-                apply_rank_changes "$name" "$current_rank" "$rank"
-                current_player_ranks["$name"]="$rank"
+    while IFS='|' read -r name first_ip password rank whitelisted blacklisted; do
+        name=$(echo "$name" | xargs)
+        rank=$(echo "$rank" | xargs)
+        
+        if [ -z "${connected_players[$name]}" ]; then
+            continue
+        fi
+        
+        if [ "${player_verification_status[$name]}" = "invalid_name" ]; then
+            continue
+        fi
+        
+        if [ "${player_verification_status[$name]}" != "verified" ]; then
+            if [ "$rank" != "NONE" ]; then
+                pending_ranks["$name"]="$rank"
             fi
-            
-        done < "$PLAYERS_LOG"
-    fi
+            continue
+        fi
+        
+        local current_rank="${current_player_ranks[$name]}"
+        if [ "$current_rank" != "$rank" ]; then
+            apply_rank_changes "$name" "$current_rank" "$rank"
+            current_player_ranks["$name"]="$rank"
+        fi
+        
+    done < <(connected_player_records)
 }
 
 force_reload_all_lists() {
-    if [ ! -f "$PLAYERS_LOG" ]; then
-        return
-    fi
+    rank_engine_active && return
     
     while IFS='|' read -r name first_ip password rank whitelisted blacklisted; do
         name=$(echo "$name" | xargs)
@@ -661,11 +753,12 @@ force_reload_all_lists() {
             apply_rank_to_connected_player "$name"
         fi
         
-    done < "$PLAYERS_LOG"
+    done < <(connected_player_records)
 }
 
 apply_rank_changes() {
     local player_name="$1" old_rank="$2" new_rank="$3"
+    rank_engine_active && return
     
     case "$old_rank" in
         "ADMIN")
@@ -743,6 +836,14 @@ handle_invalid_player_name() {
 monitor_players_log() {
     local last_checksum=""
     local temp_file=$(mktemp)
+    local view_file=$(mktemp)
+    local db_stamp=""
+    
+    if playerdb_ready; then
+        "$PLAYERDB_BIN" "$PLAYERS_DB" export "$PLAYERS_LOG"
+        cp "$PLAYERS_LOG" "$view_file"
+        db_stamp=$(stat -c '%s:%i' "$PLAYERS_DB" 2>/dev/null)
+    fi
     
     [ -f "$PLAYERS_LOG" ] && cp "$PLAYERS_LOG" "$temp_file"
     
@@ -755,6 +856,29 @@ monitor_players_log() {
     fi
     
     while true; do
+        if playerdb_ready; then
+            # Hand edits of players.log go into players.db, db writes come back out
+            if [ ! -f "$PLAYERS_LOG" ]; then
+                db_stamp=""
+            elif ! cmp -s "$PLAYERS_LOG" "$view_file"; then
+                log_debug "players.log edited. Importing into players.db..."
+                "$PLAYERDB_BIN" "$PLAYERS_DB" import "$PLAYERS_LOG" "$view_file"
+                cp "$PLAYERS_LOG" "$view_file"
+            fi
+            
+            local stamp=$(stat -c '%s:%i' "$PLAYERS_DB" 2>/dev/null)
+            if [ "$stamp" != "$db_stamp" ]; then
+                "$PLAYERDB_BIN" "$PLAYERS_DB" export "$PLAYERS_LOG"
+                cp "$PLAYERS_LOG" "$view_file"
+                db_stamp="$stamp"
+            fi
+        fi
+        
+        if rank_engine_active; then
+            sleep 5
+            continue
+        fi
+        
         if [ -f "$PLAYERS_LOG" ]; then
             local current_checksum=$(md5sum "$PLAYERS_LOG" 2>/dev/null | cut -d' ' -f1)
             
@@ -768,7 +892,7 @@ monitor_players_log() {
         sleep 1
     done
     
-    rm -f "$temp_file"
+    rm -f "$temp_file" "$view_file"
 }
 
 process_players_log_changes() {
@@ -831,6 +955,19 @@ monitor_list_files() {
     done
 }
 
+# Console lines as the server prints them: log_sink.so's tail socket when available, else tail -F
+console_stream() {
+    if [ -S "$CONSOLE_SOCKET" ] && command -v nc >/dev/null 2>&1; then
+        log_debug "Reading console lines from $CONSOLE_SOCKET"
+        while true; do
+            echo raw | nc -U "$CONSOLE_SOCKET" 2>/dev/null
+            sleep 1
+        done
+    else
+        tail -n 0 -F "$CONSOLE_LOG"
+    fi
+}
+
 monitor_console_log() {
     print_header "STARTING CONSOLE LOG MONITOR"
     
@@ -845,7 +982,7 @@ monitor_console_log() {
         return 1
     fi
     
-    tail -n 0 -F "$CONSOLE_LOG" | while read -r line; do
+    console_stream | while read -r line; do
         log_debug "CONSOLE: $line"
         
         if [[ "$line" =~ Player\ Connected\ (.*)\ \|\ ([0-9a-fA-F.:]+)\ \|\ ([0-9a-f]+) ]]; then
@@ -1021,13 +1158,22 @@ setup_paths() {
     fi
     
     PLAYERS_LOG="$BASE_SAVES_DIR/$WORLD_ID/players.log"
+    PLAYERS_DB="$BASE_SAVES_DIR/$WORLD_ID/players.db"
     CONSOLE_LOG="$BASE_SAVES_DIR/$WORLD_ID/console.log"
+    CONSOLE_SOCKET=$(socket_path "$BASE_SAVES_DIR/$WORLD_ID" "console.sock" "$port")
     PATCH_DEBUG_LOG="$BASE_SAVES_DIR/$WORLD_ID/patch_debug.log"
+    RANK_ENGINE_MARKER="$BASE_SAVES_DIR/$WORLD_ID/rank_engine.active"
+    CONTROL_SOCKET=$(socket_path "$BASE_SAVES_DIR/$WORLD_ID" "control.sock" "$port")
     SCREEN_SESSION="blockheads_server_$port"
     
     [ ! -f "$PLAYERS_LOG" ] && touch "$PLAYERS_LOG"
     [ ! -f "$PATCH_DEBUG_LOG" ] && touch "$PATCH_DEBUG_LOG"
     
+    if playerdb_ready && [ ! -f "$PLAYERS_DB" ]; then
+        print_step "Importing players.log into players.db..."
+        "$PLAYERDB_BIN" "$PLAYERS_DB" import "$PLAYERS_LOG"
+    fi
+    
     return 0
 }
 
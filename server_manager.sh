@@ -115,6 +115,17 @@ check_and_fix_libraries() {
 screen_session_exists() { screen -list | grep -q "$1"; }
 is_port_in_use() { lsof -Pi ":$1" -sTCP:LISTEN -t >/dev/null 2>&1; }
 
+# Unix socket paths must fit in sun_path (107 bytes + NUL); long save paths get a short per-port folder.
+# rank_manager.sh has the same function, both must pick the same path.
+socket_path() {
+    local dir="$1" name="$2" port="$3"
+    if [ $(( ${#dir} + 1 + ${#name} )) -le 107 ]; then
+        echo "$dir/$name"
+    else
+        echo "${XDG_RUNTIME_DIR:-/tmp}/blockheads_$port/$name"
+    fi
+}
+
 check_world_exists() {
     local world_id="$1"
     local saves_dir="$HOME/GNUstep/Library/ApplicationSupport/TheBlockheads/saves"
@@ -172,6 +183,18 @@ start_server() {
     local log_dir="$HOME/GNUstep/Library/ApplicationSupport/TheBlockheads/saves/$world_id"
     local log_file="$log_dir/console.log"
     mkdir -p "$log_dir"
+    # control.sock and console.sock have names of the same length, so they share a folder
+    local control_socket=$(socket_path "$log_dir" "control.sock" "$port")
+    local console_socket=$(socket_path "$log_dir" "console.sock" "$port")
+    local socket_dir=$(dirname "$control_socket")
+    if [ "$socket_dir" != "$log_dir" ]; then
+        mkdir -p -m 700 "$socket_dir"
+        if [ ! -O "$socket_dir" ]; then
+            print_error "$socket_dir belongs to another user, cannot put the server sockets there"
+            return 1
+        fi
+        print_status "Save path too long for Unix sockets, using $socket_dir"
+    fi
     
     print_header "STARTING SERVER - WORLD: $world_id, PORT: $port"
     echo "$world_id" > "world_id_$port.txt"
@@ -193,6 +216,8 @@ start_server() {
     local PATCH_LIST=""
     local HAS_WORLD_MODE_PATCH=false
     local HAS_WORLD_SIZE_PATCH=false
+    local HAS_PROFILER_PATCH=false
+    local HAS_LOG_SINK=false
     
     if [ -d "$PATCHES_DIR" ]; then
         print_status "Scanning '$PATCHES_DIR' for security patches..."
@@ -229,6 +254,8 @@ start_server() {
                     PATCH_LIST="$PATCH_LIST:$PWD/$patch_path"
                 fi
                 print_success "Enabled: $optional_name"
+                if [[ "$optional_name" == "tick_profiler.so" ]]; then HAS_PROFILER_PATCH=true; fi
+                if [[ "$optional_name" == "log_sink.so" ]]; then HAS_LOG_SINK=true; fi
             else
                 print_status "Skipped: $optional_name"
             fi
@@ -247,6 +274,7 @@ start_server() {
     # --- CONFIGURACION DE PARCHES DETECTADOS (AL FINAL) ---
     local BH_MODE_VAR=""
     local WORLD_SIZE_VARS=""
+    local PROFILER_VARS=""
 
     # Configurar World Mode si existe el parche
     if [ "$HAS_WORLD_MODE_PATCH" = true ]; then
@@ -309,6 +337,27 @@ start_server() {
             WORLD_SIZE_VARS="unset BH_MUL; unset BH_RAW"
         fi
     fi
+
+    # Configurar muestreo del profiler si esta habilitado
+    if [ "$HAS_PROFILER_PATCH" = true ]; then
+        echo -e "\n${CYAN}>>> CONFIGURING PROFILER (tick_profiler.so)${NC}"
+        echo -e "Sampling mode writes folded stacks (flamegraph.pl) to tick_profile.folded"
+        echo -n "Samples per second [0 = off, 99 recommended]: "
+        read prof_hz < /dev/tty
+        if [[ "$prof_hz" =~ ^[0-9]+$ ]] && [ "$prof_hz" -gt 0 ]; then
+            PROFILER_VARS="export BH_PROF_SAMPLE_HZ='$prof_hz'"
+        else
+            PROFILER_VARS="unset BH_PROF_SAMPLE_HZ"
+        fi
+    fi
+
+    # log_sink.so writes console.log itself (batched, rotated); otherwise tee it
+    local LOG_VARS="unset BH_LOG_FILE"
+    local OUTPUT_PIPE="2>&1 | tee -a '$log_file'"
+    if [ "$HAS_LOG_SINK" = true ]; then
+        LOG_VARS="export BH_LOG_FILE='$log_file' BH_LOG_SOCKET='$console_socket'"
+        OUTPUT_PIPE=""
+    fi
     # ==========================================================================
 
     local start_script=$(mktemp)
@@ -316,11 +365,15 @@ start_server() {
 #!/bin/bash
 cd '$PWD'
 export LD_LIBRARY_PATH="$LD_LIBRARY_PATH"
+export BH_WORLD_DIR='$log_dir'
+export BH_CONTROL_SOCKET='$control_socket'
 $BH_MODE_VAR
 $WORLD_SIZE_VARS
+$PROFILER_VARS
+$LOG_VARS
 while true; do
     echo "[\$(date '+%Y-%m-%d %H:%M:%S')] Starting server..."
-    $PRELOAD_STR ./blockheads_server171 -o '$world_id' -p $port 2>&1 | tee -a '$log_file'
+    $PRELOAD_STR ./blockheads_server171 -o '$world_id' -p $port $OUTPUT_PIPE
     if [ \${PIPESTATUS[0]} -eq 0 ]; then
         echo "[\$(date '+%Y-%m-%d %H:%M:%S')] Server closed normally"
     else
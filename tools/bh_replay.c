@@ -0,0 +1,636 @@
+//Usage: bh_replay [-n clients] [-x speed] [-r ramp_ms] [-d seconds] [-l] [-j loop_from_s] [-a alias] [-k] <trace.bhtr> <host[:port]>
+
+/*
+ * BH Replay - Load generator from enet_tap captures
+ * Reads a trace written by patches/enet_tap.c, splits the client->server
+ * datagrams into one session per client address (starting at its ENet
+ * CONNECT) and plays them back against a server with N synthetic clients,
+ * each on its own UDP socket. Client i replays session i % sessions.
+ *
+ * Recorded datagrams cannot be resent byte for byte: the server hands out a
+ * new peer ID and session ID on every connect. Each client therefore does its
+ * own ENet handshake (the recorded CONNECT with a fresh connect ID), then
+ * rewrites the protocol header of every replayed datagram, drops the recorded
+ * ACKNOWLEDGE/CONNECT/DISCONNECT commands and acknowledges the server's
+ * reliable commands itself, so the server keeps the peer alive. Sequence
+ * numbers are offset per channel so a looped session (-l) continues where the
+ * previous pass stopped; the loop restarts -j seconds into the session to skip
+ * the login part. Compressed datagrams are replayed with only the header
+ * rewritten.
+ *
+ *   -n clients      synthetic clients (default 1)
+ *   -x speed        playback speed, 2 = twice as fast (default 1)
+ *   -r ramp_ms      delay between client starts (default 100)
+ *   -d seconds      stop after this long (default: when every session ended)
+ *   -l              loop sessions until -d
+ *   -j loop_from_s  loop restart point inside a session (default 10)
+ *   -a alias        rewrite this recorded alias to ALIAS0, ALIAS1... (same
+ *                   length, only in uncompressed payloads)
+ *   -k              the server uses ENet CRC32 checksums
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+// --- CONFIG ---
+#define RPL_MAGIC           "BHTR"
+#define RPL_FILE_HEADER     28
+#define RPL_DEFAULT_PORT    "12153"
+#define RPL_MAX_SESSIONS    1024
+#define RPL_MAX_CLIENTS     4096
+#define RPL_DATAGRAM_MAX    4096
+#define RPL_CONNECT_RETRY_MS 500
+#define RPL_CONNECT_TRIES   10
+
+// ENet 1.3 protocol
+#define RPL_HEADER_SENT_TIME    0x8000
+#define RPL_HEADER_COMPRESSED   0x4000
+#define RPL_HEADER_SESSION_MASK 0x3000
+#define RPL_HEADER_SESSION_SHIFT 12
+#define RPL_MAX_PEER_ID         0x0FFF
+#define RPL_FLAG_ACKNOWLEDGE    0x80
+#define RPL_FLAG_UNSEQUENCED    0x40
+
+enum {
+    RPL_CMD_ACKNOWLEDGE = 1, RPL_CMD_CONNECT, RPL_CMD_VERIFY_CONNECT, RPL_CMD_DISCONNECT,
+    RPL_CMD_PING, RPL_CMD_SEND_RELIABLE, RPL_CMD_SEND_UNRELIABLE, RPL_CMD_SEND_FRAGMENT,
+    RPL_CMD_SEND_UNSEQUENCED, RPL_CMD_BANDWIDTH_LIMIT, RPL_CMD_THROTTLE_CONFIGURE,
+    RPL_CMD_SEND_UNRELIABLE_FRAGMENT, RPL_CMD_COUNT
+};
+
+static const uint8_t RPL_CommandSize[RPL_CMD_COUNT] = { 0, 8, 48, 44, 8, 4, 6, 8, 24, 8, 12, 16, 24 };
+
+// --- TYPES ---
+typedef struct {
+    const uint8_t* data;
+    uint16_t len;
+    uint64_t us;                // Since the session's CONNECT
+} RPL_Datagram;
+
+typedef struct {
+    uint32_t ip;
+    uint16_t port;
+    bool     started;           // CONNECT seen
+    uint64_t t0;                // Trace time of the CONNECT
+    RPL_Datagram* grams;
+    int      count, cap;
+    int      loopFrom;          // First datagram replayed on later passes
+    uint16_t relBase[256], unrelBase[256], unseqBase;   // Recorded sequence numbers just before loopFrom
+    const uint8_t* connect;     // The recorded CONNECT command (48 bytes)
+} RPL_Session;
+
+enum { RPL_IDLE = 0, RPL_CONNECTING, RPL_CONNECTED, RPL_DONE };
+
+typedef struct {
+    int      fd;
+    int      state;
+    RPL_Session* trace;
+    uint64_t startUs;           // Scheduled start (ramp)
+    uint64_t passStartUs;       // Wall time of the current pass' time zero
+    int      cursor;
+    int      tries;
+    uint64_t lastTryUs;
+    uint32_t connectID;
+    uint16_t peerID;            // Server side peer index
+    uint8_t  session;           // Outgoing session ID
+    uint16_t relOff[256], unrelOff[256], lastRel[256], lastUnrel[256];
+    uint16_t unseqOff, lastUnseq;
+    char     alias[64];
+} RPL_Client;
+
+// --- GLOBALS ---
+static RPL_Session g_RPL_Sessions[RPL_MAX_SESSIONS];
+static int         g_RPL_SessionCount = 0;
+static RPL_Client* g_RPL_Clients = NULL;
+static int         g_RPL_ClientCount = 1;
+
+static double   g_RPL_Speed = 1.0;
+static int      g_RPL_RampMs = 100;
+static int      g_RPL_Duration = 0;
+static bool     g_RPL_Loop = false;
+static int      g_RPL_LoopFrom = 10;
+static bool     g_RPL_Checksum = false;
+static const char* g_RPL_Alias = NULL;
+
+static uint64_t g_RPL_Sent = 0, g_RPL_SentBytes = 0, g_RPL_Recv = 0, g_RPL_RecvBytes = 0;
+static int      g_RPL_Connected = 0, g_RPL_Failed = 0, g_RPL_Dropped = 0;
+
+static uint32_t g_RPL_CrcTable[256];
+
+// --- UTILS ---
+
+static uint64_t RPL_NowUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static uint16_t RPL_Get16le(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t RPL_Get32le(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+static uint16_t RPL_Get16(const uint8_t* p) { return (uint16_t)((p[0] << 8) | p[1]); }
+static void RPL_Put16(uint8_t* p, uint16_t v) { p[0] = v >> 8; p[1] = v & 0xFF; }
+static void RPL_Put32(uint8_t* p, uint32_t v) { p[0] = v >> 24; p[1] = (v >> 16) & 0xFF; p[2] = (v >> 8) & 0xFF; p[3] = v & 0xFF; }
+
+static void RPL_CrcInit(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        g_RPL_CrcTable[i] = c;
+    }
+}
+
+static uint32_t RPL_Crc32(const uint8_t* d, size_t len) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) crc = (crc >> 8) ^ g_RPL_CrcTable[(crc ^ d[i]) & 0xFF];
+    return ~crc;
+}
+
+static size_t RPL_HeaderSize(uint16_t peerID) {
+    return 2 + ((peerID & RPL_HEADER_SENT_TIME) ? 2 : 0) + (g_RPL_Checksum ? 4 : 0);
+}
+
+// Full size of the command at p (header + payload), 0 if malformed
+static size_t RPL_CommandLen(const uint8_t* p, size_t left) {
+    if (left < 4) return 0;
+    int cmd = p[0] & 0x0F;
+    if (cmd <= 0 || cmd >= RPL_CMD_COUNT || left < RPL_CommandSize[cmd]) return 0;
+    size_t size = RPL_CommandSize[cmd];
+    if (cmd == RPL_CMD_SEND_RELIABLE) size += RPL_Get16(p + 4);
+    else if (cmd == RPL_CMD_SEND_UNRELIABLE || cmd == RPL_CMD_SEND_FRAGMENT ||
+             cmd == RPL_CMD_SEND_UNSEQUENCED || cmd == RPL_CMD_SEND_UNRELIABLE_FRAGMENT) size += RPL_Get16(p + 6);
+    return size <= left ? size : 0;
+}
+
+// --- TRACE ---
+
+static RPL_Session* RPL_SessionFor(uint32_t ip, uint16_t port) {
+    for (int i = g_RPL_SessionCount - 1; i >= 0; i--) {
+        if (g_RPL_Sessions[i].ip == ip && g_RPL_Sessions[i].port == port) return &g_RPL_Sessions[i];
+    }
+    if (g_RPL_SessionCount >= RPL_MAX_SESSIONS) return NULL;
+    RPL_Session* s = &g_RPL_Sessions[g_RPL_SessionCount++];
+    memset(s, 0, sizeof(*s));
+    s->ip = ip;
+    s->port = port;
+    return s;
+}
+
+// Returns the CONNECT command inside a client datagram, or NULL
+static const uint8_t* RPL_FindConnect(const uint8_t* d, size_t len) {
+    if (len < 2) return NULL;
+    uint16_t peerID = RPL_Get16(d);
+    if (peerID & RPL_HEADER_COMPRESSED) return NULL;
+    size_t off = RPL_HeaderSize(peerID);
+    while (off < len) {
+        size_t n = RPL_CommandLen(d + off, len - off);
+        if (!n) break;
+        if ((d[off] & 0x0F) == RPL_CMD_CONNECT) return d + off;
+        off += n;
+    }
+    return NULL;
+}
+
+// Tracks the last recorded sequence numbers per channel (the loop baseline)
+static void RPL_ScanSequences(RPL_Session* s, const RPL_Datagram* g) {
+    if (g->len < 2 || (RPL_Get16(g->data) & RPL_HEADER_COMPRESSED)) return;
+    size_t off = RPL_HeaderSize(RPL_Get16(g->data));
+    while (off < g->len) {
+        const uint8_t* cmd = g->data + off;
+        size_t n = RPL_CommandLen(cmd, g->len - off);
+        if (!n) break;
+        off += n;
+        int type = cmd[0] & 0x0F;
+        if (type == RPL_CMD_ACKNOWLEDGE || type == RPL_CMD_CONNECT || type == RPL_CMD_DISCONNECT) continue;
+        if (type == RPL_CMD_SEND_UNSEQUENCED) s->unseqBase = RPL_Get16(cmd + 4);
+        else if (cmd[0] & RPL_FLAG_ACKNOWLEDGE) s->relBase[cmd[1]] = RPL_Get16(cmd + 2);
+        if (type == RPL_CMD_SEND_UNRELIABLE || type == RPL_CMD_SEND_UNRELIABLE_FRAGMENT) s->unrelBase[cmd[1]] = RPL_Get16(cmd + 4);
+    }
+}
+
+static bool RPL_LoadTrace(const char* path) {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return false;
+    }
+    uint8_t* buf = malloc((size_t)st.st_size + 1);
+    size_t have = 0;
+    while (buf && have < (size_t)st.st_size) {
+        ssize_t r = read(fd, buf + have, (size_t)st.st_size - have);
+        if (r <= 0) break;
+        have += (size_t)r;
+    }
+    close(fd);
+    if (!buf || have < RPL_FILE_HEADER || memcmp(buf, RPL_MAGIC, 4) != 0) {
+        fprintf(stderr, "%s is not an enet_tap trace\n", path);
+        return false;
+    }
+    size_t recHeader = RPL_Get16le(buf + 6);
+    if (recHeader < 14) return false;
+
+    uint64_t t = 0;
+    size_t off = RPL_FILE_HEADER;
+    long records = 0;
+    while (off + recHeader <= have) {
+        const uint8_t* r = buf + off;
+        t += RPL_Get32le(r);
+        uint16_t port = RPL_Get16le(r + 6);
+        uint32_t ip;
+        memcpy(&ip, r + 8, 4);
+        uint16_t len = RPL_Get16le(r + 12);
+        if (off + recHeader + len > have) break;    // Torn tail of a live capture
+        const uint8_t* d = r + recHeader;
+        off += recHeader + len;
+        records++;
+        if (r[4] != 0) continue;                    // Server->client
+
+        RPL_Session* s = RPL_SessionFor(ip, port);
+        if (!s) continue;
+        const uint8_t* connect = RPL_FindConnect(d, len);
+        if (connect) {
+            // A reconnect from the same address starts the session over
+            s->count = 0;
+            s->started = true;
+            s->connect = connect;
+            s->t0 = t;
+        }
+        if (!s->started) continue;
+        if (s->count == s->cap) {
+            s->cap = s->cap ? s->cap * 2 : 256;
+            s->grams = realloc(s->grams, sizeof(RPL_Datagram) * (size_t)s->cap);
+        }
+        RPL_Datagram* g = &s->grams[s->count++];
+        g->data = d;
+        g->len = len;
+        g->us = t - s->t0;
+    }
+
+    // Keep sessions that reached a CONNECT; others started before the capture
+    int kept = 0;
+    for (int i = 0; i < g_RPL_SessionCount; i++) {
+        RPL_Session* s = &g_RPL_Sessions[i];
+        if (!s->started || s->count < 2) continue;
+        s->loopFrom = 1;
+        while (s->loopFrom < s->count - 1 && s->grams[s->loopFrom].us < (uint64_t)g_RPL_LoopFrom * 1000000ull) s->loopFrom++;
+        for (int k = 1; k < s->loopFrom; k++) RPL_ScanSequences(s, &s->grams[k]);
+        g_RPL_Sessions[kept++] = *s;
+    }
+    g_RPL_SessionCount = kept;
+    printf("[Replay] %s: %ld datagrams, %d client sessions\n", path, records, kept);
+    return kept > 0;
+}
+
+// --- ENET CLIENT ---
+
+static void RPL_Send(RPL_Client* c, uint8_t* d, size_t len) {
+    if (g_RPL_Checksum) {
+        size_t at = RPL_HeaderSize(RPL_Get16(d)) - 4;
+        // ENet seeds the checksum field with the connect ID once the peer has an ID
+        RPL_Put32(d + at, c->state == RPL_CONNECTED ? c->connectID : 0);
+        RPL_Put32(d + at, RPL_Crc32(d, len));
+    }
+    if (send(c->fd, d, len, 0) == (ssize_t)len) {
+        g_RPL_Sent++;
+        g_RPL_SentBytes += len;
+    }
+}
+
+// Header for the client's next datagram; returns its size
+static size_t RPL_WriteHeader(RPL_Client* c, uint8_t* d, uint16_t peerID, uint8_t session) {
+    RPL_Put16(d, (uint16_t)(peerID | ((uint16_t)session << RPL_HEADER_SESSION_SHIFT) | RPL_HEADER_SENT_TIME));
+    RPL_Put16(d + 2, (uint16_t)(RPL_NowUs() / 1000));
+    if (g_RPL_Checksum) memset(d + 4, 0, 4);
+    return RPL_HeaderSize(RPL_HEADER_SENT_TIME);
+}
+
+static void RPL_SendConnect(RPL_Client* c) {
+    uint8_t d[64];
+    size_t len = RPL_WriteHeader(c, d, RPL_MAX_PEER_ID, 0);
+    memcpy(d + len, c->trace->connect, RPL_CommandSize[RPL_CMD_CONNECT]);
+    RPL_Put32(d + len + 40, c->connectID);
+    len += RPL_CommandSize[RPL_CMD_CONNECT];
+    RPL_Send(c, d, len);
+    c->tries++;
+    c->lastTryUs = RPL_NowUs();
+}
+
+static void RPL_SendDisconnect(RPL_Client* c) {
+    uint8_t d[32];
+    size_t len = RPL_WriteHeader(c, d, c->peerID, c->session);
+    uint8_t* cmd = d + len;
+    cmd[0] = RPL_CMD_DISCONNECT | RPL_FLAG_UNSEQUENCED;
+    cmd[1] = 0xFF;
+    RPL_Put16(cmd + 2, 0);
+    RPL_Put32(cmd + 4, 0);
+    RPL_Send(c, d, len + 8);
+}
+
+// Same-length alias per client: STEVE -> STEV3, STE12...
+static void RPL_MakeAlias(RPL_Client* c, int index) {
+    if (!g_RPL_Alias) return;
+    size_t len = strlen(g_RPL_Alias);
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), "%d", index);
+    size_t sl = strlen(suffix);
+    if (sl >= len || len >= sizeof(c->alias)) return;
+    memcpy(c->alias, g_RPL_Alias, len - sl);
+    memcpy(c->alias + len - sl, suffix, sl + 1);
+}
+
+static void RPL_RewriteAlias(RPL_Client* c, uint8_t* p, size_t len) {
+    if (!c->alias[0]) return;
+    size_t al = strlen(g_RPL_Alias);
+    for (size_t i = 0; i + al <= len; i++) {
+        if (p[i] == (uint8_t)g_RPL_Alias[0] && memcmp(p + i, g_RPL_Alias, al) == 0) {
+            memcpy(p + i, c->alias, al);
+            i += al - 1;
+        }
+    }
+}
+
+// Rewrites one recorded client datagram for this client; returns the new size (0 = nothing to send)
+static size_t RPL_Rewrite(RPL_Client* c, const RPL_Datagram* g, uint8_t* out) {
+    if (g->len < 2) return 0;
+    uint16_t recPeer = RPL_Get16(g->data);
+    size_t inOff = RPL_HeaderSize(recPeer);
+    if (inOff > g->len) return 0;
+    size_t len = RPL_WriteHeader(c, out, c->peerID, c->session);
+
+    if (recPeer & RPL_HEADER_COMPRESSED) {
+        RPL_Put16(out, (uint16_t)(RPL_Get16(out) | RPL_HEADER_COMPRESSED));
+        memcpy(out + len, g->data + inOff, g->len - inOff);
+        return len + g->len - inOff;
+    }
+
+    size_t start = len;
+    while (inOff < g->len) {
+        const uint8_t* in = g->data + inOff;
+        size_t n = RPL_CommandLen(in, g->len - inOff);
+        if (!n) break;
+        inOff += n;
+        int cmd = in[0] & 0x0F;
+        if (cmd == RPL_CMD_ACKNOWLEDGE || cmd == RPL_CMD_CONNECT || cmd == RPL_CMD_VERIFY_CONNECT || cmd == RPL_CMD_DISCONNECT) continue;
+
+        uint8_t* o = out + len;
+        memcpy(o, in, n);
+        len += n;
+        uint8_t ch = in[1];
+        if (cmd == RPL_CMD_SEND_UNSEQUENCED) {
+            uint16_t group = (uint16_t)(RPL_Get16(in + 4) + c->unseqOff);
+            RPL_Put16(o + 4, group);
+            c->lastUnseq = group;
+            RPL_RewriteAlias(c, o + RPL_CommandSize[cmd], n - RPL_CommandSize[cmd]);
+            continue;
+        }
+        uint16_t rel = (uint16_t)(RPL_Get16(in + 2) + c->relOff[ch]);
+        RPL_Put16(o + 2, rel);
+        if (in[0] & RPL_FLAG_ACKNOWLEDGE) c->lastRel[ch] = rel;
+        if (cmd == RPL_CMD_SEND_FRAGMENT) {
+            RPL_Put16(o + 4, (uint16_t)(RPL_Get16(in + 4) + c->relOff[ch]));
+        } else if (cmd == RPL_CMD_SEND_UNRELIABLE || cmd == RPL_CMD_SEND_UNRELIABLE_FRAGMENT) {
+            uint16_t unrel = (uint16_t)(RPL_Get16(in + 4) + c->unrelOff[ch]);
+            RPL_Put16(o + 4, unrel);
+            c->lastUnrel[ch] = unrel;
+        }
+        if (cmd >= RPL_CMD_SEND_RELIABLE && cmd != RPL_CMD_BANDWIDTH_LIMIT && cmd != RPL_CMD_THROTTLE_CONFIGURE) {
+            RPL_RewriteAlias(c, o + RPL_CommandSize[cmd], n - RPL_CommandSize[cmd]);
+        }
+    }
+    return len > start ? len : 0;
+}
+
+// Acknowledges every reliable command of a server datagram and tracks connect/disconnect
+static void RPL_HandleIncoming(RPL_Client* c, const uint8_t* d, size_t len) {
+    if (len < 2) return;
+    uint16_t peerID = RPL_Get16(d);
+    if (peerID & RPL_HEADER_COMPRESSED) return;
+    uint16_t sentTime = (peerID & RPL_HEADER_SENT_TIME) && len >= 4 ? RPL_Get16(d + 2) : 0;
+    size_t off = RPL_HeaderSize(peerID);
+
+    uint8_t ack[RPL_DATAGRAM_MAX];
+    size_t ackLen = 0;
+    while (off < len) {
+        const uint8_t* cmd = d + off;
+        size_t n = RPL_CommandLen(cmd, len - off);
+        if (!n) break;
+        off += n;
+        int type = cmd[0] & 0x0F;
+
+        if (type == RPL_CMD_VERIFY_CONNECT && c->state == RPL_CONNECTING) {
+            c->peerID = RPL_Get16(cmd + 4) & RPL_MAX_PEER_ID;
+            c->session = cmd[7] & 0x03;
+            c->state = RPL_CONNECTED;
+            c->cursor = 1;
+            c->passStartUs = RPL_NowUs();
+            g_RPL_Connected++;
+        } else if (type == RPL_CMD_DISCONNECT && c->state != RPL_DONE) {
+            if (c->state == RPL_CONNECTED) g_RPL_Connected--;
+            c->state = RPL_DONE;
+            g_RPL_Dropped++;
+            return;
+        }
+
+        if ((cmd[0] & RPL_FLAG_ACKNOWLEDGE) && c->state == RPL_CONNECTED) {
+            if (ackLen == 0) ackLen = RPL_WriteHeader(c, ack, c->peerID, c->session);
+            if (ackLen + 8 > sizeof(ack)) break;
+            uint8_t* a = ack + ackLen;
+            a[0] = RPL_CMD_ACKNOWLEDGE;
+            a[1] = cmd[1];
+            memcpy(a + 2, cmd + 2, 2);
+            memcpy(a + 4, cmd + 2, 2);
+            RPL_Put16(a + 6, sentTime);
+            ackLen += 8;
+        }
+    }
+    if (ackLen) RPL_Send(c, ack, ackLen);
+}
+
+// Starts the next pass of a looped session: the recorded numbers after loopFrom
+// continue right after the last ones this client sent
+static void RPL_NextPass(RPL_Client* c, uint64_t now) {
+    RPL_Session* s = c->trace;
+    for (int ch = 0; ch < 256; ch++) {
+        c->relOff[ch] = (uint16_t)(c->lastRel[ch] - s->relBase[ch]);
+        c->unrelOff[ch] = (uint16_t)(c->lastUnrel[ch] - s->unrelBase[ch]);
+    }
+    c->unseqOff = (uint16_t)(c->lastUnseq - s->unseqBase);
+    c->cursor = s->loopFrom;
+    c->passStartUs = now - (uint64_t)(s->grams[s->loopFrom].us / g_RPL_Speed);
+}
+
+// Sends whatever is due for this client; returns microseconds until its next event
+static uint64_t RPL_Pump(RPL_Client* c, uint64_t now) {
+    uint8_t out[RPL_DATAGRAM_MAX + 16];
+    if (c->state == RPL_IDLE) {
+        if (now < c->startUs) return c->startUs - now;
+        c->state = RPL_CONNECTING;
+        RPL_SendConnect(c);
+        return RPL_CONNECT_RETRY_MS * 1000;
+    }
+    if (c->state == RPL_CONNECTING) {
+        if (now - c->lastTryUs < RPL_CONNECT_RETRY_MS * 1000) return RPL_CONNECT_RETRY_MS * 1000 - (now - c->lastTryUs);
+        if (c->tries >= RPL_CONNECT_TRIES) {
+            c->state = RPL_DONE;
+            g_RPL_Failed++;
+            return UINT64_MAX;
+        }
+        RPL_SendConnect(c);
+        return RPL_CONNECT_RETRY_MS * 1000;
+    }
+    if (c->state != RPL_CONNECTED) return UINT64_MAX;
+
+    RPL_Session* s = c->trace;
+    while (1) {
+        if (c->cursor >= s->count) {
+            if (!g_RPL_Loop) {
+                RPL_SendDisconnect(c);
+                c->state = RPL_DONE;
+                g_RPL_Connected--;
+                return UINT64_MAX;
+            }
+            RPL_NextPass(c, now);
+        }
+        const RPL_Datagram* g = &s->grams[c->cursor];
+        uint64_t due = c->passStartUs + (uint64_t)(g->us / g_RPL_Speed);
+        if (due > now) return due - now;
+        size_t len = RPL_Rewrite(c, g, out);
+        if (len) RPL_Send(c, out, len);
+        c->cursor++;
+    }
+}
+
+// --- MAIN ---
+
+static bool RPL_Resolve(const char* target, struct sockaddr_storage* addr, socklen_t* addrLen) {
+    char host[256];
+    snprintf(host, sizeof(host), "%s", target);
+    const char* port = RPL_DEFAULT_PORT;
+    char* colon = strrchr(host, ':');
+    if (colon) {
+        *colon = '\0';
+        port = colon + 1;
+    }
+    struct addrinfo hints = { 0 }, *res = NULL;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    if (getaddrinfo(host, port, &hints, &res) != 0 || !res) return false;
+    memcpy(addr, res->ai_addr, res->ai_addrlen);
+    *addrLen = res->ai_addrlen;
+    freeaddrinfo(res);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "n:x:r:d:lj:a:k")) != -1) {
+        switch (opt) {
+            case 'n': g_RPL_ClientCount = atoi(optarg); break;
+            case 'x': g_RPL_Speed = atof(optarg); break;
+            case 'r': g_RPL_RampMs = atoi(optarg); break;
+            case 'd': g_RPL_Duration = atoi(optarg); break;
+            case 'l': g_RPL_Loop = true; break;
+            case 'j': g_RPL_LoopFrom = atoi(optarg); break;
+            case 'a': g_RPL_Alias = optarg; break;
+            case 'k': g_RPL_Checksum = true; break;
+            default: argc = 0; break;
+        }
+    }
+    if (argc - optind != 2 || g_RPL_ClientCount <= 0 || g_RPL_ClientCount > RPL_MAX_CLIENTS || g_RPL_Speed <= 0.0) {
+        fprintf(stderr, "Usage: bh_replay [-n clients] [-x speed] [-r ramp_ms] [-d seconds] [-l] [-j loop_from_s] [-a alias] [-k] <trace.bhtr> <host[:port]>\n");
+        return 2;
+    }
+    if (g_RPL_Loop && g_RPL_Duration <= 0) {
+        fprintf(stderr, "-l needs -d\n");
+        return 2;
+    }
+    RPL_CrcInit();
+    if (!RPL_LoadTrace(argv[optind])) return 1;
+
+    struct sockaddr_storage addr;
+    socklen_t addrLen;
+    if (!RPL_Resolve(argv[optind + 1], &addr, &addrLen)) {
+        fprintf(stderr, "Cannot resolve %s\n", argv[optind + 1]);
+        return 1;
+    }
+
+    g_RPL_Clients = calloc((size_t)g_RPL_ClientCount, sizeof(RPL_Client));
+    struct pollfd* pfds = calloc((size_t)g_RPL_ClientCount, sizeof(struct pollfd));
+    uint64_t t0 = RPL_NowUs();
+    srand((unsigned)t0);
+    for (int i = 0; i < g_RPL_ClientCount; i++) {
+        RPL_Client* c = &g_RPL_Clients[i];
+        c->fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (c->fd < 0 || connect(c->fd, (struct sockaddr*)&addr, addrLen) != 0) {
+            perror("socket");
+            return 1;
+        }
+        c->trace = &g_RPL_Sessions[i % g_RPL_SessionCount];
+        c->startUs = t0 + (uint64_t)i * (uint64_t)g_RPL_RampMs * 1000;
+        c->connectID = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+        RPL_MakeAlias(c, i);
+        pfds[i].fd = c->fd;
+        pfds[i].events = POLLIN;
+    }
+    printf("[Replay] %d clients -> %s at %.2fx%s\n", g_RPL_ClientCount, argv[optind + 1], g_RPL_Speed, g_RPL_Loop ? ", looping" : "");
+
+    uint64_t nextReport = t0 + 1000000;
+    uint64_t end = g_RPL_Duration > 0 ? t0 + (uint64_t)g_RPL_Duration * 1000000ull : UINT64_MAX;
+    uint8_t buf[RPL_DATAGRAM_MAX];
+    while (1) {
+        uint64_t now = RPL_NowUs();
+        uint64_t wait = 100000;
+        int active = 0;
+        for (int i = 0; i < g_RPL_ClientCount; i++) {
+            RPL_Client* c = &g_RPL_Clients[i];
+            if (c->state == RPL_DONE) continue;
+            active++;
+            uint64_t w = RPL_Pump(c, now);
+            if (w < wait) wait = w;
+        }
+        if (!active || now >= end) break;
+
+        int ready = poll(pfds, (nfds_t)g_RPL_ClientCount, (int)((wait + 999) / 1000));
+        for (int i = 0; ready > 0 && i < g_RPL_ClientCount; i++) {
+            if (!(pfds[i].revents & POLLIN)) continue;
+            ssize_t r;
+            while ((r = recv(pfds[i].fd, buf, sizeof(buf), 0)) > 0) {
+                g_RPL_Recv++;
+                g_RPL_RecvBytes += (uint64_t)r;
+                RPL_HandleIncoming(&g_RPL_Clients[i], buf, (size_t)r);
+            }
+        }
+
+        now = RPL_NowUs();
+        if (now >= nextReport) {
+            printf("[Replay] %4llus  connected %d  failed %d  dropped %d  sent %llu (%llu KB)  recv %llu (%llu KB)\n",
+                   (unsigned long long)((now - t0) / 1000000), g_RPL_Connected, g_RPL_Failed, g_RPL_Dropped,
+                   (unsigned long long)g_RPL_Sent, (unsigned long long)(g_RPL_SentBytes >> 10),
+                   (unsigned long long)g_RPL_Recv, (unsigned long long)(g_RPL_RecvBytes >> 10));
+            fflush(stdout);
+            nextReport += 1000000;
+        }
+    }
+
+    for (int i = 0; i < g_RPL_ClientCount; i++) {
+        RPL_Client* c = &g_RPL_Clients[i];
+        if (c->state == RPL_CONNECTED) RPL_SendDisconnect(c);
+        close(c->fd);
+    }
+    printf("[Replay] Done: %d clients, %d never connected, %d dropped by the server, %llu datagrams sent, %llu received\n",
+           g_RPL_ClientCount, g_RPL_Failed, g_RPL_Dropped, (unsigned long long)g_RPL_Sent, (unsigned long long)g_RPL_Recv);
+    return 0;
+}
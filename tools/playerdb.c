@@ -0,0 +1,742 @@
+//Usage: playerdb <players.db> get|ip|lookup|put|del|import|export|compact|stat [args]
+
+/*
+ * Player DB - Append-only player store for rank_manager.sh and rank_engine
+ * players.log (name|first_ip|password|rank|whitelisted|blacklisted) had to be
+ * scanned line by line for every lookup and rewritten with sed for every
+ * update. players.db keeps the same six fields as CRC-checked records that are
+ * only ever appended; the newest record of a name wins, a record with the
+ * deleted flag removes it. players.db.idx is a mmap'd open-addressing index
+ * (name -> record, first_ip -> records), so get/ip are O(1) and put is one
+ * append plus a few slot writes.
+ *
+ * Crash safety: the index is only a cache of the log. It stores the log size
+ * and inode it covers; a missing, stale or foreign index is caught up or
+ * rebuilt from the log on open, and a torn record at the end of the log (crash
+ * during an append) is cut off. Compaction copies the live records to
+ * players.db.tmp, fsyncs and renames it over players.db, then rebuilds the
+ * index the same way. All commands hold an exclusive flock on players.db.lock.
+ *
+ * Record layout (little endian):
+ *     u32 magic 'BHPR', u32 payload length, u32 crc32(payload)
+ *     payload: u8 flags, then name, ip, password, rank, whitelisted,
+ *     blacklisted as NUL-terminated strings
+ *
+ *   get <name>              ip|password|rank|whitelisted|blacklisted
+ *   ip <ip>                 players.log lines of players first seen on <ip>
+ *   lookup <name>...        players.log lines of the given players
+ *   put <name> <ip> <password> <rank> [whitelisted] [blacklisted]
+ *   del <name>
+ *   import <players.log> [baseline]   merge a players.log; with a baseline
+ *                           (previous copy) only lines edited since are taken
+ *                           and removed lines are deleted
+ *   export [file]           players.log format, to stdout or atomically to file
+ *   compact
+ *   stat
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// --- CONFIG ---
+#define PDB_FILE_MAGIC      "BHPLDB1\n"
+#define PDB_IDX_MAGIC       "BHPLIX1\n"
+#define PDB_REC_MAGIC       0x52504842u     // "BHPR"
+#define PDB_FILE_HEADER     16              // Magic + reserved
+#define PDB_FIELDS          6
+#define PDB_FIELD_MAX       128
+#define PDB_PAYLOAD_MAX     (1 + PDB_FIELDS * PDB_FIELD_MAX)
+#define PDB_MIN_SLOTS       1024
+#define PDB_COMPACT_DEAD    1024            // Compact once this many dead records outnumber the live ones
+
+#define PDB_FLAG_DELETED    0x01
+
+enum { F_NAME = 0, F_IP, F_PASS, F_RANK, F_WHITE, F_BLACK };
+
+// --- TYPES ---
+typedef struct {
+    uint32_t magic;
+    uint32_t len;
+    uint32_t crc;
+} PDB_RecHead;
+
+typedef struct {
+    uint8_t flags;
+    char    f[PDB_FIELDS][PDB_FIELD_MAX];
+} PDB_Rec;
+
+typedef struct {
+    char     magic[8];
+    uint32_t cap;           // Slots per table, power of two
+    uint32_t live;          // Players
+    uint32_t nameUsed;      // Name slots in use, tombstones included
+    uint32_t ipUsed;
+    uint64_t logSize;       // Log bytes the index covers
+    uint64_t logIno;
+    uint64_t dead;          // Records superseded in the log (a delete counts once)
+} PDB_IdxHead;
+
+typedef struct {
+    uint32_t hash;
+    uint32_t pad;
+    uint64_t off;           // Record offset, 0 = empty, 1 = tombstone
+} PDB_Slot;
+
+typedef struct {
+    char         logPath[512];
+    char         idxPath[512];
+    int          lockFd;
+    int          logFd;
+    int          idxFd;
+    size_t       mapSize;
+    PDB_IdxHead* head;
+    PDB_Slot*    names;
+    PDB_Slot*    ips;
+} PDB;
+
+#define SLOT_EMPTY 0
+#define SLOT_TOMB  1
+
+static const char* g_PDB_Defaults[PDB_FIELDS] = { "", "UNKNOWN", "NONE", "NONE", "NO", "NO" };
+
+static int PDB_Rebuild(PDB* db, uint32_t cap);
+
+// --- UTILS ---
+
+static uint32_t PDB_Crc(const uint8_t* p, size_t n) {
+    static uint32_t table[256];
+    if (!table[1]) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+    }
+    uint32_t c = 0xFFFFFFFFu;
+    while (n--) c = table[(c ^ *p++) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+// Same FNV-1a as rank_engine, case-insensitive
+static uint32_t PDB_Hash(const char* s) {
+    uint32_t h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)toupper((unsigned char)*s++);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static char* PDB_Trim(char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    char* end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) *--end = '\0';
+    return s;
+}
+
+// Normalizes a field the way update_player_info does (upper case, defaults)
+static int PDB_SetField(PDB_Rec* r, int field, const char* value) {
+    char buf[PDB_FIELD_MAX];
+    snprintf(buf, sizeof(buf), "%s", value ? value : "");
+    char* v = PDB_Trim(buf);
+    if (!*v) v = (char*)g_PDB_Defaults[field];
+    if (strlen(v) >= PDB_FIELD_MAX || strpbrk(v, "|\n\r")) return -1;
+
+    char* dst = r->f[field];
+    size_t i = 0;
+    for (; v[i]; i++) dst[i] = (field == F_PASS) ? v[i] : (char)toupper((unsigned char)v[i]);
+    dst[i] = '\0';
+    return 0;
+}
+
+static int PDB_SetAll(PDB_Rec* r, char** values, int n) {
+    memset(r, 0, sizeof(*r));
+    for (int i = 0; i < PDB_FIELDS; i++) {
+        if (PDB_SetField(r, i, i < n ? values[i] : NULL) != 0) return -1;
+    }
+    return r->f[F_NAME][0] ? 0 : -1;
+}
+
+static bool PDB_SameRec(const PDB_Rec* a, const PDB_Rec* b) {
+    for (int i = 0; i < PDB_FIELDS; i++) {
+        if (strcmp(a->f[i], b->f[i]) != 0) return false;
+    }
+    return true;
+}
+
+static void PDB_PrintLine(FILE* out, const PDB_Rec* r) {
+    fprintf(out, "%s|%s|%s|%s|%s|%s\n", r->f[F_NAME], r->f[F_IP], r->f[F_PASS], r->f[F_RANK], r->f[F_WHITE], r->f[F_BLACK]);
+}
+
+// --- LOG ---
+
+// Reads the record at off. Returns its total size, 0 at a clean end of log,
+// -1 for a torn or corrupt record.
+static ssize_t PDB_ReadRec(int fd, uint64_t off, PDB_Rec* r) {
+    PDB_RecHead h;
+    ssize_t n = pread(fd, &h, sizeof(h), (off_t)off);
+    if (n == 0) return 0;
+    if (n != sizeof(h) || h.magic != PDB_REC_MAGIC || h.len < 1 + PDB_FIELDS || h.len > PDB_PAYLOAD_MAX) return -1;
+
+    uint8_t buf[PDB_PAYLOAD_MAX];
+    if (pread(fd, buf, h.len, (off_t)(off + sizeof(h))) != (ssize_t)h.len) return -1;
+    if (PDB_Crc(buf, h.len) != h.crc) return -1;
+
+    if (r) {
+        memset(r, 0, sizeof(*r));
+        r->flags = buf[0];
+        size_t p = 1;
+        for (int i = 0; i < PDB_FIELDS; i++) {
+            size_t len = strnlen((const char*)buf + p, h.len - p);
+            if (p + len >= h.len || len >= PDB_FIELD_MAX) return -1;
+            memcpy(r->f[i], buf + p, len);
+            p += len + 1;
+        }
+    }
+    return (ssize_t)(sizeof(h) + h.len);
+}
+
+static size_t PDB_Encode(const PDB_Rec* r, uint8_t* out) {
+    uint8_t* payload = out + sizeof(PDB_RecHead);
+    size_t p = 0;
+    payload[p++] = r->flags;
+    for (int i = 0; i < PDB_FIELDS; i++) {
+        size_t len = strlen(r->f[i]) + 1;
+        memcpy(payload + p, r->f[i], len);
+        p += len;
+    }
+    PDB_RecHead h = { PDB_REC_MAGIC, (uint32_t)p, PDB_Crc(payload, p) };
+    memcpy(out, &h, sizeof(h));
+    return sizeof(h) + p;
+}
+
+static int PDB_InitLog(int fd) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) return -1;
+    if (st.st_size == 0) {
+        char hdr[PDB_FILE_HEADER] = PDB_FILE_MAGIC;
+        if (pwrite(fd, hdr, sizeof(hdr), 0) != sizeof(hdr)) return -1;
+        fdatasync(fd);
+        return 0;
+    }
+    char hdr[PDB_FILE_HEADER];
+    if (pread(fd, hdr, sizeof(hdr), 0) != sizeof(hdr) || memcmp(hdr, PDB_FILE_MAGIC, 8) != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
+// --- INDEX ---
+
+static PDB_Slot* PDB_FindName(PDB* db, const char* name, PDB_Rec* out) {
+    uint32_t mask = db->head->cap - 1;
+    uint32_t h = PDB_Hash(name);
+    for (uint32_t i = h & mask;; i = (i + 1) & mask) {
+        PDB_Slot* s = &db->names[i];
+        if (s->off == SLOT_EMPTY) return NULL;
+        if (s->off == SLOT_TOMB || s->hash != h) continue;
+        PDB_Rec r;
+        if (PDB_ReadRec(db->logFd, s->off, &r) > 0 && strcasecmp(r.f[F_NAME], name) == 0) {
+            if (out) *out = r;
+            return s;
+        }
+    }
+}
+
+static void PDB_SlotAdd(PDB_Slot* table, uint32_t cap, uint32_t* used, uint32_t h, uint64_t off) {
+    uint32_t mask = cap - 1;
+    for (uint32_t i = h & mask;; i = (i + 1) & mask) {
+        if (table[i].off == SLOT_EMPTY) (*used)++;
+        if (table[i].off <= SLOT_TOMB) {
+            table[i].hash = h;
+            table[i].off = off;
+            return;
+        }
+    }
+}
+
+static void PDB_SlotDrop(PDB_Slot* table, uint32_t cap, uint32_t h, uint64_t off) {
+    uint32_t mask = cap - 1;
+    for (uint32_t i = h & mask; table[i].off != SLOT_EMPTY; i = (i + 1) & mask) {
+        if (table[i].off == off) {
+            table[i].off = SLOT_TOMB;
+            return;
+        }
+    }
+}
+
+static bool PDB_NeedsGrow(PDB* db) {
+    return (db->head->nameUsed + 1) * 2 > db->head->cap || (db->head->ipUsed + 1) * 2 > db->head->cap;
+}
+
+// Applies the record written at off to the index
+static void PDB_Apply(PDB* db, uint64_t off, const PDB_Rec* r) {
+    PDB_IdxHead* hd = db->head;
+    PDB_Rec old;
+    PDB_Slot* s = PDB_FindName(db, r->f[F_NAME], &old);
+
+    if (s) {
+        PDB_SlotDrop(db->ips, hd->cap, PDB_Hash(old.f[F_IP]), s->off);
+        hd->dead++;
+        if (r->flags & PDB_FLAG_DELETED) {
+            // Counted once above: the dropped record and its delete go together
+            s->off = SLOT_TOMB;
+            hd->live--;
+            return;
+        }
+        s->off = off;
+    } else {
+        if (r->flags & PDB_FLAG_DELETED) {
+            hd->dead++;
+            return;
+        }
+        PDB_SlotAdd(db->names, hd->cap, &hd->nameUsed, PDB_Hash(r->f[F_NAME]), off);
+        hd->live++;
+    }
+    PDB_SlotAdd(db->ips, hd->cap, &hd->ipUsed, PDB_Hash(r->f[F_IP]), off);
+}
+
+// Replays log records the index has not seen yet; cuts off a torn tail
+static int PDB_CatchUp(PDB* db) {
+    struct stat st;
+    if (fstat(db->logFd, &st) != 0) return -1;
+
+    uint64_t off = db->head->logSize;
+    while (off < (uint64_t)st.st_size) {
+        if (PDB_NeedsGrow(db)) return PDB_Rebuild(db, db->head->cap * 2);
+
+        PDB_Rec r;
+        ssize_t n = PDB_ReadRec(db->logFd, off, &r);
+        if (n <= 0) {
+            fprintf(stderr, "[PlayerDB] Dropping %llu bytes of torn data at the end of %s\n",
+                    (unsigned long long)(st.st_size - off), db->logPath);
+            if (ftruncate(db->logFd, (off_t)off) != 0) return -1;
+            break;
+        }
+        PDB_Apply(db, off, &r);
+        off += (uint64_t)n;
+        db->head->logSize = off;
+    }
+    db->head->logSize = off;
+    return 0;
+}
+
+static void PDB_Unmap(PDB* db) {
+    if (db->head) munmap(db->head, db->mapSize);
+    if (db->idxFd >= 0) close(db->idxFd);
+    db->head = NULL;
+    db->idxFd = -1;
+}
+
+static int PDB_Map(PDB* db, int fd) {
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(PDB_IdxHead)) return -1;
+    void* map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) return -1;
+
+    PDB_IdxHead* hd = map;
+    size_t want = sizeof(PDB_IdxHead) + 2 * (size_t)hd->cap * sizeof(PDB_Slot);
+    if (memcmp(hd->magic, PDB_IDX_MAGIC, 8) != 0 || hd->cap < PDB_MIN_SLOTS || (hd->cap & (hd->cap - 1)) ||
+        want != (size_t)st.st_size) {
+        munmap(map, (size_t)st.st_size);
+        return -1;
+    }
+    PDB_Unmap(db);
+    db->idxFd = fd;
+    db->mapSize = want;
+    db->head = hd;
+    db->names = (PDB_Slot*)(hd + 1);
+    db->ips = db->names + hd->cap;
+    return 0;
+}
+
+static uint64_t PDB_CountRecords(int fd) {
+    uint64_t count = 0, off = PDB_FILE_HEADER;
+    PDB_RecHead h;
+    while (pread(fd, &h, sizeof(h), (off_t)off) == sizeof(h) && h.magic == PDB_REC_MAGIC && h.len <= PDB_PAYLOAD_MAX) {
+        off += sizeof(h) + h.len;
+        count++;
+    }
+    return count;
+}
+
+// Builds a fresh index from the whole log and renames it into place
+static int PDB_Rebuild(PDB* db, uint32_t cap) {
+    uint64_t records = PDB_CountRecords(db->logFd);
+    while (cap < PDB_MIN_SLOTS || cap < records * 2 + 2) cap = cap ? cap * 2 : PDB_MIN_SLOTS;
+
+    char tmp[600];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", db->idxPath);
+    int fd = open(tmp, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return -1;
+
+    size_t size = sizeof(PDB_IdxHead) + 2 * (size_t)cap * sizeof(PDB_Slot);
+    struct stat st;
+    PDB_IdxHead hd = { PDB_IDX_MAGIC, cap, 0, 0, 0, PDB_FILE_HEADER, 0, 0 };
+    if (fstat(db->logFd, &st) != 0 || ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return -1;
+    }
+    hd.logIno = (uint64_t)st.st_ino;
+    if (pwrite(fd, &hd, sizeof(hd), 0) != sizeof(hd) || PDB_Map(db, fd) != 0) {
+        close(fd);
+        unlink(tmp);
+        return -1;
+    }
+
+    if (PDB_CatchUp(db) != 0 || rename(tmp, db->idxPath) != 0) {
+        unlink(tmp);
+        return -1;
+    }
+    return 0;
+}
+
+// Opens the index, rebuilding it when it does not match the log
+static int PDB_OpenIndex(PDB* db) {
+    struct stat st;
+    if (fstat(db->logFd, &st) != 0) return -1;
+
+    int fd = open(db->idxPath, O_RDWR | O_CLOEXEC);
+    if (fd >= 0 && PDB_Map(db, fd) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    if (fd < 0 || db->head->logIno != (uint64_t)st.st_ino || db->head->logSize > (uint64_t)st.st_size ||
+        db->head->logSize < PDB_FILE_HEADER) {
+        return PDB_Rebuild(db, db->head ? db->head->cap : 0);
+    }
+    return PDB_CatchUp(db);
+}
+
+static int PDB_Open(PDB* db, const char* path) {
+    memset(db, 0, sizeof(*db));
+    db->lockFd = db->logFd = db->idxFd = -1;
+    snprintf(db->logPath, sizeof(db->logPath), "%s", path);
+    snprintf(db->idxPath, sizeof(db->idxPath), "%s.idx", path);
+
+    char lockPath[600];
+    snprintf(lockPath, sizeof(lockPath), "%s.lock", path);
+    db->lockFd = open(lockPath, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (db->lockFd < 0 || flock(db->lockFd, LOCK_EX) != 0) return -1;
+
+    db->logFd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (db->logFd < 0 || PDB_InitLog(db->logFd) != 0) return -1;
+    return PDB_OpenIndex(db);
+}
+
+static void PDB_Close(PDB* db) {
+    PDB_Unmap(db);
+    if (db->logFd >= 0) close(db->logFd);
+    if (db->lockFd >= 0) close(db->lockFd);
+}
+
+// --- WRITES ---
+
+static int PDB_Append(PDB* db, const PDB_Rec* r) {
+    if (PDB_NeedsGrow(db) && PDB_Rebuild(db, db->head->cap * 2) != 0) return -1;
+
+    uint8_t buf[sizeof(PDB_RecHead) + PDB_PAYLOAD_MAX];
+    size_t n = PDB_Encode(r, buf);
+    uint64_t off = db->head->logSize;
+    if (pwrite(db->logFd, buf, n, (off_t)off) != (ssize_t)n) {
+        if (ftruncate(db->logFd, (off_t)off) != 0) { /* next open cuts it off */ }
+        return -1;
+    }
+
+    PDB_Apply(db, off, r);
+    db->head->logSize = off + n;
+    return 0;
+}
+
+static int PDB_Put(PDB* db, const PDB_Rec* r) {
+    PDB_Rec cur;
+    if (PDB_FindName(db, r->f[F_NAME], &cur) && PDB_SameRec(&cur, r)) return 0;
+    return PDB_Append(db, r);
+}
+
+static int PDB_Delete(PDB* db, const char* name) {
+    PDB_Rec r;
+    if (!PDB_FindName(db, name, &r)) return 1;
+    r.flags = PDB_FLAG_DELETED;
+    return PDB_Append(db, &r);
+}
+
+static int PDB_SyncDir(const char* path) {
+    char copy[512];
+    snprintf(copy, sizeof(copy), "%s", path);
+    int fd = open(dirname(copy), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    fsync(fd);
+    close(fd);
+    return 0;
+}
+
+// Copies the live records (newest-write order) to a new log and swaps it in
+static int PDB_Compact(PDB* db) {
+    char tmp[600];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", db->logPath);
+    int fd = open(tmp, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0 || PDB_InitLog(fd) != 0) {
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+
+    uint64_t in = PDB_FILE_HEADER, out = PDB_FILE_HEADER;
+    uint8_t buf[sizeof(PDB_RecHead) + PDB_PAYLOAD_MAX];
+    PDB_Rec r;
+    ssize_t n;
+    while (in < db->head->logSize && (n = PDB_ReadRec(db->logFd, in, &r)) > 0) {
+        PDB_Slot* s = PDB_FindName(db, r.f[F_NAME], NULL);
+        if (s && s->off == in) {
+            size_t len = PDB_Encode(&r, buf);
+            if (pwrite(fd, buf, len, (off_t)out) != (ssize_t)len) {
+                close(fd);
+                unlink(tmp);
+                return -1;
+            }
+            out += len;
+        }
+        in += (uint64_t)n;
+    }
+
+    if (fsync(fd) != 0 || rename(tmp, db->logPath) != 0) {
+        close(fd);
+        unlink(tmp);
+        return -1;
+    }
+    PDB_SyncDir(db->logPath);
+
+    uint64_t before = db->head->logSize;
+    close(db->logFd);
+    db->logFd = fd;
+    if (PDB_Rebuild(db, 0) != 0) return -1;
+    fprintf(stderr, "[PlayerDB] Compacted %s: %llu -> %llu bytes, %u players\n", db->logPath,
+            (unsigned long long)before, (unsigned long long)out, db->head->live);
+    return 0;
+}
+
+static int PDB_MaybeCompact(PDB* db) {
+    if (db->head->dead < PDB_COMPACT_DEAD || db->head->dead <= db->head->live) return 0;
+    return PDB_Compact(db);
+}
+
+// --- IMPORT / EXPORT ---
+
+typedef struct {
+    PDB_Rec* recs;
+    int      count;
+    int*     slots;
+    uint32_t mask;
+} PDB_Lines;
+
+// Parses a players.log; later lines win like in get_player_info
+static int PDB_LoadLines(const char* path, PDB_Lines* L) {
+    memset(L, 0, sizeof(*L));
+    FILE* f = fopen(path, "r");
+    if (!f) return -1;
+
+    int cap = 1024;
+    L->recs = malloc(sizeof(PDB_Rec) * cap);
+    char line[1024];
+    while (fgets(line, sizeof(line), f)) {
+        char* fields[PDB_FIELDS] = { 0 };
+        int n = 0;
+        char* p = line;
+        line[strcspn(line, "\r\n")] = '\0';
+        while (n < PDB_FIELDS && p) {
+            fields[n++] = p;
+            p = strchr(p, '|');
+            if (p) *p++ = '\0';
+        }
+        if (n < 4) continue;
+        if (L->count == cap) {
+            cap *= 2;
+            L->recs = realloc(L->recs, sizeof(PDB_Rec) * cap);
+        }
+        if (PDB_SetAll(&L->recs[L->count], fields, n) == 0) L->count++;
+    }
+    fclose(f);
+
+    uint32_t slots = 16;
+    while (slots < (uint32_t)L->count * 2) slots <<= 1;
+    L->mask = slots - 1;
+    L->slots = malloc(sizeof(int) * slots);
+    memset(L->slots, 0xff, sizeof(int) * slots);
+    for (int e = 0; e < L->count; e++) {
+        for (uint32_t i = PDB_Hash(L->recs[e].f[F_NAME]) & L->mask;; i = (i + 1) & L->mask) {
+            int cur = L->slots[i];
+            if (cur < 0 || strcmp(L->recs[cur].f[F_NAME], L->recs[e].f[F_NAME]) == 0) {
+                L->slots[i] = e;
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+static const PDB_Rec* PDB_LinesFind(const PDB_Lines* L, const char* name) {
+    if (!L->slots) return NULL;
+    for (uint32_t i = PDB_Hash(name) & L->mask;; i = (i + 1) & L->mask) {
+        int e = L->slots[i];
+        if (e < 0) return NULL;
+        if (strcmp(L->recs[e].f[F_NAME], name) == 0) return &L->recs[e];
+    }
+}
+
+static void PDB_FreeLines(PDB_Lines* L) {
+    free(L->recs);
+    free(L->slots);
+}
+
+static int PDB_Import(PDB* db, const char* path, const char* baselinePath) {
+    PDB_Lines cur, base = { 0 };
+    if (PDB_LoadLines(path, &cur) != 0) return -1;
+    bool haveBase = baselinePath && PDB_LoadLines(baselinePath, &base) == 0;
+
+    int put = 0, removed = 0;
+    for (uint32_t i = 0; i <= cur.mask; i++) {
+        if (cur.slots[i] < 0) continue;
+        const PDB_Rec* r = &cur.recs[cur.slots[i]];
+        const PDB_Rec* b = haveBase ? PDB_LinesFind(&base, r->f[F_NAME]) : NULL;
+        if (b && PDB_SameRec(b, r)) continue;
+
+        PDB_Rec have;
+        if (PDB_FindName(db, r->f[F_NAME], &have) && PDB_SameRec(&have, r)) continue;
+        if (PDB_Append(db, r) != 0) break;
+        put++;
+    }
+    if (haveBase) {
+        for (uint32_t i = 0; i <= base.mask; i++) {
+            if (base.slots[i] < 0) continue;
+            const char* name = base.recs[base.slots[i]].f[F_NAME];
+            if (!PDB_LinesFind(&cur, name) && PDB_Delete(db, name) == 0) removed++;
+        }
+    }
+    if (put || removed) fprintf(stderr, "[PlayerDB] Imported %s: %d updated, %d removed\n", path, put, removed);
+
+    PDB_FreeLines(&cur);
+    if (haveBase) PDB_FreeLines(&base);
+    return 0;
+}
+
+static int PDB_Export(PDB* db, FILE* out) {
+    uint64_t off = PDB_FILE_HEADER;
+    PDB_Rec r;
+    ssize_t n;
+    while (off < db->head->logSize && (n = PDB_ReadRec(db->logFd, off, &r)) > 0) {
+        PDB_Slot* s = PDB_FindName(db, r.f[F_NAME], NULL);
+        if (s && s->off == off) PDB_PrintLine(out, &r);
+        off += (uint64_t)n;
+    }
+    return ferror(out) ? -1 : 0;
+}
+
+static int PDB_ExportFile(PDB* db, const char* path) {
+    char tmp[600];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE* f = fopen(tmp, "w");
+    if (!f) return -1;
+    int rc = PDB_Export(db, f);
+    if (fclose(f) != 0) rc = -1;
+    if (rc == 0 && rename(tmp, path) != 0) rc = -1;
+    if (rc != 0) unlink(tmp);
+    return rc;
+}
+
+// --- COMMANDS ---
+
+static int PDB_Usage(void) {
+    fprintf(stderr,
+            "Usage: playerdb <players.db> <command> [args]\n"
+            "  get <name> | ip <ip> | lookup <name>...\n"
+            "  put <name> <ip> <password> <rank> [whitelisted] [blacklisted] | del <name>\n"
+            "  import <players.log> [baseline] | export [file] | compact | stat\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) return PDB_Usage();
+    const char* cmd = argv[2];
+    char** args = argv + 3;
+    int nargs = argc - 3;
+
+    PDB db;
+    if (PDB_Open(&db, argv[1]) != 0) {
+        fprintf(stderr, "[PlayerDB] Cannot open %s: %s\n", argv[1], strerror(errno));
+        PDB_Close(&db);
+        return 1;
+    }
+
+    int rc = 0;
+    bool failed = false;
+    PDB_Rec r;
+    if (strcmp(cmd, "get") == 0 && nargs == 1) {
+        if (PDB_FindName(&db, args[0], &r)) {
+            printf("%s|%s|%s|%s|%s\n", r.f[F_IP], r.f[F_PASS], r.f[F_RANK], r.f[F_WHITE], r.f[F_BLACK]);
+        } else {
+            rc = 1;
+        }
+    } else if (strcmp(cmd, "lookup") == 0) {
+        for (int i = 0; i < nargs; i++) {
+            if (PDB_FindName(&db, args[i], &r)) PDB_PrintLine(stdout, &r);
+        }
+    } else if (strcmp(cmd, "ip") == 0 && nargs == 1) {
+        PDB_Rec want;
+        if (PDB_SetField(&want, F_IP, args[0]) != 0) {
+            PDB_Close(&db);
+            return PDB_Usage();
+        }
+        uint32_t mask = db.head->cap - 1, h = PDB_Hash(want.f[F_IP]);
+        rc = 1;
+        for (uint32_t i = h & mask; db.ips[i].off != SLOT_EMPTY; i = (i + 1) & mask) {
+            PDB_Slot* s = &db.ips[i];
+            if (s->off == SLOT_TOMB || s->hash != h) continue;
+            if (PDB_ReadRec(db.logFd, s->off, &r) > 0 && strcmp(r.f[F_IP], want.f[F_IP]) == 0) {
+                PDB_PrintLine(stdout, &r);
+                rc = 0;
+            }
+        }
+    } else if (strcmp(cmd, "put") == 0 && nargs >= 4 && nargs <= PDB_FIELDS) {
+        if (PDB_SetAll(&r, args, nargs) != 0) {
+            fprintf(stderr, "[PlayerDB] Invalid field (empty name, '|' or too long)\n");
+            rc = 2;
+        } else {
+            failed = PDB_Put(&db, &r) != 0 || PDB_MaybeCompact(&db) != 0;
+        }
+    } else if (strcmp(cmd, "del") == 0 && nargs == 1) {
+        rc = PDB_Delete(&db, args[0]);
+        failed = rc < 0 || PDB_MaybeCompact(&db) != 0;
+    } else if (strcmp(cmd, "import") == 0 && (nargs == 1 || nargs == 2)) {
+        failed = PDB_Import(&db, args[0], nargs == 2 ? args[1] : NULL) != 0 || PDB_MaybeCompact(&db) != 0;
+    } else if (strcmp(cmd, "export") == 0 && nargs <= 1) {
+        failed = (nargs ? PDB_ExportFile(&db, args[0]) : PDB_Export(&db, stdout)) != 0;
+    } else if (strcmp(cmd, "compact") == 0 && nargs == 0) {
+        failed = PDB_Compact(&db) != 0;
+    } else if (strcmp(cmd, "stat") == 0 && nargs == 0) {
+        printf("players=%u dead=%llu bytes=%llu slots=%u\n", db.head->live,
+               (unsigned long long)db.head->dead, (unsigned long long)db.head->logSize, db.head->cap);
+    } else {
+        rc = PDB_Usage();
+    }
+
+    if (!failed && rc == 0 && db.head->logSize > PDB_FILE_HEADER) fdatasync(db.logFd);
+    if (failed) {
+        fprintf(stderr, "[PlayerDB] %s failed: %s\n", cmd, strerror(errno));
+        rc = 1;
+    }
+    PDB_Close(&db);
+    return rc;
+}